@@ -0,0 +1,168 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""Read the live stats of running Scarab processes (src/live_stats.h).
+
+Every process with --live_stats on keeps its counters in /dev/shm/scarab.<pid>
+and updates them every --live_stats_interval under a seqlock.
+"""
+
+import glob
+import mmap
+import os
+import struct
+import time
+
+SHM_DIR = "/dev/shm"
+MAGIC = b"SCRBLIVE"
+VERSION = 1
+
+HEADER = struct.Struct("<8sIIIIQQQQQQQddd")
+CORE = struct.Struct("<QQdQ")
+SEQ_OFFSET = struct.calcsize("<8sIIIIQQQQ") # offset of seq in Live_Stats_Header
+FLOAT_TYPE_STAT = 1
+
+class LiveStatsError(Exception):
+  pass
+
+class Core:
+  def __init__(self, fields):
+    self.inst_count, self.cycle_count, self.kips, self.done = fields
+
+class LiveStats:
+  """
+  One consistent snapshot of the segment of a Scarab process.
+
+  stats[core][name] gives the total of a stat, as the stat files would get it.
+  """
+  def __init__(self, pid, path, header, cores, stats):
+    (_, _, self.num_cores, self.num_stats, done, _, _, _, _, _, self.updates,
+     self.cycle_count, self.seconds, self.kips, self.progress) = header
+    self.pid = pid
+    self.path = path
+    self.done = bool(done)
+    self.cores = cores
+    self.stats = stats
+    self.inst_count = sum(core.inst_count for core in cores)
+
+  def alive(self):
+    try:
+      os.kill(self.pid, 0)
+    except ProcessLookupError:
+      return False
+    except PermissionError:
+      pass
+    return True
+
+def segment_path(pid):
+  return os.path.join(SHM_DIR, "scarab.{}".format(pid))
+
+def list_pids():
+  pids = []
+  for path in glob.glob(segment_path("*")):
+    suffix = path.rsplit(".", 1)[-1]
+    if suffix.isdigit():
+      pids.append(int(suffix))
+  return sorted(pids)
+
+def _read_names(buf, offset, num_stats):
+  names = []
+  for _ in range(num_stats):
+    stat_type = buf[offset]
+    end = buf.index(b"\0", offset + 1)
+    names.append((buf[offset + 1:end].decode(), stat_type))
+    offset = end + 1
+  return names
+
+def read(pid, retries=1000):
+  """Snapshot the live stats of Scarab process pid"""
+  path = segment_path(pid)
+  try:
+    with open(path, "rb") as f:
+      buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+  except (OSError, ValueError) as e:
+    raise LiveStatsError("{}: {}".format(path, e))
+
+  try:
+    if len(buf) < HEADER.size or buf[:len(MAGIC)] != MAGIC:
+      raise LiveStatsError("{}: not a Scarab live stats segment (yet)".format(path))
+    header = HEADER.unpack_from(buf, 0)
+    if header[1] != VERSION:
+      raise LiveStatsError("{}: version {} is not supported".format(path, header[1]))
+    num_cores, num_stats = header[2], header[3]
+    cores_offset, stats_offset, names_offset = header[6], header[7], header[8]
+    names = _read_names(buf[names_offset:], 0, num_stats)
+    values = struct.Struct("<{}Q".format(num_stats))
+
+    for _ in range(retries):
+      seq = struct.unpack_from("<Q", buf, SEQ_OFFSET)[0]
+      if seq & 1:
+        time.sleep(0.001)
+        continue
+      snapshot = buf[:names_offset]
+      if struct.unpack_from("<Q", buf, SEQ_OFFSET)[0] == seq:
+        break
+    else:
+      raise LiveStatsError("{}: no consistent snapshot".format(path))
+  finally:
+    buf.close()
+
+  header = HEADER.unpack_from(snapshot, 0)
+  cores = [Core(CORE.unpack_from(snapshot, cores_offset + i * CORE.size)) for i in range(num_cores)]
+  stats = []
+  for core in range(num_cores):
+    raw = values.unpack_from(snapshot, stats_offset + core * num_stats * 8)
+    core_stats = {}
+    for (name, stat_type), value in zip(names, raw):
+      if stat_type == FLOAT_TYPE_STAT:
+        value = struct.unpack("<d", struct.pack("<Q", value))[0]
+      core_stats[name] = value
+    stats.append(core_stats)
+  return LiveStats(pid, path, header, cores, stats)
+
+def read_all(pids=None):
+  """Snapshots of the given (or all) Scarab processes, skipping segments of
+  processes that have died without removing them"""
+  snapshots = []
+  for pid in pids if pids is not None else list_pids():
+    try:
+      snapshot = read(pid)
+    except LiveStatsError:
+      continue
+    if snapshot.alive():
+      snapshots.append(snapshot)
+  return snapshots
+
+def remove_stale():
+  """Remove the segments of Scarab processes that died without removing them
+  (e.g. on an ASSERT), returns their pids"""
+  stale = []
+  for pid in list_pids():
+    try:
+      os.kill(pid, 0)
+    except ProcessLookupError:
+      try:
+        os.unlink(segment_path(pid))
+        stale.append(pid)
+      except OSError:
+        pass
+    except PermissionError:
+      pass
+  return stale
@@ -24,6 +24,8 @@ import re
 import argparse
 import enum
 
+import live_stats
+
 parser = argparse.ArgumentParser(description="Scarab Batch")
 parser.add_argument('results_dir', help="Jobfile to operator on.")
 
@@ -42,7 +44,7 @@ def warning(message):
 def error(message):
   print("Error: {}".format(message))
 
-keywords = ["Notify:", "Warning:", "Heartbeat:", "Finished:"]
+keywords = ["Notify:", "Warning:", "Heartbeat:", "Finished:", "Live stats:"]
 failwords = ["Error:", "ASSERT"]
 search_files = ["*.stdout", "*.stderr"]
 
@@ -121,9 +123,22 @@ class Progress:
     self.params_out = os.path.join(self.results_dir, "PARAMS.out")
     return not os.path.exists(self.params_out)
 
+  def _get_live_stats(self):
+    """
+    Scarab prints the path of its live stats segment (src/live_stats.h) to
+    stdout. Returns a snapshot if that process is still running.
+    """
+    for line in reversed(self.matching_lines["Live stats:"]):
+      m = re.search("Live stats:\s+\S*scarab\.([0-9]+)$", line)
+      if m:
+        snapshots = live_stats.read_all([int(m.group(1))])
+        return snapshots[0] if snapshots else None
+    return None
+
   def _get_progress(self):
     """
-    Progress % is reported in scarab stdout Heartbeat.
+    Progress % is read from the live stats of the running Scarab, or else
+    reported in scarab stdout Heartbeat.
     No Heartbeat, but scarab files: Probably Running...
     """
     if self._has_not_started():
@@ -131,7 +146,12 @@ class Progress:
       self.status = JobStatus.HAS_NOT_STARTED
       self.progress = 0
     else:
-      if len(self.matching_lines["Heartbeat:"]) == 0:
+      live = self._get_live_stats()
+      if live:
+        self.progress = int(100 * live.progress)
+        self.message = generate_progress_bar(self.progress, 100,
+            " insts: {} cycles: {} KIPS: {:.1f}".format(live.inst_count, live.cycle_count, live.kips))
+      elif len(self.matching_lines["Heartbeat:"]) == 0:
         self.progress = 0
         self.message = "No Heartbeat found. Scarab is probably running..."
       else:
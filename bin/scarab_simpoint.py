@@ -0,0 +1,154 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""Simulate a trace through its SimPoint regions.
+
+  1. Profile: scarab --mode simpoint picks the representative regions and
+     their weights (skipped when --regions points at an existing
+     simpoint.regions.out).
+  2. Simulate: every region runs in its own directory, --jobs at a time.
+     With the trace and memtrace frontends the trace is fast forwarded up to
+     --warmup instructions before the region (through the trace index when
+     there is one); otherwise the instructions before the region run in
+     warmup mode. Either way the last --warmup instructions
+     before the region warm up the caches and predictors.
+  3. Combine: the stats of the regions are weighted and summed into
+     <simdir>/<name>.stat.<core>.out files, so ratios of combined counts (IPC,
+     MPKI, ...) are the SimPoint estimates for the whole run.
+"""
+
+from __future__ import print_function
+import argparse
+import glob
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import time
+
+from scarab_globals import *
+
+parser = argparse.ArgumentParser(description="Simulate the SimPoint regions of a trace")
+parser.add_argument('--scarab_args', required=True, help="Arguments for every Scarab run (frontend and trace, e.g. '--frontend memtrace --cbp_trace_r0 app.zip --memtrace_modules_log modules').")
+parser.add_argument('--params', default=None, help="Path to the PARAMS file used by every run (copied as PARAMS.in).")
+parser.add_argument('--simdir', default=os.getcwd(), help="Directory to run in. Gets profile/, region.<cluster>/ and the combined stats.")
+parser.add_argument('--regions', default=None, help="Existing simpoint.regions.out to simulate instead of profiling.")
+parser.add_argument('--profile_args', default="", help="Extra arguments for the profiling run (e.g. '--simpoint_interval 100000000').")
+parser.add_argument('--warmup', type=int, default=10000000, help="Instructions of warmup before each region.")
+parser.add_argument('--jobs', type=int, default=os.cpu_count(), help="Regions simulated at the same time.")
+parser.add_argument('--scarab', default=scarab_paths.scarab_bin, help="Path to the scarab binary. Defaults to src/scarab.")
+
+args = parser.parse_args()
+args.scarab = os.path.abspath(args.scarab)
+args.simdir = os.path.abspath(args.simdir)
+
+stat_line = re.compile(r'^(\S+)\s+([0-9.]+)\s+([0-9.nan-]+)?[%]?\s+([0-9.]+)')
+
+def run_dir(name):
+  path = os.path.join(args.simdir, name)
+  os.makedirs(path, exist_ok=True)
+  if args.params:
+    shutil.copy2(args.params, os.path.join(path, "PARAMS.in"))
+  return path
+
+def profile():
+  path = run_dir("profile")
+  cmd = [args.scarab, "--mode", "simpoint"] + shlex.split(args.scarab_args) + shlex.split(args.profile_args)
+  print("Profiling:\n" + " ".join(cmd))
+  with open(os.path.join(path, "scarab.out"), "w") as out:
+    if subprocess.call(cmd, cwd=path, stdout=out, stderr=subprocess.STDOUT):
+      scarab_utils.error("Profiling failed, see {}".format(os.path.join(path, "scarab.out")))
+  return os.path.join(path, "simpoint.regions.out")
+
+def read_regions(regions_file):
+  regions = []
+  with open(regions_file) as fp:
+    for line in fp:
+      if line.startswith("#") or not line.strip():
+        continue
+      cluster, start, length, weight = line.split()
+      regions.append((int(cluster), int(start), int(length), float(weight)))
+  return regions
+
+def region_cmd(start, length):
+  cmd = [args.scarab] + shlex.split(args.scarab_args) + ["--inst_limit", str(length)]
+  warmup = min(args.warmup, start)
+  if re.search(r"--frontend[ =](mem)?trace\b", args.scarab_args) and start > warmup:
+    cmd += ["--fast_forward", "1", "--fast_forward_trace_ins", str(start - warmup)]
+  else:
+    warmup = start
+  if warmup:
+    cmd += ["--warmup", str(warmup)]
+  return cmd
+
+def simulate(regions):
+  pending = list(regions)
+  running = {}
+  failed = []
+  while pending or running:
+    while pending and len(running) < max(args.jobs, 1):
+      cluster, start, length, weight = pending.pop(0)
+      path = run_dir("region.{}".format(cluster))
+      cmd = region_cmd(start, length)
+      print("Region {} (weight {:.4f}):\n{}".format(cluster, weight, " ".join(cmd)))
+      out = open(os.path.join(path, "scarab.out"), "w")
+      running[cluster] = (subprocess.Popen(cmd, cwd=path, stdout=out, stderr=subprocess.STDOUT), out)
+    for cluster, (proc, out) in list(running.items()):
+      if proc.poll() is None:
+        continue
+      out.close()
+      del running[cluster]
+      if proc.returncode:
+        failed.append(cluster)
+    time.sleep(1)
+  if failed:
+    scarab_utils.error("Regions {} failed, see their scarab.out".format(failed))
+
+def combine(regions):
+  """Sum the stats of every stat file over the regions, weighted."""
+  total = sum(weight for _, _, _, weight in regions)
+  combined = {}
+  for cluster, _, _, weight in regions:
+    path = os.path.join(args.simdir, "region.{}".format(cluster))
+    for stat_file in glob.glob(os.path.join(path, "*.stat.*.out")):
+      stats = combined.setdefault(os.path.basename(stat_file), {})
+      with open(stat_file) as fp:
+        for line in fp:
+          m = stat_line.match(line)
+          if m:
+            stats[m.group(1)] = stats.get(m.group(1), 0.0) + float(m.group(2)) * weight / total
+  for name, stats in combined.items():
+    with open(os.path.join(args.simdir, name), "w") as fp:
+      fp.write("/* SimPoint weighted stats of {} regions */\n".format(len(regions)))
+      for stat, value in stats.items():
+        fp.write("{:<40s} {:13.2f} {:13.2f}\n".format(stat, value, value))
+  print("Combined stats of {} regions written to {}".format(len(regions), args.simdir))
+
+def main():
+  os.makedirs(args.simdir, exist_ok=True)
+  regions_file = args.regions if args.regions else profile()
+  regions = read_regions(regions_file)
+  simulate(regions)
+  combine(regions)
+
+if __name__ == "__main__":
+  main()
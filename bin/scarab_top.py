@@ -0,0 +1,89 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""Show the progress and live stats of running Scarab processes.
+
+Every Scarab process run with --live_stats 1 (the default) exports its
+counters in /dev/shm/scarab.<pid>, see src/live_stats.h. This script lists
+them all (or the given pids) without touching the simulations.
+"""
+
+from __future__ import print_function
+import argparse
+import sys
+import time
+
+from scarab_globals import live_stats
+
+parser = argparse.ArgumentParser(description="Show the live stats of running Scarab processes")
+parser.add_argument("pids", nargs="*", type=int, help="Scarab processes to show (default: all)")
+parser.add_argument("--stats", default="", help="Comma separated stats to show per core (e.g. DCACHE_MISS,ICACHE_MISS)")
+parser.add_argument("--cores", action="store_true", help="Show every core")
+parser.add_argument("--watch", type=float, default=0, help="Refresh every WATCH seconds")
+parser.add_argument("--clean", action="store_true", help="Remove the segments of Scarab processes that died")
+
+def format_time(seconds):
+  minutes, seconds = divmod(int(seconds), 60)
+  hours, minutes = divmod(minutes, 60)
+  return "{}:{:02d}:{:02d}".format(hours, minutes, seconds)
+
+def print_snapshots(snapshots, stats, show_cores):
+  print("{:>8s} {:>6s} {:>10s} {:>16s} {:>16s} {:>10s} {:>6s}".format(
+      "PID", "PROG", "TIME", "INSTS", "CYCLES", "KIPS", "IPC"))
+  for s in snapshots:
+    ipc = s.inst_count / s.cycle_count if s.cycle_count else 0.0
+    print("{:>8d} {:>5.1f}% {:>10s} {:>16d} {:>16d} {:>10.1f} {:>6.3f}{}".format(
+        s.pid, 100 * s.progress, format_time(s.seconds), s.inst_count,
+        s.cycle_count, s.kips, ipc, "  (finishing)" if s.done else ""))
+    if not show_cores and not stats:
+      continue
+    for proc_id, core in enumerate(s.cores):
+      ipc = core.inst_count / core.cycle_count if core.cycle_count else 0.0
+      line = "{:>8s} {:>6s} {:>10s} {:>16d} {:>16d} {:>10.1f} {:>6.3f}".format(
+          "core {}".format(proc_id), "done" if core.done else "", "",
+          core.inst_count, core.cycle_count, core.kips, ipc)
+      for name in stats:
+        value = s.stats[proc_id].get(name)
+        line += "  {}={}".format(name, "?" if value is None else value)
+      print(line)
+
+def __main():
+  args = parser.parse_args()
+  stats = [name for name in args.stats.split(",") if name]
+
+  if args.clean:
+    for pid in live_stats.remove_stale():
+      print("Removed the live stats of {}".format(pid))
+
+  while True:
+    snapshots = live_stats.read_all(args.pids or None)
+    if args.watch:
+      print("\033[H\033[J", end="")
+    if snapshots:
+      print_snapshots(snapshots, stats, args.cores)
+    else:
+      print("No running Scarab processes with live stats.")
+    if not args.watch:
+      break
+    sys.stdout.flush()
+    time.sleep(args.watch)
+
+if __name__ == "__main__":
+  __main()
@@ -0,0 +1,219 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""Convert the binary pipeview and memview traces of Scarab.
+
+  text:   the text format of earlier Scarab versions (O3PipeView lines for
+          pipeview traces, memview.out lines for memview traces)
+  konata: a Konata (https://github.com/shioyadan/Konata) pipeline log, for
+          pipeview traces
+
+Traces compressed by --view_compressor (gzip, bzip2 or xz) are read as is.
+"""
+
+from __future__ import print_function
+import argparse
+import bz2
+import gzip
+import heapq
+import lzma
+import struct
+import sys
+
+parser = argparse.ArgumentParser(description="Convert a binary pipeview or memview trace")
+parser.add_argument('format', choices=['text', 'konata'], help="Output format.")
+parser.add_argument('trace', help="Trace written by Scarab (e.g. pipeview.0.trace or memview.out).")
+parser.add_argument('--output', default=None, help="Output file. Defaults to stdout.")
+
+PIPEVIEW = 0
+MEMVIEW = 1
+
+MAGIC = b"SCRBVIEW"
+VERSION = 1
+
+# Konata stage started by each pipeview event (None ends the op)
+KONATA_STAGES = {
+  "fetch": "F", "fetch_offpath": "F", "decode": "Dc", "decode_done": "Dq",
+  "map": "Rn", "map_done": "Rq", "issue": "Is", "issue_done": "Iw",
+  "ready": "Rdy", "sched": "Sc", "exec": "X", "dcache": "Dm", "done": "Cm",
+  "flush": None, "retire": None, "end": None,
+}
+
+class Record:
+  def __init__(self, data):
+    self.data = data
+    self.pos = 0
+
+  def get(self, fmt):
+    vals = struct.unpack_from("<" + fmt, self.data, self.pos)
+    self.pos += struct.calcsize("<" + fmt)
+    return vals if len(vals) > 1 else vals[0]
+
+  def str(self):
+    length = self.get("H")
+    val = self.data[self.pos:self.pos + length].decode(errors="replace")
+    self.pos += length
+    return val
+
+def open_trace(path):
+  with open(path, "rb") as f:
+    magic = f.read(6)
+  if magic.startswith(b"\x1f\x8b"):
+    return gzip.open(path, "rb")
+  if magic.startswith(b"BZh"):
+    return bz2.open(path, "rb")
+  if magic.startswith(b"\xfd7zXZ"):
+    return lzma.open(path, "rb")
+  return open(path, "rb")
+
+def read_records(path):
+  """Yields (kind, None) first, then (type, Record) for every record. Name
+  tables are handled here and yielded as (0, {table: names})."""
+  f = open_trace(path)
+  header = f.read(16)
+  if len(header) < 16 or header[:8] != MAGIC:
+    sys.exit("%s is not a binary Scarab view trace" % path)
+  version, kind = struct.unpack("<II", header[8:])
+  if version != VERSION:
+    sys.exit("%s has version %d, expected %d" % (path, version, VERSION))
+  yield kind, None
+  tables = {}
+  while True:
+    head = f.read(3)
+    if len(head) < 3:
+      break
+    length, rec_type = struct.unpack("<HB", head)
+    rec = Record(f.read(length - 3))
+    if rec_type == 0:
+      table, count = rec.get("BB")
+      tables[table] = [rec.str() for _ in range(count)]
+      yield 0, tables
+    else:
+      yield rec_type, rec
+
+def pipeview_ops(records):
+  names = []
+  for rec_type, rec in records:
+    if rec_type == 0:
+      names = rec[0]
+      continue
+    fetch_cycle, addr, seq_num, num_events = rec.get("QQQB")
+    events = [rec.get("BQ") for _ in range(num_events)]
+    yield fetch_cycle, addr, seq_num, [(names[e], c) for e, c in events], rec.str()
+
+def pipeview_text(records, out):
+  for fetch_cycle, addr, seq_num, events, disasm in pipeview_ops(records):
+    out.write("O3PipeView:new:%d:%x:0:%d:%s\n" % (fetch_cycle, addr, seq_num, disasm))
+    for name, cycle in events:
+      out.write("O3PipeView:%s:%d\n" % (name, cycle))
+
+def pipeview_konata(records, out):
+  # Konata wants commands in cycle order, but ops are written when they
+  # leave the pipeline, so gather them all first
+  commands = []
+  retire_id = 0
+  for op_id, (fetch_cycle, addr, seq_num, events, disasm) in enumerate(pipeview_ops(records)):
+    order = 0
+    def add(cycle, cmd):
+      nonlocal order
+      commands.append((cycle, op_id, order, cmd))
+      order += 1
+    add(fetch_cycle, "I\t%d\t%d\t0" % (op_id, seq_num))
+    add(fetch_cycle, "L\t%d\t0\t%x: %s" % (op_id, addr, disasm))
+    stage = None
+    for name, cycle in sorted(events, key=lambda e: e[1]):
+      if name in ("retire", "flush"):
+        if stage:
+          add(cycle, "E\t%d\t0\t%s" % (op_id, stage))
+          stage = None
+        add(cycle, "R\t%d\t%d\t%d" % (op_id, retire_id, name == "flush"))
+        retire_id += name == "retire"
+      elif KONATA_STAGES.get(name):
+        if stage:
+          add(cycle, "E\t%d\t0\t%s" % (op_id, stage))
+        stage = KONATA_STAGES[name]
+        add(cycle, "S\t%d\t0\t%s" % (op_id, stage))
+  heapq.heapify(commands)
+
+  out.write("Kanata\t0004\n")
+  cycle = None
+  while commands:
+    next_cycle, _, _, cmd = heapq.heappop(commands)
+    if cycle is None:
+      out.write("C=\t%d\n" % next_cycle)
+    elif next_cycle > cycle:
+      out.write("C\t%d\n" % (next_cycle - cycle))
+    cycle = next_cycle
+    out.write(cmd + "\n")
+
+def memview_text(records, out):
+  names = {}
+  for rec_type, rec in records:
+    if rec_type == 0:
+      names = rec
+    elif rec_type == 1:  # params
+      for _ in range(rec.get("B")):
+        name = rec.str()
+        out.write("%-20s %3d\n" % (name, rec.get("i")))
+      out.write("\n")  # empty line indicates end of param section
+    elif rec_type == 2:  # DRAM
+      event, start, end, proc_id, unique_num, req_id, bank, pos = rec.get("Bqqiqiii")
+      out.write("%8s %10s %20d %20d %2d %10d %3d %2d %2d\n" % (
+        "DRAM", names[0][event], start, end, proc_id, unique_num, req_id, bank, pos))
+    elif rec_type == 3:  # DRAM critical path
+      start, end, from_index, to_index = rec.get("qqii")
+      from_type = rec.str()
+      to_type = rec.str()
+      out.write("%8s %10s %20d %20d  %s[%d]->%s[%d]\n" % (
+        "DRAM", "CRIT_PATH", start, end, from_type, from_index, to_type, to_index))
+    elif rec_type == 4:  # memory queue
+      begin, end, proc_id, count = rec.get("qqiB")
+      reqs = "".join(" %2d" % rec.get("i") for _ in range(count))
+      out.write("%8s %10s %20d %20d %2d%s\n" % ("MEMQUEUE", "DURATION", begin, end, proc_id, reqs))
+    elif rec_type == 5:  # LLC
+      out.write("%8s %10s %20d %20d %2d\n" % (("LLC", "ACCESS") + rec.get("qqi")))
+    elif rec_type == 6:  # core state
+      state, begin, end, proc_id = rec.get("Bqqi")
+      out.write("%8s %10s %20d %20d %2d\n" % ("CORE", names[1][state], begin, end, proc_id))
+    elif rec_type == 7:  # FUs busy
+      out.write("%8s %10s %20d %20d %2d %2d\n" % (("CORE", "FUS_BUSY") + rec.get("qqii")))
+    elif rec_type == 8:  # note
+      note_type, time = rec.get("iq")
+      out.write("%8s %10d %20d %20d %2d %s\n" % ("NOTE", note_type, time, 0, 0, rec.str()))
+    else:
+      sys.exit("Unknown memview record type %d" % rec_type)
+
+def main():
+  args = parser.parse_args()
+  records = read_records(args.trace)
+  kind, _ = next(records)
+  out = open(args.output, "w") if args.output else sys.stdout
+  if kind == PIPEVIEW and args.format == "text":
+    pipeview_text(records, out)
+  elif kind == PIPEVIEW:
+    pipeview_konata(records, out)
+  elif kind == MEMVIEW and args.format == "text":
+    memview_text(records, out)
+  else:
+    sys.exit("Only pipeview traces convert to Konata")
+  out.close()
+
+if __name__ == "__main__":
+  main()
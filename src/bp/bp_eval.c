@@ -0,0 +1,453 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bp/bp_eval.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Branch predictor only simulation mode.
+ *
+ * The parent process reads the frontend of core 0 and writes one compact
+ * record per control flow op into a ring buffer in shared memory. Every
+ * predictor named in BP_EVAL_MECHS runs in its own forked process, which
+ * consumes the ring at its own pace and drives bp.c exactly like the warmup
+ * path of the cmp model does: predict, resolve, recover on a misprediction
+ * and retire, all back to back. Predictors keep their state in per-core
+ * globals (and tagescl/tagescl80 pick their configuration from BP_MECH), so
+ * separate processes are what lets them run side by side.
+ *
+ * Each predictor writes bp_eval.<name>.out with MPKI per branch class and its
+ * BP_EVAL_WORST_PCS most mispredicted branches; the parent prints a summary.
+ ***************************************************************************************/
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "bp/bp.h"
+#include "bp/bp_eval.h"
+#include "frontend/frontend.h"
+#include "libs/hash_lib.h"
+#include "live_stats.h"
+#include "op.h"
+#include "sim.h"
+
+#include "bp/bp.param.h"
+#include "core.param.h"
+#include "general.param.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define MAX_BP_EVAL_MECHS 16
+#define BP_EVAL_PUBLISH_INTERVAL 256 /* records written between head updates */
+#define BP_EVAL_CACHE_LINE 64
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Bp_Eval_Rec_struct {
+  Addr addr;
+  Addr target;
+  Addr npc;
+  uns8 inst_size;
+  uns8 cf_type;
+  uns8 dir;
+} Bp_Eval_Rec;
+
+typedef struct Bp_Eval_Result_struct {
+  Counter execs[NUM_CF_TYPES];
+  Counter mispreds[NUM_CF_TYPES];
+  Counter misfetches[NUM_CF_TYPES];
+  Flag    done;
+} Bp_Eval_Result;
+
+/* producer and consumer positions live on separate lines so the predictors do
+   not bounce the head line around while they poll */
+typedef struct Bp_Eval_Shared_struct {
+  volatile uns64 head __attribute__((aligned(BP_EVAL_CACHE_LINE)));
+  volatile Flag  done;
+  Counter        insts;
+  struct {
+    volatile uns64 tail __attribute__((aligned(BP_EVAL_CACHE_LINE)));
+  } consumers[MAX_BP_EVAL_MECHS];
+  Bp_Eval_Result results[MAX_BP_EVAL_MECHS];
+  Bp_Eval_Rec    ring[];
+} Bp_Eval_Shared;
+
+typedef struct Bp_Eval_Pc_struct {
+  Addr    addr;
+  Cf_Type cf_type;
+  Counter execs;
+  Counter mispreds;
+} Bp_Eval_Pc;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Bp_Eval_Shared* shared;
+static uns             num_mechs;
+static uns             mechs[MAX_BP_EVAL_MECHS];
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void   parse_mechs(void);
+static void   produce(void);
+static void   consume(uns idx);
+static void   write_report(uns idx, Hash_Table* pcs);
+static void   print_summary(void);
+static uns64  min_tail(void);
+static int    cmp_worst_pc(const void*, const void*);
+static double mpki(Counter events, Counter insts);
+
+/**************************************************************************************/
+/* bp_eval_sim: */
+
+void bp_eval_sim(void) {
+  pid_t pids[MAX_BP_EVAL_MECHS];
+  uns   ii;
+  Flag  failed = FALSE;
+
+  ASSERTM(0, NUM_CORES == 1, "BP simulation mode supports a single core\n");
+  ASSERTM(0, !FETCH_OFF_PATH_OPS,
+          "BP simulation mode follows the correct path only\n");
+  ASSERTM(0, BP_EVAL_RING_ENTRIES >= BP_EVAL_PUBLISH_INTERVAL &&
+               is_power_of_2(BP_EVAL_RING_ENTRIES),
+          "BP_EVAL_RING_ENTRIES must be a power of two of at least %d\n",
+          BP_EVAL_PUBLISH_INTERVAL);
+  parse_mechs();
+
+  uns64 size = sizeof(Bp_Eval_Shared) +
+               sizeof(Bp_Eval_Rec) * (uns64)BP_EVAL_RING_ENTRIES;
+  shared = (Bp_Eval_Shared*)mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  ASSERTM(0, shared != MAP_FAILED, "Could not map the branch record ring\n");
+  memset(shared, 0, sizeof(Bp_Eval_Shared));
+
+  fflush(NULL);  // do not let the children flush our buffered output again
+  for(ii = 0; ii < num_mechs; ii++) {
+    pids[ii] = fork();
+    ASSERTM(0, pids[ii] >= 0, "Could not fork the %s predictor\n",
+            bp_table[mechs[ii]].name);
+    if(pids[ii] == 0) {
+      consume(ii);
+      fflush(NULL);
+      _exit(0);
+    }
+  }
+
+  produce();
+
+  for(ii = 0; ii < num_mechs; ii++) {
+    int status;
+    waitpid(pids[ii], &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+       !shared->results[ii].done) {
+      fprintf(mystdout, "Predictor %s did not finish\n",
+              bp_table[mechs[ii]].name);
+      failed = TRUE;
+    }
+  }
+  if(!failed)
+    print_summary();
+  ASSERTM(0, !failed, "BP simulation failed\n");
+  munmap(shared, size);
+}
+
+/**************************************************************************************/
+/* parse_mechs: */
+
+static void parse_mechs(void) {
+  char  buf[MAX_STR_LENGTH + 1];
+  char* name;
+  char* save;
+
+  ASSERTM(0, BP_EVAL_MECHS, "BP_EVAL_MECHS is empty\n");
+  strncpy(buf, BP_EVAL_MECHS, MAX_STR_LENGTH);
+  buf[MAX_STR_LENGTH] = '\0';
+
+  for(name = strtok_r(buf, ",", &save); name;
+      name = strtok_r(NULL, ",", &save)) {
+    uns ii;
+    for(ii = 0; bp_table[ii].name; ii++)
+      if(!strcmp(name, bp_table[ii].name))
+        break;
+    ASSERTM(0, bp_table[ii].name, "Unknown predictor '%s' in BP_EVAL_MECHS\n",
+            name);
+    ASSERTM(0, num_mechs < MAX_BP_EVAL_MECHS,
+            "At most %d predictors can be evaluated at once\n",
+            MAX_BP_EVAL_MECHS);
+    mechs[num_mechs++] = ii;
+  }
+  ASSERTM(0, num_mechs > 0, "BP_EVAL_MECHS is empty\n");
+}
+
+/**************************************************************************************/
+/* produce: reads the frontend and fills the ring */
+
+static void produce(void) {
+  Op         op;
+  Table_Info table_info;
+  Inst_Info  inst_info;
+  uns64      head = 0;
+  uns64      room = 0;
+  Counter    limit;
+
+  op.table_info = &table_info;
+  op.inst_info  = &inst_info;
+  op.mbp7_info  = NULL;
+  limit         = INST_LIMIT ? inst_limit[0] : 0;
+
+  while(!retired_exit[0] && (!limit || inst_count[0] < limit)) {
+    frontend_fetch_op(0, &op);
+    op_count[0]++;
+
+    if(op.table_info->cf_type) {
+      if(room == 0) {
+        /* wait for the slowest predictor to make space */
+        __atomic_store_n(&shared->head, head, __ATOMIC_RELEASE);
+        while((room = BP_EVAL_RING_ENTRIES - (head - min_tail())) <
+              BP_EVAL_PUBLISH_INTERVAL) {
+          /* predictors only exit after the trace is done, so one that is
+             gone already died and would stall the ring forever */
+          int status;
+          ASSERTM(0, waitpid(-1, &status, WNOHANG) <= 0,
+                  "A predictor process exited early\n");
+          sched_yield();
+        }
+      }
+      Bp_Eval_Rec* rec = &shared->ring[head & (BP_EVAL_RING_ENTRIES - 1)];
+      rec->addr        = op.inst_info->addr;
+      rec->target      = op.oracle_info.target;
+      rec->npc         = op.oracle_info.npc;
+      rec->inst_size   = op.inst_info->trace_info.inst_size;
+      rec->cf_type     = op.table_info->cf_type;
+      rec->dir         = op.oracle_info.dir;
+      head++;
+      room--;
+      if(head % BP_EVAL_PUBLISH_INTERVAL == 0)
+        __atomic_store_n(&shared->head, head, __ATOMIC_RELEASE);
+    }
+
+    if(op.exit)
+      retired_exit[0] = TRUE;
+    if(op.eom) {
+      inst_count[0]++;
+      frontend_retire(0, op.inst_uid);
+      live_stats_cycle();
+    }
+  }
+
+  shared->insts = inst_count[0];
+  __atomic_store_n(&shared->head, head, __ATOMIC_RELEASE);
+  __atomic_store_n(&shared->done, TRUE, __ATOMIC_RELEASE);
+}
+
+/**************************************************************************************/
+/* consume: runs one predictor over the ring (in a child process) */
+
+static void consume(uns idx) {
+  Bp_Data         bp_data;
+  Bp_Eval_Result* result = &shared->results[idx];
+  Hash_Table      pcs;
+  Op              op;
+  Table_Info      table_info;
+  Inst_Info       inst_info;
+  uns64           tail = 0;
+
+  BP_MECH = mechs[idx];
+  memset(&bp_data, 0, sizeof(bp_data));
+  init_bp_data(0, &bp_data);
+  init_hash_table(&pcs, "bp_eval_pcs", 4096, sizeof(Bp_Eval_Pc));
+
+  memset(&op, 0, sizeof(op));
+  memset(&table_info, 0, sizeof(table_info));
+  memset(&inst_info, 0, sizeof(inst_info));
+  op.table_info = &table_info;
+  op.inst_info  = &inst_info;
+
+  while(TRUE) {
+    uns64 head = __atomic_load_n(&shared->head, __ATOMIC_ACQUIRE);
+    if(tail == head) {
+      if(__atomic_load_n(&shared->done, __ATOMIC_ACQUIRE) &&
+         tail == __atomic_load_n(&shared->head, __ATOMIC_ACQUIRE))
+        break;
+      sched_yield();
+      continue;
+    }
+
+    for(; tail < head; tail++) {
+      Bp_Eval_Rec* rec = &shared->ring[tail & (BP_EVAL_RING_ENTRIES - 1)];
+      Flag         new_entry;
+
+      memset(&op.oracle_info, 0, sizeof(op.oracle_info));
+      op.op_num                      = tail + 1;
+      inst_info.addr                 = rec->addr;
+      inst_info.trace_info.inst_size = rec->inst_size;
+      table_info.cf_type             = rec->cf_type;
+      op.oracle_info.dir             = rec->dir;
+      op.oracle_info.target          = rec->target;
+      op.oracle_info.npc             = rec->npc;
+
+      bp_predict_op(&bp_data, &op, 0, rec->addr);
+      bp_target_known_op(&bp_data, &op);
+      bp_resolve_op(&bp_data, &op);
+      if(op.oracle_info.mispred || op.oracle_info.misfetch)
+        bp_recover_op(&bp_data, rec->cf_type, &op.recovery_info);
+      bp_retire_op(&bp_data, &op);
+
+      result->execs[rec->cf_type]++;
+      result->mispreds[rec->cf_type] += op.oracle_info.mispred;
+      result->misfetches[rec->cf_type] += op.oracle_info.misfetch;
+
+      Bp_Eval_Pc* pc = (Bp_Eval_Pc*)hash_table_access_create(&pcs, rec->addr,
+                                                             &new_entry);
+      if(new_entry) {
+        pc->addr    = rec->addr;
+        pc->cf_type = rec->cf_type;
+      }
+      pc->execs++;
+      pc->mispreds += op.oracle_info.mispred || op.oracle_info.misfetch;
+    }
+    __atomic_store_n(&shared->consumers[idx].tail, tail, __ATOMIC_RELEASE);
+  }
+
+  write_report(idx, &pcs);
+  result->done = TRUE;
+}
+
+/**************************************************************************************/
+/* write_report: */
+
+static void write_report(uns idx, Hash_Table* pcs) {
+  Bp_Eval_Result* result = &shared->results[idx];
+  Counter         insts  = shared->insts;
+  char            name[MAX_STR_LENGTH + 1];
+  FILE*           file;
+  uns             ii;
+
+  snprintf(name, MAX_STR_LENGTH, "bp_eval.%s", bp_table[mechs[idx]].name);
+  file = file_tag_fopen(OUTPUT_DIR, name, "w");
+  ASSERTM(0, file, "Could not open the %s report\n", name);
+
+  fprintf(file, "Predictor: %s  Instructions: %llu\n\n",
+          bp_table[mechs[idx]].name, insts);
+  fprintf(file, "%-10s %14s %14s %14s %10s\n", "Class", "Execs", "Mispreds",
+          "Misfetches", "MPKI");
+  for(ii = 1; ii < NUM_CF_TYPES; ii++) {
+    if(!result->execs[ii])
+      continue;
+    fprintf(file, "%-10s %14llu %14llu %14llu %10.3f\n", cf_type_names[ii],
+            result->execs[ii], result->mispreds[ii], result->misfetches[ii],
+            mpki(result->mispreds[ii] + result->misfetches[ii], insts));
+  }
+
+  if(pcs->count) {
+    Bp_Eval_Pc** worst = (Bp_Eval_Pc**)hash_table_flatten(pcs, NULL);
+    qsort(worst, pcs->count, sizeof(Bp_Eval_Pc*), cmp_worst_pc);
+
+    fprintf(file, "\nWorst branches\n");
+    fprintf(file, "%-18s %-10s %14s %14s %8s %10s\n", "PC", "Class", "Execs",
+            "Mispreds", "Rate", "MPKI");
+    for(ii = 0; ii < MIN2(BP_EVAL_WORST_PCS, pcs->count); ii++) {
+      Bp_Eval_Pc* pc = worst[ii];
+      if(!pc->mispreds)
+        break;
+      fprintf(file, "0x%-16llx %-10s %14llu %14llu %7.2f%% %10.3f\n",
+              (unsigned long long)pc->addr, cf_type_names[pc->cf_type],
+              pc->execs, pc->mispreds, 100.0 * pc->mispreds / pc->execs,
+              mpki(pc->mispreds, insts));
+    }
+    free(worst);
+  }
+  fclose(file);
+}
+
+/**************************************************************************************/
+/* print_summary: */
+
+static void print_summary(void) {
+  Counter insts = shared->insts;
+  uns     ii, jj;
+
+  fprintf(mystdout, "\nBranch prediction over %llu instructions (MPKI)\n",
+          insts);
+  fprintf(mystdout, "%-12s %10s", "Predictor", "Total");
+  for(jj = 1; jj < NUM_CF_TYPES; jj++)
+    fprintf(mystdout, " %9s", cf_type_names[jj]);
+  fprintf(mystdout, "\n");
+
+  for(ii = 0; ii < num_mechs; ii++) {
+    Bp_Eval_Result* result = &shared->results[ii];
+    Counter         total  = 0;
+    for(jj = 1; jj < NUM_CF_TYPES; jj++)
+      total += result->mispreds[jj] + result->misfetches[jj];
+    fprintf(mystdout, "%-12s %10.3f", bp_table[mechs[ii]].name,
+            mpki(total, insts));
+    for(jj = 1; jj < NUM_CF_TYPES; jj++)
+      fprintf(mystdout, " %9.3f",
+              mpki(result->mispreds[jj] + result->misfetches[jj], insts));
+    fprintf(mystdout, "\n");
+  }
+  fprintf(mystdout, "\n");
+}
+
+/**************************************************************************************/
+/* min_tail: */
+
+static uns64 min_tail(void) {
+  uns64 tail = MAX_CTR;
+  uns   ii;
+  for(ii = 0; ii < num_mechs; ii++)
+    tail = MIN2(tail, __atomic_load_n(&shared->consumers[ii].tail,
+                                      __ATOMIC_ACQUIRE));
+  return tail;
+}
+
+/**************************************************************************************/
+/* cmp_worst_pc: most mispredictions first */
+
+static int cmp_worst_pc(const void* a, const void* b) {
+  const Bp_Eval_Pc* pa = *(Bp_Eval_Pc* const*)a;
+  const Bp_Eval_Pc* pb = *(Bp_Eval_Pc* const*)b;
+  if(pa->mispreds != pb->mispreds)
+    return pa->mispreds < pb->mispreds ? 1 : -1;
+  return pa->addr < pb->addr ? -1 : pa->addr > pb->addr;
+}
+
+/**************************************************************************************/
+/* mpki: */
+
+static double mpki(Counter events, Counter insts) {
+  return insts ? 1000.0 * events / insts : 0.0;
+}
@@ -0,0 +1,42 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bp/bp_eval.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Branch predictor only simulation mode (--mode bp). The
+ *                frontend is read once and every conditional and
+ *                unconditional branch is fed to several predictors from
+ *                bp_table at the same time, without any timing model.
+ ***************************************************************************************/
+
+#ifndef __BP_EVAL_H__
+#define __BP_EVAL_H__
+
+/**************************************************************************************/
+/* Prototypes */
+
+void bp_eval_sim(void);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __BP_EVAL_H__ */
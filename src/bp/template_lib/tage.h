@@ -22,28 +22,34 @@
 #ifndef __TAGE_H_
 #define __TAGE_H_
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
 #include "utils.h"
 
 /* The main history register suitable for very large history. The history is
- * implemented as a circular buffer for efficiency. The API only allows
- * insertions of bits into the most recent position of the history and provides
- * an accessor for random access of individual bits. It also provides an API for
- * rewinding the history to support recovery from mispeculation */
+ * implemented as a circular buffer of 64-bit words for efficiency. The API only
+ * allows insertions of bits into the most recent position of the history and
+ * provides accessors for random access of individual bits or short runs of
+ * bits. It also provides an API for rewinding the history to support recovery
+ * from mispeculation */
 template <int history_size>
 class Long_History_Register {
  public:
-  // Buffer_size needs to be a power of 2. (buffer_size - history_size) should
-  // be large enough to cover speculative branches that are not yet retired.
-  Long_History_Register(int max_in_flight_branches) : history_bits_() {
-    int log_buffer_size       = get_min_num_bits_to_represent(history_size +
+  // Buffer_size needs to be a power of 2 (and at least one word).
+  // (buffer_size - history_size) should be large enough to cover speculative
+  // branches that are not yet retired.
+  Long_History_Register(int max_in_flight_branches) : history_words_() {
+    int log_buffer_size = get_min_num_bits_to_represent(history_size +
                                                         max_in_flight_branches);
-    buffer_size_              = 1 << log_buffer_size;
-    buffer_access_mask_       = (1 << log_buffer_size) - 1;
+    if(log_buffer_size < 6) {
+      log_buffer_size = 6;
+    }
+    buffer_size_              = int64_t(1) << log_buffer_size;
+    buffer_access_mask_       = buffer_size_ - 1;
     max_num_speculative_bits_ = buffer_size_ - history_size;
-    history_bits_.resize(buffer_size_);
+    history_words_.resize(buffer_size_ / 64, 0);
   }
 
   // Pushes one bit into the history at the head. Increments
@@ -53,7 +59,10 @@ class Long_History_Register {
     // TODO: it will be cleaner to mask head_ with (size_ - 1) now. But I
     // want to keep it compatible with Seznec.
     head_ -= 1;
-    history_bits_[head_ & buffer_access_mask_] = bit;
+    int64_t  pos  = head_ & buffer_access_mask_;
+    uint64_t mask = uint64_t(1) << (pos & 63);
+    history_words_[pos >> 6] = (history_words_[pos >> 6] & ~mask) |
+                               (bit ? mask : 0);
 
     num_speculative_bits_ += 1;
     assert(num_speculative_bits_ <= max_num_speculative_bits_);
@@ -74,7 +83,22 @@ class Long_History_Register {
 
   // Random access interface, i=0 is the most recent branch (head).
   bool operator[](size_t i) const {
-    return history_bits_[(head_ + i) & buffer_access_mask_];
+    int64_t pos = (head_ + i) & buffer_access_mask_;
+    return (history_words_[pos >> 6] >> (pos & 63)) & 1;
+  }
+
+  // Returns num_bits (< 64) consecutive history bits starting at i, with
+  // bit i in the least significant position.
+  uint64_t get_bits(size_t i, int num_bits) const {
+    int64_t  pos    = (head_ + i) & buffer_access_mask_;
+    int64_t  word   = pos >> 6;
+    int      offset = pos & 63;
+    uint64_t bits   = history_words_[word] >> offset;
+    if(offset + num_bits > 64) {
+      bits |= history_words_[(word + 1) & (buffer_access_mask_ >> 6)]
+              << (64 - offset);
+    }
+    return bits & ((uint64_t(1) << num_bits) - 1);
   }
 
   int64_t head_idx() const { return head_; }
@@ -83,60 +107,93 @@ class Long_History_Register {
   int num_speculative_bits_ = 0;  // keeps track of how many bits can be
                                   // discarded during a rewind without losing
                                   // bits in the most significant position.
-  std::vector<bool> history_bits_;
-  int64_t           head_ = 0;
-  int64_t           buffer_size_;
-  int64_t           buffer_access_mask_;
-  int64_t           max_num_speculative_bits_;
+  std::vector<uint64_t> history_words_;
+  int64_t               head_ = 0;
+  int64_t               buffer_size_;
+  int64_t               buffer_access_mask_;
+  int64_t               max_num_speculative_bits_;
 };
 
-/* Computes the a folded history of a large history, as bits are shifted into
- * the history. The caller should update the folded history everytime  */
-template <int history_size>
-class Folded_History {
+/* Computes the folded histories of a large history, as bits are shifted into
+ * the history. The state of all folded histories is kept in parallel arrays so
+ * that a whole set is updated in one loop. Shifting num_bits bits into a
+ * folded history of length c is a c-bit rotation by num_bits, xor-ed with the
+ * new bits and with the bits leaving the original length (rotated to the
+ * outpoint), so several bits are folded in at once. The caller should update
+ * the folded histories everytime bits are pushed into the history register,
+ * after pushing them. */
+template <int history_size, int num_histories>
+class Folded_History_Set {
  public:
-  Folded_History(int original_length, int compressed_length) :
-      current_value_(0), original_length_(original_length),
-      compressed_length_(compressed_length),
-      outpoint_(original_length % compressed_length) {}
-
-  int64_t get_value() const { return current_value_; }
-
-  void update(const Long_History_Register<history_size>& history_register) {
-    // Shift in the most recent GHR bit.
-    current_value_ = (current_value_ << 1) ^ history_register[0];
+  Folded_History_Set() :
+      current_values_(), original_lengths_(), compressed_lengths_(),
+      outpoints_(), masks_() {}
+
+  void initialize(int i, int original_length, int compressed_length) {
+    assert(compressed_length > 0 && compressed_length < 32);
+    current_values_[i]     = 0;
+    original_lengths_[i]   = original_length;
+    compressed_lengths_[i] = compressed_length;
+    outpoints_[i]          = original_length % compressed_length;
+    masks_[i]              = (uint64_t(1) << compressed_length) - 1;
+  }
 
-    // Shift out the least recent GHR bit.
-    current_value_ ^= history_register[original_length_] << outpoint_;
+  int64_t get_value(int i) const { return current_values_[i]; }
 
-    // Fold shifted-out bit in.
-    current_value_ ^= current_value_ >> compressed_length_;
+  // The most bits that can be folded in (or out) by a single update.
+  int max_bits_per_update() const {
+    int max_bits = 63;
+    for(int i = 0; i < num_histories; ++i) {
+      max_bits = std::min(max_bits, compressed_lengths_[i]);
+    }
+    return max_bits;
+  }
 
-    // Mask out the unused bits.
-    current_value_ &= (1 << compressed_length_) - 1;
+  // Folds in the num_bits most recent bits of history_register.
+  void update(const Long_History_Register<history_size>& history_register,
+              int num_bits) {
+    assert(num_bits > 0 && num_bits <= max_bits_per_update());
+    const uint64_t in_bits = history_register.get_bits(0, num_bits);
+    for(int i = 0; i < num_histories; ++i) {
+      const int      length = compressed_lengths_[i];
+      const uint64_t value  = current_values_[i];
+      const uint64_t out_bits =
+        history_register.get_bits(original_lengths_[i], num_bits)
+        << outpoints_[i];
+      current_values_[i] = ((value << num_bits) ^
+                            (value >> (length - num_bits)) ^ in_bits ^
+                            out_bits ^ (out_bits >> length)) &
+                           masks_[i];
+    }
   }
 
+  // Folds out the num_bits most recent bits of history_register. Must be
+  // called before those bits are rewound out of the register.
   void update_reverse(
-    const Long_History_Register<history_size>& history_register) {
-    // Fold out the most recent GHR bit.
-    current_value_ ^= history_register[0];
-
-    // Fold out the least recent GHR bit.
-    current_value_ ^= history_register[original_length_] << outpoint_;
-
-    // Rotate the low bit around to high bit.
-    current_value_ = ((current_value_ & 1) << (compressed_length_ - 1)) |
-                     (current_value_ >> 1);
-
-    // Mask out the unused bits.
-    current_value_ &= (1 << compressed_length_) - 1;
+    const Long_History_Register<history_size>& history_register,
+    int                                        num_bits) {
+    assert(num_bits > 0 && num_bits <= max_bits_per_update());
+    const uint64_t in_bits = history_register.get_bits(0, num_bits);
+    for(int i = 0; i < num_histories; ++i) {
+      const int      length = compressed_lengths_[i];
+      const uint64_t out_bits =
+        history_register.get_bits(original_lengths_[i], num_bits)
+        << outpoints_[i];
+      const uint64_t value = (current_values_[i] ^ in_bits ^ out_bits ^
+                              (out_bits >> length)) &
+                             masks_[i];
+      current_values_[i] = ((value >> num_bits) ^
+                            (value << (length - num_bits))) &
+                           masks_[i];
+    }
   }
 
  private:
-  int64_t current_value_;
-  int     original_length_;
-  int     compressed_length_;
-  int     outpoint_;
+  int64_t  current_values_[num_histories];
+  int      original_lengths_[num_histories];
+  int      compressed_lengths_[num_histories];
+  int      outpoints_[num_histories];
+  uint64_t masks_[num_histories];
 };
 
 template <class TAGE_CONFIG>
@@ -265,13 +322,8 @@ class Tage_Histories {
 
       path_history_ = (path_history_ << 1) ^ (path_hash & 127);
       path_hash >>= 1;
-
-      for(int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
-        folded_histories_for_indices_[j].update(history_register_);
-        folded_histories_for_tags_0_[j].update(history_register_);
-        folded_histories_for_tags_1_[j].update(history_register_);
-      }
     }
+    folded_histories_.update(history_register_, num_bit_inserts);
 
     path_history_ = path_history_ &
                     ((1 << TAGE_CONFIG::PATH_HISTORY_WIDTH) - 1);
@@ -279,6 +331,18 @@ class Tage_Histories {
 
   void intialize_folded_history(void);
 
+  // Folded histories of the j-th history length, for the table indices and
+  // for the two halves of the tags.
+  int64_t folded_history_for_index(int j) const {
+    return folded_histories_.get_value(j);
+  }
+  int64_t folded_history_for_tag_0(int j) const {
+    return folded_histories_.get_value(TAGE_CONFIG::NUM_HISTORIES + j);
+  }
+  int64_t folded_history_for_tag_1(int j) const {
+    return folded_histories_.get_value(2 * TAGE_CONFIG::NUM_HISTORIES + j);
+  }
+
   // Hash function for the path history used in creating table indices.
   int64_t compute_path_hash(int64_t path_history, int max_width, int bank,
                             int index_size) const;
@@ -290,12 +354,10 @@ class Tage_Histories {
 
   // Predictor State
   Long_History_Register<TAGE_CONFIG::MAX_HISTORY_SIZE> history_register_;
-  std::vector<Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>>
-    folded_histories_for_indices_;
-  std::vector<Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>>
-    folded_histories_for_tags_0_;
-  std::vector<Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>>
-    folded_histories_for_tags_1_;
+  // Index histories first, then the tag_0 and tag_1 histories.
+  Folded_History_Set<TAGE_CONFIG::MAX_HISTORY_SIZE,
+                     3 * TAGE_CONFIG::NUM_HISTORIES>
+    folded_histories_;
 
   int64_t path_history_;
   int64_t head_old_;
@@ -586,16 +648,14 @@ class Tage {
     int64_t num_flushed_bits =
       (prediction_info.global_history_head_checkpoint_ -
        tage_histories_.history_register_.head_idx());
-    for(int i = 0; i < num_flushed_bits; ++i) {
-      for(int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
-        tage_histories_.folded_histories_for_indices_[j].update_reverse(
-          tage_histories_.history_register_);
-        tage_histories_.folded_histories_for_tags_0_[j].update_reverse(
-          tage_histories_.history_register_);
-        tage_histories_.folded_histories_for_tags_1_[j].update_reverse(
-          tage_histories_.history_register_);
-      }
-      tage_histories_.history_register_.rewind(1);
+    const int max_bits_per_update =
+      tage_histories_.folded_histories_.max_bits_per_update();
+    while(num_flushed_bits > 0) {
+      int num_bits = std::min<int64_t>(num_flushed_bits, max_bits_per_update);
+      tage_histories_.folded_histories_.update_reverse(
+        tage_histories_.history_register_, num_bits);
+      tage_histories_.history_register_.rewind(num_bits);
+      num_flushed_bits -= num_bits;
     }
     tage_histories_.path_history_ = prediction_info.path_history_checkpoint;
   }
@@ -689,19 +749,18 @@ void Tage<TAGE_CONFIG>::initialize_table_sizes(void) {
 
 template <class TAGE_CONFIG>
 void Tage_Histories<TAGE_CONFIG>::intialize_folded_history(void) {
-  // insert dummy entries for the zeroth entry of the vector
   for(int i = 0; i < TAGE_CONFIG::NUM_HISTORIES; i++) {
     // For some reason I cannot pass LOG_ENTRIES_PER_BANK to emplace_bank()
     // directly (gcc complains that variable is undefined), do not know why.
     // REVISIT: since I got rid of LOG_ENTRIES_PER_BANK as a constant, this
     // should be fine now.
     const int LOG_ENTRIES_PER_BANK2 = TAGE_CONFIG::LOG_ENTRIES_PER_BANK;
-    folded_histories_for_indices_.emplace_back(history_sizes_.arr[i],
-                                               LOG_ENTRIES_PER_BANK2);
-    folded_histories_for_tags_0_.emplace_back(history_sizes_.arr[i],
-                                              tag_bits_.arr[i]);
-    folded_histories_for_tags_1_.emplace_back(history_sizes_.arr[i],
-                                              tag_bits_.arr[i] - 1);
+    folded_histories_.initialize(i, history_sizes_.arr[i],
+                                 LOG_ENTRIES_PER_BANK2);
+    folded_histories_.initialize(TAGE_CONFIG::NUM_HISTORIES + i,
+                                 history_sizes_.arr[i], tag_bits_.arr[i]);
+    folded_histories_.initialize(2 * TAGE_CONFIG::NUM_HISTORIES + i,
+                                 history_sizes_.arr[i], tag_bits_.arr[i] - 1);
   }
 }
 
@@ -757,18 +816,14 @@ void Tage<TAGE_CONFIG>::fill_table_indices_tags(
         TAGE_CONFIG::LOG_ENTRIES_PER_BANK);
       int64_t index = br_pc;
       index ^= br_pc >> (std::abs(TAGE_CONFIG::LOG_ENTRIES_PER_BANK - i) + 1);
-      index ^=
-        tage_histories_.folded_histories_for_indices_[(i - 1) / 2].get_value();
+      index ^= tage_histories_.folded_history_for_index((i - 1) / 2);
       index ^= path_hash;
       output->indices[i] = index &
                            ((1 << TAGE_CONFIG::LOG_ENTRIES_PER_BANK) - 1);
 
       int64_t tag = br_pc;
-      tag ^=
-        tage_histories_.folded_histories_for_tags_0_[(i - 1) / 2].get_value();
-      tag ^=
-        tage_histories_.folded_histories_for_tags_1_[(i - 1) / 2].get_value()
-        << 1;
+      tag ^= tage_histories_.folded_history_for_tag_0((i - 1) / 2);
+      tag ^= tage_histories_.folded_history_for_tag_1((i - 1) / 2) << 1;
       output->tags[i] = tag &
                         ((1 << tage_histories_.tag_bits_.arr[(i - 1) / 2]) - 1);
 
@@ -39,6 +39,8 @@
 #include "dvfs/perf_pred.h"
 #include "general.param.h"
 #include "globals/assert.h"
+#include "host_prof.h"
+#include "memory/cache_explore.h"
 #include "memory/cache_part.h"
 #include "memory/memory.param.h"
 #include "op_pool.h"
@@ -59,7 +61,6 @@ static void cmp_redirect(void);
 static void cmp_measure_chip_util(void);
 static void cmp_istreams(void);
 static void cmp_cores(void);
-static void warmup_uncore(uns proc_id, Addr addr, Flag write);
 
 /**************************************************************************************/
 /* cmp_init */
@@ -125,6 +126,7 @@ void cmp_init(uns mode) {
     dvfs_init();
 
   cache_part_init();
+  cache_explore_init();
 
   ASSERTM(0, !USE_LATE_BP || LATE_BP_LATENCY < (DECODE_CYCLES + MAP_CYCLES),
           "Late branch prediction latency should be less than the total "
@@ -154,17 +156,30 @@ void cmp_reset() {
 /* cmp_cycle: */
 
 void cmp_cycle() {
+  HOST_PROF_BEGIN(CMP_CYCLE);
+
+  HOST_PROF_BEGIN(CMP_ISTREAMS);
   cmp_istreams();
+  HOST_PROF_END(0, CMP_ISTREAMS);
 
   /* Frequency domain checking is inside this function, since it
      handles both shared cache and memory */
+  HOST_PROF_BEGIN(UPDATE_MEMORY);
   update_memory();
+  HOST_PROF_END(0, UPDATE_MEMORY);
 
   cmp_cores();
 
-  if(DVFS_ON)
+  if(DVFS_ON) {
+    HOST_PROF_BEGIN(DVFS);
     dvfs_cycle();
+    HOST_PROF_END(0, DVFS);
+  }
+  HOST_PROF_BEGIN(CACHE_PART);
   cache_part_update();
+  HOST_PROF_END(0, CACHE_PART);
+
+  HOST_PROF_END(0, CMP_CYCLE);
 }
 
 void cmp_istreams(void) {
@@ -205,14 +220,33 @@ void cmp_cores(void) {
       set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
       cmp_set_all_stages(proc_id);
 
+      HOST_PROF_BEGIN(DCACHE_STAGE);
       update_dcache_stage(&exec->sd);
+      HOST_PROF_END(proc_id, DCACHE_STAGE);
+
+      HOST_PROF_BEGIN(EXEC_STAGE);
       update_exec_stage(&node->sd);
+      HOST_PROF_END(proc_id, EXEC_STAGE);
+
+      HOST_PROF_BEGIN(NODE_STAGE);
       update_node_stage(map->last_sd);
+      HOST_PROF_END(proc_id, NODE_STAGE);
+
+      HOST_PROF_BEGIN(MAP_STAGE);
       update_map_stage(dec->last_sd);
+      HOST_PROF_END(proc_id, MAP_STAGE);
+
+      HOST_PROF_BEGIN(DECODE_STAGE);
       update_decode_stage(&ic->sd);
+      HOST_PROF_END(proc_id, DECODE_STAGE);
+
+      HOST_PROF_BEGIN(ICACHE_STAGE);
       update_icache_stage();
+      HOST_PROF_END(proc_id, ICACHE_STAGE);
 
+      HOST_PROF_BEGIN(NODE_SCHED_OPS);
       node_sched_ops();
+      HOST_PROF_END(proc_id, NODE_SCHED_OPS);
 
       cmp_measure_chip_util();
     }
@@ -370,11 +404,19 @@ void cmp_retire_hook(Op* op) {
   free_op(op);
 }
 
+/**************************************************************************************/
+/* warmup_uncore: functionally warm up the L1 of the current memory model
+   with an access that missed in a core cache (also used by the interval
+   model) */
+
 void warmup_uncore(uns proc_id, Addr addr, Flag write) {
   Addr dummy_line_addr;
   ASSERTM(0, !MLC_PRESENT, "Warmup for MLC not implemented\n");
 
-  Cache*   l1_cache = &(cmp_model.memory.uncores[proc_id].l1->cache);
+  if(CACHE_EXPLORE)
+    cache_explore_uncore_access(proc_id, addr);
+
+  Cache*   l1_cache = &(mem->uncores[proc_id].l1->cache);
   L1_Data* l1_data  = cache_access(l1_cache, addr, &dummy_line_addr, TRUE);
   if(l1_data) {  // hit
     if(write)
@@ -432,6 +474,8 @@ void cmp_warmup(Op* op) {
   Flag is_load  = op->table_info->mem_type == MEM_LD;
   Flag is_store = op->table_info->mem_type == MEM_ST;
   if(is_load || is_store) {
+    if(CACHE_EXPLORE)
+      cache_explore_dcache_access(proc_id, va);
     Cache*       dcache  = &(cmp_model.dcache_stage[proc_id].dcache);
     Dcache_Data* dc_data = cache_access(dcache, va, &dummy_line_addr, TRUE);
     if(dc_data) {
@@ -86,6 +86,7 @@ void cmp_done(void);
 void cmp_wake(Op*, Op*, uns8);
 void cmp_retire_hook(Op*);
 void cmp_warmup(Op*);
+void warmup_uncore(uns proc_id, Addr addr, Flag write);
 
 /**************************************************************************************/
 
@@ -29,6 +29,7 @@
 #include "cmp_model_support.h"
 #include "cmp_model.h"
 #include "core.param.h"
+#include "frontend/frontend.h"
 #include "frontend/pin_trace_fe.h"
 #include "general.param.h"
 #include "globals/assert.h"
@@ -123,3 +124,42 @@ void cmp_init_bogus_sim(uns8 proc_id) {
   reset_exec_stage();
   reset_dcache_stage();
 }
+
+/**************************************************************************************/
+/* cmp_hold_fetch: Stop (or restart) fetching new ops on a core. Ops already
+ * fetched keep flowing through the pipeline, so holding fetch and cycling
+ * until cmp_drained drains the core. Used by sampling_sim.
+ */
+void cmp_hold_fetch(uns8 proc_id, Flag hold) {
+  cmp_model.icache_stage[proc_id].hold_fetch = hold;
+}
+
+/**************************************************************************************/
+/* cmp_drained: Has every fetched op of the core retired or been flushed, with
+ * no recovery or redirect pending?
+ */
+Flag cmp_drained(uns8 proc_id) {
+  Icache_Stage*     icache_stage = &cmp_model.icache_stage[proc_id];
+  Bp_Recovery_Info* recovery     = &cmp_model.bp_recovery_info[proc_id];
+
+  return list_get_count(&cmp_model.thread_data[proc_id].seq_op_list) == 0 &&
+         icache_stage->state == IC_FETCH &&
+         icache_stage->next_state == IC_FETCH &&
+         recovery->recovery_cycle == MAX_CTR &&
+         recovery->redirect_cycle == MAX_CTR;
+}
+
+/**************************************************************************************/
+/* cmp_resync_fetch: Restart fetch on a drained core at the frontend's next
+ * instruction. The frontend may have moved on while the core was drained
+ * (e.g. by functional warming), so the fetch address is reloaded from it.
+ */
+void cmp_resync_fetch(uns8 proc_id) {
+  ASSERT(proc_id, cmp_drained(proc_id));
+  cmp_set_all_stages(proc_id);
+
+  td->inst_addr = frontend_next_fetch_addr(proc_id);
+  ASSERT_PROC_ID_IN_ADDR(proc_id, td->inst_addr);
+  reset_all_ops_icache_stage();
+  ic->hold_fetch = FALSE;
+}
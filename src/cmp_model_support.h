@@ -39,6 +39,9 @@ void cmp_init_cmp_model(void);
 void cmp_init_thread_data(uns8);
 void cmp_set_all_stages(uns8);
 void cmp_init_bogus_sim(uns8);
+void cmp_hold_fetch(uns8, Flag);
+Flag cmp_drained(uns8);
+void cmp_resync_fetch(uns8);
 /**************************************************************************************/
 /* External variables */
 
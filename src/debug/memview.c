@@ -28,6 +28,7 @@
 
 #include "debug/memview.h"
 #include "core.param.h"
+#include "debug/view_trace.h"
 #include "exec_ports.h"
 #include "freq.h"
 #include "general.param.h"
@@ -48,6 +49,30 @@ DEFINE_ENUM(Memview_Note_Type, MEMVIEW_NOTE_TYPE_LIST);
 /**************************************************************************************/
 /* Types */
 
+/* Record types (see debug/view_trace.h). The fields follow the columns of the
+   text lines that bin/scarab_view.py prints for them: times are u64 and procs
+   u32. Table 0 names the DRAM events and table 1 the core states. */
+typedef enum Memview_Record_enum {
+  MEMVIEW_REC_PARAMS = 1,  // <u8 n> n * (<name> <u32 value>)
+  MEMVIEW_REC_DRAM,        // <u8 event> <start> <end> <proc> <req unique num>
+                           // <u32 req id> <u32 bank> <u32 pos>
+  MEMVIEW_REC_CRIT_PATH,   // <start> <end> <u32 from idx> <u32 to idx>
+                           // <from type> <to type>
+  MEMVIEW_REC_MEMQUEUE,    // <begin> <end> <proc> <u8 n> n * <u32 reqs>
+  MEMVIEW_REC_LLC,         // <start> <end> <proc>
+  MEMVIEW_REC_CORE,        // <u8 state> <begin> <end> <proc>
+  MEMVIEW_REC_FUS_BUSY,    // <begin> <end> <proc> <u32 fus busy>
+  MEMVIEW_REC_NOTE,        // <u32 type> <time> <note>
+} Memview_Record;
+
+typedef enum Memview_Core_State_enum {
+  MEMVIEW_STALL,
+  MEMVIEW_COMPUTE,
+  MEMVIEW_MEM_BLOCK,
+  MEMVIEW_MEM_AVAIL,
+  MEMVIEW_NUM_CORE_STATES
+} Memview_Core_State;
+
 typedef struct Bank_Info_struct {
   uns pos;
 } Bank_Info;
@@ -66,7 +91,7 @@ typedef struct Proc_Info_struct {
 /**************************************************************************************/
 /* Global Variables */
 
-FILE*         trace;
+Async_Writer* trace;
 Bank_Info*    bank_infos;
 Proc_Info*    proc_infos;
 Trigger*      start_trigger;
@@ -78,7 +103,7 @@ Mem_Req_Type* req_types;
 static void trace_memqueue_state(uns proc_id, Counter begin, Counter end,
                                  uns* num_reqs_by_type);
 static void trace_core_state(uns proc_id, Counter begin, Counter end,
-                             const char* state);
+                             Memview_Core_State state);
 static void trace_fus_busy(uns proc_id, Counter begin, Counter end,
                            uns fus_busy);
 
@@ -91,9 +116,7 @@ void memview_init(void) {
     return;
   }
 
-  const char* memview_filename = MEMVIEW_FILE;
-  trace                        = fopen(memview_filename, "w");
-  ASSERTM(0, trace, "Could not open %s\n", memview_filename);
+  trace = view_trace_open(MEMVIEW_FILE, VIEW_MEMVIEW);
 
   bank_infos = calloc(RAMULATOR_CHANNELS * RAMULATOR_BANKS, sizeof(Bank_Info));
   proc_infos = calloc(NUM_CORES, sizeof(Proc_Info));
@@ -114,7 +137,22 @@ void memview_init(void) {
   start_trigger = trigger_create("MEMVIEW START TRIGGER", MEMVIEW_START,
                                  TRIGGER_ONCE);
 
-#define MEMVIEW_PARAM_PRINT(param) fprintf(trace, "%-20s %3d\n", #param, param)
+  const char* dram_events[MEMVIEW_DRAM_NUM_ELEMS];
+  for(uns event = 0; event < MEMVIEW_DRAM_NUM_ELEMS; event++)
+    dram_events[event] = Memview_Dram_Event_str(event);
+  const char* core_states[MEMVIEW_NUM_CORE_STATES] = {"STALL", "COMPUTE",
+                                                      "MEM_BLOCK", "MEM_AVAIL"};
+  view_trace_names(trace, 0, dram_events, MEMVIEW_DRAM_NUM_ELEMS);
+  view_trace_names(trace, 1, core_states, MEMVIEW_NUM_CORE_STATES);
+
+  View_Record rec;
+  view_record_start(&rec, MEMVIEW_REC_PARAMS);
+  uns num_params_pos = rec.len;
+  view_u8(&rec, 0);
+#define MEMVIEW_PARAM_PRINT(param) \
+  view_str(&rec, #param);          \
+  view_u32(&rec, param);           \
+  rec.buf[num_params_pos]++
   MEMVIEW_PARAM_PRINT(NUM_CORES);
   MEMVIEW_PARAM_PRINT(NUM_FUS);
   // MEMVIEW_PARAM_PRINT(MEMORY_CYCLE_TIME);
@@ -124,8 +162,7 @@ void memview_init(void) {
   MEMVIEW_PARAM_PRINT(MEM_REQ_BUFFER_ENTRIES);
   MEMVIEW_PARAM_PRINT(MEMVIEW_NOTE_NUM_ELEMS);
 #undef MEMVIEW_PARAM_PRINT
-
-  fprintf(trace, "\n");  // empty line indicates end of param section
+  view_record_end(trace, &rec);
 }
 
 /**************************************************************************************/
@@ -138,11 +175,18 @@ void memview_dram(Memview_Dram_Event event, Mem_Req* req, uns flat_bank_id,
   if(!trigger_on(start_trigger))
     return;
 
-  Bank_Info* bank_info = &bank_infos[flat_bank_id];
-  fprintf(trace, "%8s %10s %20lld %20lld %2d %10lld %3d %2d %2d\n", "DRAM",
-          Memview_Dram_Event_str(event), start, end, req ? req->proc_id : -1,
-          req ? req->unique_num : -1, req ? req->id : -1, flat_bank_id,
-          bank_info->pos);
+  Bank_Info*  bank_info = &bank_infos[flat_bank_id];
+  View_Record rec;
+  view_record_start(&rec, MEMVIEW_REC_DRAM);
+  view_u8(&rec, event);
+  view_u64(&rec, start);
+  view_u64(&rec, end);
+  view_u32(&rec, req ? req->proc_id : -1);
+  view_u64(&rec, req ? req->unique_num : -1);
+  view_u32(&rec, req ? req->id : -1);
+  view_u32(&rec, flat_bank_id);
+  view_u32(&rec, bank_info->pos);
+  view_record_end(trace, &rec);
   if(event == MEMVIEW_DRAM_COLUMN) {
     bank_info->pos = (bank_info->pos + 1) % 3;
   }
@@ -156,19 +200,29 @@ void memview_dram_crit_path(const char* from_type_str, uns from_index,
   if(!trigger_on(start_trigger))
     return;
 
-  fprintf(trace, "%8s %10s %20lld %20lld  %s[%d]->%s[%d]\n", "DRAM",
-          "CRIT_PATH", start, end, from_type_str, from_index, to_type_str,
-          to_index);
+  View_Record rec;
+  view_record_start(&rec, MEMVIEW_REC_CRIT_PATH);
+  view_u64(&rec, start);
+  view_u64(&rec, end);
+  view_u32(&rec, from_index);
+  view_u32(&rec, to_index);
+  view_str(&rec, from_type_str);
+  view_str(&rec, to_type_str);
+  view_record_end(trace, &rec);
 }
 
 void trace_memqueue_state(uns proc_id, Counter begin, Counter end,
                           uns* num_reqs_by_type) {
-  fprintf(trace, "%8s %10s %20lld %20lld %2d", "MEMQUEUE", "DURATION", begin,
-          end, proc_id);
+  View_Record rec;
+  view_record_start(&rec, MEMVIEW_REC_MEMQUEUE);
+  view_u64(&rec, begin);
+  view_u64(&rec, end);
+  view_u32(&rec, proc_id);
+  view_u8(&rec, MRT_NUM_ELEMS);
   for(Mem_Req_Type type = 0; type < MRT_NUM_ELEMS; type++) {
-    fprintf(trace, " %2d", num_reqs_by_type[type]);
+    view_u32(&rec, num_reqs_by_type[type]);
   }
-  fprintf(trace, "\n");
+  view_record_end(trace, &rec);
 }
 
 /**************************************************************************************/
@@ -234,9 +288,13 @@ void memview_l1(Mem_Req* req) {
     return;
 
   ASSERT(0, req);
-  fprintf(trace, "%8s %10s %20lld %20lld %2d\n", "LLC", "ACCESS", freq_time(),
-          (freq_time() + freq_get_cycle_time(FREQ_DOMAIN_L1) * L1_CYCLES),
-          req->proc_id);
+  View_Record rec;
+  view_record_start(&rec, MEMVIEW_REC_LLC);
+  view_u64(&rec, freq_time());
+  view_u64(&rec,
+           freq_time() + freq_get_cycle_time(FREQ_DOMAIN_L1) * L1_CYCLES);
+  view_u32(&rec, req->proc_id);
+  view_record_end(trace, &rec);
 }
 
 /**************************************************************************************/
@@ -251,7 +309,7 @@ void memview_core_stall(uns proc_id, Flag stalled, Flag mem_blocked) {
   if(proc_info->stalled != stalled) {
     if(trigger_on(start_trigger)) {
       trace_core_state(proc_id, proc_info->last_stalled_event_time, freq_time(),
-                       proc_info->stalled ? "STALL" : "COMPUTE");
+                       proc_info->stalled ? MEMVIEW_STALL : MEMVIEW_COMPUTE);
     }
     proc_info->last_stalled_event_time = freq_time();
     proc_info->stalled                 = stalled;
@@ -260,7 +318,8 @@ void memview_core_stall(uns proc_id, Flag stalled, Flag mem_blocked) {
     if(trigger_on(start_trigger)) {
       trace_core_state(proc_id, proc_info->last_mem_blocked_event_time,
                        freq_time(),
-                       proc_info->mem_blocked ? "MEM_BLOCK" : "MEM_AVAIL");
+                       proc_info->mem_blocked ? MEMVIEW_MEM_BLOCK :
+                                                MEMVIEW_MEM_AVAIL);
     }
     proc_info->last_mem_blocked_event_time = freq_time();
     proc_info->mem_blocked                 = mem_blocked;
@@ -271,9 +330,14 @@ void memview_core_stall(uns proc_id, Flag stalled, Flag mem_blocked) {
 /* trace_core_state */
 
 void trace_core_state(uns proc_id, Counter begin, Counter end,
-                      const char* state) {
-  fprintf(trace, "%8s %10s %20lld %20lld %2d\n", "CORE", state, begin, end,
-          proc_id);
+                      Memview_Core_State state) {
+  View_Record rec;
+  view_record_start(&rec, MEMVIEW_REC_CORE);
+  view_u8(&rec, state);
+  view_u64(&rec, begin);
+  view_u64(&rec, end);
+  view_u32(&rec, proc_id);
+  view_record_end(trace, &rec);
 }
 
 /**************************************************************************************/
@@ -299,8 +363,13 @@ void memview_fus_busy(uns proc_id, uns fus_busy) {
 /* trace_fus_busy */
 
 void trace_fus_busy(uns proc_id, Counter begin, Counter end, uns fus_busy) {
-  fprintf(trace, "%8s %10s %20lld %20lld %2d %2d\n", "CORE", "FUS_BUSY", begin,
-          end, proc_id, fus_busy);
+  View_Record rec;
+  view_record_start(&rec, MEMVIEW_REC_FUS_BUSY);
+  view_u64(&rec, begin);
+  view_u64(&rec, end);
+  view_u32(&rec, proc_id);
+  view_u32(&rec, fus_busy);
+  view_record_end(trace, &rec);
 }
 
 /**************************************************************************************/
@@ -313,17 +382,18 @@ void memview_done(void) {
     for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
       Proc_Info* proc_info = &proc_infos[proc_id];
       trace_core_state(proc_id, proc_info->last_stalled_event_time, freq_time(),
-                       proc_info->stalled ? "STALL" : "COMPUTE");
+                       proc_info->stalled ? MEMVIEW_STALL : MEMVIEW_COMPUTE);
       trace_core_state(proc_id, proc_info->last_mem_blocked_event_time,
                        freq_time(),
-                       proc_info->mem_blocked ? "MEM_BLOCK" : "MEM_AVAIL");
+                       proc_info->mem_blocked ? MEMVIEW_MEM_BLOCK :
+                                                MEMVIEW_MEM_AVAIL);
       trace_fus_busy(proc_id, proc_info->last_fus_change_time, freq_time(),
                      proc_info->fus_busy);
       trace_memqueue_state(proc_id, proc_info->last_memqueue_change_time,
                            freq_time(), proc_info->num_reqs_by_type);
     }
   }
-  fclose(trace);
+  async_writer_close(trace);
 }
 
 /**************************************************************************************/
@@ -333,8 +403,12 @@ void memview_note(Memview_Note_Type type, const char* str) {
   if(!MEMVIEW)
     return;
   if(trigger_on(start_trigger)) {
-    fprintf(trace, "%8s %10d %20lld %20lld %2d %s\n", "NOTE", type, freq_time(),
-            0ULL, 0, str);
+    View_Record rec;
+    view_record_start(&rec, MEMVIEW_REC_NOTE);
+    view_u32(&rec, type);
+    view_u64(&rec, freq_time());
+    view_str(&rec, str);
+    view_record_end(trace, &rec);
   }
 }
 
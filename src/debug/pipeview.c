@@ -29,6 +29,7 @@
 #include "debug/pipeview.h"
 #include "core.param.h"
 #include "debug/debug_print.h"
+#include "debug/view_trace.h"
 #include "general.param.h"
 #include "globals/assert.h"
 #include "globals/global_defs.h"
@@ -36,41 +37,70 @@
 
 /**************************************************************************************
 
-Input file format:
-O3PipeView:fetch:<timestamp>:<inst addr>:<uop addr>:<seq num>:<disasm>
+Records (see debug/view_trace.h), one per op:
+<fetch cycle> <inst addr> <seq num> <u8 n> n * (<u8 event> <u64 cycle>) <disasm>
+Table 0 names the events. bin/scarab_view.py turns them back into
+O3PipeView:new:<timestamp>:<inst addr>:<uop addr>:<seq num>:<disasm>
 O3PipeView:<event>:<timestamp>
-<event> can be map, issue, sched, etc.
-All events for a uop must be on consecutive lines
+lines (all events for a uop on consecutive lines) or into a Konata log.
 
 ***************************************************************************************/
 
+/**************************************************************************************/
+/* Types: */
+
+typedef enum Pipeview_Event_enum {
+  PIPEVIEW_FETCH,
+  PIPEVIEW_FETCH_OFFPATH,
+  PIPEVIEW_DECODE,
+  PIPEVIEW_DECODE_DONE,
+  PIPEVIEW_MAP,
+  PIPEVIEW_MAP_DONE,
+  PIPEVIEW_ISSUE,
+  PIPEVIEW_ISSUE_DONE,
+  PIPEVIEW_READY,
+  PIPEVIEW_SCHED,
+  PIPEVIEW_EXEC,
+  PIPEVIEW_DCACHE,
+  PIPEVIEW_DONE,
+  PIPEVIEW_FLUSH,
+  PIPEVIEW_RETIRE,
+  PIPEVIEW_END,
+  PIPEVIEW_NUM_EVENTS
+} Pipeview_Event;
+
 /**************************************************************************************/
 /* Global variables: */
 
-static FILE** files = NULL;
+static Async_Writer** files = NULL;
 
 /**************************************************************************************/
 /* Constants: */
 
-static const char* PREFIX = "O3PipeView";
+static const char* const EVENT_NAMES[PIPEVIEW_NUM_EVENTS] = {
+  "fetch", "fetch_offpath", "decode", "decode_done", "map",  "map_done",
+  "issue", "issue_done",    "ready",  "sched",       "exec", "dcache",
+  "done",  "flush",         "retire", "end",
+};
+
+static const uns8 PIPEVIEW_OP = 1;  // record type
 
 /**************************************************************************************/
 /* Local prototypes: */
 
-void print_header(FILE*, Op*);
-void print_event(FILE*, Op*, const char*, Counter);
+static void put_event(View_Record*, uns8*, Op*, Pipeview_Event, Counter);
 
 /**************************************************************************************/
 /* pipeview_init: */
 
 void pipeview_init(void) {
-  files = malloc(sizeof(FILE*) * NUM_CORES);
+  files = malloc(sizeof(Async_Writer*) * NUM_CORES);
   if(PIPEVIEW) {
     for(uns proc_id = 0; proc_id < NUM_CORES; ++proc_id) {
       char filename[MAX_STR_LENGTH + 1];
       sprintf(filename, "%s.%d.trace", PIPEVIEW_FILE, proc_id);
-      files[proc_id] = fopen(filename, "w");
-      ASSERT(proc_id, files[proc_id]);
+      files[proc_id] = view_trace_open(filename, VIEW_PIPEVIEW);
+      view_trace_names(files[proc_id], 0, EVENT_NAMES, PIPEVIEW_NUM_EVENTS);
     }
   }
 }
@@ -82,37 +112,51 @@ void pipeview_print_op(struct Op_struct* op) {
   if(!DEBUG_RANGE_COND(op->proc_id))
     return;
 
-  FILE* file = files[op->proc_id];
-  print_header(file, op);
+  View_Record rec;
+  uns8        num_events = 0;
+  view_record_start(&rec, PIPEVIEW_OP);
+  view_u64(&rec, op->fetch_cycle);
+  view_u64(&rec, op->inst_info->addr);
+  view_u64(&rec, op->unique_num_per_proc);
+  uns num_events_pos = rec.len;
+  view_u8(&rec, 0);
+
   if(op->off_path) {
-    print_event(file, op, "fetch_offpath", op->fetch_cycle);
+    put_event(&rec, &num_events, op, PIPEVIEW_FETCH_OFFPATH, op->fetch_cycle);
   } else {
-    print_event(file, op, "fetch", op->fetch_cycle);
+    put_event(&rec, &num_events, op, PIPEVIEW_FETCH, op->fetch_cycle);
   }
-  print_event(file, op, "decode", op->fetch_cycle + 1);
-  print_event(file, op, "decode_done", op->fetch_cycle + 1 + DECODE_CYCLES);
-  print_event(file, op, "map", op->map_cycle);
-  print_event(file, op, "map_done", op->map_cycle + MAP_CYCLES);
-  print_event(file, op, "issue", op->issue_cycle);
-  print_event(file, op, "issue_done", op->issue_cycle + 1);
+  put_event(&rec, &num_events, op, PIPEVIEW_DECODE, op->fetch_cycle + 1);
+  put_event(&rec, &num_events, op, PIPEVIEW_DECODE_DONE,
+            op->fetch_cycle + 1 + DECODE_CYCLES);
+  put_event(&rec, &num_events, op, PIPEVIEW_MAP, op->map_cycle);
+  put_event(&rec, &num_events, op, PIPEVIEW_MAP_DONE,
+            op->map_cycle + MAP_CYCLES);
+  put_event(&rec, &num_events, op, PIPEVIEW_ISSUE, op->issue_cycle);
+  put_event(&rec, &num_events, op, PIPEVIEW_ISSUE_DONE, op->issue_cycle + 1);
   if(op->srcs_not_rdy_vector == 0) {
     // op was ready at rdy_cycle only if all sources are ready
-    print_event(file, op, "ready", MAX2(op->rdy_cycle, op->issue_cycle + 1));
+    put_event(&rec, &num_events, op, PIPEVIEW_READY,
+              MAX2(op->rdy_cycle, op->issue_cycle + 1));
   } else {
     ASSERT(op->proc_id, op->off_path);
   }
-  print_event(file, op, "sched", op->sched_cycle);
-  print_event(file, op, "exec", op->exec_cycle);
-  print_event(file, op, "dcache", op->dcache_cycle);
-  print_event(file, op, "done", op->done_cycle);
+  put_event(&rec, &num_events, op, PIPEVIEW_SCHED, op->sched_cycle);
+  put_event(&rec, &num_events, op, PIPEVIEW_EXEC, op->exec_cycle);
+  put_event(&rec, &num_events, op, PIPEVIEW_DCACHE, op->dcache_cycle);
+  put_event(&rec, &num_events, op, PIPEVIEW_DONE, op->done_cycle);
   if(op->off_path) {
-    print_event(file, op, "flush", cycle_count);
-    print_event(file, op, "end", cycle_count);
+    put_event(&rec, &num_events, op, PIPEVIEW_FLUSH, cycle_count);
+    put_event(&rec, &num_events, op, PIPEVIEW_END, cycle_count);
   } else {
     ASSERT(op->proc_id, op->retire_cycle <= cycle_count);
-    print_event(file, op, "retire", op->retire_cycle);
-    print_event(file, op, "end", op->retire_cycle);
+    put_event(&rec, &num_events, op, PIPEVIEW_RETIRE, op->retire_cycle);
+    put_event(&rec, &num_events, op, PIPEVIEW_END, op->retire_cycle);
   }
+
+  rec.buf[num_events_pos] = num_events;
+  view_str(&rec, disasm_op(op, TRUE));
+  view_record_end(files[op->proc_id], &rec);
 }
 
 /**************************************************************************************/
@@ -121,27 +165,22 @@ void pipeview_print_op(struct Op_struct* op) {
 void pipeview_done(void) {
   if(PIPEVIEW) {
     for(uns proc_id = 0; proc_id < NUM_CORES; ++proc_id) {
-      fclose(files[proc_id]);
+      async_writer_close(files[proc_id]);
     }
   }
 }
 
 /**************************************************************************************/
-/* print_event: */
+/* put_event: */
 
-void print_event(FILE* file, Op* op, const char* name, Counter cycle) {
-  /* print only events that make sense because flushed ops may not
+static void put_event(View_Record* rec, uns8* num_events, Op* op,
+                      Pipeview_Event event, Counter cycle) {
+  /* record only events that make sense because flushed ops may not
      have all *_cycle fields set and non mem ops will not have
      dcache_cycle set  */
   if(cycle >= op->fetch_cycle && cycle <= cycle_count) {
-    fprintf(file, "%s:%s:%lld\n", PREFIX, name, cycle);
+    view_u8(rec, event);
+    view_u64(rec, cycle);
+    (*num_events)++;
   }
 }
-
-/**************************************************************************************/
-/* print_header: */
-
-void print_header(FILE* file, Op* op) {
-  fprintf(file, "%s:new:%lld:%llx:%d:%lld:%s\n", PREFIX, op->fetch_cycle,
-          op->inst_info->addr, 0, op->unique_num_per_proc, disasm_op(op, TRUE));
-}
@@ -0,0 +1,56 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : debug/view_trace.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Binary record format of the pipeview and memview traces
+ ***************************************************************************************/
+
+#include "debug/view_trace.h"
+#include "general.param.h"
+
+/**************************************************************************************/
+/* view_trace_open: */
+
+Async_Writer* view_trace_open(const char* filename, View_Kind kind) {
+  uns32         header[2] = {VIEW_TRACE_VERSION, kind};
+  Async_Writer* writer    = async_writer_open(filename, VIEW_COMPRESSOR,
+                                              VIEW_BUFFER_SIZE);
+  async_writer_put(writer, "SCRBVIEW", 8);
+  async_writer_put(writer, header, sizeof(header));
+  return writer;
+}
+
+/**************************************************************************************/
+/* view_trace_names: */
+
+void view_trace_names(Async_Writer* writer, uns8 table,
+                      const char* const* names, uns8 count) {
+  View_Record rec;
+  view_record_start(&rec, 0);
+  view_u8(&rec, table);
+  view_u8(&rec, count);
+  for(uns8 ii = 0; ii < count; ii++)
+    view_str(&rec, names[ii]);
+  view_record_end(writer, &rec);
+}
@@ -0,0 +1,118 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : debug/view_trace.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Binary record format of the pipeview and memview traces
+ ***************************************************************************************/
+
+#ifndef __VIEW_TRACE_H__
+#define __VIEW_TRACE_H__
+
+#include <string.h>
+#include "globals/global_types.h"
+#include "libs/async_writer_lib.h"
+
+/**************************************************************************************
+
+File format (little endian, bin/scarab_view.py converts it to text or Konata):
+"SCRBVIEW" <u32 version> <u32 kind>, then records of
+<u16 record length> <u8 record type> <fields>
+Strings are <u16 length> <bytes>. Record type 0 lists the names of a table
+(<u8 table> <u8 count> <string>...), the other types depend on the kind.
+
+***************************************************************************************/
+
+/**************************************************************************************/
+/* Types */
+
+#define VIEW_TRACE_VERSION 1
+#define VIEW_RECORD_MAX 1024
+
+typedef enum View_Kind_enum {
+  VIEW_PIPEVIEW,
+  VIEW_MEMVIEW,
+} View_Kind;
+
+typedef struct View_Record_struct {
+  uns8 buf[VIEW_RECORD_MAX];
+  uns  len;
+} View_Record;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Open a trace and write its file header */
+Async_Writer* view_trace_open(const char* filename, View_Kind kind);
+
+/* Write the names of a table of the trace */
+void view_trace_names(Async_Writer* writer, uns8 table,
+                      const char* const* names, uns8 count);
+
+/**************************************************************************************/
+/* Record building */
+
+static inline void view_bytes(View_Record* rec, const void* data, uns size) {
+  if(rec->len + size <= VIEW_RECORD_MAX) {
+    memcpy(&rec->buf[rec->len], data, size);
+    rec->len += size;
+  }
+}
+
+static inline void view_u8(View_Record* rec, uns8 val) {
+  view_bytes(rec, &val, sizeof(val));
+}
+
+static inline void view_u16(View_Record* rec, uns16 val) {
+  view_bytes(rec, &val, sizeof(val));
+}
+
+static inline void view_u32(View_Record* rec, uns32 val) {
+  view_bytes(rec, &val, sizeof(val));
+}
+
+static inline void view_u64(View_Record* rec, uns64 val) {
+  view_bytes(rec, &val, sizeof(val));
+}
+
+/* Strings are cut to fit the record */
+static inline void view_str(View_Record* rec, const char* str) {
+  uns len  = strlen(str);
+  uns room = VIEW_RECORD_MAX - rec->len - sizeof(uns16);
+  len      = len < room ? len : room;
+  view_u16(rec, len);
+  view_bytes(rec, str, len);
+}
+
+static inline void view_record_start(View_Record* rec, uns8 type) {
+  rec->len = sizeof(uns16);
+  view_u8(rec, type);
+}
+
+static inline void view_record_end(Async_Writer* writer, View_Record* rec) {
+  uns16 len = rec->len;
+  memcpy(rec->buf, &len, sizeof(len));
+  async_writer_put(writer, rec->buf, rec->len);
+}
+
+#endif /* #ifndef __VIEW_TRACE_H__ */
@@ -23,8 +23,9 @@
  * File         : dumb_model.c
  * Author       : HPS Research Group
  * Date         : 7/23/2013
- * Description  : Model that drives the memory system with randomly
- *                generated memory requests (no core modeling)
+ * Description  : Model that drives the memory system with synthetic memory
+ *                requests (no core modeling): random, streaming, strided,
+ *                pointer chasing or replayed from an address log
  ***************************************************************************************/
 
 #include "debug/debug_macros.h"
@@ -38,6 +39,7 @@
 #include "model.h"
 #include "sim.h"
 
+#include <string.h>
 #include <unistd.h>
 
 #include "debug/debug.param.h"
@@ -48,28 +50,57 @@
 /**************************************************************************************/
 /* Types */
 
+typedef enum Dumb_Pattern_enum {
+  DUMB_RANDOM,
+  DUMB_STREAM,
+  DUMB_STRIDE,
+  DUMB_CHASE,
+  DUMB_REPLAY,
+  NUM_DUMB_PATTERNS,
+} Dumb_Pattern;
+
+typedef struct Replay_Req_struct {
+  Counter cycle;  // L1 cycle to send the request at
+  Addr    addr;
+  Flag    write;
+} Replay_Req;
+
 typedef struct Proc_Info_struct {
   uns avg_req_distance;  // average number of cycles between reqs
   uns avg_row_hits;  // average number of row hits for every row open (incl. 1st
                      // conflict)
-  uns  mlp;          // maximum number of outstanding reqs
-  Addr last_addr;    // addr of last req (for retrying and generating row hits)
-  uns  reqs_out;     // number of outstanding reqs
-  Flag retry;        // couldn't send last mem req, keep retrying
-  Flag dumb;         // is this core actually dumb
+  uns          mlp;        // maximum number of outstanding reqs
+  Dumb_Pattern pattern;    // address pattern
+  Addr         last_addr;  // addr of last req (for retrying and generating row
+                           // hits)
+  Flag    last_write;      // last req is a writeback
+  uns64   cursor;          // offset of the next stream/stride/chase req
+  uns     replay_idx;      // next req of the replay log
+  Counter next_req_cycle;  // L1 cycle of the next req with a fixed interval
+  uns     reqs_out;        // number of outstanding reqs
+  Flag    retry;           // couldn't send last mem req, keep retrying
+  Flag    dumb;            // is this core actually dumb
 } Proc_Info;
 
 /**************************************************************************************/
 /* Local prototypes */
 
 static Flag dumb_req_done(Mem_Req* req);
+static void dumb_read_replay_file(void);
+static Flag dumb_want_req(Proc_Info* info, Counter l1_cycle);
+static void dumb_next_req(uns proc_id, Proc_Info* info);
 
 /**************************************************************************************/
 /* Global variables */
 
-static Proc_Info* infos;
-static Counter    req_num;
-static uns64      page_num_mask;
+static const char* const dumb_pattern_names[NUM_DUMB_PATTERNS] = {
+  "random", "stream", "stride", "chase", "replay"};
+
+static Proc_Info*  infos;
+static Counter     req_num;
+static uns64       page_num_mask;
+static Replay_Req* replay_reqs;
+static uns         num_replay_reqs;
 
 /**************************************************************************************/
 /* dumb_init */
@@ -115,7 +146,7 @@ void dumb_init(uns mode) {
     info->mlp = DUMB_MODEL_MLP;
     if(DUMB_MODEL_MLP_PER_CORE) {
       int* elems     = malloc(NUM_CORES * sizeof(uns));
-      uns  num_elems = parse_int_array(elems, DUMB_MODEL_AVG_ROW_HITS_PER_CORE,
+      uns  num_elems = parse_int_array(elems, DUMB_MODEL_MLP_PER_CORE,
                                       NUM_CORES);
       ASSERT(0, num_elems == NUM_CORES);
       for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
@@ -124,6 +155,26 @@ void dumb_init(uns mode) {
     }
     info->last_addr = convert_to_cmp_addr(proc_id, 0);
   }
+
+  char patterns[MAX_NUM_PROCS][MAX_STR_LENGTH + 1];
+  uns  num_patterns = parse_string_array(patterns, DUMB_MODEL_PATTERN,
+                                        MAX_NUM_PROCS);
+  ASSERTM(0, num_patterns == 1 || num_patterns == NUM_CORES,
+          "dumb_model_pattern needs one pattern or one per core\n");
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    const char*  name    = patterns[num_patterns == 1 ? 0 : proc_id];
+    Dumb_Pattern pattern = 0;
+    while(pattern < NUM_DUMB_PATTERNS &&
+          strcmp(name, dumb_pattern_names[pattern]))
+      pattern++;
+    if(pattern == NUM_DUMB_PATTERNS)
+      FATAL_ERROR(0, "Unknown dumb_model_pattern %s\n", name);
+    if(pattern == DUMB_REPLAY && !replay_reqs)
+      dumb_read_replay_file();
+    infos[proc_id].pattern = pattern;
+  }
+  ASSERTM(0, is_power_of_2(DUMB_MODEL_FOOTPRINT / L1_LINE_SIZE),
+          "dumb_model_footprint must be a power of 2 number of lines\n");
   if(SIM_MODEL == DUMB_MODEL) {
     // Only dumb model is running, initialize required subset of
     // microarchitecture model
@@ -139,6 +190,41 @@ void dumb_init(uns mode) {
 }
 
 
+/**************************************************************************************/
+/* dumb_read_replay_file: */
+
+static void dumb_read_replay_file(void) {
+  ASSERTM(0, DUMB_MODEL_REPLAY_FILE,
+          "The replay pattern needs a dumb_model_replay_file\n");
+  FILE* file = fopen(DUMB_MODEL_REPLAY_FILE, "r");
+  if(!file)
+    FATAL_ERROR(0, "Could not open %s\n", DUMB_MODEL_REPLAY_FILE);
+
+  uns  size = 1024;
+  char line[MAX_STR_LENGTH + 1];
+  replay_reqs = malloc(size * sizeof(Replay_Req));
+  while(fgets(line, sizeof(line), file)) {
+    unsigned long long cycle, addr;
+    char               type = 'r';
+    if(line[0] == '#' || sscanf(line, "%llu %llx %c", &cycle, &addr, &type) < 2)
+      continue;
+    if(num_replay_reqs == size) {
+      size *= 2;
+      replay_reqs = realloc(replay_reqs, size * sizeof(Replay_Req));
+    }
+    ASSERTM(0,
+            !num_replay_reqs || replay_reqs[num_replay_reqs - 1].cycle <= cycle,
+            "%s is not sorted by cycle\n", DUMB_MODEL_REPLAY_FILE);
+    replay_reqs[num_replay_reqs].cycle = cycle;
+    replay_reqs[num_replay_reqs].addr  = addr;
+    replay_reqs[num_replay_reqs].write = type == 'w' || type == 'W';
+    num_replay_reqs++;
+  }
+  fclose(file);
+  MESSAGEU(0, "Read %u requests from %s\n", num_replay_reqs,
+           DUMB_MODEL_REPLAY_FILE);
+}
+
 /**************************************************************************************/
 /* dumb_reset: */
 
@@ -155,6 +241,10 @@ Flag dumb_req_done(Mem_Req* req) {
   ASSERT(proc_id, info->reqs_out >= req->req_count);
   info->reqs_out -= req->req_count;
   INC_STAT_EVENT(proc_id, NODE_INST_COUNT, req->req_count);
+  INC_STAT_EVENT(proc_id, DUMB_MODEL_REQ_DONE, req->req_count);
+  INC_STAT_EVENT(proc_id, DUMB_MODEL_REQ_LATENCY,
+                 req->req_count *
+                   (freq_cycle_count(FREQ_DOMAIN_L1) - req->start_cycle));
   inst_count[proc_id] += req->req_count;
   if(SIM_MODEL == DUMB_MODEL && !sim_done[proc_id] && INST_LIMIT &&
      inst_count[proc_id] >= inst_limit[proc_id]) {
@@ -163,48 +253,123 @@ Flag dumb_req_done(Mem_Req* req) {
   return TRUE;
 }
 
+/**************************************************************************************/
+/* dumb_want_req: does the core send a new request this cycle? */
+
+static Flag dumb_want_req(Proc_Info* info, Counter l1_cycle) {
+  if(info->reqs_out == info->mlp)
+    return FALSE;
+  if(info->pattern == DUMB_REPLAY)
+    return info->replay_idx < num_replay_reqs &&
+           replay_reqs[info->replay_idx].cycle <= l1_cycle;
+  // each of the mlp chains sends its next request as soon as the previous one
+  // is back, only the memory latency sets the pace
+  if(info->pattern == DUMB_CHASE)
+    return TRUE;
+  if(DUMB_MODEL_REQ_INTERVAL) {
+    if(l1_cycle < info->next_req_cycle)
+      return FALSE;
+    info->next_req_cycle = l1_cycle + DUMB_MODEL_REQ_INTERVAL;
+    return TRUE;
+  }
+  return (rand() % info->avg_req_distance) == 0;
+}
+
+/**************************************************************************************/
+/* dumb_next_req: generate the address and type of the next request */
+
+static void dumb_next_req(uns proc_id, Proc_Info* info) {
+  uns64 lines  = DUMB_MODEL_FOOTPRINT / L1_LINE_SIZE;
+  Addr  offset = 0;
+
+  info->last_write = DUMB_MODEL_WRITE_PERCENT &&
+                     (uns)(rand() % 100) < DUMB_MODEL_WRITE_PERCENT;
+  switch(info->pattern) {
+    case DUMB_RANDOM:
+      offset = rand() * L1_LINE_SIZE;
+      if(rand() % info->avg_row_hits != 0) {
+        // make row hit
+        Addr  addr        = convert_to_cmp_addr(proc_id, offset);
+        uns64 page_num    = info->last_addr & page_num_mask;
+        uns64 page_offset = addr & ~page_num_mask;
+        info->last_addr   = page_num | page_offset;
+        return;
+      }
+      break;
+    case DUMB_STREAM:
+      offset       = info->cursor;
+      info->cursor = (info->cursor + L1_LINE_SIZE) % DUMB_MODEL_FOOTPRINT;
+      break;
+    case DUMB_STRIDE:
+      offset       = info->cursor;
+      info->cursor = (info->cursor + DUMB_MODEL_STRIDE) % DUMB_MODEL_FOOTPRINT;
+      break;
+    case DUMB_CHASE:
+      // full period LCG over the lines of the footprint
+      info->cursor = (info->cursor * 6364136223846793005ULL +
+                      1442695040888963407ULL) &
+                     (lines - 1);
+      offset = info->cursor * L1_LINE_SIZE;
+      break;
+    case DUMB_REPLAY:
+      offset           = replay_reqs[info->replay_idx].addr;
+      info->last_write = replay_reqs[info->replay_idx].write;
+      info->replay_idx++;
+      break;
+    default:
+      FATAL_ERROR(proc_id, "Unknown dumb pattern %u\n", info->pattern);
+  }
+  offset &= ~(Addr)(L1_LINE_SIZE - 1);
+  info->last_addr = convert_to_cmp_addr(proc_id, offset);
+}
+
 /**************************************************************************************/
 /* dumb_cycle: */
 
 void dumb_cycle() {
   if(!freq_is_ready(FREQ_DOMAIN_L1))
     return;
+  Counter l1_cycle = freq_cycle_count(FREQ_DOMAIN_L1);
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     if(SIM_MODEL != DUMB_MODEL && proc_id != DUMB_CORE)
       continue;
     STAT_EVENT(proc_id, NODE_CYCLE);
-    Proc_Info* info     = &infos[proc_id];
-    Flag       send_req = info->retry || (info->reqs_out < info->mlp &&
-                                    (rand() % info->avg_req_distance) == 0);
+    Proc_Info* info = &infos[proc_id];
     if(info->retry || info->reqs_out == info->mlp) {
       STAT_EVENT(proc_id, FULL_WINDOW_STALL);
     }
-    if(send_req) {
-      ASSERT(proc_id, info->reqs_out < info->mlp);
-      Addr addr;
-      if(info->retry) {
-        addr = info->last_addr;
-      } else {
-        addr = convert_to_cmp_addr(proc_id, rand() * L1_LINE_SIZE);
-        if(rand() % info->avg_row_hits != 0) {
-          // make row hit
-          uns64 page_num    = info->last_addr & page_num_mask;
-          uns64 page_offset = addr & ~page_num_mask;
-          addr              = page_num | page_offset;
-        }
+    if(!info->retry) {
+      if(!dumb_want_req(info, l1_cycle)) {
+        if(SIM_MODEL == DUMB_MODEL && info->pattern == DUMB_REPLAY &&
+           info->replay_idx == num_replay_reqs && !info->reqs_out)
+          retired_exit[proc_id] = TRUE;
+        continue;
       }
-      ASSERT(proc_id, get_proc_id_from_cmp_addr(addr) == proc_id);
-      info->last_addr    = addr;
-      Counter unique_num = SIM_MODEL == DUMB_MODEL ? req_num : unique_count;
-      Flag sent = new_mem_req(MRT_DFETCH, proc_id, addr, L1_LINE_SIZE, 0, NULL,
-                              dumb_req_done, unique_num, NULL);
-      info->retry = !sent;
-      if(sent) {
-        req_num++;
+      dumb_next_req(proc_id, info);
+    }
+
+    Addr addr = info->last_addr;
+    ASSERT(proc_id, get_proc_id_from_cmp_addr(addr) == proc_id);
+    Counter unique_num = SIM_MODEL == DUMB_MODEL ? req_num : unique_count;
+    Flag    sent;
+    if(info->last_write) {
+      // writebacks need no answer, so they do not count towards the mlp
+      sent = new_mem_dc_wb_req(MRT_WB, proc_id, addr, L1_LINE_SIZE, 1, NULL,
+                               NULL, unique_num, TRUE);
+    } else {
+      sent = new_mem_req(MRT_DFETCH, proc_id, addr, L1_LINE_SIZE, 0, NULL,
+                         dumb_req_done, unique_num, NULL);
+    }
+    info->retry = !sent;
+    if(sent) {
+      STAT_EVENT(proc_id, DUMB_MODEL_REQ);
+      if(info->last_write)
+        STAT_EVENT(proc_id, DUMB_MODEL_REQ_WRITE);
+      else
         info->reqs_out++;
-        if(SIM_MODEL != DUMB_MODEL)
-          unique_count++;
-      }
+      req_num++;
+      if(SIM_MODEL != DUMB_MODEL)
+        unique_count++;
     }
   }
   if(SIM_MODEL == DUMB_MODEL)
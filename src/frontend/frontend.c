@@ -34,6 +34,7 @@
 #include "globals/assert.h"
 #include "globals/global_defs.h"
 #include "globals/global_vars.h"
+#include "host_prof.h"
 #include "icache_stage.h"
 #include "op.h"
 #include "pin_exec_driven_fe.h"
@@ -112,7 +113,9 @@ Flag frontend_can_fetch_op(uns proc_id) {
 }
 
 void frontend_fetch_op(uns proc_id, Op* op) {
+  HOST_PROF_BEGIN(FRONTEND_FETCH);
   frontend->fetch_op(proc_id, op);
+  HOST_PROF_END(proc_id, FRONTEND_FETCH);
   collect_op_stats(op);
 }
 
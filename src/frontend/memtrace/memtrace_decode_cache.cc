@@ -0,0 +1,248 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/memtrace/memtrace_decode_cache.cc
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : The shared file is a header followed by one Entry per
+ *                instruction. Runs map the file read only and append the
+ *                instructions they decoded at the end, under an exclusive
+ *                lock. An instruction may end up in the file more than once.
+ ***************************************************************************************/
+#include "frontend/memtrace/memtrace_decode_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pin/pin_lib/x86_decoder.h"
+
+namespace {
+
+struct FileHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t entry_size;  // a different ctype_pin_inst makes the file unusable
+  // X86_DECODER_VERSION and a hash of xed_get_version(), a different decoder
+  // may fill in the same instruction differently
+  uint32_t decoder_version;
+  uint32_t unused;
+  uint64_t xed_hash;
+};
+
+const char     DECODE_CACHE_MAGIC[8] = {'S', 'C', 'R', 'B', 'D', 'E', 'C', '1'};
+const uint32_t DECODE_CACHE_VERSION  = 2;
+
+uint64_t xedHash() {
+  uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a
+  for(const char* c = xed_get_version(); *c; c++)
+    hash = (hash ^ (uint8_t)*c) * 0x100000001b3ULL;
+  return hash;
+}
+
+bool writeAll(int _fd, const void* _buf, size_t _size) {
+  const uint8_t* buf = static_cast<const uint8_t*>(_buf);
+  while(_size > 0) {
+    ssize_t written = write(_fd, buf, _size);
+    if(written <= 0)
+      return false;
+    buf += written;
+    _size -= written;
+  }
+  return true;
+}
+
+void initHeader(FileHeader* _header, uint32_t _entry_size) {
+  memcpy(_header->magic, DECODE_CACHE_MAGIC, sizeof(_header->magic));
+  _header->version         = DECODE_CACHE_VERSION;
+  _header->entry_size      = _entry_size;
+  _header->decoder_version = X86_DECODER_VERSION;
+  _header->unused          = 0;
+  _header->xed_hash        = xedHash();
+}
+
+bool headerMatches(const FileHeader& _header, uint32_t _entry_size) {
+  return !memcmp(_header.magic, DECODE_CACHE_MAGIC, sizeof(_header.magic)) &&
+         _header.version == DECODE_CACHE_VERSION &&
+         _header.entry_size == _entry_size &&
+         _header.decoder_version == X86_DECODER_VERSION &&
+         _header.xed_hash == xedHash();
+}
+
+// Open and lock the file for appending. A run that replaced the file while
+// this one waited for the lock leaves it with the old one, so open it again.
+int openLocked(const std::string& _path) {
+  for(;;) {
+    int fd = open(_path.c_str(), O_RDWR | O_APPEND | O_CREAT, 0644);
+    if(fd < 0)
+      return -1;
+    struct stat fd_st, path_st;
+    if(flock(fd, LOCK_EX) != 0 || fstat(fd, &fd_st) != 0) {
+      close(fd);
+      return -1;
+    }
+    if(stat(_path.c_str(), &path_st) == 0 && path_st.st_dev == fd_st.st_dev &&
+       path_st.st_ino == fd_st.st_ino)
+      return fd;
+    close(fd);
+  }
+}
+
+}  // namespace
+
+DecodeCache::DecodeCache(const std::string& _path) :
+    path_(_path), loaded_(false), map_(nullptr), map_size_(0),
+    shared_hits_(0) {}
+
+DecodeCache::~DecodeCache() {
+  if(map_)
+    munmap(const_cast<uint8_t*>(map_), map_size_);
+}
+
+const ctype_pin_inst* DecodeCache::find(uint64_t _pc) {
+  auto iter = insts_.find(_pc);
+  return iter == insts_.end() ? nullptr : &iter->second;
+}
+
+const ctype_pin_inst* DecodeCache::findShared(uint64_t _build_id,
+                                              uint64_t _offset) {
+  if(path_.empty())
+    return nullptr;
+  if(!loaded_)
+    loadShared();
+  auto iter = shared_.find(std::make_pair(_build_id, _offset));
+  if(iter == shared_.end())
+    return nullptr;
+  shared_hits_++;
+  return &iter->second->inst;
+}
+
+void DecodeCache::insert(uint64_t _pc, const ctype_pin_inst& _inst) {
+  insts_.emplace(_pc, _inst);
+}
+
+void DecodeCache::insertShared(uint64_t _build_id, uint64_t _offset,
+                               const ctype_pin_inst& _inst) {
+  if(path_.empty())
+    return;
+  Entry entry;
+  entry.build_id = _build_id;
+  entry.offset   = _offset;
+  entry.inst     = _inst;
+  new_entries_.push_back(entry);
+}
+
+// Index the file as it was when the first lookup happened. Entries appended
+// by concurrent runs after that are picked up by the next run.
+void DecodeCache::loadShared() {
+  loaded_ = true;
+  int fd  = open(path_.c_str(), O_RDONLY);
+  if(fd < 0)
+    return;
+
+  struct stat st;
+  if(fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(FileHeader)) {
+    map_size_ = st.st_size;
+    void* map = mmap(nullptr, map_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(map == MAP_FAILED) {
+      map_size_ = 0;
+    } else {
+      map_ = static_cast<const uint8_t*>(map);
+    }
+  }
+  close(fd);
+  if(!map_)
+    return;
+
+  const FileHeader* header = reinterpret_cast<const FileHeader*>(map_);
+  if(!headerMatches(*header, sizeof(Entry))) {
+    std::cout << "Ignoring decode cache " << path_
+              << " written by a different build of Scarab" << std::endl;
+    return;
+  }
+  size_t num_entries = (map_size_ - sizeof(FileHeader)) / sizeof(Entry);
+  const Entry* entries = reinterpret_cast<const Entry*>(map_ +
+                                                        sizeof(FileHeader));
+  shared_.reserve(num_entries);
+  for(size_t i = 0; i < num_entries; i++) {
+    shared_.emplace(std::make_pair(entries[i].build_id, entries[i].offset),
+                    &entries[i]);
+  }
+}
+
+void DecodeCache::flush() {
+  if(path_.empty())
+    return;
+  if(new_entries_.empty()) {
+    std::cout << "Found all " << shared_hits_
+              << " instructions in decode cache " << path_ << std::endl;
+    return;
+  }
+
+  int fd = openLocked(path_);
+  if(fd < 0) {
+    std::cout << "Could not write decode cache " << path_ << std::endl;
+    return;
+  }
+
+  // entries are only appended to a file with our header, a file of another
+  // build is replaced as a whole so that it does not mix entry sizes
+  FileHeader  header;
+  struct stat st;
+  bool        ok      = fstat(fd, &st) == 0;
+  bool        replace = false;
+  if(ok && st.st_size > 0) {
+    replace = pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+              !headerMatches(header, sizeof(Entry));
+  }
+  initHeader(&header, sizeof(Entry));
+  size_t entries_size = new_entries_.size() * sizeof(Entry);
+  if(replace) {
+    std::cout << "Replacing decode cache " << path_
+              << " written by a different build of Scarab" << std::endl;
+    std::string tmp_path = path_ + ".tmp." + std::to_string(getpid());
+    int tmp_fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ok = tmp_fd >= 0 && writeAll(tmp_fd, &header, sizeof(header)) &&
+         writeAll(tmp_fd, new_entries_.data(), entries_size);
+    if(tmp_fd >= 0)
+      ok = close(tmp_fd) == 0 && ok;
+    ok = ok && rename(tmp_path.c_str(), path_.c_str()) == 0;
+    if(!ok)
+      unlink(tmp_path.c_str());
+  } else {
+    if(ok && st.st_size == 0)
+      ok = writeAll(fd, &header, sizeof(header));
+    ok = ok && writeAll(fd, new_entries_.data(), entries_size);
+  }
+  flock(fd, LOCK_UN);
+  close(fd);
+
+  std::cout << (ok ? "Added " : "Failed to add ") << new_entries_.size()
+            << " instructions to decode cache " << path_ << " ("
+            << shared_hits_ << " found)" << std::endl;
+  new_entries_.clear();
+}
@@ -0,0 +1,83 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/memtrace/memtrace_decode_cache.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Cache of decoded instructions (the static part of
+ *                ctype_pin_inst) by PC for this run, and by binary build id
+ *                and offset in a file shared by all runs over the binaries
+ ***************************************************************************************/
+#ifndef MEMTRACE_DECODE_CACHE_H
+#define MEMTRACE_DECODE_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ctype_pin_inst.h"
+
+class DecodeCache {
+ public:
+  // Without a path, instructions are only cached for this run
+  explicit DecodeCache(const std::string& _path);
+  ~DecodeCache();
+
+  // Instruction decoded earlier in this run, nullptr if none
+  const ctype_pin_inst* find(uint64_t _pc);
+  // Instruction decoded by an earlier run, nullptr if none
+  const ctype_pin_inst* findShared(uint64_t _build_id, uint64_t _offset);
+  void insert(uint64_t _pc, const ctype_pin_inst& _inst);
+  // Also keep it for later runs (written by flush)
+  void insertShared(uint64_t _build_id, uint64_t _offset,
+                    const ctype_pin_inst& _inst);
+  // Append the instructions new to the file
+  void flush();
+
+ private:
+  struct Entry {
+    uint64_t       build_id;
+    uint64_t       offset;
+    ctype_pin_inst inst;
+  } __attribute__((packed));
+
+  struct KeyHash {
+    size_t operator()(const std::pair<uint64_t, uint64_t>& _key) const {
+      return _key.first ^ (_key.second * 0x9e3779b97f4a7c15ULL);
+    }
+  };
+
+  void loadShared();
+
+  std::string                                 path_;
+  std::unordered_map<uint64_t, ctype_pin_inst> insts_;
+  bool                                         loaded_;
+  const uint8_t*                               map_;
+  size_t                                       map_size_;
+  std::unordered_map<std::pair<uint64_t, uint64_t>, const Entry*, KeyHash>
+                     shared_;
+  uint64_t           shared_hits_;
+  std::vector<Entry> new_entries_;
+};
+
+#endif
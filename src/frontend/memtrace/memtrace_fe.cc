@@ -38,6 +38,7 @@
 #include "bp/bp.param.h"
 #include "ctype_pin_inst.h"
 #include "frontend/memtrace/memtrace_fe.h"
+#include "frontend/trace_wrong_path.h"
 #include "isa/isa.h"
 #include "pin/pin_lib/uop_generator.h"
 #include "pin/pin_lib/x86_decoder.h"
@@ -45,6 +46,7 @@
 
 #define DR_DO_NOT_DEFINE_int64
 
+#include "frontend/memtrace/memtrace_decode_cache.h"
 #include "frontend/memtrace/memtrace_trace_reader_memtrace.h"
 
 /**************************************************************************************/
@@ -56,12 +58,14 @@
 /**************************************************************************************/
 /* Global Variables */
 
-char*           trace_files[MAX_NUM_PROCS];
-TraceReader*    trace_readers[MAX_NUM_PROCS];
-ctype_pin_inst* next_pi;
-uint64_t        ins_id    = 0;
-uint64_t        prior_tid = 0;
-uint64_t        prior_pid = 0;
+char*               trace_files[MAX_NUM_PROCS];
+TraceReader*        trace_readers[MAX_NUM_PROCS];
+ctype_pin_inst*     next_pi;
+uint64_t            ins_id    = 0;
+uint64_t            prior_tid = 0;
+uint64_t            prior_pid = 0;
+static Flag         from_trace[MAX_NUM_PROCS];  // fetching next_pi
+static DecodeCache* decode_cache;
 
 /**************************************************************************************/
 /* Private Functions */
@@ -134,6 +138,51 @@ int roi(const xed_decoded_inst_t* ins) {
   return 0;
 }
 
+// Fill in the static info of a correct path instruction, from the shared
+// decode cache if possible, and cache it
+static void memtrace_decode(int proc_id, const InstInfo* insi,
+                            ctype_pin_inst* next_pi) {
+  const ctype_pin_inst* cached   = nullptr;
+  uint64_t              build_id = 0;
+  uint64_t              offset   = 0;
+  Flag                  shared   = FALSE;
+
+  // Instructions without decode info are not from a binary
+  if(MEMTRACE_DECODE_CACHE && !insi->unknown_type)
+    shared = trace_readers[proc_id]->moduleKeyForVAddr(insi->pc, &build_id,
+                                                       &offset);
+  if(shared)
+    cached = decode_cache->findShared(build_id, offset);
+  if(cached) {
+    *next_pi = *cached;
+    fill_in_dynamic_info(next_pi, insi);
+  } else {
+    memset(next_pi, 0, sizeof(ctype_pin_inst));
+    fill_in_dynamic_info(next_pi, insi);
+    fill_in_basic_info(next_pi, insi->ins);
+    uint32_t max_op_width = add_dependency_info(next_pi, insi->ins);
+    fill_in_simd_info(next_pi, insi->ins, max_op_width);
+    apply_x87_bug_workaround(next_pi, insi->ins);
+    fill_in_cf_info(next_pi, insi->ins);
+    print_err_if_invalid(next_pi, insi->ins);
+  }
+
+  // Gathers and scatters keep operand info by PC outside of ctype_pin_inst
+  if(next_pi->is_gather_scatter)
+    return;
+  ctype_pin_inst inst        = *next_pi;
+  inst.inst_uid              = 0;
+  inst.instruction_addr      = 0;
+  inst.instruction_next_addr = 0;
+  inst.branch_target         = 0;
+  inst.actually_taken        = 0;
+  memset(inst.ld_vaddr, 0, sizeof(inst.ld_vaddr));
+  memset(inst.st_vaddr, 0, sizeof(inst.st_vaddr));
+  decode_cache->insert(insi->pc, inst);
+  if(shared && !cached)
+    decode_cache->insertShared(build_id, offset, inst);
+}
+
 int memtrace_trace_read(int proc_id, ctype_pin_inst* next_pi) {
   InstInfo* insi;
 
@@ -147,14 +196,15 @@ int memtrace_trace_read(int proc_id, ctype_pin_inst* next_pi) {
     }
   } while(insi->pid != prior_pid || insi->tid != prior_tid);
 
-  memset(next_pi, 0, sizeof(ctype_pin_inst));
-  fill_in_dynamic_info(next_pi, insi);
-  fill_in_basic_info(next_pi, insi->ins);
-  uint32_t max_op_width = add_dependency_info(next_pi, insi->ins);
-  fill_in_simd_info(next_pi, insi->ins, max_op_width);
-  apply_x87_bug_workaround(next_pi, insi->ins);
-  fill_in_cf_info(next_pi, insi->ins);
-  print_err_if_invalid(next_pi, insi->ins);
+  // The static info of a PC is the same every time, so only the dynamic info
+  // is filled in after the first time (or after an earlier run)
+  const ctype_pin_inst* cached = decode_cache->find(insi->pc);
+  if(cached) {
+    *next_pi = *cached;
+    fill_in_dynamic_info(next_pi, insi);
+  } else {
+    memtrace_decode(proc_id, insi, next_pi);
+  }
 
   // End of ROI
   if(roi(insi->ins))
@@ -163,21 +213,45 @@ int memtrace_trace_read(int proc_id, ctype_pin_inst* next_pi) {
   return 1;
 }
 
+// Decode a wrong path instruction from the binaries of the trace
+Flag memtrace_decode_wrong_path(uns proc_id, Addr addr, ctype_pin_inst* info) {
+  const xed_decoded_inst_t* ins = trace_readers[proc_id]->staticInstruction(
+    addr);
+  if(!ins)
+    return FALSE;
+
+  memset(info, 0, sizeof(ctype_pin_inst));
+  info->instruction_addr = addr;
+  fill_in_basic_info(info, ins);
+  uint32_t max_op_width = add_dependency_info(info, ins);
+  fill_in_simd_info(info, ins, max_op_width);
+  apply_x87_bug_workaround(info, ins);
+  fill_in_cf_info(info, ins);
+  if(info->op_type == OP_INV)
+    return FALSE;
+
+  // Only direct targets are known without executing
+  if(info->cf_type == CF_BR || info->cf_type == CF_CBR ||
+     info->cf_type == CF_CALL) {
+    info->branch_target = addr + info->size +
+                          xed_decoded_inst_get_branch_displacement(ins);
+    info->actually_taken = info->cf_type != CF_CBR;
+  }
+  return TRUE;
+}
 
 /**************************************************************************************/
 /* trace_init() */
 
 void memtrace_init(void) {
-  /*ASSERTM(0, !FETCH_OFF_PATH_OPS,
-          "Trace frontend does not support wrong path. Turn off "
-          "FETCH_OFF_PATH_OPS\n");
-  */
-
   uop_generator_init(NUM_CORES);
   init_x86_decoder(nullptr);
   init_x87_stack_delta();
+  trace_wp_init(NUM_CORES, memtrace_decode_wrong_path);
 
   next_pi = (ctype_pin_inst*)malloc(NUM_CORES * sizeof(ctype_pin_inst));
+  decode_cache = new DecodeCache(MEMTRACE_DECODE_CACHE ? MEMTRACE_DECODE_CACHE :
+                                                         "");
 
   /* temp variable needed for easy initialization syntax */
   char* tmp_trace_files[MAX_NUM_PROCS] = {
@@ -244,6 +318,8 @@ void memtrace_setup(uns proc_id) {
 /* trace_next_fetch_addr */
 
 Addr memtrace_next_fetch_addr(uns proc_id) {
+  if(trace_wp_active(proc_id))
+    return trace_wp_next_fetch_addr(proc_id);
   return next_pi[proc_id].instruction_addr;
 }
 
@@ -255,6 +331,7 @@ void memtrace_done() {
   for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     // delete trace_readers[proc_id];
   }
+  decode_cache->flush();
   printf("done\n");
 }
 
@@ -265,18 +342,26 @@ void memtrace_close_trace_file(uns proc_id) {
 
 Flag memtrace_can_fetch_op(uns proc_id) {
   assert(proc_id == 0);
-  return !(uop_generator_get_eom(proc_id) && trace_read_done[proc_id]);
+  return trace_wp_active(proc_id) ||
+         !(uop_generator_get_eom(proc_id) && trace_read_done[proc_id]);
 }
 
 void memtrace_fetch_op(uns proc_id, Op* op) {
   if(uop_generator_get_bom(proc_id)) {
     // ASSERT(proc_id, !trace_read_done[proc_id] && !reached_exit[proc_id]);
-    uop_generator_get_uop(proc_id, op, &next_pi[proc_id]);
+    from_trace[proc_id] = !trace_wp_active(proc_id);
+    uop_generator_get_uop(proc_id, op,
+                          from_trace[proc_id] ? &next_pi[proc_id] :
+                                                trace_wp_fetch(proc_id));
   } else {
     uop_generator_get_uop(proc_id, op, NULL);
   }
 
-  if(uop_generator_get_eom(proc_id)) {
+  if(!from_trace[proc_id]) {
+    // only the last correct path instruction of the trace exits
+    op->exit = op->eom && trace_read_done[proc_id] && !trace_wp_active(proc_id);
+  } else if(uop_generator_get_eom(proc_id)) {
+    trace_wp_record(proc_id, &next_pi[proc_id]);
     int        success = memtrace_trace_read(proc_id, &next_pi[proc_id]);
     static int ins     = 0;
     ins++;
@@ -289,20 +374,15 @@ void memtrace_fetch_op(uns proc_id, Op* op) {
 }
 
 void memtrace_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
-  assert(0);
-  // FATAL_ERROR(proc_id, "Trace frontend does not support wrong path. Turn off
-  // "
-  //                     "FETCH_OFF_PATH_OPS\n");
+  trace_wp_redirect(proc_id, inst_uid, fetch_addr);
 }
 
 void memtrace_recover(uns proc_id, uns64 inst_uid) {
-  assert(0);
-  // FATAL_ERROR(proc_id, "Trace frontend does not support wrong path. Turn off
-  // "
-  //                     "FETCH_OFF_PATH_OPS\n");
+  trace_wp_recover(proc_id, inst_uid);
 }
 
 void memtrace_retire(uns proc_id, uns64 inst_uid) {
   // Trace frontend does not need to communicate to PIN which instruction are
-  // retired.
+  // retired, only to drop the correct path it keeps for recoveries.
+  trace_wp_retire(proc_id, inst_uid);
 }
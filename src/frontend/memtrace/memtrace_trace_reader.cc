@@ -59,15 +59,16 @@ static std::mutex initMutex;
 
 // A non-reader
 TraceReader::TraceReader() :
-    trace_ready_(false), binary_ready_(false), skipped_(0) {
+    trace_ready_(false), binary_ready_(false), quiet_lookup_(false),
+    skipped_(0) {
   init("");
 }
 
 // Trace + single binary
 TraceReader::TraceReader(const std::string& _trace, const std::string& _binary,
                          uint64_t _offset, uint32_t _buf_size) :
-    trace_ready_(false),
-    binary_ready_(true), warn_not_found_(1), skipped_(0), buf_size_(_buf_size) {
+    trace_ready_(false), binary_ready_(true), quiet_lookup_(false),
+    warn_not_found_(1), skipped_(0), buf_size_(_buf_size) {
   binaryFileIs(_binary, _offset);
 }
 
@@ -75,8 +76,8 @@ TraceReader::TraceReader(const std::string& _trace, const std::string& _binary,
 TraceReader::TraceReader(const std::string& _trace,
                          const std::string& _binary_group_path,
                          uint32_t           _buf_size) :
-    trace_ready_(false),
-    binary_ready_(true), warn_not_found_(1), skipped_(0), buf_size_(_buf_size) {
+    trace_ready_(false), binary_ready_(true), quiet_lookup_(false),
+    warn_not_found_(1), skipped_(0), buf_size_(_buf_size) {
 }
 
 TraceReader::~TraceReader() {
@@ -383,3 +384,97 @@ const TraceReader::returnValue TraceReader::findPCInSegment(
 TraceReader::bufferEntry TraceReader::bufferStart() {
   return ins_buffer.begin();
 }
+
+const xed_decoded_inst_t* TraceReader::staticInstruction(uint64_t _pc) {
+  // The correct path decoded it already
+  auto xed_map_iter = xed_map_.find(_pc);
+  if(xed_map_iter != xed_map_.end()) {
+    auto& xed_tuple = (*xed_map_iter).second;
+    return get<MAP_UNKNOWN>(xed_tuple) ? nullptr :
+                                         get<MAP_XED>(xed_tuple).get();
+  }
+
+  // Wrong path instructions are kept apart, so that a bad decode (e.g. from
+  // the middle of an instruction) never reaches the correct path
+  auto wp_iter = wrong_path_map_.find(_pc);
+  if(wp_iter == wrong_path_map_.end()) {
+    unique_ptr<xed_decoded_inst_t> ins;
+    uint64_t                       size;
+    uint8_t*                       loc;
+    quiet_lookup_ = true;
+    bool found    = locationForVAddr(_pc, &loc, &size);
+    quiet_lookup_ = false;
+    if(found) {
+      ins = make_unique<xed_decoded_inst_t>();
+      xed_decoded_inst_zero_set_mode(ins.get(), &xed_state_);
+      size = std::min<uint64_t>(size, XED_MAX_INSTRUCTION_BYTES);
+      if(xed_decode(ins.get(), loc, size) != XED_ERROR_NONE)
+        ins.reset();
+    }
+    wp_iter = wrong_path_map_.emplace(_pc, std::move(ins)).first;
+  }
+  return wp_iter->second.get();
+}
+
+bool TraceReader::moduleKeyForVAddr(uint64_t _pc, uint64_t* _build_id,
+                                    uint64_t* _offset) {
+  uint8_t* start;
+  uint64_t size;
+  uint8_t* loc;
+
+  quiet_lookup_ = true;
+  bool found    = moduleForVAddr(_pc, &start, &size, &loc);
+  quiet_lookup_ = false;
+  if(!found)
+    return false;
+
+  auto iter = build_ids_.find(start);
+  if(iter == build_ids_.end())
+    iter = build_ids_.emplace(start, buildIdOfModule(start, size)).first;
+  *_build_id = iter->second;
+  *_offset   = loc - start;
+  return *_build_id != 0;
+}
+
+// FNV-1a hash of the GNU build id note of the module mapped at _start, or 0
+// if it has none
+uint64_t TraceReader::buildIdOfModule(const uint8_t* _start, uint64_t _size) {
+  if(_size < sizeof(Elf64_Ehdr) || memcmp(_start, ELFMAG, SELFMAG) != 0)
+    return 0;
+  const Elf64_Ehdr* hdr = reinterpret_cast<const Elf64_Ehdr*>(_start);
+  if(_size < hdr->e_phoff + hdr->e_phnum * sizeof(Elf64_Phdr))
+    return 0;
+  const Elf64_Phdr* phdr = reinterpret_cast<const Elf64_Phdr*>(_start +
+                                                               hdr->e_phoff);
+
+  // The module is mapped as loaded, starting at its lowest segment
+  uint64_t base = UINT64_MAX;
+  for(Elf64_Half i = 0; i < hdr->e_phnum; i++) {
+    if(phdr[i].p_type == PT_LOAD)
+      base = std::min<uint64_t>(base, phdr[i].p_vaddr & ~0xfffULL);
+  }
+
+  for(Elf64_Half i = 0; i < hdr->e_phnum; i++) {
+    if(phdr[i].p_type != PT_NOTE || phdr[i].p_vaddr < base ||
+       phdr[i].p_vaddr - base + phdr[i].p_filesz > _size)
+      continue;
+    const uint8_t* note = _start + (phdr[i].p_vaddr - base);
+    const uint8_t* end  = note + phdr[i].p_filesz;
+    while(note + sizeof(Elf64_Nhdr) <= end) {
+      const Elf64_Nhdr* nhdr = reinterpret_cast<const Elf64_Nhdr*>(note);
+      const uint8_t*    name = note + sizeof(Elf64_Nhdr);
+      const uint8_t*    desc = name + ((nhdr->n_namesz + 3) & ~3U);
+      if(desc + nhdr->n_descsz > end)
+        break;
+      if(nhdr->n_type == NT_GNU_BUILD_ID && nhdr->n_namesz == 4 &&
+         memcmp(name, "GNU", 4) == 0) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for(uint32_t j = 0; j < nhdr->n_descsz; j++)
+          hash = (hash ^ desc[j]) * 0x100000001b3ULL;
+        return hash ? hash : 1;
+      }
+      note = desc + ((nhdr->n_descsz + 3) & ~3U);
+    }
+  }
+  return 0;
+}
@@ -89,18 +89,27 @@ class TraceReader {
   const returnValue findPC(bufferEntry& ref, uint64_t _pc);
   const returnValue peekInstructionAtIndex(uint32_t idx, bufferEntry& ref);
   bufferEntry       bufferStart();
+  // Decode the instruction at _pc straight from the binaries (for the wrong
+  // path). Returns nullptr if _pc is not in a binary or does not decode.
+  const xed_decoded_inst_t* staticInstruction(uint64_t _pc);
+  // Identify _pc across runs: the hash of the GNU build id of its binary and
+  // its offset in the binary. Returns false if the binary has no build id.
+  bool moduleKeyForVAddr(uint64_t _pc, uint64_t* _build_id, uint64_t* _offset);
 
  private:
-  virtual const InstInfo* getNextInstruction()                        = 0;
-  virtual void            binaryGroupPathIs(const std::string& _path) = 0;
-  virtual bool            initTrace()                                 = 0;
+  virtual const InstInfo* getNextInstruction()                            = 0;
+  virtual void            binaryGroupPathIs(const std::string& _path)     = 0;
+  virtual bool            initTrace()                                     = 0;
   virtual bool            locationForVAddr(uint64_t _vaddr, uint8_t** _loc,
-                                           uint64_t* _size)           = 0;
+                                           uint64_t* _size)               = 0;
+  virtual bool            moduleForVAddr(uint64_t _vaddr, uint8_t** _start,
+                                         uint64_t* _size, uint8_t** _loc) = 0;
 
   void init_buffer();
   void binaryFileIs(const std::string& _binary, uint64_t _offset);
 
   std::unique_ptr<xed_decoded_inst_t> makeNop(uint8_t _length);
+  uint64_t buildIdOfModule(const uint8_t* _start, uint64_t _size);
 
  protected:
   std::string                                                    trace_;
@@ -114,6 +123,10 @@ class TraceReader {
   std::unordered_map<uint64_t, std::tuple<int, bool, bool, bool,
                                           std::unique_ptr<xed_decoded_inst_t>>>
                        xed_map_;
+  std::unordered_map<uint64_t, std::unique_ptr<xed_decoded_inst_t>>
+                       wrong_path_map_;
+  std::unordered_map<const uint8_t*, uint64_t> build_ids_;  // 0 if none
+  bool                 quiet_lookup_;  // addresses may not be in a binary
   int                  warn_not_found_;
   uint64_t             skipped_;
   uint32_t             buf_size_;
@@ -326,18 +326,33 @@ const InstInfo* TraceReaderMemtrace::getNextInstruction() {
 
 bool TraceReaderMemtrace::locationForVAddr(uint64_t _vaddr, uint8_t** _loc,
                                            uint64_t* _size) {
+  uint8_t* module_start;
+  uint64_t module_size;
+
+  if(!moduleForVAddr(_vaddr, &module_start, &module_size, _loc))
+    return false;
+  *_size = module_size - (*_loc - module_start);
+  return true;
+}
+
+bool TraceReaderMemtrace::moduleForVAddr(uint64_t _vaddr, uint8_t** _start,
+                                         uint64_t* _size, uint8_t** _loc) {
   app_pc module_start;
   size_t module_size;
 
   *_loc = module_mapper_->find_mapped_trace_bounds(
     reinterpret_cast<app_pc>(_vaddr), &module_start, &module_size);
-  *_size = reinterpret_cast<uint64_t>(module_size) -
-           (reinterpret_cast<uint64_t>(*_loc) -
-            reinterpret_cast<uint64_t>(module_start));
-  if(!module_mapper_->get_last_error().empty()) {
-    std::cout << "Failed to find mapped address: " << std::hex << _vaddr
-              << " Error: " << module_mapper_->get_last_error() << std::endl;
+  // Wrong path lookups fail often, so go by the result of this lookup
+  // rather than by the last error of the module mapper
+  if(!*_loc) {
+    if(!quiet_lookup_) {
+      std::cout << "Failed to find mapped address: " << std::hex << _vaddr
+                << " Error: " << module_mapper_->get_last_error()
+                << std::endl;
+    }
     return false;
   }
+  *_start = reinterpret_cast<uint8_t*>(module_start);
+  *_size  = static_cast<uint64_t>(module_size);
   return true;
 }
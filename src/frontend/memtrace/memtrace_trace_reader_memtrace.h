@@ -49,6 +49,8 @@ class TraceReaderMemtrace : public TraceReader {
   bool               initTrace() override;
   bool               locationForVAddr(uint64_t _vaddr, uint8_t** _loc,
                                       uint64_t* _size) override;
+  bool               moduleForVAddr(uint64_t _vaddr, uint8_t** _start,
+                                    uint64_t* _size, uint8_t** _loc) override;
   void               init(const std::string& _trace);
   static const char* parse_buildid_string(const char* src, OUT void** data);
   bool               getNextInstruction__(InstInfo* _info, InstInfo* _prior);
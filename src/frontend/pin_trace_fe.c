@@ -41,6 +41,7 @@
 #include "ctype_pin_inst.h"
 #include "frontend/pin_trace_fe.h"
 #include "frontend/pin_trace_read.h"
+#include "frontend/trace_wrong_path.h"
 #include "isa/isa.h"
 
 /**************************************************************************************/
@@ -56,17 +57,25 @@ char* trace_files[MAX_NUM_PROCS];
 
 ctype_pin_inst* next_pi;
 
+static uns64* trace_uid;   // unique id of the next trace instruction
+static Flag*  from_trace;  // fetching next_pi
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static int trace_read_next(uns proc_id);
+
 /**************************************************************************************/
 /* trace_init() */
 
 void trace_init() {
-  ASSERTM(0, !FETCH_OFF_PATH_OPS,
-          "Trace frontend does not support wrong path. Turn off "
-          "FETCH_OFF_PATH_OPS\n");
-
   uop_generator_init(NUM_CORES);
+  // traces carry no binaries, the wrong path is the code seen in the trace
+  trace_wp_init(NUM_CORES, NULL);
 
-  next_pi = (ctype_pin_inst*)malloc(NUM_CORES * sizeof(ctype_pin_inst));
+  next_pi    = (ctype_pin_inst*)malloc(NUM_CORES * sizeof(ctype_pin_inst));
+  trace_uid  = (uns64*)calloc(NUM_CORES, sizeof(uns64));
+  from_trace = (Flag*)calloc(NUM_CORES, sizeof(Flag));
 
   pin_trace_file_pointer_init(NUM_CORES);
 
@@ -100,13 +109,29 @@ void trace_init() {
 
 void trace_setup(uns proc_id) {
   pin_trace_open(proc_id, trace_files[proc_id]);
-  pin_trace_read(proc_id, &next_pi[proc_id]);
+  if(FAST_FORWARD) {
+    uns64 skipped = pin_trace_skip(proc_id, trace_files[proc_id],
+                                   FAST_FORWARD_TRACE_INS);
+    ASSERTM(proc_id, skipped == FAST_FORWARD_TRACE_INS,
+            "Trace %s ends after %llu instructions\n", trace_files[proc_id],
+            skipped);
+  }
+  trace_read_next(proc_id);
+}
+
+static int trace_read_next(uns proc_id) {
+  int success = pin_trace_read(proc_id, &next_pi[proc_id]);
+  // the uids recorded by gen_trace are not unique
+  next_pi[proc_id].inst_uid = trace_uid[proc_id]++;
+  return success;
 }
 
 /**************************************************************************************/
 /* trace_next_fetch_addr */
 
 Addr trace_next_fetch_addr(uns proc_id) {
+  if(trace_wp_active(proc_id))
+    return convert_to_cmp_addr(proc_id, trace_wp_next_fetch_addr(proc_id));
   return convert_to_cmp_addr(proc_id, next_pi[proc_id].instruction_addr);
 }
 
@@ -125,13 +150,17 @@ void trace_close_trace_file(uns proc_id) {
 }
 
 Flag trace_can_fetch_op(uns proc_id) {
-  return !(uop_generator_get_eom(proc_id) && trace_read_done[proc_id]);
+  return trace_wp_active(proc_id) ||
+         !(uop_generator_get_eom(proc_id) && trace_read_done[proc_id]);
 }
 
 void trace_fetch_op(uns proc_id, Op* op) {
   if(uop_generator_get_bom(proc_id)) {
-    ASSERT(proc_id, !trace_read_done[proc_id] && !reached_exit[proc_id]);
-    ctype_pin_inst* starlab_pi = &next_pi[proc_id];
+    from_trace[proc_id]        = !trace_wp_active(proc_id);
+    ctype_pin_inst* starlab_pi = from_trace[proc_id] ? &next_pi[proc_id] :
+                                                       trace_wp_fetch(proc_id);
+    ASSERT(proc_id, !from_trace[proc_id] ||
+                      (!trace_read_done[proc_id] && !reached_exit[proc_id]));
 
     static char fetch_macro_addr[128];
     if(voided_macro_inst_ht == NULL)
@@ -143,13 +172,17 @@ void trace_fetch_op(uns proc_id, Op* op) {
     sprintf(fetch_macro_addr, "%016lX", starlab_pi->instruction_addr);
     starlab_insert(voided_macro_inst_ht, fetch_macro_addr, &macro_addr_optype);
 
-    uop_generator_get_uop(proc_id, op, &next_pi[proc_id]);
+    uop_generator_get_uop(proc_id, op, starlab_pi);
   } else {
     uop_generator_get_uop(proc_id, op, NULL);
   }
 
-  if(uop_generator_get_eom(proc_id)) {
-    int success = pin_trace_read(proc_id, &next_pi[proc_id]);
+  if(!from_trace[proc_id]) {
+    // only the last correct path instruction of the trace exits
+    op->exit = op->eom && trace_read_done[proc_id] && !trace_wp_active(proc_id);
+  } else if(uop_generator_get_eom(proc_id)) {
+    trace_wp_record(proc_id, &next_pi[proc_id]);
+    int success = trace_read_next(proc_id);
     if(!success) {
       trace_read_done[proc_id] = TRUE;
       reached_exit[proc_id]    = TRUE;
@@ -162,16 +195,15 @@ void trace_fetch_op(uns proc_id, Op* op) {
 }
 
 void trace_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
-  FATAL_ERROR(proc_id, "Trace frontend does not support wrong path. Turn off "
-                       "FETCH_OFF_PATH_OPS\n");
+  trace_wp_redirect(proc_id, inst_uid, fetch_addr);
 }
 
 void trace_recover(uns proc_id, uns64 inst_uid) {
-  FATAL_ERROR(proc_id, "Trace frontend does not support wrong path. Turn off "
-                       "FETCH_OFF_PATH_OPS\n");
+  trace_wp_recover(proc_id, inst_uid);
 }
 
 void trace_retire(uns proc_id, uns64 inst_uid) {
   // Trace frontend does not need to communicate to PIN which instruction are
-  // retired.
+  // retired, only to drop the correct path it keeps for recoveries.
+  trace_wp_retire(proc_id, inst_uid);
 }
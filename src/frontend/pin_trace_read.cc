@@ -33,6 +33,7 @@
 
 #include "frontend/pin_trace_read.h"
 #include "isa/isa.h"
+#include "pin/pin_trace/trace_index.h"
 
 extern "C" {
 #include "globals/utils.h"
@@ -47,6 +48,38 @@ void pin_trace_file_pointer_init(unsigned char num_cores) {
   pin_file = (FILE**)malloc(num_cores * sizeof(FILE*));
 }
 
+/* Last index entry at or before instruction num_insts: the instruction and
+   byte offset its bzip2 stream starts at. Returns false if the trace has no
+   usable index. */
+static bool trace_index_find(const char* name, uint64_t num_insts,
+                             uint64_t* inst, uint64_t* offset) {
+  std::string index_name = std::string(name) + TRACE_INDEX_SUFFIX;
+  FILE*       index      = fopen(index_name.c_str(), "r");
+  if(!index)
+    return false;
+
+  char   magic[64];
+  size_t record_size = 0;
+  bool   found       = false;
+  if(fgets(magic, sizeof(magic), index) &&
+     sscanf(magic, TRACE_INDEX_MAGIC " %zu", &record_size) == 1 &&
+     record_size == sizeof(ctype_pin_inst)) {
+    uint64_t entry_inst, entry_offset;
+    while(fscanf(index, "%" SCNu64 " %" SCNu64, &entry_inst, &entry_offset) ==
+            2 &&
+          entry_inst <= num_insts) {
+      *inst   = entry_inst;
+      *offset = entry_offset;
+      found   = true;
+    }
+  } else {
+    printf("Ignoring trace index %s: it does not match this build\n",
+           index_name.c_str());
+  }
+  fclose(index);
+  return found;
+}
+
 void pin_trace_open(unsigned char proc_id, const char* name) {
   char cmdline[1024];
   sprintf(cmdline, "bzip2 -dc %s", name);
@@ -71,3 +104,36 @@ int pin_trace_read(unsigned char proc_id, ctype_pin_inst* pi) {
   }
   return 1;
 }
+
+uint64_t pin_trace_skip(unsigned char proc_id, const char* name,
+                        uint64_t num_insts) {
+  static ctype_pin_inst skip_buf[1024];
+  uint64_t              skipped = 0;
+  uint64_t              offset  = 0;
+
+  if(trace_index_find(name, num_insts, &skipped, &offset) && offset) {
+    char cmdline[1024];
+    sprintf(cmdline, "tail -c +%" PRIu64 " %s | bzip2 -dc", offset + 1, name);
+    pclose(pin_file[proc_id]);
+    pin_file[proc_id] = popen(cmdline, "r");
+    if(!pin_file[proc_id]) {
+      printf("Cannot open trace file: %s\n", name);
+      exit(1);
+    }
+  } else {
+    skipped = 0;
+  }
+  printf("Fast forwarding core %u to instruction %" PRIu64
+         " (seeking to instruction %" PRIu64 ")\n",
+         proc_id, num_insts, skipped);
+
+  while(skipped < num_insts) {
+    size_t chunk = num_insts - skipped < 1024 ? num_insts - skipped : 1024;
+    size_t got   = fread(skip_buf, sizeof(ctype_pin_inst), chunk,
+                       pin_file[proc_id]);
+    skipped += got;
+    if(got != chunk)
+      break;
+  }
+  return skipped;
+}
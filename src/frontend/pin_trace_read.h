@@ -29,6 +29,7 @@
 #ifndef __PIN_TRACE_READ_H__
 #define __PIN_TRACE_READ_H__
 
+#include <stdint.h>
 #include "ctype_pin_inst.h"
 
 #ifdef __cplusplus
@@ -39,6 +40,9 @@ void pin_trace_file_pointer_init(unsigned char);
 int  pin_trace_read(unsigned char, ctype_pin_inst*);
 void pin_trace_open(unsigned char, const char*);
 void pin_trace_close(unsigned char);
+/* Skip the first instructions of a trace just opened, seeking through its
+   index if it has one. Returns the number of instructions skipped. */
+uint64_t pin_trace_skip(unsigned char, const char*, uint64_t);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,235 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/trace_wrong_path.cc
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Wrong path fetch for the trace driven frontends
+ ***************************************************************************************/
+
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include "debug/debug.param.h"
+#include "debug/debug_macros.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "frontend/trace_wrong_path.h"
+#include "pin/pin_lib/uop_generator.h"
+#include "statistics.h"
+#include "table_info.h"
+}
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_TRACE_READ, ##args)
+
+/* Wrong path instructions get unique ids that never match a trace
+   instruction */
+#define WRONG_PATH_UID_BASE (1ULL << 63)
+
+/**************************************************************************************/
+/* Types */
+
+struct Wp_Core {
+  std::deque<ctype_pin_inst> history;  // correct path fetched and not retired
+  size_t replay;       // next history entry to fetch again after a recovery
+  Flag   off_path;     // fetching the wrong path
+  Addr   wp_addr;      // next wrong path fetch address
+  ctype_pin_inst wp_inst;  // wrong path instruction being fetched
+  std::unordered_map<Addr, ctype_pin_inst> code;  // static code, by address
+};
+
+/**************************************************************************************/
+/* Global Variables */
+
+static std::vector<Wp_Core> wp_cores;
+static Trace_Wp_Decode_Func wp_decode;
+static uns64                wp_uid = WRONG_PATH_UID_BASE;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void trace_wp_rewind(uns proc_id, Wp_Core* core, uns64 inst_uid,
+                            Flag must_find);
+static void trace_wp_synthesize(uns proc_id, Wp_Core* core);
+
+/**************************************************************************************/
+/* trace_wp_init: */
+
+void trace_wp_init(uns num_cores, Trace_Wp_Decode_Func decode) {
+  wp_cores.resize(num_cores);
+  for(auto& core : wp_cores) {
+    core.replay   = 0;
+    core.off_path = FALSE;
+    core.wp_addr  = 0;
+  }
+  wp_decode = decode;
+}
+
+/**************************************************************************************/
+/* trace_wp_active: */
+
+Flag trace_wp_active(uns proc_id) {
+  const Wp_Core& core = wp_cores[proc_id];
+  return core.off_path || core.replay < core.history.size();
+}
+
+/**************************************************************************************/
+/* trace_wp_next_fetch_addr: */
+
+Addr trace_wp_next_fetch_addr(uns proc_id) {
+  const Wp_Core& core = wp_cores[proc_id];
+  ASSERT(proc_id, trace_wp_active(proc_id));
+  return core.off_path ? core.wp_addr :
+                         core.history[core.replay].instruction_addr;
+}
+
+/**************************************************************************************/
+/* trace_wp_fetch: the next instruction, valid until the next call */
+
+ctype_pin_inst* trace_wp_fetch(uns proc_id) {
+  Wp_Core& core = wp_cores[proc_id];
+  ASSERT(proc_id, trace_wp_active(proc_id));
+  if(!core.off_path)
+    return &core.history[core.replay++];
+  trace_wp_synthesize(proc_id, &core);
+  return &core.wp_inst;
+}
+
+/**************************************************************************************/
+/* trace_wp_record: */
+
+void trace_wp_record(uns proc_id, const ctype_pin_inst* inst) {
+  if(!FETCH_OFF_PATH_OPS)
+    return;
+  Wp_Core& core = wp_cores[proc_id];
+  ASSERT(proc_id, !trace_wp_active(proc_id));
+  core.history.push_back(*inst);
+  core.replay                        = core.history.size();
+  core.code[inst->instruction_addr] = *inst;
+}
+
+/**************************************************************************************/
+/* trace_wp_redirect: fetch the wrong path at fetch_addr after inst_uid */
+
+void trace_wp_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
+  Wp_Core& core = wp_cores[proc_id];
+  DEBUG(proc_id, "Wrong path redirect after %llu to 0x%llx\n", inst_uid,
+        fetch_addr);
+  // a correct path instruction may have been followed by more correct path
+  // before the redirect (late branch predictor), they are fetched again later
+  trace_wp_rewind(proc_id, &core, inst_uid, FALSE);
+  core.off_path = TRUE;
+  core.wp_addr  = convert_to_cmp_addr(0, fetch_addr);  // removing proc_id
+  uop_generator_recover(proc_id);
+}
+
+/**************************************************************************************/
+/* trace_wp_recover: back to the correct path after inst_uid */
+
+void trace_wp_recover(uns proc_id, uns64 inst_uid) {
+  Wp_Core& core = wp_cores[proc_id];
+  DEBUG(proc_id, "Wrong path recover after %llu\n", inst_uid);
+  trace_wp_rewind(proc_id, &core, inst_uid, TRUE);
+  core.off_path = FALSE;
+  uop_generator_recover(proc_id);
+}
+
+/**************************************************************************************/
+/* trace_wp_retire: */
+
+void trace_wp_retire(uns proc_id, uns64 inst_uid) {
+  Wp_Core& core = wp_cores[proc_id];
+  if(inst_uid == (uns64)-1)
+    return;
+  while(core.replay && core.history.front().inst_uid <= inst_uid) {
+    core.history.pop_front();
+    core.replay--;
+  }
+}
+
+/**************************************************************************************/
+/* trace_wp_rewind: fetch the correct path after inst_uid again */
+
+static void trace_wp_rewind(uns proc_id, Wp_Core* core, uns64 inst_uid,
+                            Flag must_find) {
+  for(size_t idx = core->history.size(); idx > 0; idx--) {
+    if(core->history[idx - 1].inst_uid == inst_uid) {
+      core->replay = idx;
+      return;
+    }
+  }
+  ASSERTM(proc_id, !must_find,
+          "Recovery to inst_uid %llu, which is not in the fetched correct "
+          "path\n",
+          inst_uid);
+}
+
+/**************************************************************************************/
+/* trace_wp_synthesize: the wrong path instruction at wp_addr. Its last
+   execution in the trace gives the direction, target and memory addresses.
+   Code never executed is decoded from the binaries: conditional branches
+   fall through, indirect targets are unknown and memory addresses are left to
+   the uop generator. Anything else becomes a NOP, like the wrong path NOP
+   mode of the PIN frontend. */
+
+static void trace_wp_synthesize(uns proc_id, Wp_Core* core) {
+  ctype_pin_inst* inst = &core->wp_inst;
+  auto            iter = core->code.find(core->wp_addr);
+
+  if(iter != core->code.end()) {
+    *inst = iter->second;
+    STAT_EVENT(proc_id, TRACE_WRONG_PATH_SEEN);
+  } else if(wp_decode && wp_decode(proc_id, core->wp_addr, inst)) {
+    core->code[core->wp_addr] = *inst;
+    STAT_EVENT(proc_id, TRACE_WRONG_PATH_DECODED);
+  } else {
+    memset(inst, 0, sizeof(ctype_pin_inst));
+    inst->instruction_addr = core->wp_addr;
+    inst->size             = 1;
+    inst->op_type          = OP_NOP;
+    inst->fake_inst        = 1;
+    inst->fake_inst_reason = WPNM_REASON_REDIRECT_TO_NOT_INSTRUMENTED;
+    strcpy(inst->pin_iclass, "DUMMY_NOP");
+    STAT_EVENT(proc_id, TRACE_WRONG_PATH_UNKNOWN);
+  }
+
+  Addr next_addr = inst->instruction_addr + inst->size;
+  if(inst->cf_type != NOT_CF && inst->actually_taken && inst->branch_target)
+    next_addr = inst->branch_target;
+  else
+    inst->actually_taken = 0;
+  inst->instruction_next_addr = next_addr;
+  inst->inst_uid              = wp_uid++;
+  inst->exit                  = 0;
+  core->wp_addr               = next_addr;
+}
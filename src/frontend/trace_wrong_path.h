@@ -0,0 +1,73 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/trace_wrong_path.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Wrong path fetch for the trace driven frontends. Wrong path
+ *                instructions come from the static code seen in the trace or
+ *                decoded from the application binaries, and the correct path
+ *                fetched since the last retire is kept to resume on recovery.
+ ***************************************************************************************/
+
+#ifndef __TRACE_WRONG_PATH_H__
+#define __TRACE_WRONG_PATH_H__
+
+#include "ctype_pin_inst.h"
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+/* Decodes the instruction at addr from the application binaries, without
+   dynamic information. Returns FALSE if addr is not in a known binary. */
+typedef Flag (*Trace_Wp_Decode_Func)(uns proc_id, Addr addr,
+                                     ctype_pin_inst* inst);
+
+/**************************************************************************************/
+/* Prototypes */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void trace_wp_init(uns num_cores, Trace_Wp_Decode_Func decode);
+
+/* Does the next instruction come from here (wrong path or correct path
+   fetched again after a recovery) instead of from the trace? */
+Flag            trace_wp_active(uns proc_id);
+Addr            trace_wp_next_fetch_addr(uns proc_id);
+ctype_pin_inst* trace_wp_fetch(uns proc_id);
+
+/* Called by the frontend for every instruction fetched from the trace */
+void trace_wp_record(uns proc_id, const ctype_pin_inst* inst);
+
+/* Implementing the frontend redirect interface */
+void trace_wp_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr);
+void trace_wp_recover(uns proc_id, uns64 inst_uid);
+void trace_wp_retire(uns proc_id, uns64 inst_uid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __TRACE_WRONG_PATH_H__ */
@@ -0,0 +1,191 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : host_prof.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Host-side profiler. The per-phase counters are regular stats
+ *                (host_prof.stat.def); this file writes the KIPS-over-time
+ *                trace that shows how simulation speed and the share of each
+ *                phase change during the run.
+ ***************************************************************************************/
+
+#include "host_prof.h"
+#include <stdio.h>
+#include <time.h>
+#include "core.param.h"
+#include "general.param.h"
+#include "globals/assert.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+#include "stat_mon.h"
+#include "statistics.h"
+#include "trigger.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define FIRST_PHASE_STAT HOST_PROF_CMP_CYCLE_CALLS
+#define LAST_PHASE_STAT HOST_PROF_CACHE_PART_CYCLES
+#define NUM_PHASES ((LAST_PHASE_STAT - FIRST_PHASE_STAT + 1) / 2)
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Stat_Mon* stat_mon;
+static Trigger*  interval_trigger = NULL;
+static FILE*     file;
+static double    start_time;
+static double    last_time;
+static Counter   last_inst_count;
+static Counter   last_cycle_count;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static double wall_time(void);
+static void   trace_kips(void);
+
+/**************************************************************************************/
+/* host_prof_init: */
+
+void host_prof_init(void) {
+  ASSERT(0, (LAST_PHASE_STAT - FIRST_PHASE_STAT + 1) % 2 == 0);
+  start_time = last_time = wall_time();
+  last_inst_count        = 0;
+  last_cycle_count       = 0;
+
+  if(!HOST_PROF || !strcmp(HOST_PROF_TRACE_INTERVAL, "never"))
+    return;
+
+  file = file_tag_fopen(OUTPUT_DIR, HOST_PROF_TRACE_FILE, "w");
+  ASSERTM(0, file, "Could not open %s\n", HOST_PROF_TRACE_FILE);
+
+  fprintf(file, "Cycles\tInstructions\tSeconds\tKIPS\tCumulative_KIPS\t"
+                "Host_Cycles_Per_Cycle");
+  for(uns ii = 0; ii < NUM_PHASES; ii++) {
+    const char* name = global_stat_array[0][FIRST_PHASE_STAT + 2 * ii].name;
+    /* strip the HOST_PROF_ prefix and the _CALLS suffix */
+    name += strlen("HOST_PROF_");
+    fprintf(file, "\t%.*s", (int)(strlen(name) - strlen("_CALLS")), name);
+  }
+  fprintf(file, "\n");
+
+  stat_mon = stat_mon_create_from_range(FIRST_PHASE_STAT, LAST_PHASE_STAT);
+  interval_trigger = trigger_create("HOST_PROF_TRACE_INTERVAL",
+                                    HOST_PROF_TRACE_INTERVAL, TRIGGER_REPEAT);
+}
+
+/**************************************************************************************/
+/* host_prof_cycle: */
+
+void host_prof_cycle(void) {
+  if(!file)
+    return;
+
+  if(trigger_fired(interval_trigger)) {
+    trace_kips();
+  }
+}
+
+/**************************************************************************************/
+/* host_prof_done: */
+
+void host_prof_done(void) {
+  if(HOST_PROF) {
+    Counter total_inst_count = 0;
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+      total_inst_count += inst_count[proc_id];
+    double elapsed = wall_time() - start_time;
+    fprintf(mystdout, "** Host profile:  %.2f s  --  %.2f KIPS  --  %.1f host "
+                      "cycles per cycle\n",
+            elapsed, elapsed > 0 ? total_inst_count / elapsed / 1000 : 0.0,
+            cycle_count ?
+              (double)GET_TOTAL_STAT_EVENT(0, HOST_PROF_CMP_CYCLE_CYCLES) /
+                cycle_count :
+              0.0);
+  }
+
+  if(!file)
+    return;
+
+  /* trace the final interval */
+  trace_kips();
+
+  fclose(file);
+  file = NULL;
+
+  stat_mon_free(stat_mon);
+  trigger_free(interval_trigger);
+}
+
+/**************************************************************************************/
+/* wall_time: */
+
+static double wall_time(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**************************************************************************************/
+/* trace_kips: one line per interval, with the share of each phase in the host
+ * cycles spent in cmp_cycle during the interval */
+
+static void trace_kips(void) {
+  Counter total_inst_count = 0;
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    total_inst_count += inst_count[proc_id];
+
+  double  now        = wall_time();
+  double  interval   = now - last_time;
+  double  elapsed    = now - start_time;
+  Counter insts      = total_inst_count - last_inst_count;
+  Counter cycles     = cycle_count - last_cycle_count;
+  Counter phase_sums[NUM_PHASES];
+
+  for(uns ii = 0; ii < NUM_PHASES; ii++) {
+    phase_sums[ii] = 0;
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+      phase_sums[ii] += stat_mon_get_count(stat_mon, proc_id,
+                                           FIRST_PHASE_STAT + 2 * ii + 1);
+  }
+  /* the first phase is the whole cmp_cycle */
+  Counter total_ticks = phase_sums[0];
+
+  fprintf(file, "%llu\t%llu\t%.3f\t%.2f\t%.2f\t%.1f", cycle_count,
+          total_inst_count, elapsed,
+          interval > 0 ? insts / interval / 1000 : 0.0,
+          elapsed > 0 ? total_inst_count / elapsed / 1000 : 0.0,
+          cycles ? (double)total_ticks / cycles : 0.0);
+  for(uns ii = 0; ii < NUM_PHASES; ii++) {
+    fprintf(file, "\t%.4f",
+            total_ticks ? (double)phase_sums[ii] / total_ticks : 0.0);
+  }
+  fprintf(file, "\n");
+  fflush(file);
+
+  stat_mon_reset(stat_mon);
+  last_time        = now;
+  last_inst_count  = total_inst_count;
+  last_cycle_count = cycle_count;
+}
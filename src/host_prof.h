@@ -0,0 +1,92 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : host_prof.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Host-side profiler. Measures how much host time (in TSC
+ *                ticks) Scarab spends in each phase of a simulated cycle.
+ ***************************************************************************************/
+
+#ifndef __HOST_PROF_H__
+#define __HOST_PROF_H__
+
+#include "general.param.h"
+#include "globals/global_types.h"
+#include "statistics.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+/**************************************************************************************/
+/* Macros */
+
+/* Time a phase listed in host_prof.stat.def. BEGIN and END must be called in
+   the same scope. The calls and TSC ticks of the phase are accumulated in the
+   HOST_PROF_<phase>_CALLS and HOST_PROF_<phase>_CYCLES stats of proc_id. */
+#define HOST_PROF_BEGIN(phase) uns64 host_prof_start_##phase = host_prof_now()
+
+#define HOST_PROF_END(proc_id, phase)                                 \
+  host_prof_record((proc_id), HOST_PROF_##phase##_CALLS,              \
+                   HOST_PROF_##phase##_CYCLES, host_prof_start_##phase)
+
+/**************************************************************************************/
+/* Inline functions */
+
+static inline uns64 host_prof_rdtsc(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uns64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static inline uns64 host_prof_now(void) {
+  return HOST_PROF ? host_prof_rdtsc() : 0;
+}
+
+static inline void host_prof_record(uns proc_id, Stat_Enum calls_stat,
+                                    Stat_Enum cycles_stat, uns64 start) {
+  if(!HOST_PROF)
+    return;
+  STAT_EVENT(proc_id, calls_stat);
+  INC_STAT_EVENT(proc_id, cycles_stat, host_prof_rdtsc() - start);
+}
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize the KIPS trace */
+void host_prof_init(void);
+
+/* Call every cycle */
+void host_prof_cycle(void);
+
+/* Clean up */
+void host_prof_done(void);
+
+#endif  // __HOST_PROF_H__
@@ -299,6 +299,9 @@ void update_icache_stage() {
     case IC_FETCH: {
       Break_Reason break_fetch = BREAK_DONT;
 
+      if(ic->hold_fetch)
+        return;
+
       ic->off_path &= !ic->back_on_path;
       ic->back_on_path = FALSE;
 
@@ -967,10 +970,11 @@ Flag icache_fill_line(Mem_Req* req)  // cmp FIXME maybe needed to be optimized
 }
 
 /**************************************************************************************/
-/* icache_off_path: */
+/* icache_off_path: (models without an icache stage, like the interval model,
+   never fetch off path) */
 
 inline Flag icache_off_path(void) {
-  return ic->off_path;
+  return ic && ic->off_path;
 }
 
 /*************************************************************************************/
@@ -71,6 +71,8 @@ typedef struct Icache_Stage_struct {
   Flag        off_path;        /* is the icache fetching on the correct path? */
   Flag back_on_path; /* did a recovery happen to put the machine back on path?
                       */
+  Flag hold_fetch;   /* stop fetching new ops (lets sampled simulation drain
+                        the pipeline) */
 
   Counter rdy_cycle; /* cycle that the henry icache will return data (only used
                         in henry model) */
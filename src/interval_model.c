@@ -0,0 +1,622 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : interval_model.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Interval (mechanistic) core model. Each core dispatches
+ *                ISSUE_WIDTH ops per cycle from the frontend into a window of
+ *                NODE_TABLE_SIZE ops, computes when every op is done from its
+ *                register and memory dependences and its latency, and retires
+ *                NODE_RET_WIDTH done ops per cycle in order. Only the events
+ *                that interrupt this flow are modeled: branch mispredictions
+ *                and BTB misses (real branch predictors), icache and dcache
+ *                misses (real core caches, misses go through the real memory
+ *                system), fetch barriers and a full window. There are no
+ *                pipeline stages, functional units or wrong path ops.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+#include "isa/isa_macros.h"
+
+#include "cmp_model.h"
+#include "cmp_model_support.h"
+#include "dcache_stage.h"
+#include "freq.h"
+#include "frontend/frontend.h"
+#include "frontend/pin_trace_fe.h"
+#include "host_prof.h"
+#include "interval_model.h"
+#include "map.h"
+#include "memory/cache_explore.h"
+#include "memory/cache_part.h"
+#include "model.h"
+#include "op_pool.h"
+#include "prefetcher/pref_common.h"
+#include "sim.h"
+#include "statistics.h"
+
+#include "bp/bp.param.h"
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "dvfs/dvfs.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/pref.param.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_NODE_STAGE, ##args)
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void interval_set_core(uns8 proc_id);
+static Flag interval_schedule(Interval_Core* core, Op* op);
+static void interval_schedule_branch(Interval_Core* core, Op* op);
+static void interval_rescan(Interval_Core* core);
+static void interval_retire(Interval_Core* core);
+static void interval_fetch(Interval_Core* core);
+static Flag interval_icache_fill(Mem_Req* req);
+static Flag interval_dcache_fill(Mem_Req* req);
+
+/**************************************************************************************/
+/* interval_init */
+
+void interval_init(uns mode) {
+  if(mode != WARMUP_MODE)
+    return;
+
+  ASSERTM(0, !DVFS_ON, "DVFS is not supported by the interval model\n");
+
+  freq_init();
+
+  interval_model.cores            = calloc(NUM_CORES, sizeof(Interval_Core));
+  interval_model.thread_data      = calloc(NUM_CORES, sizeof(Thread_Data));
+  interval_model.bp_recovery_info = calloc(NUM_CORES,
+                                           sizeof(Bp_Recovery_Info));
+  interval_model.bp_data          = calloc(NUM_CORES, sizeof(Bp_Data));
+
+  for(uns8 proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Interval_Core* core = &interval_model.cores[proc_id];
+
+    set_thread_data(&interval_model.thread_data[proc_id]);
+    set_map_data(&td->map_data);
+    cmp_init_thread_data(proc_id);
+
+    init_bp_recovery_info(proc_id, &interval_model.bp_recovery_info[proc_id]);
+    init_bp_data(proc_id, &interval_model.bp_data[proc_id]);
+
+    core->proc_id     = proc_id;
+    core->window      = calloc(NODE_TABLE_SIZE, sizeof(Op*));
+    core->fetch_stall = INTERVAL_BRANCH_STALL;
+    init_cache(&core->icache, "ICACHE", ICACHE_SIZE, ICACHE_ASSOC,
+               ICACHE_LINE_SIZE, 0, REPL_TRUE_LRU);
+    init_cache(&core->dcache, "DCACHE", DCACHE_SIZE, DCACHE_ASSOC,
+               DCACHE_LINE_SIZE, sizeof(Dcache_Data), DCACHE_REPL);
+
+    op_count[proc_id]              = 1;
+    unique_count_per_core[proc_id] = 1;
+  }
+
+  set_memory(&interval_model.memory);
+  init_memory();
+
+  cache_part_init();
+  cache_explore_init();
+}
+
+/**************************************************************************************/
+/* interval_reset: */
+
+void interval_reset() {
+  reset_memory();
+}
+
+/**************************************************************************************/
+/* interval_set_core: point the global thread, map and branch predictor data
+   at a core */
+
+static void interval_set_core(uns8 proc_id) {
+  set_thread_data(&interval_model.thread_data[proc_id]);
+  set_map_data(&td->map_data);
+  set_bp_data(&interval_model.bp_data[proc_id]);
+  set_bp_recovery_info(&interval_model.bp_recovery_info[proc_id]);
+}
+
+/**************************************************************************************/
+/* interval_cycle: */
+
+void interval_cycle() {
+  HOST_PROF_BEGIN(UPDATE_MEMORY);
+  update_memory();
+  HOST_PROF_END(0, UPDATE_MEMORY);
+
+  for(uns8 proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+      continue;
+    if(!freq_is_ready(FREQ_DOMAIN_CORES[proc_id]))
+      continue;
+
+    Interval_Core* core = &interval_model.cores[proc_id];
+    cycle_count         = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+    interval_set_core(proc_id);
+    STAT_EVENT(proc_id, NODE_CYCLE);
+
+    if(core->rescan)
+      interval_rescan(core);
+    interval_retire(core);
+    interval_fetch(core);
+  }
+
+  cache_part_update();
+}
+
+/**************************************************************************************/
+/* interval_schedule: compute when an op is done. Returns FALSE if that is
+   not known yet because a source waits for a miss (or the miss of the op
+   itself could not be sent), the op is then rescheduled by interval_rescan. */
+
+static Flag interval_schedule(Interval_Core* core, Op* op) {
+  uns     proc_id = core->proc_id;
+  Counter ready   = cycle_count;
+
+  for(uns ii = 0; ii < op->oracle_info.num_srcs; ii++) {
+    Src_Info* src    = &op->oracle_info.src_info[ii];
+    Op*       src_op = src->op;
+    if(!src_op->op_pool_valid || src_op->unique_num != src->unique_num)
+      continue;  // retired
+    if(src_op->done_cycle == MAX_CTR)
+      return FALSE;
+    ready = MAX2(ready, src_op->done_cycle);
+  }
+
+  int     latency    = op->inst_info->latency;
+  Counter exec_cycle = ready + MAX2(MAX2(latency, -latency), 1);
+  Flag    is_load    = op->table_info->mem_type == MEM_LD;
+  Flag    is_store   = op->table_info->mem_type == MEM_ST;
+
+  if(is_load || is_store) {
+    Addr         line_addr;
+    Dcache_Data* data = (Dcache_Data*)cache_access(
+      &core->dcache, op->oracle_info.va, &line_addr, TRUE);
+    if(data) {
+      data->dirty |= is_store;
+      data->read_count[0] += is_load;
+      data->write_count[0] += is_store;
+      STAT_EVENT(proc_id, DCACHE_HIT);
+    } else {
+      // the request leaves the core when the address is computed
+      uns delay = exec_cycle - cycle_count + DCACHE_CYCLES - 1 +
+                  op->inst_info->extra_ld_latency;
+      if(!new_mem_req(is_load ? MRT_DFETCH : MRT_DSTORE, proc_id, line_addr,
+                      DCACHE_LINE_SIZE, delay, op, interval_dcache_fill,
+                      op->unique_num, 0)) {
+        core->rescan = TRUE;  // retry next cycle
+        return FALSE;
+      }
+      STAT_EVENT(proc_id, DCACHE_MISS);
+      STAT_EVENT(proc_id, DCACHE_MISS_ONPATH);
+      op->engine_info.dcmiss = TRUE;
+    }
+    op->sched_cycle = ready;
+    op->exec_cycle  = exec_cycle;
+    // stores retire into the store buffer, loads wait for the fill
+    if(is_store || data)
+      op->done_cycle = exec_cycle + (is_load ? DCACHE_CYCLES : 0);
+    return TRUE;
+  }
+
+  op->sched_cycle = ready;
+  op->exec_cycle  = exec_cycle;
+  op->done_cycle  = exec_cycle;
+  if(op->table_info->cf_type)
+    interval_schedule_branch(core, op);
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* interval_schedule_branch: resolve a branch once its exec cycle is known. A
+   misprediction restarts dispatch after the recovery and the refill of the
+   frontend (decode and map). */
+
+static void interval_schedule_branch(Interval_Core* core, Op* op) {
+  if(!BP_UPDATE_AT_RETIRE) {
+    if(op->table_info->cf_type >= CF_IBR)
+      bp_target_known_op(g_bp_data, op);
+    bp_resolve_op(g_bp_data, op);
+  }
+
+  if(op->oracle_info.mispred || op->oracle_info.misfetch) {
+    bp_recover_op(g_bp_data, op->table_info->cf_type, &op->recovery_info);
+    ASSERT(core->proc_id, core->branch_wait);
+    core->branch_wait = FALSE;
+    core->fetch_cycle = op->exec_cycle + 1 + EXTRA_RECOVERY_CYCLES +
+                        DECODE_CYCLES + MAP_CYCLES;
+    core->fetch_stall = INTERVAL_BRANCH_STALL;
+  } else if(op->table_info->cf_type >= CF_IBR && op->oracle_info.btb_miss &&
+            op->oracle_info.no_target) {
+    ASSERT(core->proc_id, core->branch_wait);
+    core->branch_wait = FALSE;
+    core->fetch_cycle = op->exec_cycle + 1 + EXTRA_REDIRECT_CYCLES;
+    core->fetch_stall = INTERVAL_BRANCH_STALL;
+  }
+}
+
+/**************************************************************************************/
+/* interval_rescan: schedule the waiting ops in program order (so that the
+   consumers of a freshly scheduled op are scheduled in the same pass) */
+
+static void interval_rescan(Interval_Core* core) {
+  core->rescan = FALSE;
+  for(uns ii = 0; ii < core->window_count; ii++) {
+    Op* op = core->window[(core->window_head + ii) % NODE_TABLE_SIZE];
+    if(op->sched_cycle == MAX_CTR)
+      interval_schedule(core, op);
+  }
+}
+
+/**************************************************************************************/
+/* interval_retire: */
+
+static void interval_retire(Interval_Core* core) {
+  uns proc_id = core->proc_id;
+
+  for(uns ret_count = 0; ret_count < NODE_RET_WIDTH && core->window_count;
+      ret_count++) {
+    Op* op = core->window[core->window_head];
+
+    if(op->done_cycle > cycle_count) {
+      if(op->engine_info.dcmiss) {
+        STAT_EVENT(proc_id, RET_BLOCKED_DC_MISS);
+        if(op->engine_info.l1_miss) {
+          STAT_EVENT(proc_id, RET_BLOCKED_L1_MISS);
+          STAT_EVENT(proc_id, RET_BLOCKED_MEM_STALL);
+        } else {
+          STAT_EVENT(proc_id, RET_BLOCKED_L1_ACCESS);
+        }
+      }
+      break;
+    }
+
+    DEBUG(proc_id, "Retiring op_num:%s\n", unsstr64(op->op_num));
+
+    if(op->eom) {
+      inst_count[proc_id]++;
+      STAT_EVENT(proc_id, NODE_INST_COUNT);
+
+      Flag retire_op = IS_CALLSYS(op->table_info) ||
+                       op->table_info->bar_type & BAR_FETCH ||
+                       (inst_count[proc_id] % NODE_RETIRE_RATE == 0);
+
+      if(op->exit) {
+        retired_exit[proc_id] = TRUE;
+        frontend_retire(proc_id, -1);
+      } else if(retire_op) {
+        frontend_retire(proc_id, op->inst_uid);
+      }
+    }
+    uop_count[proc_id]++;
+    STAT_EVENT(proc_id, NODE_UOP_COUNT);
+    STAT_EVENT(proc_id, RET_ALL_INST);
+    STAT_EVENT(proc_id, OP_RETIRED);
+
+    if(op->table_info->cf_type) {
+      if(BP_UPDATE_AT_RETIRE) {
+        if(op->table_info->cf_type >= CF_IBR)
+          bp_target_known_op(g_bp_data, op);
+        bp_resolve_op(g_bp_data, op);
+      }
+      bp_retire_op(g_bp_data, op);
+    }
+
+    op->retire_cycle = cycle_count;
+    free_op(op);
+
+    core->window_head = (core->window_head + 1) % NODE_TABLE_SIZE;
+    core->window_count--;
+  }
+}
+
+/**************************************************************************************/
+/* interval_fetch: dispatch up to ISSUE_WIDTH ops into the window */
+
+static void interval_fetch(Interval_Core* core) {
+  uns proc_id = core->proc_id;
+
+  if(core->icache_wait) {
+    STAT_EVENT(proc_id, INTERVAL_ICACHE_STALL);
+    return;
+  }
+  if(core->branch_wait || cycle_count < core->fetch_cycle) {
+    STAT_EVENT(proc_id, core->fetch_stall);
+    return;
+  }
+  if(core->barrier_wait) {
+    if(core->window_count) {
+      STAT_EVENT(proc_id, INTERVAL_BARRIER_STALL);
+      return;
+    }
+    core->barrier_wait = FALSE;
+  }
+
+  for(uns ii = 0; ii < ISSUE_WIDTH; ii++) {
+    if(core->window_count == NODE_TABLE_SIZE) {
+      STAT_EVENT(proc_id, FULL_WINDOW_STALL);
+      break;
+    }
+    if(!frontend_can_fetch_op(proc_id))
+      break;
+
+    /* look up the icache once per line */
+    Addr fetch_addr = frontend_next_fetch_addr(proc_id);
+    Addr line_addr;
+    if(core->icache_line != (fetch_addr & ~(Addr)(ICACHE_LINE_SIZE - 1))) {
+      if(cache_access(&core->icache, fetch_addr, &line_addr, TRUE)) {
+        STAT_EVENT(proc_id, ICACHE_HIT);
+        core->icache_line = line_addr;
+      } else {
+        if(new_mem_req(MRT_IFETCH, proc_id, line_addr, ICACHE_LINE_SIZE, 0,
+                       NULL, interval_icache_fill, unique_count, 0)) {
+          STAT_EVENT(proc_id, ICACHE_MISS);
+          STAT_EVENT(proc_id, ICACHE_MISS_ONPATH);
+          core->icache_wait = TRUE;
+        }
+        break;
+      }
+    }
+
+    Op* op = alloc_op(proc_id);
+    frontend_fetch_op(proc_id, op);
+    op->fetch_addr  = op->inst_info->addr;
+    op->fetch_cycle = cycle_count;
+    op->issue_cycle = cycle_count;
+    td->inst_addr   = op->inst_info->addr;
+
+    if(DUMP_TRACE && DEBUG_RANGE_COND(proc_id))
+      print_func_op(op);
+
+    thread_map_op(op);
+    thread_map_mem_dep(op);
+    STAT_EVENT(proc_id, FETCH_ALL_INST);
+    STAT_EVENT(proc_id, ORACLE_ON_PATH_INST);
+
+    op_count[proc_id]++;
+    unique_count_per_core[proc_id]++;
+    unique_count++;
+
+    core->window[(core->window_head + core->window_count) % NODE_TABLE_SIZE] =
+      op;
+    core->window_count++;
+
+    if(op->table_info->cf_type) {
+      bp_predict_op(g_bp_data, op, 0, op->inst_info->addr);
+      if(op->table_info->cf_type <= CF_CALL) {
+        // direct target, known at decode
+        bp_target_known_op(g_bp_data, op);
+        if(op->oracle_info.btb_miss) {
+          op->oracle_info.misfetch = FALSE;
+          core->fetch_cycle = cycle_count + DECODE_CYCLES + 1 +
+                              EXTRA_REDIRECT_CYCLES;
+          core->fetch_stall = INTERVAL_BRANCH_STALL;
+        }
+      } else if(op->oracle_info.btb_miss && !op->oracle_info.no_target) {
+        core->fetch_cycle = cycle_count + DECODE_CYCLES + 1 +
+                            EXTRA_REDIRECT_CYCLES;
+        core->fetch_stall = INTERVAL_BRANCH_STALL;
+      }
+      core->branch_wait = op->oracle_info.mispred ||
+                          op->oracle_info.misfetch ||
+                          (op->table_info->cf_type >= CF_IBR &&
+                           op->oracle_info.btb_miss &&
+                           op->oracle_info.no_target);
+    }
+
+    interval_schedule(core, op);
+
+    if(IS_CALLSYS(op->table_info) || op->table_info->bar_type & BAR_FETCH) {
+      core->barrier_wait = TRUE;
+      if(IS_CALLSYS(op->table_info)) {
+        core->fetch_cycle = cycle_count + EXTRA_CALLSYS_CYCLES;
+        core->fetch_stall = INTERVAL_BARRIER_STALL;
+      }
+      break;
+    }
+    if(core->branch_wait || cycle_count < core->fetch_cycle)
+      break;
+  }
+}
+
+/**************************************************************************************/
+/* interval_icache_fill: */
+
+static Flag interval_icache_fill(Mem_Req* req) {
+  Interval_Core* core = &interval_model.cores[req->proc_id];
+  Addr           line_addr, repl_line_addr;
+
+  cache_insert(&core->icache, req->proc_id, req->addr, &line_addr,
+               &repl_line_addr);
+  core->icache_wait = FALSE;
+  return SUCCESS;
+}
+
+/**************************************************************************************/
+/* interval_dcache_fill: insert the line (writing back a dirty victim) and
+   wake up the loads that wait for it */
+
+static Flag interval_dcache_fill(Mem_Req* req) {
+  Interval_Core* core    = &interval_model.cores[req->proc_id];
+  Counter        now     = freq_cycle_count(FREQ_DOMAIN_CORES[req->proc_id]);
+  Op**           op_p    = (Op**)list_start_head_traversal(&req->op_ptrs);
+  Counter*       op_uniq = (Counter*)list_start_head_traversal(
+    &req->op_uniques);
+  Addr         line_addr, repl_line_addr;
+  Flag         repl_line_valid;
+  Dcache_Data* data;
+
+  data = (Dcache_Data*)get_next_repl_line(&core->dcache, req->proc_id,
+                                          req->addr, &repl_line_addr,
+                                          &repl_line_valid);
+  if(repl_line_valid && data->dirty) {
+    if(!new_mem_dc_wb_req(MRT_WB, get_proc_id_from_cmp_addr(repl_line_addr),
+                          repl_line_addr, DCACHE_LINE_SIZE, 1, NULL, NULL,
+                          unique_count, TRUE))
+      return FAILURE;
+    STAT_EVENT(req->proc_id, DCACHE_WB_REQ_DIRTY);
+    STAT_EVENT(req->proc_id, DCACHE_WB_REQ);
+  }
+
+  data = (Dcache_Data*)cache_insert(&core->dcache, req->proc_id, req->addr,
+                                    &line_addr, &repl_line_addr);
+  memset(data, 0, sizeof(Dcache_Data));
+  data->dirty       = req->dirty_l0;
+  data->fetch_cycle = now;
+  STAT_EVENT(req->proc_id, DCACHE_FILL);
+
+  for(; op_p; op_p = (Op**)list_next_element(&req->op_ptrs)) {
+    Op* op = *op_p;
+    ASSERT(req->proc_id, op_uniq);
+    if(op->unique_num == *op_uniq && op->op_pool_valid &&
+       op->done_cycle == MAX_CTR) {
+      op->done_cycle = now + 1;
+      core->rescan   = TRUE;
+    }
+    op_uniq = (Counter*)list_next_element(&req->op_uniques);
+  }
+  return SUCCESS;
+}
+
+/**************************************************************************************/
+/* interval_warmup: warm up the caches and the branch predictor of a core */
+
+void interval_warmup(Op* op) {
+  uns            proc_id = op->proc_id;
+  Interval_Core* core    = &interval_model.cores[proc_id];
+  Addr           va      = op->oracle_info.va;
+  Addr           dummy_line_addr, repl_line_addr;
+
+  if(!cache_access(&core->icache, op->inst_info->addr, &dummy_line_addr,
+                   TRUE)) {
+    warmup_uncore(proc_id, op->inst_info->addr, FALSE);
+    cache_insert(&core->icache, proc_id, op->inst_info->addr,
+                 &dummy_line_addr, &repl_line_addr);
+  }
+
+  Flag is_load  = op->table_info->mem_type == MEM_LD;
+  Flag is_store = op->table_info->mem_type == MEM_ST;
+  if(is_load || is_store) {
+    if(CACHE_EXPLORE)
+      cache_explore_dcache_access(proc_id, va);
+    Dcache_Data* data = cache_access(&core->dcache, va, &dummy_line_addr,
+                                     TRUE);
+    if(data) {
+      data->dirty |= is_store;
+    } else {
+      warmup_uncore(proc_id, va, FALSE);
+      data = (Dcache_Data*)cache_insert(&core->dcache, proc_id, va,
+                                        &dummy_line_addr, &repl_line_addr);
+      if(data->dirty)
+        warmup_uncore(proc_id, repl_line_addr, TRUE);
+      memset(data, 0, sizeof(Dcache_Data));
+      data->dirty = is_store;
+    }
+  }
+
+  if(op->table_info->cf_type != NOT_CF) {
+    Bp_Data* bp_data = &interval_model.bp_data[proc_id];
+    bp_predict_op(bp_data, op, 1, op->inst_info->addr);
+    bp_target_known_op(bp_data, op);
+    bp_resolve_op(bp_data, op);
+    if(op->oracle_info.mispred || op->oracle_info.misfetch)
+      bp_recover_op(bp_data, op->table_info->cf_type, &op->recovery_info);
+    bp_data->bp->retire_func(op);
+  }
+}
+
+/**************************************************************************************/
+/* interval_init_bogus_sim: restart the trace of a core that finished (see
+   cmp_init_bogus_sim) */
+
+void interval_init_bogus_sim(uns8 proc_id) {
+  Interval_Core* core = &interval_model.cores[proc_id];
+
+  trace_read_done[proc_id] = FALSE;
+  reached_exit[proc_id]    = FALSE;
+  retired_exit[proc_id]    = FALSE;
+
+  interval_set_core(proc_id);
+  trace_close_trace_file(proc_id);
+  op_count[proc_id] = uop_count[proc_id] + 1;
+  trace_setup(proc_id);
+
+  for(; core->window_count; core->window_count--) {
+    free_op(core->window[core->window_head]);
+    core->window_head = (core->window_head + 1) % NODE_TABLE_SIZE;
+  }
+  core->branch_wait  = FALSE;
+  core->barrier_wait = FALSE;
+  core->fetch_cycle  = 0;
+  td->inst_addr      = trace_next_fetch_addr(proc_id);
+  reset_map();
+}
+
+/**************************************************************************************/
+/* interval_debug: */
+
+void interval_debug() {
+  for(uns8 proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Interval_Core* core = &interval_model.cores[proc_id];
+    FPRINT_LINE(proc_id, GLOBAL_DEBUG_STREAM);
+    fprintf(GLOBAL_DEBUG_STREAM,
+            "Core %u  window:%u  fetch_cycle:%s  branch_wait:%u  "
+            "icache_wait:%u  barrier_wait:%u\n",
+            proc_id, core->window_count, unsstr64(core->fetch_cycle),
+            core->branch_wait, core->icache_wait, core->barrier_wait);
+    FPRINT_LINE(proc_id, GLOBAL_DEBUG_STREAM);
+  }
+  debug_memory();
+}
+
+/**************************************************************************************/
+/* interval_per_core_done: */
+
+void interval_per_core_done(uns8 proc_id) {
+  stats_per_core_collect(proc_id);
+  if(PREF_FRAMEWORK_ON)
+    pref_per_core_done(proc_id);
+}
+
+/**************************************************************************************/
+/* interval_done: */
+
+void interval_done() {
+  if(PREF_FRAMEWORK_ON)
+    pref_done();
+  finalize_memory();
+}
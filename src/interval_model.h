@@ -0,0 +1,94 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : interval_model.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Interval (mechanistic) core model: cores dispatch the op
+ *                stream of the frontend into a reorder window and only model
+ *                the events that break the steady dispatch flow (branch
+ *                mispredictions, icache and dcache misses, full window), on
+ *                top of the real branch predictors and memory system
+ ***************************************************************************************/
+
+#ifndef __INTERVAL_MODEL_H__
+#define __INTERVAL_MODEL_H__
+
+#include "bp/bp.h"
+#include "libs/cache_lib.h"
+#include "memory/memory.h"
+#include "statistics.h"
+#include "thread.h"
+
+/**************************************************************************************/
+/* interval model data */
+
+typedef struct Interval_Core_struct {
+  uns8 proc_id;
+
+  Op** window;        // dispatched ops that did not retire, in program order
+  uns  window_head;   // index of the oldest op in window
+  uns  window_count;  // number of ops in window
+  Flag rescan;        // a miss returned (or could not be sent), schedule the
+                      // ops waiting for it
+
+  Counter   fetch_cycle;   // no dispatch before this cycle (refill, redirect)
+  Stat_Enum fetch_stall;   // stat counting the cycles before fetch_cycle
+  Flag      branch_wait;   // waiting for a mispredicted branch to resolve
+  Flag      barrier_wait;  // waiting for the window to drain (fetch barrier)
+  Flag      icache_wait;   // waiting for an icache miss
+  Addr      icache_line;   // line of the last icache hit
+
+  Cache icache;
+  Cache dcache;
+} Interval_Core;
+
+typedef struct Interval_Model_struct {
+  Memory memory;
+
+  Interval_Core*    cores;
+  Thread_Data*      thread_data;
+  Bp_Recovery_Info* bp_recovery_info;
+  Bp_Data*          bp_data;
+} Interval_Model;
+
+/**************************************************************************************/
+/* Global vars */
+
+Interval_Model        interval_model;
+extern Interval_Model interval_model;
+
+/**************************************************************************************/
+/* Prototypes */
+
+void interval_init(uns mode);
+void interval_reset(void);
+void interval_cycle(void);
+void interval_debug(void);
+void interval_per_core_done(uns8);
+void interval_done(void);
+void interval_warmup(Op*);
+void interval_init_bogus_sim(uns8);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __INTERVAL_MODEL_H__ */
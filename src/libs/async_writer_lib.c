@@ -0,0 +1,159 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/async_writer_lib.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Single producer, single consumer byte ring drained into a
+ *                file (or a compressor pipe) by a helper thread
+ ***************************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "libs/async_writer_lib.h"
+
+/**************************************************************************************/
+/* Types */
+
+struct Async_Writer_struct {
+  FILE* file;
+  Flag  piped;  // file is a compressor pipe
+  char* ring;
+  uns64 size;
+
+  uns64 head;        // bytes queued (written by the simulation thread)
+  uns64 tail;        // bytes written (written by the helper thread)
+  uns64 tail_cache;  // last tail seen by the simulation thread
+  Flag  done;
+
+  pthread_t thread;
+};
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static void* async_writer_main(void* arg);
+
+/**************************************************************************************/
+/* async_writer_open: */
+
+Async_Writer* async_writer_open(const char* filename, const char* compressor,
+                                uns buf_size) {
+  Async_Writer* writer = calloc(1, sizeof(Async_Writer));
+  ASSERTM(0, buf_size && !(buf_size & (buf_size - 1)),
+          "Async writer buffer size %u is not a power of 2\n", buf_size);
+
+  if(compressor && compressor[0]) {
+    char cmd[MAX_STR_LENGTH + 1];
+    snprintf(cmd, MAX_STR_LENGTH, "%s > %s", compressor, filename);
+    writer->file  = popen(cmd, "w");
+    writer->piped = TRUE;
+  } else {
+    writer->file = fopen(filename, "w");
+  }
+  ASSERTM(0, writer->file, "Could not open %s\n", filename);
+
+  writer->ring = malloc(buf_size);
+  writer->size = buf_size;
+  int err = pthread_create(&writer->thread, NULL, async_writer_main, writer);
+  ASSERTM(0, !err, "Could not start the writer thread for %s\n", filename);
+  return writer;
+}
+
+/**************************************************************************************/
+/* async_writer_put: */
+
+void async_writer_put(Async_Writer* writer, const void* data, uns size) {
+  const char* bytes = (const char*)data;
+  uns64       head  = writer->head;
+
+  while(size > 0) {
+    uns64 room = writer->size - (head - writer->tail_cache);
+    if(room == 0) {
+      /* wait for the helper thread to make space */
+      while((writer->tail_cache = __atomic_load_n(
+               &writer->tail, __ATOMIC_ACQUIRE)) == head - writer->size)
+        sched_yield();
+      continue;
+    }
+    uns64 pos = head & (writer->size - 1);
+    uns64 len = MIN3(size, room, writer->size - pos);
+    memcpy(&writer->ring[pos], bytes, len);
+    bytes += len;
+    size -= len;
+    head += len;
+    __atomic_store_n(&writer->head, head, __ATOMIC_RELEASE);
+  }
+}
+
+/**************************************************************************************/
+/* async_writer_close: */
+
+void async_writer_close(Async_Writer* writer) {
+  __atomic_store_n(&writer->done, TRUE, __ATOMIC_RELEASE);
+  pthread_join(writer->thread, NULL);
+  if(writer->piped)
+    pclose(writer->file);
+  else
+    fclose(writer->file);
+  free(writer->ring);
+  free(writer);
+}
+
+/**************************************************************************************/
+/* async_writer_main: helper thread, writes whatever has been queued */
+
+static void* async_writer_main(void* arg) {
+  Async_Writer*         writer = (Async_Writer*)arg;
+  uns64                 tail   = 0;
+  const struct timespec nap    = {0, 100000};
+
+  while(TRUE) {
+    uns64 head = __atomic_load_n(&writer->head, __ATOMIC_ACQUIRE);
+    if(tail == head) {
+      if(__atomic_load_n(&writer->done, __ATOMIC_ACQUIRE) &&
+         tail == __atomic_load_n(&writer->head, __ATOMIC_ACQUIRE))
+        break;
+      nanosleep(&nap, NULL);
+      continue;
+    }
+
+    uns64  pos     = tail & (writer->size - 1);
+    uns64  len     = MIN2(head - tail, writer->size - pos);
+    size_t written = fwrite(&writer->ring[pos], 1, len, writer->file);
+    ASSERTM(0, written == len, "Async writer could not write\n");
+    tail += len;
+    __atomic_store_n(&writer->tail, tail, __ATOMIC_RELEASE);
+  }
+  return NULL;
+}
@@ -0,0 +1,57 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/async_writer_lib.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Output files written by a helper thread: the simulation
+ *                thread only copies records into a lock-free ring, and
+ *                compression runs in a separate process
+ ***************************************************************************************/
+
+#ifndef __ASYNC_WRITER_LIB_H__
+#define __ASYNC_WRITER_LIB_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Async_Writer_struct Async_Writer;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Open filename for writing through a ring of buf_size bytes (a power of
+   2). With a compressor command (e.g. "gzip -1"), the file is the output of
+   the command. */
+Async_Writer* async_writer_open(const char* filename, const char* compressor,
+                                uns buf_size);
+
+/* Queue size bytes for writing (waits for the helper thread if the ring is
+   full, so nothing is ever dropped) */
+void async_writer_put(Async_Writer* writer, const void* data, uns size);
+
+/* Write everything queued, close the file and free the writer */
+void async_writer_close(Async_Writer* writer);
+
+#endif /* #ifndef __ASYNC_WRITER_LIB_H__ */
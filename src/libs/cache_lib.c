@@ -56,12 +56,17 @@ static inline uns  cache_index(Cache* cache, Addr addr, Addr* tag,
                                Addr* line_addr);
 static inline void update_repl_policy(Cache*, Cache_Entry*, uns, uns, Flag);
 static inline Cache_Entry* find_repl_entry(Cache*, uns8, uns, uns*);
+static Cache_Entry** alloc_cache_sets(uns num_sets, uns ways, uns data_size,
+                                     Flag slab_data);
 
 /* for ideal replacement */
 static inline void*        access_unsure_lines(Cache*, uns, Addr, Flag);
 static inline Cache_Entry* insert_sure_line(Cache*, uns, Addr);
 static inline void         invalidate_unsure_line(Cache*, uns, Addr);
 
+/* for dynamic insertion */
+static void dip_insert(Cache*, Cache_Entry*, uns);
+
 /**************************************************************************************/
 /* Global Variables */
 
@@ -82,6 +87,37 @@ uns ext_cache_index(Cache* cache, Addr addr, Addr* tag, Addr* line_addr) {
 }
 
 
+/**************************************************************************************/
+/* alloc_cache_sets: Allocates the lines of all sets in one zeroed array, and
+ * their data in another unless slab_data is off (the lines of REPL_IDEAL
+ * caches trade data pointers with the unsure lists, which free them). Large
+ * callocs come straight from the OS, so pages are only touched when used. */
+
+static Cache_Entry** alloc_cache_sets(uns num_sets, uns ways, uns data_size,
+                                      Flag slab_data) {
+  Cache_Entry** sets  = (Cache_Entry**)malloc(sizeof(Cache_Entry*) * num_sets);
+  Cache_Entry*  lines = (Cache_Entry*)calloc((size_t)num_sets * ways,
+                                            sizeof(Cache_Entry));
+  char*         data  = NULL;
+  size_t        ii;
+
+  if(data_size && slab_data)
+    data = (char*)calloc((size_t)num_sets * ways, data_size);
+
+  for(ii = 0; ii < num_sets; ii++)
+    sets[ii] = &lines[ii * ways];
+  for(ii = 0; ii < (size_t)num_sets * ways; ii++) {
+    if(!data_size)
+      lines[ii].data = INIT_CACHE_DATA_VALUE;
+    else if(data)
+      lines[ii].data = data + ii * data_size;
+    else
+      lines[ii].data = calloc(1, data_size);
+  }
+  return sets;
+}
+
+
 /**************************************************************************************/
 /* init_cache: */
 
@@ -89,7 +125,7 @@ void init_cache(Cache* cache, const char* name, uns cache_size, uns assoc,
                 uns line_size, uns data_size, Repl_Policy repl_policy) {
   uns num_lines = cache_size / line_size;
   uns num_sets  = cache_size / line_size / assoc;
-  uns ii, jj;
+  uns ii;
 
   DEBUG(0, "Initializing cache called '%s'.\n", name);
 
@@ -112,28 +148,14 @@ void init_cache(Cache* cache, const char* name, uns cache_size, uns assoc,
   /* allocate memory for NMRU replacement counters  */
   cache->repl_ctrs = (uns*)calloc(num_sets, sizeof(uns));
 
-  /* allocate memory for all the sets (pointers to line arrays)  */
-  cache->entries = (Cache_Entry**)malloc(sizeof(Cache_Entry*) * num_sets);
+  /* allocate memory for all of the lines and their data */
+  cache->entries = alloc_cache_sets(num_sets, assoc, data_size,
+                                    repl_policy != REPL_IDEAL);
 
   /* allocate memory for the unsure lists (if necessary) */
-  if(cache->repl_policy == REPL_IDEAL)
+  if(cache->repl_policy == REPL_IDEAL) {
     cache->unsure_lists = (List*)malloc(sizeof(List) * num_sets);
-
-  /* allocate memory for all of the lines in each set */
-  for(ii = 0; ii < num_sets; ii++) {
-    cache->entries[ii] = (Cache_Entry*)malloc(sizeof(Cache_Entry) * assoc);
-    /* allocate memory for all of the data elements in each line */
-    for(jj = 0; jj < assoc; jj++) {
-      cache->entries[ii][jj].valid = FALSE;
-      if(data_size) {
-        cache->entries[ii][jj].data = (void*)malloc(data_size);
-        memset(cache->entries[ii][jj].data, 0, data_size);
-      } else
-        cache->entries[ii][jj].data = INIT_CACHE_DATA_VALUE;
-    }
-
-    /* initialize the unsure lists (if necessary) */
-    if(cache->repl_policy == REPL_IDEAL) {
+    for(ii = 0; ii < num_sets; ii++) {
       char list_name[MAX_STR_LENGTH + 1];
       snprintf(list_name, MAX_STR_LENGTH, "%.*s unsure [%d]",
                MAX_STR_LENGTH - 20, cache->name, ii);  // 21 guaruntees the
@@ -157,43 +179,21 @@ void init_cache(Cache* cache, const char* name, uns cache_size, uns assoc,
 
   /* allocate memory for the back-up lists (if necessary) */
   if(cache->repl_policy == REPL_SHADOW_IDEAL) {
-    cache->shadow_entries = (Cache_Entry**)malloc(sizeof(Cache_Entry*) *
-                                                  num_sets);
-    /* allocate memory for all of the lines in each set */
-    for(ii = 0; ii < num_sets; ii++) {
-      cache->shadow_entries[ii] = (Cache_Entry*)malloc(sizeof(Cache_Entry) *
-                                                       assoc);
-      /* allocate memory for all of the data elements in each line */
-      for(jj = 0; jj < assoc; jj++) {
-        cache->shadow_entries[ii][jj].valid = FALSE;
-        if(data_size) {
-          cache->shadow_entries[ii][jj].data = (void*)malloc(data_size);
-          memset(cache->shadow_entries[ii][jj].data, 0, data_size);
-        } else
-          cache->shadow_entries[ii][jj].data = INIT_CACHE_DATA_VALUE;
-      }
-    }
+    cache->shadow_entries = alloc_cache_sets(num_sets, assoc, data_size, TRUE);
   }
 
   else if(cache->repl_policy == REPL_IDEAL_STORAGE) {
-    cache->shadow_entries = (Cache_Entry**)malloc(sizeof(Cache_Entry*) *
-                                                  num_sets);
-    cache->queue_end      = (uns*)malloc(sizeof(uns) * num_sets);
-    /* allocate memory for all of the lines in each set */
-    for(ii = 0; ii < num_sets; ii++) {
-      cache->shadow_entries[ii] = (Cache_Entry*)malloc(sizeof(Cache_Entry) *
-                                                       ideal_num_entries);
-      /* allocate memory for all of the data elements in each line */
-      for(jj = 0; jj < ideal_num_entries; jj++) {
-        cache->shadow_entries[ii][jj].valid = FALSE;
-        if(data_size) {
-          cache->shadow_entries[ii][jj].data = (void*)malloc(data_size);
-          memset(cache->shadow_entries[ii][jj].data, 0, data_size);
-        } else
-          cache->shadow_entries[ii][jj].data = INIT_CACHE_DATA_VALUE;
-      }
-      cache->queue_end[ii] = 0;
-    }
+    cache->shadow_entries = alloc_cache_sets(num_sets, ideal_num_entries,
+                                             data_size, TRUE);
+    cache->queue_end      = (uns*)calloc(num_sets, sizeof(uns));
+  }
+
+  if(cache->repl_policy == REPL_DIP) {
+    ASSERTM(0, num_sets >= 2 && DIP_BIP_EPSILON,
+            "REPL_DIP needs two sets and a non-zero DIP_BIP_EPSILON\n");
+    set_duel_init(&cache->dip_duel, num_sets,
+                  MIN2(DIP_LEADER_SETS, num_sets / 2), DIP_PSEL_BITS);
+    cache->dip_bip_ctr = 0;
   }
 }
 
@@ -314,6 +314,8 @@ void* cache_insert_replpos(Cache* cache, uns8 proc_id, Addr addr,
   switch(insert_repl_policy) {
     case INSERT_REPL_DEFAULT:
       update_repl_policy(cache, new_line, set, repl_index, TRUE);
+      if(cache->repl_policy == REPL_DIP)
+        dip_insert(cache, new_line, set);
       break;
     case INSERT_REPL_LRU:
       new_line->last_access_time = 123;  // Just choose a small number
@@ -463,7 +465,8 @@ Cache_Entry* find_repl_entry(Cache* cache, uns8 proc_id, uns set, uns* way) {
   int ii;
   switch(cache->repl_policy) {
     case REPL_SHADOW_IDEAL:
-    case REPL_TRUE_LRU: {
+    case REPL_TRUE_LRU:
+    case REPL_DIP: {
       uns     lru_ind  = 0;
       Counter lru_time = MAX_CTR;
       for(ii = 0; ii < cache->assoc; ii++) {
@@ -597,6 +600,7 @@ static inline void update_repl_policy(Cache* cache, Cache_Entry* cur_entry,
     case REPL_SHADOW_IDEAL:
     case REPL_TRUE_LRU:
     case REPL_PARTITION:
+    case REPL_DIP:
       cur_entry->last_access_time = sim_time;
       break;
     case REPL_RANDOM: {
@@ -654,6 +658,22 @@ static inline void update_repl_policy(Cache* cache, Cache_Entry* cur_entry,
 }
 
 
+/**************************************************************************************/
+/* dip_insert: dynamic insertion (Qureshi et al., ISCA 2007). A fill is a miss,
+   which trains the selector in a leader set. Policy A keeps the LRU insertion
+   at MRU. Policy B (bimodal) inserts at LRU, except one in DIP_BIP_EPSILON
+   fills, so that a working set larger than the cache keeps part of it
+   instead of thrashing the whole set. */
+
+static void dip_insert(Cache* cache, Cache_Entry* new_line, uns set) {
+  set_duel_miss(&cache->dip_duel, set);
+  if(!set_duel_use_b(&cache->dip_duel, set))
+    return;
+  if(++cache->dip_bip_ctr % DIP_BIP_EPSILON)
+    new_line->last_access_time = 0;
+}
+
+
 /**************************************************************************************/
 /* access_unsure_lines: */
 
@@ -31,6 +31,7 @@
 
 #include "globals/global_defs.h"
 #include "libs/list_lib.h"
+#include "libs/set_mon_lib.h"
 
 
 /**************************************************************************************/
@@ -54,6 +55,7 @@ typedef enum Repl_Policy_enum {
                          isn't stored at the cache */
   REPL_MLP,           /* mlp based replacement  -- uses MLP_REPL_POLICY */
   REPL_PARTITION,     /* Based on the partition*/
+  REPL_DIP,           /* LRU, set dueling of MRU and bimodal insertion */
   NUM_REPL
 } Repl_Policy;
 
@@ -119,6 +121,9 @@ typedef struct Cache_struct {
   uns*     num_ways_occupied_core; /* For cache partitioning */
   uns*     lru_index_core;         /* For cache partitioning */
   Counter* lru_time_core;          /* For cache partitioning */
+
+  Set_Duel dip_duel;    /* For REPL_DIP: MRU (A) or bimodal (B) insertion */
+  uns      dip_bip_ctr; /* For REPL_DIP: bimodal insertions so far */
 } Cache;
 
 
@@ -27,11 +27,16 @@
  ***************************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "debug/debug_macros.h"
 #include "globals/assert.h"
 #include "globals/global_defs.h"
 #include "globals/global_types.h"
 #include "globals/global_vars.h"
+#include "globals/utils.h"
 
 #include "libs/hash_lib.h"
 #include "libs/malloc_lib.h"
@@ -42,21 +47,168 @@
 /**************************************************************************************/
 /* Macros */
 
-#define DEBUG(args...) _DEBUG(DEBUG_HASH_LIB, ##args)
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_HASH_LIB, ##args)
 
-#define HASH_INDEX(table, key) (((uns)(key)) % (table)->buckets)
+#define HASH_GROUP_SIZE 16
+#define HASH_MIN_SLOTS HASH_GROUP_SIZE
+#define HASH_MAX_INIT_SLOTS 4096 /* larger tables grow on demand */
+#define HASH_CTRL_EMPTY ((uns8)0x80)
+#define HASH_CTRL_DELETED ((uns8)0xfe)
+#define HASH_MAX_LOAD(slots) ((slots) / 8 * 7)
+
+#define HASH_TAG(hash) ((uns8)((hash)&0x7f))
+#define HASH_NUM_GROUPS(table) ((table)->buckets / HASH_GROUP_SIZE)
+#define HASH_FIRST_GROUP(table, hash) \
+  ((uns)((hash) >> 7) & (HASH_NUM_GROUPS(table) - 1))
+
+
+/**************************************************************************************/
+/* Prototypes */
+
+static void hash_table_alloc_slots(Hash_Table* table, uns slots);
+static void hash_table_resize(Hash_Table* table, uns slots);
 
 
 /**************************************************************************************/
-// Global variables
+/* Local inline functions */
+
+/* keys are often aligned addresses, so mix all their bits (murmur3
+   finalizer) */
+static inline uns64 hash_key(int64 key) {
+  uns64 hash = (uns64)key;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/* bit ii of the result is set if control byte ii of the group equals byte */
+static inline uns hash_group_match(uns8 const* ctrl, uns8 byte) {
+#ifdef __SSE2__
+  __m128i group = _mm_load_si128((__m128i const*)ctrl);
+  return (uns)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte)));
+#else
+  uns mask = 0;
+  uns ii;
+  for(ii = 0; ii < HASH_GROUP_SIZE; ii++)
+    mask |= (uns)(ctrl[ii] == byte) << ii;
+  return mask;
+#endif
+}
+
+/* bit ii of the result is set if slot ii of the group is empty or deleted */
+static inline uns hash_group_match_free(uns8 const* ctrl) {
+#ifdef __SSE2__
+  return (uns)_mm_movemask_epi8(_mm_load_si128((__m128i const*)ctrl));
+#else
+  uns mask = 0;
+  uns ii;
+  for(ii = 0; ii < HASH_GROUP_SIZE; ii++)
+    mask |= (uns)(ctrl[ii] >> 7) << ii;
+  return mask;
+#endif
+}
+
+/* returns the slot holding key (whose data also matches 'data' under eq_func,
+   if data is given), or -1. Groups are visited in triangular order, which
+   covers all of them since their number is a power of two. */
+static inline int hash_table_find(Hash_Table const* table, int64 key,
+                                  void const* data, uns64 hash) {
+  uns group = HASH_FIRST_GROUP(table, hash);
+  uns step  = 0;
+
+  while(TRUE) {
+    uns8 const* ctrl  = table->ctrl + group * HASH_GROUP_SIZE;
+    uns         match = hash_group_match(ctrl, HASH_TAG(hash));
+    while(match) {
+      uns               slot  = group * HASH_GROUP_SIZE + __builtin_ctz(match);
+      Hash_Table_Entry* entry = &table->entries[slot];
+      if(entry->key == key && (!data || table->eq_func(entry->data, data)))
+        return slot;
+      match &= match - 1;
+    }
+    if(hash_group_match(ctrl, HASH_CTRL_EMPTY))
+      return -1;
+    step++;
+    ASSERT(0, step <= HASH_NUM_GROUPS(table));
+    group = (group + step) & (HASH_NUM_GROUPS(table) - 1);
+  }
+}
+
+/* returns the first empty or deleted slot on the probe sequence of hash */
+static inline uns hash_table_find_free(Hash_Table const* table, uns64 hash) {
+  uns group = HASH_FIRST_GROUP(table, hash);
+  uns step  = 0;
+
+  while(TRUE) {
+    uns free = hash_group_match_free(table->ctrl + group * HASH_GROUP_SIZE);
+    if(free)
+      return group * HASH_GROUP_SIZE + __builtin_ctz(free);
+    step++;
+    ASSERT(0, step <= HASH_NUM_GROUPS(table));
+    group = (group + step) & (HASH_NUM_GROUPS(table) - 1);
+  }
+}
+
+/* claims a free slot for key, growing the table first if needed */
+static inline Hash_Table_Entry* hash_table_insert(Hash_Table* table,
+                                                  int64 key, uns64 hash) {
+  uns slot;
+
+  if(table->count + table->tombstones + 1 > HASH_MAX_LOAD(table->buckets)) {
+    /* mostly tombstones: rebuild at the same size, otherwise double */
+    if((table->count + 1) * 2 > HASH_MAX_LOAD(table->buckets))
+      hash_table_resize(table, table->buckets * 2);
+    else
+      hash_table_resize(table, table->buckets);
+  }
+
+  slot = hash_table_find_free(table, hash);
+  if(table->ctrl[slot] == HASH_CTRL_DELETED)
+    table->tombstones--;
+  table->ctrl[slot]         = HASH_TAG(hash);
+  table->entries[slot].key  = key;
+  table->entries[slot].data = NULL;
+  table->count++;
+  return &table->entries[slot];
+}
 
-#define NUM_HASH_TABLE_PRIMES 12
-static uns const hash_table_primes[NUM_HASH_TABLE_PRIMES] = {
-  1, 5, 11, 23, 47, 101, 211, 401, 811, 1601, 3209, 6373};
+/* releases a slot. A slot whose group still has an empty slot can become
+   empty again, since no probe sequence ever went past that group. */
+static inline void hash_table_remove(Hash_Table* table, uns slot) {
+  uns8 const* ctrl = table->ctrl + ROUND_DOWN(slot, HASH_GROUP_SIZE);
+
+  if(!table->external_data)
+    sfree(table->data_size, table->entries[slot].data);
+  if(hash_group_match(ctrl, HASH_CTRL_EMPTY))
+    table->ctrl[slot] = HASH_CTRL_EMPTY;
+  else {
+    table->ctrl[slot] = HASH_CTRL_DELETED;
+    table->tombstones++;
+  }
+  table->count--;
+  ASSERT(0, table->count >= 0);
+}
+
+/* allocates the data of a new entry */
+static inline void* hash_table_new_data(Hash_Table* table,
+                                        Hash_Table_Entry* entry) {
+  ASSERTM(0, !table->external_data,
+          "Hash table '%s' holds data from hash_table_access_replace\n",
+          table->name);
+  entry->data = smalloc(table->data_size);
+  ASSERT(0, entry->data);
+  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
+          (unsigned long int)table->data_size, table->name, table->count);
+  return entry->data;
+}
 
 
 /**************************************************************************************/
-/* init_hash_table: */
+/* init_hash_table: 'buckets' is a hint of how many entries the table will
+   hold, the table grows as needed */
 
 void init_hash_table(Hash_Table* table, const char* name, uns buckets,
                      uns data_size) {
@@ -66,13 +218,66 @@ void init_hash_table(Hash_Table* table, const char* name, uns buckets,
 void init_complex_hash_table(Hash_Table* table, const char* name, uns buckets,
                              uns data_size,
                              Flag (*eq_func)(void const*, void const*)) {
-  table->name      = strdup(name);
-  table->buckets   = buckets;
-  table->data_size = data_size;
-  table->count     = 0;
-  table->entries   = (Hash_Table_Entry**)calloc(buckets,
-                                              sizeof(Hash_Table_Entry*));
-  table->eq_func   = eq_func;
+  uns slots = HASH_MIN_SLOTS;
+
+  while(slots < MIN2(buckets, HASH_MAX_INIT_SLOTS))
+    slots <<= 1;
+
+  table->name          = strdup(name);
+  table->data_size     = data_size;
+  table->count         = 0;
+  table->tombstones    = 0;
+  table->external_data = FALSE;
+  table->eq_func       = eq_func;
+  hash_table_alloc_slots(table, slots);
+}
+
+
+/**************************************************************************************/
+/* hash_table_alloc_slots: */
+
+static void hash_table_alloc_slots(Hash_Table* table, uns slots) {
+  void* ctrl;
+
+  ASSERT(0, slots >= HASH_MIN_SLOTS && !(slots & (slots - 1)));
+  ASSERTM(0, !posix_memalign(&ctrl, HASH_GROUP_SIZE, slots),
+          "Could not allocate %u slots for hash table '%s'\n", slots,
+          table->name);
+  memset(ctrl, HASH_CTRL_EMPTY, slots);
+  table->ctrl    = (uns8*)ctrl;
+  table->entries = (Hash_Table_Entry*)malloc(slots * sizeof(Hash_Table_Entry));
+  ASSERT(0, table->entries);
+  table->buckets = slots;
+}
+
+
+/**************************************************************************************/
+/* hash_table_resize: move every entry to a fresh array of 'slots' slots,
+   dropping tombstones. The data of the entries does not move. */
+
+static void hash_table_resize(Hash_Table* table, uns slots) {
+  uns8*             old_ctrl    = table->ctrl;
+  Hash_Table_Entry* old_entries = table->entries;
+  uns               old_slots   = table->buckets;
+  uns               ii;
+
+  DEBUG(0, "Resizing hash table '%s' from %u to %u slots (%d entries)\n",
+        table->name, old_slots, slots, table->count);
+  ASSERT(0, HASH_MAX_LOAD(slots) > (uns)table->count);
+  hash_table_alloc_slots(table, slots);
+  table->tombstones = 0;
+
+  for(ii = 0; ii < old_slots; ii++) {
+    if(!(old_ctrl[ii] & 0x80)) {
+      uns64 hash = hash_key(old_entries[ii].key);
+      uns   slot = hash_table_find_free(table, hash);
+      table->ctrl[slot]    = HASH_TAG(hash);
+      table->entries[slot] = old_entries[ii];
+    }
+  }
+
+  free(old_ctrl);
+  free(old_entries);
 }
 
 
@@ -82,121 +287,50 @@ void init_complex_hash_table(Hash_Table* table, const char* name, uns buckets,
 
 
 void* hash_table_access(Hash_Table const* table, int64 key) {
-  // {{{ access hash table using simple key compare
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-
-  for(temp = bucket; temp != NULL; temp = temp->next)
-    if(temp->key == key)
-      return temp->data;
-
-  return NULL;
-  // }}}
+  int slot = hash_table_find(table, key, NULL, hash_key(key));
+  return slot >= 0 ? table->entries[slot].data : NULL;
 }
 
 void* complex_hash_table_access(Hash_Table const* table, int64 key,
                                 void const* data) {
-  // {{{ access hash table using a complex comparison
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
+  int slot;
 
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
 
-  for(temp = bucket; temp != NULL; temp = temp->next)
-    if(temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
-
-  return NULL;
-  // }}}
+  slot = hash_table_find(table, key, data, hash_key(key));
+  return slot >= 0 ? table->entries[slot].data : NULL;
 }
 
 
 /**************************************************************************************/
 /* hash_table_access_create: access the hash table.  Return the data
-   pointer if it hits an existing entry.  Otherwise, allocate a new
-   entry and return its data pointer. */
+   pointer if it hits, otherwise create a new entry and return its data
+   pointer. */
 
 void* hash_table_access_create(Hash_Table* table, int64 key, Flag* new_entry) {
-  // {{{ access hash table using simple key compare
-  uns               index    = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket   = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
-  *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key)
-      return temp->data;
-    else
-      prev = temp;
-  }
-  table->count++;
-  *new_entry = TRUE;
-  new_hash   = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key  = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if(prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size,
-          table->name, table->count);
+  uns64 hash = hash_key(key);
+  int   slot = hash_table_find(table, key, NULL, hash);
 
-  return new_hash->data;
-  // }}}
+  *new_entry = slot < 0;
+  if(slot >= 0)
+    return table->entries[slot].data;
+  return hash_table_new_data(table, hash_table_insert(table, key, hash));
 }
 
 void* complex_hash_table_access_create(Hash_Table* table, int64 key,
                                        void const* data, Flag* new_entry) {
-  // {{{ access hash table using a complex comparison
-  uns               index    = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket   = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
+  uns64 hash = hash_key(key);
+  int   slot;
 
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
 
-  *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
-    else
-      prev = temp;
-  }
-  table->count++;
-  *new_entry = TRUE;
-  new_hash   = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key  = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if(prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size,
-          table->name, table->count);
-
-  return new_hash->data;
-  // }}}
+  slot       = hash_table_find(table, key, data, hash);
+  *new_entry = slot < 0;
+  if(slot >= 0)
+    return table->entries[slot].data;
+  return hash_table_new_data(table, hash_table_insert(table, key, hash));
 }
 
 
@@ -205,61 +339,26 @@ void* complex_hash_table_access_create(Hash_Table* table, int64 key,
    TRUE if it was found, FALSE otherwise */
 
 Flag hash_table_access_delete(Hash_Table* table, int64 key) {
-  // {{{ access hash table using simple key compare
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if(prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
+  int slot = hash_table_find(table, key, NULL, hash_key(key));
 
-  return FALSE;
-  // }}}
+  if(slot < 0)
+    return FALSE;
+  hash_table_remove(table, slot);
+  return TRUE;
 }
 
 Flag complex_hash_table_access_delete(Hash_Table* table, int64 key,
                                       void const* data) {
-  // {{{ access hash table using a complex comparison
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
+  int slot;
 
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
 
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key && table->eq_func(temp->data, data)) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if(prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
-
-  return FALSE;
-  // }}}
+  slot = hash_table_find(table, key, data, hash_key(key));
+  if(slot < 0)
+    return FALSE;
+  hash_table_remove(table, slot);
+  return TRUE;
 }
 
 
@@ -267,24 +366,20 @@ Flag complex_hash_table_access_delete(Hash_Table* table, int64 key,
 /* hash_table_clear: */
 
 void hash_table_clear(Hash_Table* table) {
-  Hash_Table_Entry* temp0;
-  Hash_Table_Entry* temp1;
-  uns               count = 0;
-  int               ii;
+  uns count = 0;
+  uns ii;
 
   for(ii = 0; ii < table->buckets; ii++) {
-    temp0 = table->entries[ii];
-    while(temp0) {
-      temp1 = temp0->next;
-      sfree(table->data_size, temp0->data);
-      sfree(sizeof(Hash_Table_Entry), temp0);
-      temp0 = temp1;
+    if(!(table->ctrl[ii] & 0x80)) {
+      if(!table->external_data)
+        sfree(table->data_size, table->entries[ii].data);
       count++;
     }
-    table->entries[ii] = NULL;
   }
   ASSERT(0, count == table->count);
-  table->count = 0;
+  memset(table->ctrl, HASH_CTRL_EMPTY, table->buckets);
+  table->count      = 0;
+  table->tombstones = 0;
 }
 
 
@@ -294,10 +389,9 @@ void hash_table_clear(Hash_Table* table) {
  */
 
 void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
-  Hash_Table_Entry* temp;
-  void**            new_array;
-  uns               count = 0;
-  int               ii;
+  void** new_array;
+  uns    count = 0;
+  uns    ii;
 
   if(table->count == 0)
     return NULL;
@@ -310,14 +404,9 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
   }
 
   /* write into the new array */
-  count = 0;
-  for(ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while(temp) {
-      new_array[count++] = temp->data;
-      temp               = temp->next;
-    }
-  }
+  for(ii = 0; ii < table->buckets; ii++)
+    if(!(table->ctrl[ii] & 0x80))
+      new_array[count++] = table->entries[ii].data;
 
   ASSERTM(0, count == table->count, "%d %d\n", count, table->count);
   ASSERTM(0, count > 0, "%d %d\n", count, table->count);
@@ -332,9 +421,8 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
 
 void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*),
                      void*       arg) {
-  int               count = 0;
-  Hash_Table_Entry* temp;
-  int               ii;
+  int count = 0;
+  uns ii;
 
   ASSERT(0, scan_func);
 
@@ -342,11 +430,9 @@ void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*),
     return;
 
   for(ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while(temp) {
+    if(!(table->ctrl[ii] & 0x80)) {
       count++;
-      scan_func(temp->data, arg);
-      temp = temp->next;
+      scan_func(table->entries[ii].data, arg);
     }
   }
   ASSERT(0, count == table->count);
@@ -354,55 +440,19 @@ void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*),
 
 
 /**************************************************************************************/
-// hash_table_rehash: expand or contract the hash table
-// WARNING: this hasn't really been tested
+// hash_table_rehash: resize the table to hold at least new_buckets slots (0
+// doubles it). Tables also grow on their own as entries are added.
 
 void hash_table_rehash(Hash_Table* table, int new_buckets) {
-  Hash_Table_Entry** new_entries;
-  Hash_Table_Entry** flat_entries;
-  Hash_Table_Entry** old_entries = table->entries;
-  uns                old_buckets = table->buckets;
-  Hash_Table_Entry*  temp;
-  uns                ii, jj;
+  uns slots = HASH_MIN_SLOTS;
 
   ASSERT(0, new_buckets >= 0);
-  if(new_buckets == 0) {  // use next prime
-    new_buckets = table->buckets;
-    for(ii = 0; ii < NUM_HASH_TABLE_PRIMES - 1; ii++)
-      if(hash_table_primes[ii] == old_buckets) {
-        new_buckets = hash_table_primes[ii + 1];
-        break;
-      }
-  }
-  if(new_buckets == old_buckets)
-    return;
-
-  // flatten hash table into an array of entries
-  flat_entries = (Hash_Table_Entry**)malloc(table->count *
-                                            sizeof(Hash_Table_Entry*));
-  for(ii = 0, jj = 0; ii < old_buckets; ii++)
-    for(temp = old_entries[ii]; temp; temp = temp->next)
-      flat_entries[jj++] = temp;
-  ASSERT(0, jj == table->count);
-
-  // replace old with new and free the old entry array
-  new_entries = (Hash_Table_Entry**)calloc(new_buckets,
-                                           sizeof(Hash_Table_Entry*));
-  ASSERT(0, new_entries);
-  ASSERT(0, new_buckets > 0 && new_buckets < 100000);
-  table->buckets = new_buckets;
-  table->entries = new_entries;
-  free(old_entries);
-
-  // insert each element
-  for(ii = 0; ii < table->count; ii++) {
-    Hash_Table_Entry* temp  = flat_entries[ii];
-    uns               index = HASH_INDEX(table, temp->key);
-    temp->next              = table->entries[index];
-    table->entries[index]   = temp;
-  }
-
-  free(flat_entries);
+  if(new_buckets == 0)
+    new_buckets = table->buckets * 2;
+  while(slots < (uns)new_buckets || HASH_MAX_LOAD(slots) <= (uns)table->count)
+    slots <<= 1;
+  if(slots != table->buckets)
+    hash_table_resize(table, slots);
 }
 
 /**************************************************************************************/
@@ -411,42 +461,20 @@ void hash_table_rehash(Hash_Table* table, int new_buckets) {
 //                            if it doesn't exist yet
 void hash_table_access_replace(Hash_Table* table, int64 key,
                                void* replacement) {
-  // {{{ access hash table using simple key compare
-  uns               index    = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket   = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev      = NULL;
-  Flag              new_entry = FALSE;
-  UNUSED(new_entry);
+  uns64 hash = hash_key(key);
+  int   slot;
+
   ASSERT(0, replacement);
-  ASSERT(0, index < table->buckets);
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key) {
-      /* May not want to free the memory in case there are other valid pointers
-         to it. ASSERT(0,temp->data); free(table->data_size, temp->data);
-      */
-      temp->data = replacement;
-      return;
-    } else {
-      prev = temp;
-    }
+  ASSERTM(0, table->external_data || table->count == 0,
+          "Hash table '%s' already holds its own data\n", table->name);
+  table->external_data = TRUE;
+
+  slot = hash_table_find(table, key, NULL, hash);
+  if(slot >= 0) {
+    /* May not want to free the memory in case there are other valid pointers
+       to it. */
+    table->entries[slot].data = replacement;
+    return;
   }
-  table->count++;
-  new_entry = TRUE;
-  new_hash  = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key  = key;
-  new_hash->next = NULL;
-  new_hash->data = replacement;
-
-  if(prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry), table->name,
-          table->count);
-  // }}}
+  hash_table_insert(table, key, hash)->data = replacement;
 }
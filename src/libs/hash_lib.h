@@ -23,7 +23,13 @@
  * File         : libs/hash_lib.h
  * Author       : HPS Research Group
  * Date         : 9/22/1998
- * Description  :
+ * Description  : Open-addressing hash table keyed by int64.
+ *
+ * Slots are probed a 16-slot group at a time: a control byte per slot holds
+ * 7 bits of the key's hash (or EMPTY/DELETED) and a whole group is compared
+ * with one SSE2 instruction. The table doubles when it is 7/8 full. Each
+ * entry's data is a separate arena allocation that never moves, so pointers
+ * returned by the access functions stay valid until the entry is deleted.
  ***************************************************************************************/
 
 #ifndef __HASH_LIB_H__
@@ -36,17 +42,19 @@
 /* Types */
 
 typedef struct Hash_Table_Entry_struct {
-  int64                           key;
-  void*                           data;
-  struct Hash_Table_Entry_struct* next;
+  int64 key;
+  void* data;
 } Hash_Table_Entry;
 
 typedef struct Hash_Table_struct {
-  char*              name;
-  uns                buckets;
-  uns                data_size;
-  int                count;  // total number of elements in the hash table
-  Hash_Table_Entry** entries;
+  char*             name;
+  uns               buckets;  // number of slots (a power of two, >= 16)
+  uns               data_size;
+  int               count;       // total number of elements in the hash table
+  uns               tombstones;  // deleted slots that still end probe chains
+  uns8*             ctrl;        // one control byte per slot
+  Hash_Table_Entry* entries;
+  Flag              external_data;  // data comes from hash_table_access_replace
   Flag (*eq_func)(void const* const, void const* const);
 } Hash_Table;
 
@@ -70,6 +78,8 @@ void** hash_table_flatten(Hash_Table*, void**);
 void   hash_table_scan(Hash_Table*, void (*)(void*, void*), void*);
 void   hash_table_rehash(Hash_Table*, int);
 
+/* Tables filled with hash_table_access_replace hold caller-owned data, which
+   is never freed by the table. Do not mix it with the _create functions. */
 void hash_table_access_replace(Hash_Table*, int64, void*);
 /**************************************************************************************/
 
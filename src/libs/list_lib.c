@@ -45,6 +45,8 @@
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_LIST_LIB, ##args)
 #define DEBUGU(proc_id, args...) _DEBUGU(proc_id, DEBUG_LIST_LIB, ##args)
 #define FREE_LIST_ALLOC_SIZE 8
+#define LIST_ENTRY_SIZE(list) \
+  (sizeof(List_Entry) + (list)->data_size - sizeof(char))
 #define VERIFY_LIST_COUNTS FALSE
 
 
@@ -91,7 +93,7 @@ void clear_list(List* list) {
       List_Entry *temp0, *temp1;
       for(temp0 = list->head; temp0 != NULL; temp0 = temp1) {
         temp1 = temp0->next;
-        free(temp0);
+        sfree(LIST_ENTRY_SIZE(list), temp0);
       }
     }
     list->head  = NULL;
@@ -122,7 +124,7 @@ void clip_list_at_current(List* list) {
       List_Entry *temp0, *temp1;
       for(temp0 = list->current->next; temp0 != NULL; temp0 = temp1) {
         temp1 = temp0->next;
-        free(temp0);
+        sfree(LIST_ENTRY_SIZE(list), temp0);
       }
     }
     list->tail       = list->current;
@@ -148,10 +150,10 @@ static inline List_Entry* get_list_entry(List* list) {
       return temp;
     }
 
-    size = sizeof(List_Entry) + list->data_size - sizeof(char);
+    size = LIST_ENTRY_SIZE(list);
 
     ASSERT(0, FREE_LIST_ALLOC_SIZE > 1);
-    rval = (List_Entry*)malloc(size * FREE_LIST_ALLOC_SIZE);
+    rval = (List_Entry*)smalloc(size * FREE_LIST_ALLOC_SIZE);
     ASSERT(0, rval);
     temp       = (List_Entry*)((char*)rval + size);
     list->free = temp;
@@ -167,8 +169,8 @@ static inline List_Entry* get_list_entry(List* list) {
     }
     temp->next = NULL;
   } else {
-    size = sizeof(List_Entry) + list->data_size - sizeof(char);
-    rval = (List_Entry*)malloc(size);
+    size = LIST_ENTRY_SIZE(list);
+    rval = (List_Entry*)smalloc(size);
     ASSERT(0, rval);
     list->total_count++;
   }
@@ -186,7 +188,7 @@ static inline void free_list_entry(List* list, List_Entry* entry) {
     list->free  = entry;
     list->free_count++;
   } else {
-    free(entry);
+    sfree(LIST_ENTRY_SIZE(list), entry);
     list->total_count--;
   }
   list->count--;
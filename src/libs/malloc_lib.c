@@ -23,97 +23,172 @@
  * File         : libs/malloc_lib.c
  * Author       : HPS Research Group
  * Date         : 3/14/2000
- * Description  : A faster malloc for small repetitive allocations
+ * Description  : Slab allocator for small repetitive allocations
  ***************************************************************************************/
-#include "libs/malloc_lib.h"
+
+#include <stdlib.h>
+#include <string.h>
+
 #include "debug/debug_macros.h"
 #include "globals/assert.h"
 #include "globals/global_defs.h"
 #include "globals/global_types.h"
 #include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "general.param.h"
+#include "libs/malloc_lib.h"
+#include "statistics.h"
 
-/* Defines */
-#define MAX_SMALLOC 32768
-#define WRAPPER_BLOCK 1024
-#define SMALLOC_BLOCK (0x1 << 20)
+/**************************************************************************************/
+/* Macros */
+
+#define SLAB_ALIGN 64           /* slabs and their first object on a line */
+#define SLAB_BYTES (64 << 10)   /* target size of one slab */
+#define SLAB_MIN_OBJS 16        /* objects per slab when they are large */
+#define ARENA_GRANULE 16        /* size classes are multiples of this */
+#define ARENA_MAX_ALLOC 32768   /* largest arena allocation */
+#define ARENA_NUM_CLASSES (ARENA_MAX_ALLOC / ARENA_GRANULE)
 
+/**************************************************************************************/
 /* Global Variables */
-static char*          raw_mem_ptr       = NULL;
-static int            raw_mem_size      = 0;
-static SMalloc_Entry* wrapper_free_list = NULL;
-static SMalloc_Entry* smalloc_free_list[MAX_SMALLOC];
 
-static inline SMalloc_Entry* get_wrapper();
-static inline void           free_wrapper(SMalloc_Entry* wrap);
+static Slab_Pool* arenas[MAX_NUM_PROCS];     /* size-class pools per core */
+static Slab_Pool* pool_lists[MAX_NUM_PROCS]; /* every pool of a core */
+static Counter    reported_peak_bytes[MAX_NUM_PROCS];
+
+/**************************************************************************************/
+/* slab_pool_init: objects are never smaller than the free list link, and
+   init_func (if given) runs once on each object when its slab is allocated */
+
+void slab_pool_init(Slab_Pool* pool, const char* name, uns proc_id,
+                    uns obj_size, uns link_offset, void (*init_func)(void*)) {
+  ASSERT(proc_id, proc_id < MAX_NUM_PROCS);
+  ASSERT(proc_id,
+         link_offset + sizeof(void*) <= MAX2(obj_size, sizeof(void*)));
+  memset(pool, 0, sizeof(Slab_Pool));
+  pool->name          = name;
+  pool->proc_id       = proc_id;
+  pool->obj_size      = ROUND_UP(MAX2(obj_size, sizeof(void*)), sizeof(void*));
+  pool->objs_per_slab = MAX2(SLAB_BYTES / pool->obj_size, SLAB_MIN_OBJS);
+  pool->link_offset   = link_offset;
+  pool->init_func     = init_func;
+
+  pool->next_pool     = pool_lists[proc_id];
+  pool_lists[proc_id] = pool;
+}
 
 /**************************************************************************************/
-/* get_wrapper */
-static inline SMalloc_Entry* get_wrapper() {
-  SMalloc_Entry* tmp;
-
-  if(wrapper_free_list == NULL) {
-    char* wrap_mem = (char*)malloc(sizeof(SMalloc_Entry) * WRAPPER_BLOCK);
-    SMalloc_Entry* cur_wrap;
-    int            ii;
-    ASSERT(0, wrap_mem);
-    for(ii = 0; ii < WRAPPER_BLOCK; ii++) {
-      cur_wrap          = (SMalloc_Entry*)wrap_mem;
-      cur_wrap->next    = wrapper_free_list;
-      wrapper_free_list = cur_wrap;
-      wrap_mem += sizeof(SMalloc_Entry);
-    }
+/* slab_pool_refill: allocate a new slab and put all its objects on the free
+   list in address order */
+
+void slab_pool_refill(Slab_Pool* pool) {
+  uns   bytes = SLAB_ALIGN + pool->objs_per_slab * pool->obj_size;
+  void* slab;
+  char* obj;
+  int   ii;
+
+  ASSERT(pool->proc_id, pool->free_head == NULL);
+  ASSERTM(pool->proc_id, !posix_memalign(&slab, SLAB_ALIGN, bytes),
+          "Could not allocate a %u-byte slab for pool '%s'\n", bytes,
+          pool->name);
+  *(void**)slab = pool->slabs;
+  pool->slabs   = slab;
+  pool->num_slabs++;
+
+  obj = (char*)slab + SLAB_ALIGN;
+  for(ii = pool->objs_per_slab - 1; ii >= 0; ii--) {
+    void* cur = obj + ii * pool->obj_size;
+    if(pool->init_func)
+      pool->init_func(cur);
+    SLAB_LINK(pool, cur) = pool->free_head;
+    pool->free_head      = cur;
   }
-  tmp               = wrapper_free_list;
-  wrapper_free_list = wrapper_free_list->next;
-  return tmp;
 }
 
 /**************************************************************************************/
-/* free_wrapper */
-static inline void free_wrapper(SMalloc_Entry* wrap) {
-  wrap->next        = wrapper_free_list;
-  wrapper_free_list = wrap;
+/* arena_pool: the pool of proc_id's arena that serves nbytes */
+
+static inline Slab_Pool* arena_pool(uns proc_id, uns nbytes) {
+  uns        size_class = nbytes ? (nbytes - 1) / ARENA_GRANULE : 0;
+  Slab_Pool* pool;
+
+  ASSERTM(proc_id, nbytes <= ARENA_MAX_ALLOC,
+          "Arena allocations are limited to %d bytes (%u requested)\n",
+          ARENA_MAX_ALLOC, nbytes);
+  if(!arenas[proc_id]) {
+    arenas[proc_id] = (Slab_Pool*)calloc(ARENA_NUM_CLASSES, sizeof(Slab_Pool));
+    ASSERT(proc_id, arenas[proc_id]);
+  }
+  pool = &arenas[proc_id][size_class];
+  if(!pool->obj_size)
+    slab_pool_init(pool, "arena", proc_id, (size_class + 1) * ARENA_GRANULE, 0,
+                   NULL);
+  return pool;
+}
+
+/**************************************************************************************/
+/* arena_alloc: */
+
+void* arena_alloc(uns proc_id, uns nbytes) {
+  if(ARENA_USE_MALLOC)
+    return malloc(MAX2(nbytes, 1));
+  return slab_alloc(arena_pool(proc_id, nbytes));
+}
+
+/**************************************************************************************/
+/* arena_free: nbytes must match the size passed to arena_alloc */
+
+void arena_free(uns proc_id, uns nbytes, void* ptr) {
+  if(ARENA_USE_MALLOC) {
+    free(ptr);
+    return;
+  }
+  slab_free(arena_pool(proc_id, nbytes), ptr);
+}
+
+/**************************************************************************************/
+/* update_arena_stats: add the allocator activity since the last call to the
+   ARENA_* stats of proc_id. Called before the stats are dumped. */
+
+void update_arena_stats(uns proc_id) {
+  Slab_Pool* pool;
+  Counter    peak_bytes = 0;
+
+  for(pool = pool_lists[proc_id]; pool; pool = pool->next_pool) {
+    INC_STAT_EVENT(proc_id, ARENA_ALLOCS, pool->allocs - pool->reported_allocs);
+    INC_STAT_EVENT(proc_id, ARENA_FREES, pool->frees - pool->reported_frees);
+    INC_STAT_EVENT(proc_id, ARENA_SLABS,
+                   pool->num_slabs - pool->reported_slabs);
+    INC_STAT_EVENT(proc_id, ARENA_SLAB_BYTES,
+                   (pool->num_slabs - pool->reported_slabs) *
+                     (SLAB_ALIGN + pool->objs_per_slab * pool->obj_size));
+    pool->reported_allocs = pool->allocs;
+    pool->reported_frees  = pool->frees;
+    pool->reported_slabs  = pool->num_slabs;
+    peak_bytes += pool->peak_live * pool->obj_size;
+  }
+
+  if(peak_bytes > reported_peak_bytes[proc_id]) {
+    INC_STAT_EVENT(proc_id, ARENA_PEAK_LIVE_BYTES,
+                   peak_bytes - reported_peak_bytes[proc_id]);
+    reported_peak_bytes[proc_id] = peak_bytes;
+  }
 }
 
 /**************************************************************************************/
 /* smalloc */
+
 void* smalloc(int nbytes) {
-  SMalloc_Entry* tmp;
-  void*          ptr = NULL;
-
-  ASSERT(0, nbytes < MAX_SMALLOC);
-  if(smalloc_free_list[nbytes]) {
-    tmp                       = smalloc_free_list[nbytes];
-    smalloc_free_list[nbytes] = smalloc_free_list[nbytes]->next;
-    ptr                       = tmp->data;
-    free_wrapper(tmp);
-  } else { /* need to allocate some memory */
-    if(nbytes > raw_mem_size) {
-      while(raw_mem_size >=
-            sizeof(SMalloc_Entry)) { /* never can have too many wrappers */
-        tmp = (SMalloc_Entry*)raw_mem_ptr;
-        free_wrapper(tmp);
-        raw_mem_ptr += sizeof(SMalloc_Entry);
-        raw_mem_size -= sizeof(SMalloc_Entry);
-      }
-      /* Yes, we waste up to 7 bytes per SMALLOC_BLOCK allocation */
-      raw_mem_ptr = (char*)malloc(SMALLOC_BLOCK);
-      ASSERT(0, raw_mem_ptr);
-      raw_mem_size = SMALLOC_BLOCK;
-    }
-    ptr = raw_mem_ptr;
-    raw_mem_ptr += nbytes;
-    raw_mem_size -= nbytes;
-  }
-  ASSERT(0, ptr);
-  return ptr;
+  ASSERT(0, nbytes >= 0);
+  return arena_alloc(0, nbytes);
 }
 
 /**************************************************************************************/
 /* sfree */
+
 void sfree(int nbytes, void* item) {
-  SMalloc_Entry* wrapper    = get_wrapper();
-  wrapper->next             = smalloc_free_list[nbytes];
-  wrapper->data             = item;
-  smalloc_free_list[nbytes] = wrapper;
+  ASSERT(0, nbytes >= 0);
+  arena_free(0, nbytes, item);
 }
@@ -23,23 +23,89 @@
  * File         : libs/malloc_lib.h
  * Author       : HPS Research Group
  * Date         : 3/14/2000
- * Description  : A faster malloc for small repetitive allocations
+ * Description  : Slab allocator for small repetitive allocations.
+ *
+ * A Slab_Pool hands out fixed-size objects carved from 64-byte aligned slabs
+ * and keeps freed objects on an intrusive free list, so objects allocated
+ * together stay close in memory and are never returned to libc. Every core
+ * owns an arena of pools, one per 16-byte size class, reached through
+ * arena_alloc/arena_free (smalloc/sfree use the arena of core 0). Typed pools
+ * such as the op pool are initialized directly with slab_pool_init.
  ***************************************************************************************/
 
 #ifndef __MALLOC_LIB_H__
 #define __MALLOC_LIB_H__
 
-typedef struct SMalloc_Raw_struct {
-  char* ptr;
-  int   cur_size;
-} SMalloc_Raw;
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Slab_Pool_struct {
+  const char* name;
+  uns         proc_id;
+  uns         obj_size;
+  uns         objs_per_slab;
+  uns         link_offset; /* where a free object keeps its free list link */
+  void (*init_func)(void*); /* called once per object when its slab is made */
+
+  void* free_head; /* free objects, linked at link_offset */
+  void* slabs;     /* all slabs of the pool, linked through their header */
+
+  Counter allocs;
+  Counter frees;
+  Counter num_slabs;
+  Counter live;
+  Counter peak_live;
+
+  Counter reported_allocs; /* values already counted in the stats */
+  Counter reported_frees;
+  Counter reported_slabs;
+
+  struct Slab_Pool_struct* next_pool; /* the other pools of proc_id */
+} Slab_Pool;
+
+/**************************************************************************************/
+/* Macros */
 
-typedef struct SMalloc_Entry_struct {
-  void*                        data;
-  struct SMalloc_Entry_struct* next;
-} SMalloc_Entry;
+#define SLAB_LINK(pool, obj) (*(void**)((char*)(obj) + (pool)->link_offset))
+
+/**************************************************************************************/
+/* Prototypes */
+
+void slab_pool_init(Slab_Pool* pool, const char* name, uns proc_id,
+                    uns obj_size, uns link_offset, void (*init_func)(void*));
+void slab_pool_refill(Slab_Pool* pool);
+
+void* arena_alloc(uns proc_id, uns nbytes);
+void  arena_free(uns proc_id, uns nbytes, void* ptr);
+void  update_arena_stats(uns proc_id);
 
 void* smalloc(int nbytes);
 void  sfree(int nbytes, void* item);
 
+/**************************************************************************************/
+/* Inline functions */
+
+static inline void* slab_alloc(Slab_Pool* pool) {
+  void* obj;
+
+  if(!pool->free_head)
+    slab_pool_refill(pool);
+  obj             = pool->free_head;
+  pool->free_head = SLAB_LINK(pool, obj);
+
+  pool->allocs++;
+  if(++pool->live > pool->peak_live)
+    pool->peak_live = pool->live;
+  return obj;
+}
+
+static inline void slab_free(Slab_Pool* pool, void* obj) {
+  SLAB_LINK(pool, obj) = pool->free_head;
+  pool->free_head      = obj;
+  pool->frees++;
+  pool->live--;
+}
+
 #endif /* #ifndef __MALLOC_LIB_H__ */
@@ -0,0 +1,301 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/set_mon_lib.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Set-sampled monitors: per-core LRU shadow tags with stack
+ *                position hit counters (UMON) and set-dueling selectors
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "libs/set_mon_lib.h"
+
+#include "debug/debug.param.h"
+
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_CACHE_LIB, ##args)
+
+/* index of the (proc_id, sampled set) pair */
+#define SET_MON_ROW(mon, proc_id, idx) \
+  ((proc_id) * (mon)->num_sampled_sets + (idx))
+
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static inline Flag set_mon_row(Set_Mon* mon, uns proc_id, Addr addr,
+                               uns* row, Addr* tag);
+static inline int  set_mon_find(Set_Mon* mon, uns row, Addr tag);
+
+
+/**************************************************************************************/
+/* set_mon_init: */
+
+void set_mon_init(Set_Mon* mon, const char* name, uns num_sets, uns assoc,
+                  uns line_size, uns num_procs, uns sample_modulo,
+                  uns data_size) {
+  DEBUG(0, "Initializing set monitor called '%s'.\n", name);
+  ASSERTM(0, is_power_of_2(num_sets), "set count must be a power of 2\n");
+  ASSERTM(0, is_power_of_2(line_size), "line size must be a power of 2\n");
+  ASSERT(0, assoc > 0 && assoc <= 256 && sample_modulo > 0);
+
+  strncpy(mon->name, name, MAX_STR_LENGTH);
+  mon->num_procs        = num_procs;
+  mon->assoc            = assoc;
+  mon->line_shift       = LOG2(line_size);
+  mon->set_bits         = LOG2(num_sets);
+  mon->set_mask         = N_BIT_MASK(mon->set_bits);
+  mon->sample_modulo    = sample_modulo;
+  mon->num_sampled_sets = (num_sets + sample_modulo - 1) / sample_modulo;
+  mon->data_size        = data_size;
+
+  uns rows       = num_procs * mon->num_sampled_sets;
+  mon->tags      = calloc(rows * assoc, sizeof(Addr));
+  mon->stack     = calloc(rows * assoc, sizeof(uns8));
+  mon->num_valid = calloc(rows, sizeof(uns16));
+  mon->data      = data_size ? calloc(rows * assoc, data_size) : NULL;
+  mon->hits      = calloc(num_procs * assoc, sizeof(Counter));
+  mon->accesses  = calloc(num_procs, sizeof(Counter));
+}
+
+
+/**************************************************************************************/
+/* set_mon_row: find the shadow row of a sampled address */
+
+static inline Flag set_mon_row(Set_Mon* mon, uns proc_id, Addr addr,
+                               uns* row, Addr* tag) {
+  uns set = addr >> mon->line_shift & mon->set_mask;
+  if(set % mon->sample_modulo != 0)
+    return FALSE;
+  ASSERT(proc_id, proc_id < mon->num_procs);
+  *row = SET_MON_ROW(mon, proc_id, set / mon->sample_modulo);
+  *tag = addr >> (mon->line_shift + mon->set_bits);
+  return TRUE;
+}
+
+
+/**************************************************************************************/
+/* set_mon_find: stack position of the tag in the row, -1 if absent */
+
+static inline int set_mon_find(Set_Mon* mon, uns row, Addr tag) {
+  Addr* tags  = &mon->tags[row * mon->assoc];
+  uns8* stack = &mon->stack[row * mon->assoc];
+  for(uns pos = 0; pos < mon->num_valid[row]; pos++) {
+    if(tags[stack[pos]] == tag)
+      return pos;
+  }
+  return -1;
+}
+
+
+/**************************************************************************************/
+/* set_mon_sampled: is the set of the address monitored? */
+
+Flag set_mon_sampled(Set_Mon* mon, Addr addr) {
+  uns set = addr >> mon->line_shift & mon->set_mask;
+  return set % mon->sample_modulo == 0;
+}
+
+
+/**************************************************************************************/
+/* set_mon_lookup: returns the LRU stack position of the line (0 is MRU, -1 is
+ * a miss or an unsampled set) without updating any state */
+
+int set_mon_lookup(Set_Mon* mon, uns proc_id, Addr addr, void** data) {
+  uns  row;
+  Addr tag;
+  if(!set_mon_row(mon, proc_id, addr, &row, &tag))
+    return -1;
+  int pos = set_mon_find(mon, row, tag);
+  if(data && pos >= 0 && mon->data)
+    *data = &mon->data[(row * mon->assoc + mon->stack[row * mon->assoc + pos]) *
+                       mon->data_size];
+  return pos;
+}
+
+
+/**************************************************************************************/
+/* set_mon_access: move the line to MRU, inserting it (and evicting the LRU
+ * line) on a miss. Returns the stack position before the access as
+ * set_mon_lookup does. With count set, the access and the hit position are
+ * added to the counters. *data points at the line's user data (zeroed on
+ * insertion). */
+
+int set_mon_access(Set_Mon* mon, uns proc_id, Addr addr, Flag count,
+                   void** data) {
+  uns  row;
+  Addr tag;
+  if(!set_mon_row(mon, proc_id, addr, &row, &tag))
+    return -1;
+
+  Addr* tags  = &mon->tags[row * mon->assoc];
+  uns8* stack = &mon->stack[row * mon->assoc];
+  int   pos   = set_mon_find(mon, row, tag);
+  uns   last;
+  uns8  way;
+
+  if(pos >= 0) {
+    last = pos;
+    way  = stack[pos];
+  } else if(mon->num_valid[row] < mon->assoc) {
+    last = mon->num_valid[row]++;
+    way  = last;
+  } else {
+    last = mon->assoc - 1;
+    way  = stack[last];
+  }
+  memmove(&stack[1], &stack[0], last * sizeof(uns8));
+  stack[0] = way;
+
+  if(pos < 0) {
+    tags[way] = tag;
+    if(mon->data)
+      memset(&mon->data[(row * mon->assoc + way) * mon->data_size], 0,
+             mon->data_size);
+  }
+  if(data && mon->data)
+    *data = &mon->data[(row * mon->assoc + way) * mon->data_size];
+
+  if(count)
+    set_mon_count(mon, proc_id, pos);
+  return pos;
+}
+
+
+/**************************************************************************************/
+/* set_mon_count: count an access that hit at stack position pos (-1 for a
+ * miss) */
+
+void set_mon_count(Set_Mon* mon, uns proc_id, int pos) {
+  mon->accesses[proc_id]++;
+  if(pos >= 0)
+    mon->hits[proc_id * mon->assoc + pos]++;
+}
+
+
+/**************************************************************************************/
+/* set_mon_hits: */
+
+Counter set_mon_hits(Set_Mon* mon, uns proc_id, uns pos) {
+  ASSERT(proc_id, pos < mon->assoc);
+  return mon->hits[proc_id * mon->assoc + pos];
+}
+
+
+/**************************************************************************************/
+/* set_mon_accesses: */
+
+Counter set_mon_accesses(Set_Mon* mon, uns proc_id) {
+  return mon->accesses[proc_id];
+}
+
+
+/**************************************************************************************/
+/* set_mon_miss_curve: miss_rates[ways - 1] for 1 to assoc ways, from the
+ * counts since the last reset (all zero without accesses) */
+
+void set_mon_miss_curve(Set_Mon* mon, uns proc_id, double* miss_rates) {
+  Counter accesses = mon->accesses[proc_id];
+  Counter misses   = accesses;
+  for(uns ways = 1; ways <= mon->assoc; ways++) {
+    misses -= set_mon_hits(mon, proc_id, ways - 1);
+    miss_rates[ways - 1] = accesses ? (double)misses / (double)accesses : 0.0;
+  }
+}
+
+
+/**************************************************************************************/
+/* set_mon_reset_counts: */
+
+void set_mon_reset_counts(Set_Mon* mon) {
+  memset(mon->hits, 0, mon->num_procs * mon->assoc * sizeof(Counter));
+  memset(mon->accesses, 0, mon->num_procs * sizeof(Counter));
+}
+
+
+/**************************************************************************************/
+/* set_duel_init: num_leaders leader sets for each policy */
+
+void set_duel_init(Set_Duel* duel, uns num_sets, uns num_leaders,
+                   uns psel_bits) {
+  ASSERT(0, num_leaders > 0 && num_leaders * 2 <= num_sets);
+  ASSERT(0, psel_bits > 0 && psel_bits < 31);
+  duel->leader_modulo = num_sets / num_leaders;
+  duel->psel_max      = (1 << psel_bits) - 1;
+  duel->psel          = duel->psel_max / 2;
+}
+
+
+/**************************************************************************************/
+/* set_duel_role: the first set of each group of leader_modulo sets leads for
+ * A and the middle one for B */
+
+Set_Duel_Role set_duel_role(Set_Duel* duel, uns set) {
+  uns offset = set % duel->leader_modulo;
+  if(offset == 0)
+    return SET_DUEL_LEADER_A;
+  if(offset == duel->leader_modulo / 2)
+    return SET_DUEL_LEADER_B;
+  return SET_DUEL_FOLLOWER;
+}
+
+
+/**************************************************************************************/
+/* set_duel_miss: a miss in a leader set votes for the other policy */
+
+void set_duel_miss(Set_Duel* duel, uns set) {
+  switch(set_duel_role(duel, set)) {
+    case SET_DUEL_LEADER_A:
+      duel->psel = MIN2(duel->psel + 1, duel->psel_max);
+      break;
+    case SET_DUEL_LEADER_B:
+      duel->psel = MAX2(duel->psel - 1, 0);
+      break;
+    default:
+      break;
+  }
+}
+
+
+/**************************************************************************************/
+/* set_duel_use_b: should the set use policy B? */
+
+Flag set_duel_use_b(Set_Duel* duel, uns set) {
+  switch(set_duel_role(duel, set)) {
+    case SET_DUEL_LEADER_A:
+      return FALSE;
+    case SET_DUEL_LEADER_B:
+      return TRUE;
+    default:
+      return duel->psel > duel->psel_max / 2;
+  }
+}
@@ -0,0 +1,105 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/set_mon_lib.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Set-sampled monitors: per-core LRU shadow tags with stack
+ *                position hit counters (UMON) and set-dueling selectors
+ ***************************************************************************************/
+
+#ifndef __SET_MON_LIB_H__
+#define __SET_MON_LIB_H__
+
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+
+
+/**************************************************************************************/
+/* Types */
+
+/* Shadow tags of every sample_modulo-th set of a cache, kept separately for
+   each core. All state lives in a few contiguous arrays indexed by (core,
+   sampled set, way), so the footprint depends only on the number of sampled
+   sets. */
+typedef struct Set_Mon_struct {
+  char name[MAX_STR_LENGTH + 1];
+  uns  num_procs;
+  uns  assoc;
+  uns  line_shift;
+  uns  set_bits;
+  Addr set_mask;
+  uns  sample_modulo;
+  uns  num_sampled_sets;
+  uns  data_size;  // bytes of user data per shadow line (may be 0)
+
+  Addr*    tags;       // [proc][sampled set][way]
+  uns8*    stack;      // [proc][sampled set][pos] -> way, MRU first
+  uns16*   num_valid;  // [proc][sampled set], valid lines are stack[0, n)
+  char*    data;       // [proc][sampled set][way] user data
+  Counter* hits;       // [proc][pos] hits counted at each stack position
+  Counter* accesses;   // [proc] counted accesses
+} Set_Mon;
+
+typedef enum Set_Duel_Role_enum {
+  SET_DUEL_FOLLOWER,
+  SET_DUEL_LEADER_A,  // always uses policy A and trains the selector
+  SET_DUEL_LEADER_B,  // always uses policy B and trains the selector
+} Set_Duel_Role;
+
+/* Set dueling between two policies: a few leader sets are dedicated to each
+   policy and a saturating counter of their misses picks the policy for all
+   the follower sets (used by REPL_DIP in libs/cache_lib.c). */
+typedef struct Set_Duel_struct {
+  uns leader_modulo;
+  int psel;
+  int psel_max;
+} Set_Duel;
+
+
+/**************************************************************************************/
+/* Prototypes */
+
+void set_mon_init(Set_Mon* mon, const char* name, uns num_sets, uns assoc,
+                  uns line_size, uns num_procs, uns sample_modulo,
+                  uns data_size);
+Flag set_mon_sampled(Set_Mon* mon, Addr addr);
+int  set_mon_lookup(Set_Mon* mon, uns proc_id, Addr addr, void** data);
+int  set_mon_access(Set_Mon* mon, uns proc_id, Addr addr, Flag count,
+                    void** data);
+void    set_mon_count(Set_Mon* mon, uns proc_id, int pos);
+Counter set_mon_hits(Set_Mon* mon, uns proc_id, uns pos);
+Counter set_mon_accesses(Set_Mon* mon, uns proc_id);
+void    set_mon_miss_curve(Set_Mon* mon, uns proc_id, double* miss_rates);
+void    set_mon_reset_counts(Set_Mon* mon);
+
+void          set_duel_init(Set_Duel* duel, uns num_sets, uns num_leaders,
+                            uns psel_bits);
+Set_Duel_Role set_duel_role(Set_Duel* duel, uns set);
+void          set_duel_miss(Set_Duel* duel, uns set);
+Flag          set_duel_use_b(Set_Duel* duel, uns set);
+
+
+/**************************************************************************************/
+
+
+#endif /* #ifndef __SET_MON_LIB_H__ */
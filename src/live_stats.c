@@ -0,0 +1,257 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : live_stats.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Live stats of a running simulation in shared memory. The
+ *                simulation thread copies the stat totals into the segment
+ *                every LIVE_STATS_INTERVAL under a seqlock, so readers never
+ *                slow it down.
+ ***************************************************************************************/
+
+#include "live_stats.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "core.param.h"
+#include "freq.h"
+#include "general.param.h"
+#include "globals/assert.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+#include "statistics.h"
+
+/**************************************************************************************/
+/* Macros */
+
+/* live_stats_cycle calls between two looks at the clock */
+#define LIVE_STATS_CHECK_CALLS 1024
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Live_Stats_Header* header = NULL;
+static Live_Stats_Core*   cores;
+static uns64*             stats;
+static uns64              size;
+static char               path[MAX_STR_LENGTH + 1];
+static uns                calls;
+static double (*get_progress)(void);
+static double  start_time;
+static double  last_time;
+static Counter last_inst_count[MAX_NUM_PROCS];
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static double wall_time(void);
+static void   update(void);
+static void   remove_segment(void);
+static void   remove_stale_segments(void);
+
+/**************************************************************************************/
+/* live_stats_init: */
+
+void live_stats_init(double (*progress)(void)) {
+  if(!LIVE_STATS)
+    return;
+
+  uns64 names_size = 0;
+  for(uns ii = 0; ii < NUM_GLOBAL_STATS; ii++)
+    names_size += strlen(global_stat_array[0][ii].name) + 2;
+  uns64 cores_offset = sizeof(Live_Stats_Header);
+  uns64 stats_offset = cores_offset + NUM_CORES * sizeof(Live_Stats_Core);
+  uns64 names_offset = stats_offset +
+                       (uns64)NUM_CORES * NUM_GLOBAL_STATS * sizeof(uns64);
+  size = names_offset + names_size;
+
+  remove_stale_segments();
+  /* monitoring is optional, so a host without /dev/shm only gets a warning */
+  snprintf(path, MAX_STR_LENGTH, "/dev/shm/scarab.%d", getpid());
+  int   fd  = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  void* map = MAP_FAILED;
+  if(fd >= 0 && ftruncate(fd, size) == 0)
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if(fd >= 0)
+    close(fd);
+  if(map == MAP_FAILED) {
+    fprintf(mystdout, "Warning: could not create live stats in %s\n", path);
+    if(fd >= 0)
+      unlink(path);
+    return;
+  }
+  atexit(remove_segment);
+
+  header = (Live_Stats_Header*)map;
+  cores  = (Live_Stats_Core*)((char*)map + cores_offset);
+  stats  = (uns64*)((char*)map + stats_offset);
+
+  char* name = (char*)map + names_offset;
+  for(uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    *name++ = global_stat_array[0][ii].type;
+    strcpy(name, global_stat_array[0][ii].name);
+    name += strlen(name) + 1;
+  }
+
+  header->version      = LIVE_STATS_VERSION;
+  header->num_cores    = NUM_CORES;
+  header->num_stats    = NUM_GLOBAL_STATS;
+  header->pid          = getpid();
+  header->cores_offset = cores_offset;
+  header->stats_offset = stats_offset;
+  header->names_offset = names_offset;
+  /* readers check the magic last */
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(header->magic, "SCRBLIVE", sizeof(header->magic));
+
+  get_progress = progress;
+  start_time = last_time = wall_time();
+  memset(last_inst_count, 0, sizeof(last_inst_count));
+  fprintf(mystdout, "Live stats: %s\n", path);
+  update();
+}
+
+/**************************************************************************************/
+/* live_stats_cycle: */
+
+void live_stats_cycle(void) {
+  if(!header)
+    return;
+
+  if(++calls < LIVE_STATS_CHECK_CALLS)
+    return;
+  calls = 0;
+  if((wall_time() - last_time) * 1000 >= LIVE_STATS_INTERVAL) {
+    update();
+  }
+}
+
+/**************************************************************************************/
+/* live_stats_done: */
+
+void live_stats_done(void) {
+  if(!header)
+    return;
+
+  header->done = TRUE;
+  update();
+}
+
+/**************************************************************************************/
+/* wall_time: */
+
+static double wall_time(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**************************************************************************************/
+/* update: copy the current values into the segment under the seqlock */
+
+static void update(void) {
+  double  now              = wall_time();
+  double  interval         = now - last_time;
+  Counter total_inst_count = 0;
+  Counter last_total_count = 0;
+  uns64   seq              = header->seq;
+
+  __atomic_store_n(&header->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Live_Stats_Core* core  = &cores[proc_id];
+    Counter          insts = inst_count[proc_id] - last_inst_count[proc_id];
+    core->inst_count       = inst_count[proc_id];
+    core->cycle_count      = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+    core->kips             = interval > 0 ? insts / interval / 1000 : 0.0;
+    core->done             = sim_done[proc_id];
+    total_inst_count += inst_count[proc_id];
+    last_total_count += last_inst_count[proc_id];
+    last_inst_count[proc_id] = inst_count[proc_id];
+
+    uns64* values = &stats[(uns64)proc_id * NUM_GLOBAL_STATS];
+    for(uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+      if(global_stat_array[proc_id][ii].type == FLOAT_TYPE_STAT) {
+        double value = GET_TOTAL_STAT_VALUE(proc_id, ii);
+        memcpy(&values[ii], &value, sizeof(value));
+      } else {
+        values[ii] = GET_TOTAL_STAT_EVENT(proc_id, ii);
+      }
+    }
+  }
+
+  header->updates++;
+  header->cycle_count = cycle_count;
+  header->seconds     = now - start_time;
+  header->kips        = interval > 0 ? (total_inst_count - last_total_count) /
+                                         interval / 1000 :
+                                       0.0;
+  header->progress    = get_progress();
+  last_time           = now;
+
+  __atomic_store_n(&header->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/**************************************************************************************/
+/* remove_segment: at exit, monitors only see running simulations (forked
+   helper processes leave the segment of their parent alone) */
+
+static void remove_segment(void) {
+  if(header->pid != (uns64)getpid())
+    return;
+  munmap(header, size);
+  unlink(path);
+}
+
+/**************************************************************************************/
+/* remove_stale_segments: segments of Scarab processes that were killed
+   before they could remove them */
+
+static void remove_stale_segments(void) {
+  DIR* dir = opendir("/dev/shm");
+  if(!dir)
+    return;
+  struct dirent* entry;
+  while((entry = readdir(dir))) {
+    char* end;
+    if(strncmp(entry->d_name, "scarab.", 7))
+      continue;
+    long pid = strtol(entry->d_name + 7, &end, 10);
+    if(end == entry->d_name + 7 || *end || pid <= 0)
+      continue;
+    if(kill(pid, 0) != 0 && errno == ESRCH) {
+      char stale_path[MAX_STR_LENGTH + 1];
+      snprintf(stale_path, MAX_STR_LENGTH, "/dev/shm/%s", entry->d_name);
+      unlink(stale_path);
+    }
+  }
+  closedir(dir);
+}
@@ -0,0 +1,96 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : live_stats.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Live stats of a running simulation in shared memory, for
+ *                bin/scarab_top.py and other monitors
+ ***************************************************************************************/
+
+#ifndef __LIVE_STATS_H__
+#define __LIVE_STATS_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************
+
+Layout of /dev/shm/scarab.<pid> (little endian, see Live_Stats_Header):
+the header, then num_cores Live_Stats_Core, then the stat values as
+[core][stat] 8-byte words (doubles for FLOAT_TYPE_STAT stats, counts for the
+rest, the totals the stat files would get now), then one
+"<u8 stat type><name>\0" per stat. Everything from seq on is updated under a
+seqlock: seq is odd while the simulation writes, so a reader copies the
+values and retries unless seq was the same even number before and after the
+copy.
+
+The segment is removed when Scarab exits. A Scarab killed without running
+its exit handlers (SIGKILL, a crash) leaves it behind, so the next Scarab on
+the host removes the segments of processes that are gone.
+
+***************************************************************************************/
+
+/**************************************************************************************/
+/* Types */
+
+#define LIVE_STATS_VERSION 1
+
+typedef struct Live_Stats_Header_struct {
+  char   magic[8];  // "SCRBLIVE"
+  uns32  version;
+  uns32  num_cores;
+  uns32  num_stats;
+  uns32  done;  // the simulation has ended
+  uns64  pid;
+  uns64  cores_offset;
+  uns64  stats_offset;
+  uns64  names_offset;
+  uns64  seq;
+  uns64  updates;
+  uns64  cycle_count;
+  double seconds;   // wall clock time since the start of the simulation
+  double kips;      // all cores, since the previous update
+  double progress;  // fraction of the instruction or simulation limit
+} Live_Stats_Header;
+
+typedef struct Live_Stats_Core_struct {
+  uns64  inst_count;
+  uns64  cycle_count;
+  double kips;  // since the previous update
+  uns64  done;  // the core reached its limit or the end of its program
+} Live_Stats_Core;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Create the segment (if LIVE_STATS is on). progress gives the fraction of
+   the simulation done. */
+void live_stats_init(double (*progress)(void));
+
+/* Update the segment every LIVE_STATS_INTERVAL ms. Called every simulated
+   cycle, or every instruction in the functional modes. */
+void live_stats_cycle(void);
+
+/* Final update (the segment is removed when Scarab exits) */
+void live_stats_done(void);
+
+#endif /* #ifndef __LIVE_STATS_H__ */
@@ -210,9 +210,12 @@ Scarab's source code is organized as follows:
 #include "globals/global_vars.h"
 #include "globals/utils.h"
 
+#include "bp/bp_eval.h"
+#include "live_stats.h"
 #include "optimizer2.h"
 #include "param_parser.h"
 #include "sim.h"
+#include "simpoint.h"
 #include "statistics.h"
 #include "version.h"
 
@@ -270,6 +273,7 @@ int main(int argc, char* argv[], char* envp[]) {
   fprintf(mystdout, "Scarab started at %s\n", ctime(&cur_time));
   WRITE_STATUS("PID %d", getpid());
   WRITE_STATUS("STARTED");
+  live_stats_init(sim_progress);
 
   /* call the function for the type of simulation  */
   switch(SIM_MODE) {
@@ -279,11 +283,26 @@ int main(int argc, char* argv[], char* envp[]) {
     case FULL_SIM_MODE:
       full_sim();
       break;
+    case BP_SIM_MODE:
+      bp_eval_sim();
+      break;
+    case CACHE_SIM_MODE:
+      cache_explore_sim();
+      break;
+    case SIMPOINT_SIM_MODE:
+      simpoint_sim();
+      break;
+    case SAMPLE_SIM_MODE:
+      sampling_sim();
+      break;
     default:
       FATAL_ERROR(0, "Unknown simulation mode.");
       break;
   }
 
+  live_stats_done();
+  stat_profile_done();
+
   /* all done --- print finish messages */
   time(&cur_time);
   fprintf(mystdout, "Scarab finished at %s\n", ctime(&cur_time));
@@ -43,7 +43,6 @@
 #include "memory/memory.param.h"
 
 #include "cmp_model.h"
-#include "libs/hash_lib.h"
 #include "statistics.h"
 
 /**************************************************************************************/
@@ -52,41 +51,45 @@
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_MAP, ##args)
 #define DEBUGU(proc_id, args...) _DEBUGU(proc_id, DEBUG_MAP, ##args)
 
-#define WAKE_UP_ENTRIES_INC 256 /* default 256 */
 #define MEM_ADDR_SRC \
   0 /* address for memory instructions calculated off source 0 */
 
-#define MEM_MAP_ENTRY_SIZE_LOG 3
-#define MEM_MAP_ENTRY_SIZE (1 << MEM_MAP_ENTRY_SIZE_LOG)
-#define MEM_MAP_BYTE_IN_ENTRY(va) ((va) & (MEM_MAP_ENTRY_SIZE - 1))
-#define MEM_MAP_ENTRY_ADDR(va) ((va) & ~(Addr)(MEM_MAP_ENTRY_SIZE - 1))
-
-#define MEM_MAP_KEY(va) ((va) >> MEM_MAP_ENTRY_SIZE_LOG)
-#define MEM_MAP_BYTE_INDEX(byte, off_path) \
-  ((byte) + ((off_path) ? MEM_MAP_ENTRY_SIZE : 0))
+#define STORE_MAP_LINE_SIZE_LOG 6
+#define STORE_MAP_LINE_SIZE (1 << STORE_MAP_LINE_SIZE_LOG)
+#define STORE_MAP_BYTE_IN_LINE(va) ((va) & (STORE_MAP_LINE_SIZE - 1))
+#define STORE_MAP_LINE_ADDR(va) ((va) & ~(Addr)(STORE_MAP_LINE_SIZE - 1))
+#define STORE_MAP_NONE ((uns)-1)
 
 /**************************************************************************************/
 /* Types */
 
-typedef struct Mem_Map_Entry_struct {
-  Op* op[2 * MEM_MAP_ENTRY_SIZE]; /* last op to write (invalid when committed),
-                                   * first half onpath, second half offpath*/
-  uns flag_mask;                  /* offpath flags, one per byte */
-  uns store_mask;                 /* shows position of all distinct stores
-                                   * supplying a partial value to this map entry */
-} Mem_Map_Entry;
-
-/* Data structure for easy traversal of memory map hash given an
-   access with an address and size */
-typedef struct Mem_Map_Traversal_struct {
-  Addr entry_addr; /* Entry address, can be used by caller */
-  Addr first_entry_addr;
-  Addr last_entry_addr;
-  uns  byte; /* Byte within entry, can be used by caller */
-  uns  last_byte;
-  uns  first_entry_first_byte;
-  uns  last_entry_last_byte;
-} Mem_Map_Traversal;
+/* A line written by in-flight stores. Lines live in an open addressed table
+   (linear probing) so a lookup is one probe sequence per accessed line. */
+struct Store_Map_Line_struct {
+  Addr line_addr;
+  uns  head; /* youngest store record (STORE_MAP_NONE if the slot is free) */
+};
+
+/* One store's bytes in a line. A record only keeps the bytes that no younger
+   store on the same path has written, and is dropped once that is empty. */
+struct Store_Map_Store_struct {
+  Op*   op;
+  uns64 mask;  /* bytes of the line, one bit per byte */
+  uns   epoch; /* store_epoch when mapped (offpath records are hidden after a
+                  recovery until rebuild_offpath_map maps them again) */
+  uns   next;  /* next older record of the line (or next free record) */
+  Flag  off_path;
+};
+
+/* Data structure for easy traversal of the store map given an access with an
+   address and size */
+typedef struct Store_Map_Traversal_struct {
+  Addr line_addr; /* Line address, can be used by caller */
+  Addr first_line_addr;
+  Addr last_line_addr;
+  uns  first_line_first_byte;
+  uns  last_line_last_byte;
+} Store_Map_Traversal;
 
 /**************************************************************************************/
 /* External variables */
@@ -99,6 +102,10 @@ extern Op invalid_op;
 
 Map_Data* map_data = NULL;
 
+/* wake ups can happen while another core's map data is current (e.g. from
+   the memory system), so the wake up ring is found through op->proc_id */
+static Map_Data* proc_map_data[MAX_NUM_PROCS];
+
 const char* const dep_type_names[NUM_DEP_TYPES] = {
   "REG_DATA",
   "MEM_ADDR",
@@ -112,20 +119,27 @@ static inline void read_reg_map(Op*);
 static inline void read_store_map(Op*);
 static inline void update_map(Op*);
 
-static inline void expand_wake_up_entries(void);
+static inline uns  wake_up_slot(Map_Data* md, Op* op);
+static inline Flag wake_up_slot_has(Map_Data* md, uns slot, Op* op);
 static inline void update_store_hash(Op* op);
 static inline Op*  add_store_deps(Op* op);
 static inline void update_map_entry(Op* op, Map_Entry* map_entry);
-static inline void recover_mem_map_entry(void* hash_entry, void* arg);
 
-/* memory map hash traversal */
-static inline void mem_map_entry_traversal_init(Mem_Map_Traversal* traversal,
-                                                Addr va, uns size);
-static inline Flag mem_map_entry_traversal_done(Mem_Map_Traversal* traversal);
-static inline void mem_map_entry_traversal_next(Mem_Map_Traversal* traversal);
-static inline void mem_map_byte_traversal_init(Mem_Map_Traversal* traversal);
-static inline Flag mem_map_byte_traversal_done(Mem_Map_Traversal* traversal);
-static inline void mem_map_byte_traversal_next(Mem_Map_Traversal* traversal);
+/* store map */
+static inline uns             store_map_hash(Addr line_addr);
+static inline Store_Map_Line* store_map_find(Addr line_addr);
+static Store_Map_Line*        store_map_find_create(Addr line_addr);
+static void                   store_map_delete_line(Store_Map_Line* entry);
+static uns                    store_map_alloc(void);
+static inline void            store_map_free(uns idx);
+static inline Flag            store_map_visible(Store_Map_Store* st);
+
+/* store map traversal */
+static inline void  store_map_traversal_init(Store_Map_Traversal* traversal,
+                                             Addr va, uns size);
+static inline Flag  store_map_traversal_done(Store_Map_Traversal* traversal);
+static inline void  store_map_traversal_next(Store_Map_Traversal* traversal);
+static inline uns64 store_map_traversal_mask(Store_Map_Traversal* traversal);
 
 /**************************************************************************************/
 /* set_map_data: */
@@ -160,18 +174,31 @@ void init_map(uns8 proc_id) {
   map_data->last_store[1].op     = &invalid_op;
   map_data->last_store[1].op_num = 0;
 
-  /* Allocate the wake_up_entry pool. */
-  expand_wake_up_entries();
-
-  /* Initialize the memory dependence hash table. The number of
-     buckets matters since we scan all entries (and all buckets) on
-     branch misprediction recovery, so we want to keep the number of
-     buckets large enough to avoid collisions but small enough to
-     keep the scan fast. Since the number of entries is roughly at
-     most the number of in-flight stores, we set the number of
-     buckets to the size of instruction window. */
-  init_hash_table(&map_data->oracle_mem_hash, "oracle mem dependence map",
-                  NODE_TABLE_SIZE, sizeof(Mem_Map_Entry));
+  /* Allocate the wake up ring and the dependence bitmaps */
+  if(WAKE_UP_RING_SIZE) {
+    ASSERTM(proc_id, is_power_of_2(WAKE_UP_RING_SIZE),
+            "WAKE_UP_RING_SIZE must be a power of 2\n");
+    map_data->wake_up_ring_size = MAX2(WAKE_UP_RING_SIZE, 64);
+  } else {
+    map_data->wake_up_ring_size = 2 << LOG2(MAX2(NODE_TABLE_SIZE, 32) * 2 - 1);
+  }
+  map_data->wake_up_words = map_data->wake_up_ring_size / 64;
+  map_data->wake_up_ring  = calloc(map_data->wake_up_ring_size,
+                                  sizeof(Wake_Up_Slot));
+  map_data->wake_up_deps  = calloc(map_data->wake_up_ring_size *
+                                    map_data->wake_up_words,
+                                  sizeof(uns64));
+  proc_map_data[proc_id] = map_data;
+
+  /* Initialize the store map. Its tables grow on demand; start the line
+     table at twice the size of the instruction window. */
+  map_data->store_lines_size = 1 << (LOG2(MAX2(NODE_TABLE_SIZE, 32) * 2 - 1) +
+                                     1);
+  map_data->store_lines      = malloc(map_data->store_lines_size *
+                                 sizeof(Store_Map_Line));
+  for(ii = 0; ii < map_data->store_lines_size; ii++)
+    map_data->store_lines[ii].head = STORE_MAP_NONE;
+  map_data->free_store = STORE_MAP_NONE;
 }
 
 
@@ -184,18 +211,10 @@ void recover_map() {
   for(ii = 0; ii < NUM_REG_IDS; ii++)
     map_data->map_flags[ii] = FALSE;
   map_data->last_store_flag = FALSE;
-  hash_table_scan(&map_data->oracle_mem_hash, recover_mem_map_entry, NULL);
+  map_data->store_epoch++; /* hide offpath stores */
   rebuild_offpath_map();
 }
 
-/**************************************************************************************/
-/* recover_mem_map_entry: */
-
-void recover_mem_map_entry(void* hash_entry, void* arg) {
-  Mem_Map_Entry* entry = (Mem_Map_Entry*)hash_entry;
-  entry->flag_mask     = 0;
-}
-
 /**************************************************************************************/
 /* rebuild_offpath_map: rebuild the offpath half of map structures
    using the sequential op list from a Thread. Make sure you recover
@@ -222,26 +241,6 @@ void rebuild_offpath_map() {
 }
 
 
-/**************************************************************************************/
-/* expand_wake_up_pool: */
-
-static inline void expand_wake_up_entries() {
-  Wake_Up_Entry* new_pool = (Wake_Up_Entry*)calloc(WAKE_UP_ENTRIES_INC,
-                                                   sizeof(Wake_Up_Entry));
-  uns            ii;
-
-  DEBUGU(map_data->proc_id, "Expanding wake up pool to size %d\n",
-         (map_data->wake_up_entries + WAKE_UP_ENTRIES_INC));
-  for(ii = 0; ii < WAKE_UP_ENTRIES_INC - 1; ii++)
-    new_pool[ii].next = &new_pool[ii + 1];
-  new_pool[ii].next        = map_data->free_list_head;
-  map_data->free_list_head = &new_pool[0];
-  map_data->wake_up_entries += WAKE_UP_ENTRIES_INC;
-  ASSERT(map_data->proc_id,
-         map_data->wake_up_entries <= WAKE_UP_ENTRIES_INC * 128);
-}
-
-
 /**************************************************************************************/
 /* map_op: involves two things: setting up the src array in op_info
    and updating the current map state based on the op's output values.
@@ -363,89 +362,200 @@ void map_mem_dep(Op* op) {
 }
 
 /**************************************************************************************/
-/* map_mem_*_traversal_*: these functions traverse the memory map
-   entries and bytes within those entries given an access with an
-   address and size. */
+/* store_map_*_traversal_*: these functions traverse the lines of the store
+   map given an access with an address and size. */
 
-static inline void mem_map_entry_traversal_init(Mem_Map_Traversal* traversal,
-                                                Addr va, uns size) {
+static inline void store_map_traversal_init(Store_Map_Traversal* traversal,
+                                            Addr va, uns size) {
   Addr last_va = ADDR_PLUS_OFFSET(va, size - 1);  // last byte in access
-  traversal->first_entry_addr       = MEM_MAP_ENTRY_ADDR(va);
-  traversal->last_entry_addr        = MEM_MAP_ENTRY_ADDR(last_va);
-  traversal->entry_addr             = traversal->first_entry_addr;
-  traversal->first_entry_first_byte = MEM_MAP_BYTE_IN_ENTRY(va);
-  traversal->last_entry_last_byte   = MEM_MAP_BYTE_IN_ENTRY(last_va);
+  traversal->first_line_addr       = STORE_MAP_LINE_ADDR(va);
+  traversal->last_line_addr        = STORE_MAP_LINE_ADDR(last_va);
+  traversal->line_addr             = traversal->first_line_addr;
+  traversal->first_line_first_byte = STORE_MAP_BYTE_IN_LINE(va);
+  traversal->last_line_last_byte   = STORE_MAP_BYTE_IN_LINE(last_va);
 
   if(0 == size) {
     // special case - if the size is 0, we shouldn't do a traversal at all, so
     // force the traversal to be "done"
-    traversal->entry_addr = ADDR_PLUS_OFFSET(traversal->last_entry_addr,
-                                             MEM_MAP_ENTRY_SIZE);
-    ASSERT(get_proc_id_from_cmp_addr(va),
-           mem_map_entry_traversal_done(traversal));
+    traversal->line_addr = ADDR_PLUS_OFFSET(traversal->last_line_addr,
+                                            STORE_MAP_LINE_SIZE);
+    ASSERT(get_proc_id_from_cmp_addr(va), store_map_traversal_done(traversal));
   }
 }
 
-static inline Flag mem_map_entry_traversal_done(Mem_Map_Traversal* traversal) {
-  return traversal->entry_addr ==
-         ADDR_PLUS_OFFSET(traversal->last_entry_addr, MEM_MAP_ENTRY_SIZE);
+static inline Flag store_map_traversal_done(Store_Map_Traversal* traversal) {
+  return traversal->line_addr ==
+         ADDR_PLUS_OFFSET(traversal->last_line_addr, STORE_MAP_LINE_SIZE);
+}
+
+static inline void store_map_traversal_next(Store_Map_Traversal* traversal) {
+  traversal->line_addr = ADDR_PLUS_OFFSET(traversal->line_addr,
+                                          STORE_MAP_LINE_SIZE);
 }
 
-static inline void mem_map_entry_traversal_next(Mem_Map_Traversal* traversal) {
-  traversal->entry_addr = ADDR_PLUS_OFFSET(traversal->entry_addr,
-                                           MEM_MAP_ENTRY_SIZE);
+/* bytes of the current line covered by the access */
+static inline uns64 store_map_traversal_mask(Store_Map_Traversal* traversal) {
+  uns first = traversal->line_addr == traversal->first_line_addr ?
+                traversal->first_line_first_byte :
+                0;
+  uns last  = traversal->line_addr == traversal->last_line_addr ?
+                traversal->last_line_last_byte :
+                STORE_MAP_LINE_SIZE - 1;
+  ASSERT(0, first <= last);
+  return (~0ULL >> (STORE_MAP_LINE_SIZE - 1 - last)) & (~0ULL << first);
 }
 
-static inline void mem_map_byte_traversal_init(Mem_Map_Traversal* traversal) {
-  traversal->byte = traversal->entry_addr == traversal->first_entry_addr ?
-                      traversal->first_entry_first_byte :
-                      0;
-  traversal->last_byte = traversal->entry_addr == traversal->last_entry_addr ?
-                           traversal->last_entry_last_byte :
-                           MEM_MAP_ENTRY_SIZE - 1;
-  ASSERT(0, traversal->byte <= traversal->last_byte);
+/**************************************************************************************/
+/* store_map_hash: home slot of a line in the line table */
+
+static inline uns store_map_hash(Addr line_addr) {
+  uns64 key = (line_addr >> STORE_MAP_LINE_SIZE_LOG) * 0x9E3779B97F4A7C15ULL;
+  return (uns)(key >> 32) & (map_data->store_lines_size - 1);
+}
+
+/**************************************************************************************/
+/* store_map_find: */
+
+static inline Store_Map_Line* store_map_find(Addr line_addr) {
+  uns mask = map_data->store_lines_size - 1;
+  for(uns ii = store_map_hash(line_addr);; ii = (ii + 1) & mask) {
+    Store_Map_Line* entry = &map_data->store_lines[ii];
+    if(entry->head == STORE_MAP_NONE)
+      return NULL;
+    if(entry->line_addr == line_addr)
+      return entry;
+  }
+}
+
+/**************************************************************************************/
+/* store_map_find_create: the table is kept at most half full, so probe
+   sequences stay short and always end at a free slot */
+
+static Store_Map_Line* store_map_find_create(Addr line_addr) {
+  Store_Map_Line* entry = store_map_find(line_addr);
+  if(entry)
+    return entry;
+
+  if(2 * (map_data->num_store_lines + 1) > map_data->store_lines_size) {
+    Store_Map_Line* old_lines = map_data->store_lines;
+    uns             old_size  = map_data->store_lines_size;
+
+    map_data->store_lines_size = 2 * old_size;
+    map_data->store_lines      = malloc(map_data->store_lines_size *
+                                   sizeof(Store_Map_Line));
+    for(uns ii = 0; ii < map_data->store_lines_size; ii++)
+      map_data->store_lines[ii].head = STORE_MAP_NONE;
+    for(uns ii = 0; ii < old_size; ii++) {
+      if(old_lines[ii].head == STORE_MAP_NONE)
+        continue;
+      uns jj = store_map_hash(old_lines[ii].line_addr);
+      while(map_data->store_lines[jj].head != STORE_MAP_NONE)
+        jj = (jj + 1) & (map_data->store_lines_size - 1);
+      map_data->store_lines[jj] = old_lines[ii];
+    }
+    free(old_lines);
+  }
+
+  uns ii = store_map_hash(line_addr);
+  while(map_data->store_lines[ii].head != STORE_MAP_NONE)
+    ii = (ii + 1) & (map_data->store_lines_size - 1);
+  entry            = &map_data->store_lines[ii];
+  entry->line_addr = line_addr;
+  map_data->num_store_lines++;
+  return entry;
+}
+
+/**************************************************************************************/
+/* store_map_delete_line: remove a line whose last store record went away,
+   shifting later entries of its probe sequence back into the hole */
+
+static void store_map_delete_line(Store_Map_Line* entry) {
+  uns mask = map_data->store_lines_size - 1;
+  uns hole = entry - map_data->store_lines;
+
+  ASSERT(map_data->proc_id, entry->head == STORE_MAP_NONE);
+  map_data->num_store_lines--;
+  for(uns ii = (hole + 1) & mask;
+      map_data->store_lines[ii].head != STORE_MAP_NONE; ii = (ii + 1) & mask) {
+    uns home = store_map_hash(map_data->store_lines[ii].line_addr);
+    /* move the entry if its home is not cyclically within (hole, ii] */
+    if(((ii - home) & mask) >= ((ii - hole) & mask)) {
+      map_data->store_lines[hole]    = map_data->store_lines[ii];
+      map_data->store_lines[ii].head = STORE_MAP_NONE;
+      hole                           = ii;
+    }
+  }
+}
+
+/**************************************************************************************/
+/* store_map_alloc: get a free store record (indices stay valid when the
+   record array grows) */
+
+static uns store_map_alloc(void) {
+  if(map_data->free_store == STORE_MAP_NONE) {
+    uns old_size          = map_data->stores_size;
+    map_data->stores_size = old_size ? 2 * old_size :
+                                       MAX2(NODE_TABLE_SIZE, 32);
+    map_data->stores = realloc(map_data->stores,
+                               map_data->stores_size * sizeof(Store_Map_Store));
+    ASSERT(map_data->proc_id, map_data->stores);
+    for(uns ii = map_data->stores_size; ii-- > old_size;) {
+      map_data->stores[ii].next = map_data->free_store;
+      map_data->free_store      = ii;
+    }
+  }
+
+  uns idx              = map_data->free_store;
+  map_data->free_store = map_data->stores[idx].next;
+  return idx;
 }
 
-static inline Flag mem_map_byte_traversal_done(Mem_Map_Traversal* traversal) {
-  return traversal->byte > traversal->last_byte;
+/**************************************************************************************/
+/* store_map_free: */
+
+static inline void store_map_free(uns idx) {
+  map_data->stores[idx].op   = NULL;
+  map_data->stores[idx].next = map_data->free_store;
+  map_data->free_store       = idx;
 }
 
-static inline void mem_map_byte_traversal_next(Mem_Map_Traversal* traversal) {
-  traversal->byte++;
+/**************************************************************************************/
+/* store_map_visible: is the store part of the current view of memory? */
+
+static inline Flag store_map_visible(Store_Map_Store* st) {
+  return !st->off_path || st->epoch == map_data->store_epoch;
 }
 
 /**************************************************************************************/
 /* delete_store_hash_entry */
 
 void delete_store_hash_entry(Op* op) {
-  Addr              va = op->oracle_info.va;
-  Mem_Map_Traversal traversal;
+  Addr                va = op->oracle_info.va;
+  Store_Map_Traversal traversal;
 
   ASSERT(map_data->proc_id, map_data->proc_id == op->proc_id);
 
-  /* Iterate through each entry that was written to by the op */
-  for(mem_map_entry_traversal_init(&traversal, va, op->oracle_info.mem_size);
-      !mem_map_entry_traversal_done(&traversal);
-      mem_map_entry_traversal_next(&traversal)) {
-    Mem_Map_Entry* mem_map_p = (Mem_Map_Entry*)hash_table_access(
-      &map_data->oracle_mem_hash, MEM_MAP_KEY(traversal.entry_addr));
+  /* Iterate through each line that was written to by the op */
+  for(store_map_traversal_init(&traversal, va, op->oracle_info.mem_size);
+      !store_map_traversal_done(&traversal);
+      store_map_traversal_next(&traversal)) {
+    Store_Map_Line* entry = store_map_find(traversal.line_addr);
 
-    if(!mem_map_p)
+    if(!entry)
       continue;
 
-    /* Iterate through each byte written to by the op (within this entry) */
-    for(mem_map_byte_traversal_init(&traversal);
-        !mem_map_byte_traversal_done(&traversal);
-        mem_map_byte_traversal_next(&traversal)) {
-      uns ind = MEM_MAP_BYTE_INDEX(traversal.byte, op->off_path);
-      if(TESTBIT(mem_map_p->store_mask, ind) && mem_map_p->op[ind] == op) {
-        CLRBIT(mem_map_p->store_mask, ind);
+    /* the op's record may already be gone if younger stores overwrote it */
+    for(uns* link = &entry->head; *link != STORE_MAP_NONE;
+        link      = &map_data->stores[*link].next) {
+      uns idx = *link;
+      if(map_data->stores[idx].op == op) {
+        *link = map_data->stores[idx].next;
+        store_map_free(idx);
+        break;
       }
     }
-    if(!mem_map_p->store_mask) {
-      hash_table_access_delete(&map_data->oracle_mem_hash,
-                               MEM_MAP_KEY(traversal.entry_addr));
-    }
+    if(entry->head == STORE_MAP_NONE)
+      store_map_delete_line(entry);
   }
 }
 
@@ -453,32 +563,33 @@ void delete_store_hash_entry(Op* op) {
 /* add_store_deps: */
 
 static inline Op* add_store_deps(Op* op) {
-  Addr              va            = op->oracle_info.va;
-  Op*               last_src_op   = NULL;
-  uns               orig_num_srcs = op->oracle_info.num_srcs;
-  Mem_Map_Traversal traversal;
+  Addr                va            = op->oracle_info.va;
+  Op*                 last_src_op   = NULL;
+  uns                 orig_num_srcs = op->oracle_info.num_srcs;
+  Store_Map_Traversal traversal;
 
   ASSERT(map_data->proc_id, map_data->proc_id == op->proc_id);
 
-  /* Iterate through each entry that is read by the op */
-  for(mem_map_entry_traversal_init(&traversal, va, op->oracle_info.mem_size);
-      !mem_map_entry_traversal_done(&traversal);
-      mem_map_entry_traversal_next(&traversal)) {
-    Mem_Map_Entry* mem_map_p = (Mem_Map_Entry*)hash_table_access(
-      &map_data->oracle_mem_hash, MEM_MAP_KEY(traversal.entry_addr));
+  /* Iterate through each line that is read by the op */
+  for(store_map_traversal_init(&traversal, va, op->oracle_info.mem_size);
+      !store_map_traversal_done(&traversal);
+      store_map_traversal_next(&traversal)) {
+    Store_Map_Line* entry = store_map_find(traversal.line_addr);
 
-    if(!mem_map_p)
+    if(!entry)
       continue;
 
-    /* Iterate through each byte read by the op (within this entry) */
-    for(mem_map_byte_traversal_init(&traversal);
-        !mem_map_byte_traversal_done(&traversal);
-        mem_map_byte_traversal_next(&traversal)) {
-      uns ind = MEM_MAP_BYTE_INDEX(
-        traversal.byte, TESTBIT(mem_map_p->flag_mask, traversal.byte));
-      if(!TESTBIT(mem_map_p->store_mask, ind))
-        continue; /* ensure mem_map_p info is valid */
-      Op* src_op = mem_map_p->op[ind];
+    /* Walk the stores youngest first; each read byte comes from the first
+       visible store that writes it */
+    uns64 bytes = store_map_traversal_mask(&traversal);
+    for(uns idx = entry->head; idx != STORE_MAP_NONE && bytes;
+        idx     = map_data->stores[idx].next) {
+      Store_Map_Store* st = &map_data->stores[idx];
+      if(!(st->mask & bytes) || !store_map_visible(st))
+        continue;
+      bytes &= ~st->mask;
+
+      Op* src_op = st->op;
       ASSERTM(op->proc_id,
               BYTE_OVERLAP(src_op->oracle_info.va, src_op->oracle_info.mem_size,
                            va, op->oracle_info.mem_size),
@@ -522,35 +633,106 @@ static inline Op* add_store_deps(Op* op) {
 /* update_store_hash: */
 
 static inline void update_store_hash(Op* op) {
-  Mem_Map_Entry*    mem_map_p;
-  Addr              va = op->oracle_info.va;
-  Mem_Map_Traversal traversal;
+  Addr                va = op->oracle_info.va;
+  Store_Map_Traversal traversal;
 
   ASSERT(map_data->proc_id, map_data->proc_id == op->proc_id);
 
-  /* Iterate through each entry that was written to by the op */
-  for(mem_map_entry_traversal_init(&traversal, va, op->oracle_info.mem_size);
-      !mem_map_entry_traversal_done(&traversal);
-      mem_map_entry_traversal_next(&traversal)) {
-    Flag new_entry = FALSE;
-    mem_map_p      = (Mem_Map_Entry*)hash_table_access_create(
-      &map_data->oracle_mem_hash, MEM_MAP_KEY(traversal.entry_addr),
-      &new_entry);
-
-    if(new_entry) {
-      mem_map_p->flag_mask  = 0;
-      mem_map_p->store_mask = 0;
+  /* Iterate through each line that was written to by the op */
+  for(store_map_traversal_init(&traversal, va, op->oracle_info.mem_size);
+      !store_map_traversal_done(&traversal);
+      store_map_traversal_next(&traversal)) {
+    uns64           bytes = store_map_traversal_mask(&traversal);
+    Store_Map_Line* entry = store_map_find_create(traversal.line_addr);
+
+    /* Drop the op's own record (offpath stores are mapped again by
+       rebuild_offpath_map) and take the bytes it writes away from older
+       visible stores on the same path */
+    for(uns* link = &entry->head; *link != STORE_MAP_NONE;) {
+      uns              idx = *link;
+      Store_Map_Store* st  = &map_data->stores[idx];
+      if(st->op != op && (st->off_path != op->off_path ||
+                          !store_map_visible(st) || (st->mask &= ~bytes))) {
+        link = &st->next;
+        continue;
+      }
+      *link = st->next;
+      store_map_free(idx);
     }
 
-    /* Iterate through each byte written to by the op (within this entry) */
-    for(mem_map_byte_traversal_init(&traversal);
-        !mem_map_byte_traversal_done(&traversal);
-        mem_map_byte_traversal_next(&traversal)) {
-      DEFBIT(mem_map_p->flag_mask, traversal.byte, op->off_path);
-      uns ind = MEM_MAP_BYTE_INDEX(traversal.byte, op->off_path);
-      SETBIT(mem_map_p->store_mask, ind);
-      mem_map_p->op[ind] = op;
+    uns              idx = store_map_alloc();
+    Store_Map_Store* st  = &map_data->stores[idx];
+    st->op               = op;
+    st->mask             = bytes;
+    st->epoch            = map_data->store_epoch;
+    st->off_path         = op->off_path;
+    st->next             = entry->head;
+    entry->head          = idx;
+  }
+}
+
+/**************************************************************************************/
+/* wake_up_slot: ring slot of a mapped op */
+
+static inline uns wake_up_slot(Map_Data* md, Op* op) {
+  return op->op_num & (md->wake_up_ring_size - 1);
+}
+
+/**************************************************************************************/
+/* wake_up_slot_has: is the op (still) the one mapped into the slot? */
+
+static inline Flag wake_up_slot_has(Map_Data* md, uns slot, Op* op) {
+  Wake_Up_Slot* entry = &md->wake_up_ring[slot];
+  return entry->op == op && entry->unique_num == op->unique_num &&
+         op->op_pool_valid;
+}
+
+/**************************************************************************************/
+/* wake_up_iter_start: returns the oldest live op that depends on op, NULL if
+   there is none. Dependent ops are younger than op and the ring holds less
+   than a full ring of ops, so going around the ring from the slot after op
+   visits them in program order. */
+
+Op* wake_up_iter_start(Wake_Up_Iter* iter, Op* op) {
+  Map_Data* md = proc_map_data[op->proc_id];
+  uns       slot;
+
+  ASSERT(op->proc_id, md);
+  slot           = wake_up_slot(md, op);
+  iter->map_data = md;
+  iter->row      = &md->wake_up_deps[slot * md->wake_up_words];
+  iter->first    = (slot + 1) & (md->wake_up_ring_size - 1);
+  iter->count    = 0;
+  iter->word     = iter->first / 64;
+  iter->bits     = iter->row[iter->word] & (~0ULL << (iter->first % 64));
+  if(!wake_up_slot_has(md, slot, op))
+    return NULL;  // never mapped, so nothing depends on it
+  return wake_up_iter_next(iter);
+}
+
+/**************************************************************************************/
+/* wake_up_iter_next: */
+
+Op* wake_up_iter_next(Wake_Up_Iter* iter) {
+  Map_Data* md = iter->map_data;
+
+  while(TRUE) {
+    while(iter->bits) {
+      uns slot = iter->word * 64 + __builtin_ctzll(iter->bits);
+      iter->bits &= iter->bits - 1;
+      Wake_Up_Slot* entry = &md->wake_up_ring[slot];
+      /* bits are cleared when a dependent op is freed, but check anyway */
+      if(entry->op && wake_up_slot_has(md, slot, entry->op))
+        return entry->op;
     }
+    if(iter->count == md->wake_up_words)
+      return NULL;
+    iter->count++;
+    iter->word = (iter->word + 1) % md->wake_up_words;
+    iter->bits = iter->row[iter->word];
+    /* the last word visited is the first one again, below the first slot */
+    if(iter->count == md->wake_up_words)
+      iter->bits &= ~(~0ULL << (iter->first % 64));
   }
 }
 
@@ -558,8 +740,8 @@ static inline void update_store_hash(Op* op) {
 /* wake_up_ops: */
 
 void wake_up_ops(Op* op, Dep_Type type, void (*wake_action)(Op*, Op*, uns8)) {
-  Wake_Up_Entry* temp;
-
+  Wake_Up_Iter iter;
+  Op*          dep_op;
 
   _DEBUG(op->proc_id, DEBUG_REPLAY,
          "Waking up ops from src_op:%s unique:%s type:%s\n",
@@ -569,33 +751,32 @@ void wake_up_ops(Op* op, Dep_Type type, void (*wake_action)(Op*, Op*, uns8)) {
           op->off_path);
 
   ASSERT(op->proc_id, wake_action);
-  for(temp = op->wake_up_head; temp; temp = temp->next) {
-    Op*     dep_op         = temp->op;
-    Counter dep_unique_num = temp->unique_num;
-
-    ASSERT(op->proc_id, dep_op);
-
-    if(temp->dep_type != type)
-      continue;
-    /* if the stored unique num is not the same as the op pool entry, the op has
-           been reclaimed and the wake up should be ignored */
-    if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
-      ASSERTM(op->proc_id, op->proc_id == dep_op->proc_id,
-              "dep_op proc_id: %u, valid: %u\n", dep_op->proc_id,
-              dep_op->op_pool_valid);
-      if(test_not_rdy_bit(dep_op, temp->rdy_bit)) {
+  for(dep_op = wake_up_iter_start(&iter, op); dep_op;
+      dep_op = wake_up_iter_next(&iter)) {
+    uns           slot     = wake_up_slot(iter.map_data, dep_op);
+    Wake_Up_Slot* entry    = &iter.map_data->wake_up_ring[slot];
+    uns           src_mask = entry->src_mask;
+
+    ASSERTM(op->proc_id, op->proc_id == dep_op->proc_id,
+            "dep_op proc_id: %u, valid: %u\n", dep_op->proc_id,
+            dep_op->op_pool_valid);
+    /* every source of the dependent op produced by op with this type */
+    while(src_mask) {
+      uns       rdy_bit  = __builtin_ctz(src_mask);
+      Src_Info* src_info = &entry->op_info->src_info[rdy_bit];
+      src_mask &= src_mask - 1;
+      if(src_info->op != op || src_info->unique_num != op->unique_num ||
+         src_info->type != type)
+        continue;
+      if(test_not_rdy_bit(dep_op, rdy_bit)) {
         DEBUG(dep_op->proc_id, "Waking up  op_num:%s\n",
               unsstr64(dep_op->op_num));
 
-        ASSERTM(dep_op->proc_id, test_not_rdy_bit(dep_op, temp->rdy_bit),
-                "dep_op_num:%s  not_rdy_vector:%x\n", unsstr64(dep_op->op_num),
-                dep_op->srcs_not_rdy_vector);
-
         /* unset the not ready bit for this source */
-        clear_not_rdy_bit(dep_op, temp->rdy_bit);
+        clear_not_rdy_bit(dep_op, rdy_bit);
 
         /* call the wake action function */
-        wake_action(op, dep_op, temp->rdy_bit);
+        wake_action(op, dep_op, rdy_bit);
       }
     }
   }
@@ -607,13 +788,33 @@ void wake_up_ops(Op* op, Dep_Type type, void (*wake_action)(Op*, Op*, uns8)) {
 
 void add_to_wake_up_lists(Op* op, Op_Info* op_info,
                           void (*wake_action)(Op*, Op*, uns8)) {
-  uns  ii;
-  Flag dep_on_in_window_store = FALSE;
+  uns           ii;
+  uns           slot;
+  Wake_Up_Slot* entry;
+  Flag          dep_on_in_window_store = FALSE;
   UNUSED(dep_on_in_window_store);
 
   ASSERT(map_data->proc_id, op);
   ASSERT(map_data->proc_id, op_info);
   ASSERT(map_data->proc_id, op->proc_id == map_data->proc_id);
+  ASSERT(map_data->proc_id, op_info->num_srcs <= 32);
+
+  /* claim the op's ring slot, the previous owner must be gone */
+  slot  = wake_up_slot(map_data, op);
+  entry = &map_data->wake_up_ring[slot];
+  ASSERTM(map_data->proc_id,
+          !entry->op || entry->op == op ||
+            !wake_up_slot_has(map_data, slot, entry->op),
+          "Wake up ring too small (op_num %llu and %llu in flight), increase "
+          "WAKE_UP_RING_SIZE\n",
+          entry->op->op_num, op->op_num);
+  entry->op         = op;
+  entry->unique_num = op->unique_num;
+  entry->op_info    = op_info;
+  entry->src_mask   = 0;
+  op->wake_up_count = 0;
+  memset(&map_data->wake_up_deps[slot * map_data->wake_up_words], 0,
+         map_data->wake_up_words * sizeof(uns64));
 
   for(ii = 0; ii < op_info->num_srcs; ii++) {
     Src_Info* src_info = &op_info->src_info[ii];
@@ -632,46 +833,25 @@ void add_to_wake_up_lists(Op* op, Op_Info* op_info,
       /* make sure the source op is still in the machine */
       /* add to the src op's wake up list regardless of whether
              it has already produced a result or not */
-      Wake_Up_Entry* wake;
+      uns src_slot = wake_up_slot(map_data, src_op);
 
       ASSERTM(
         op->proc_id, op->proc_id == src_op->proc_id,
         "op num: %llu fetch: %llu, src_op num: %llu unique: %llu fetch: %llu\n",
         op->op_num, op->fetch_cycle, src_op->op_num, src_op->unique_num,
         src_op->fetch_cycle);
-
-      if(map_data->free_list_head == NULL) {
-        ASSERT(map_data->proc_id,
-               map_data->active_wake_up_entries == map_data->wake_up_entries);
-        expand_wake_up_entries();
-      }
+      ASSERT(op->proc_id, wake_up_slot_has(map_data, src_slot, src_op));
 
       if(src_info->type == MEM_DATA_DEP)
         dep_on_in_window_store = TRUE;
 
-      wake = map_data->free_list_head;
-      map_data->active_wake_up_entries++;
-      map_data->free_list_head = wake->next;
-
-      wake->op         = op;
-      wake->unique_num = op->unique_num;
-      wake->dep_type   = src_info->type;
-      wake->rdy_bit    = ii;
-      wake->next       = NULL;
-
-      if(src_op->wake_up_tail == NULL) {
-        src_op->wake_up_head  = wake;
-        src_op->wake_up_tail  = wake;
-        src_op->wake_up_count = 1;
-      } else {
-        ASSERT(map_data->proc_id, src_op->wake_up_head);
-        src_op->wake_up_tail->next = wake;
-        src_op->wake_up_tail       = wake;
-        src_op->wake_up_count++;
-      }
+      SETBIT(entry->src_mask, ii);
+      map_data->wake_up_deps[src_slot * map_data->wake_up_words + slot / 64] |=
+        1ULL << (slot % 64);
+      src_op->wake_up_count++;
 
       if(TRACK_L1_MISS_DEPS) {
-        // An op can occupy multiple entries in the wakeup list of another op
+        // An op can be in the wake up list of another op for several sources
         if(src_op->engine_info.l1_miss &&
            !src_op->engine_info.l1_miss_satisfied)
           op->engine_info.dep_on_l1_miss = TRUE;
@@ -699,26 +879,37 @@ void add_to_wake_up_lists(Op* op, Op_Info* op_info,
 
 
 /**************************************************************************************/
-/* free_wake_up_list: */
+/* free_wake_up_list: release the op's ring slot and remove it from the
+   wake up lists of its sources (its slot may be reused by a younger op with
+   the same op_num after a recovery) */
 
 void free_wake_up_list(Op* op) {
-  ASSERT(map_data->proc_id, op);
-  ASSERT(map_data->proc_id, op->proc_id == map_data->proc_id);
-
-  if(op->wake_up_tail) {
-    ASSERT(map_data->proc_id, op->wake_up_head);
-    DEBUG(map_data->proc_id, "Freeing wake up list for op_num:%s\n",
-          unsstr64(op->op_num));
-    op->wake_up_tail->next   = map_data->free_list_head;
-    map_data->free_list_head = op->wake_up_head;
-    map_data->active_wake_up_entries -= op->wake_up_count;
-    ASSERT(map_data->proc_id, map_data->active_wake_up_entries >= 0);
-    op->wake_up_head = NULL;
-    op->wake_up_tail = NULL;
-  } else {
-    DEBUG(map_data->proc_id, "No wake up list for op_num:%s\n",
+  Map_Data*     md = proc_map_data[op->proc_id];
+  uns           slot;
+  Wake_Up_Slot* entry;
+  uns           src_mask;
+
+  ASSERT(op->proc_id, md);
+  slot  = wake_up_slot(md, op);
+  entry = &md->wake_up_ring[slot];
+  if(!wake_up_slot_has(md, slot, op)) {
+    DEBUG(op->proc_id, "No wake up list for op_num:%s\n",
           unsstr64(op->op_num));
+    return;
+  }
+
+  DEBUG(op->proc_id, "Freeing wake up list for op_num:%s\n",
+        unsstr64(op->op_num));
+  for(src_mask = entry->src_mask; src_mask; src_mask &= src_mask - 1) {
+    Src_Info* src_info = &entry->op_info->src_info[__builtin_ctz(src_mask)];
+    Op*       src_op   = src_info->op;
+    uns       src_slot = wake_up_slot(md, src_op);
+    if(src_op->unique_num == src_info->unique_num &&
+       wake_up_slot_has(md, src_slot, src_op))
+      md->wake_up_deps[src_slot * md->wake_up_words + slot / 64] &=
+        ~(1ULL << (slot % 64));
   }
+  entry->op = NULL;
 }
 
 
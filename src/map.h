@@ -44,6 +44,16 @@ typedef struct Map_Entry_struct {
                          only overwritten) */
 } Map_Entry;
 
+typedef struct Wake_Up_Slot_struct {
+  Op*      op;          /* op mapped into the slot (NULL if none) */
+  Counter  unique_num;  /* unique number of that op */
+  Op_Info* op_info;     /* op_info whose sources were added to wake up lists */
+  uns      src_mask;    /* sources that were added (bits of op_info src_info) */
+} Wake_Up_Slot;
+
+typedef struct Store_Map_Line_struct  Store_Map_Line;
+typedef struct Store_Map_Store_struct Store_Map_Store;
+
 typedef struct Map_Data_struct {
   /* store information about the last op to write each register */
   uns8      proc_id;
@@ -53,13 +63,35 @@ typedef struct Map_Data_struct {
   Map_Entry last_store[2];
   Flag      last_store_flag;
 
-  Hash_Table oracle_mem_hash;
-
-  Wake_Up_Entry* free_list_head;
-  uns            wake_up_entries;
-  uns            active_wake_up_entries;
+  /* In-flight stores for memory dependences: an open addressed table of the
+     lines they write, each with a list of store records (youngest first) */
+  Store_Map_Line*  store_lines;
+  Store_Map_Store* stores;
+  uns              store_lines_size;  // power of 2
+  uns              num_store_lines;
+  uns              stores_size;
+  uns              free_store;   // head of the free store record list
+  uns              store_epoch;  // bumped on every recovery
+
+  /* Mapped ops in flight, in slot op_num % wake_up_ring_size. Row s of
+     wake_up_deps is a bitmap of the slots of the ops that depend on the op in
+     slot s. */
+  Wake_Up_Slot* wake_up_ring;
+  uns64*        wake_up_deps;
+  uns           wake_up_ring_size;
+  uns           wake_up_words;  // uns64 words per bitmap row
 } Map_Data;
 
+/* iterator over the live ops that depend on an op (oldest first) */
+typedef struct Wake_Up_Iter_struct {
+  Map_Data* map_data;
+  uns64*    row;
+  uns       first;  // first slot after the producer
+  uns       count;  // words visited so far
+  uns       word;
+  uns64     bits;
+} Wake_Up_Iter;
+
 
 /**************************************************************************************/
 /* External Variables */
@@ -80,6 +112,8 @@ void      map_mem_dep(Op*);
 void      wake_up_ops(Op*, Dep_Type, void (*)(Op*, Op*, uns8));
 void      free_wake_up_list(Op*);
 void      add_to_wake_up_lists(Op*, Op_Info*, void (*)(Op*, Op*, uns8));
+Op*       wake_up_iter_start(Wake_Up_Iter*, Op*);
+Op*       wake_up_iter_next(Wake_Up_Iter*);
 
 void add_src_from_op(Op*, Op*, Dep_Type);
 void add_src_from_map_entry(Op*, Map_Entry*, Dep_Type);
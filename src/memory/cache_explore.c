@@ -0,0 +1,338 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cache_explore.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Functional cache exploration.
+ *
+ * During warmup every data access of a core (the DCACHE level) and every
+ * access that leaves its icache/dcache (the UNCORE level, the stream
+ * warmup_uncore sees) is fed to
+ *
+ *  - one private instance per core of each cache in CACHE_EXPLORE_CONFIGS,
+ *    so a whole sweep of sizes and associativities takes a single run, and
+ *  - an LRU stack distance monitor per core and level (Mattson et al.), which
+ *    gives the misses of a fully associative LRU cache of every size at once.
+ *
+ * The stack distance of an access is the number of distinct lines touched
+ * since the previous access to its line. Each line keeps the time of its last
+ * access in a hash table and a Fenwick tree over time marks the last access
+ * of every line, so the distance is the number of marks after that time.
+ * When the times run out the live lines are renumbered 1..n in order.
+ *
+ * The results are stats (memory/cache_explore.stat.def), so they come out
+ * per core in the regular stat files.
+ ***************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug/debug_macros.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "libs/cache_lib.h"
+#include "libs/hash_lib.h"
+#include "memory/cache_explore.h"
+#include "statistics.h"
+
+#include "core.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define MAX_EXPLORE_CONFIGS 16
+#define NUM_LRU_SIZES 17 /* 1KB to 64MB */
+#define STACK_DIST_INIT_CAPACITY (1 << 16)
+
+/**************************************************************************************/
+/* Types */
+
+typedef enum Explore_Level_enum {
+  EXPLORE_DCACHE,
+  EXPLORE_UNCORE,
+  NUM_EXPLORE_LEVELS
+} Explore_Level;
+
+typedef struct Stack_Dist_struct {
+  Hash_Table last_use;  /* line address -> time of its last access */
+  uns*       tree;      /* Fenwick tree over time, 1-based */
+  uns64      capacity;  /* number of times the tree can hold */
+  uns64      next_time; /* time of the next access */
+  uns64      live;      /* distinct lines seen so far */
+} Stack_Dist;
+
+typedef struct Explore_Config_struct {
+  Explore_Level level;
+  uns           size;
+  uns           assoc;
+  Cache*        caches; /* one per core */
+} Explore_Config;
+
+/**************************************************************************************/
+/* Global variables */
+
+static const char* const level_names[NUM_EXPLORE_LEVELS] = {"dcache",
+                                                             "uncore"};
+static const Stat_Enum   level_stats[NUM_EXPLORE_LEVELS]  = {
+  CACHE_EXPLORE_DCACHE_ACCESS, CACHE_EXPLORE_UNCORE_ACCESS};
+
+static Explore_Config configs[MAX_EXPLORE_CONFIGS];
+static uns            num_configs;
+static Stack_Dist*    stack_dists; /* [proc_id * NUM_EXPLORE_LEVELS + level] */
+static uns            line_shift;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void  parse_configs(void);
+static uns   parse_size(const char* str);
+static void  explore_access(uns proc_id, Explore_Level level, Addr addr);
+static void  stack_dist_init(Stack_Dist* sd, const char* name);
+static uns64 stack_dist_access(Stack_Dist* sd, Addr line);
+static void  stack_dist_compact(Stack_Dist* sd);
+static int   cmp_time_ptr(const void* a, const void* b);
+
+/**************************************************************************************/
+/* cache_explore_init: */
+
+void cache_explore_init(void) {
+  if(!CACHE_EXPLORE)
+    return;
+
+  ASSERTM(0, is_power_of_2(CACHE_EXPLORE_LINE_SIZE) &&
+               CACHE_EXPLORE_LINE_SIZE <= 1024,
+          "CACHE_EXPLORE_LINE_SIZE must be a power of two up to 1KB\n");
+  line_shift = LOG2(CACHE_EXPLORE_LINE_SIZE);
+
+  parse_configs();
+
+  if(CACHE_EXPLORE_STACK_DISTANCE) {
+    stack_dists = (Stack_Dist*)calloc(NUM_CORES * NUM_EXPLORE_LEVELS,
+                                      sizeof(Stack_Dist));
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+      for(uns level = 0; level < NUM_EXPLORE_LEVELS; level++)
+        stack_dist_init(&stack_dists[proc_id * NUM_EXPLORE_LEVELS + level],
+                        level_names[level]);
+  }
+}
+
+/**************************************************************************************/
+/* cache_explore_dcache_access: */
+
+void cache_explore_dcache_access(uns proc_id, Addr addr) {
+  explore_access(proc_id, EXPLORE_DCACHE, addr);
+}
+
+/**************************************************************************************/
+/* cache_explore_uncore_access: */
+
+void cache_explore_uncore_access(uns proc_id, Addr addr) {
+  explore_access(proc_id, EXPLORE_UNCORE, addr);
+}
+
+/**************************************************************************************/
+/* parse_configs: */
+
+static void parse_configs(void) {
+  char  buf[MAX_STR_LENGTH + 1];
+  char* spec;
+  char* save;
+
+  if(!CACHE_EXPLORE_CONFIGS)
+    return;
+  strncpy(buf, CACHE_EXPLORE_CONFIGS, MAX_STR_LENGTH);
+  buf[MAX_STR_LENGTH] = '\0';
+
+  for(spec = strtok_r(buf, ",", &save); spec;
+      spec = strtok_r(NULL, ",", &save)) {
+    char  level[16];
+    char  size[32];
+    uns   assoc;
+    uns   ii;
+    ASSERTM(0, num_configs < MAX_EXPLORE_CONFIGS,
+            "At most %d cache exploration configs are supported\n",
+            MAX_EXPLORE_CONFIGS);
+    ASSERTM(0, sscanf(spec, "%15[^:]:%31[^:]:%u", level, size, &assoc) == 3,
+            "Bad cache exploration config '%s'\n", spec);
+
+    Explore_Config* config = &configs[num_configs];
+    for(ii = 0; ii < NUM_EXPLORE_LEVELS; ii++)
+      if(!strcmp(level, level_names[ii]))
+        break;
+    ASSERTM(0, ii < NUM_EXPLORE_LEVELS,
+            "Unknown cache exploration level '%s'\n", level);
+    config->level = ii;
+    config->size  = parse_size(size);
+    config->assoc = assoc;
+    ASSERTM(0, assoc && config->size % (assoc * CACHE_EXPLORE_LINE_SIZE) == 0,
+            "Cache exploration config '%s' has no whole number of sets\n",
+            spec);
+
+    config->caches = (Cache*)calloc(NUM_CORES, sizeof(Cache));
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      char name[MAX_STR_LENGTH + 1];
+      snprintf(name, MAX_STR_LENGTH, "EXPLORE %s[%u]", spec, proc_id);
+      init_cache(&config->caches[proc_id], name, config->size, assoc,
+                 CACHE_EXPLORE_LINE_SIZE, sizeof(Flag), REPL_TRUE_LRU);
+    }
+    fprintf(mystdout, "Cache exploration config %u: %s %u bytes %u-way\n",
+            num_configs, level_names[config->level], config->size, assoc);
+    num_configs++;
+  }
+}
+
+/**************************************************************************************/
+/* parse_size: bytes, with an optional k or m suffix */
+
+static uns parse_size(const char* str) {
+  char* end;
+  uns64 size = strtoull(str, &end, 0);
+  if(*end == 'k' || *end == 'K')
+    size <<= 10;
+  else if(*end == 'm' || *end == 'M')
+    size <<= 20;
+  else
+    ASSERTM(0, *end == '\0', "Bad cache size '%s'\n", str);
+  ASSERTM(0, size && size <= 0xffffffffULL, "Bad cache size '%s'\n", str);
+  return size;
+}
+
+/**************************************************************************************/
+/* explore_access: */
+
+static void explore_access(uns proc_id, Explore_Level level, Addr addr) {
+  const Stat_Enum access_stat = level_stats[level];
+  STAT_EVENT(proc_id, access_stat);
+
+  if(CACHE_EXPLORE_STACK_DISTANCE) {
+    Stack_Dist* sd   = &stack_dists[proc_id * NUM_EXPLORE_LEVELS + level];
+    uns64       dist = stack_dist_access(sd, addr >> line_shift);
+    if(dist == MAX_CTR)
+      STAT_EVENT(proc_id, access_stat + 1);  // COLD_MISS
+    /* an LRU cache of 2^k KB holds the 2^k KB / line size most recently
+       used lines, so it misses whenever the distance reaches that */
+    for(uns kk = 0;
+        kk < NUM_LRU_SIZES && dist >= (1024ULL << kk) >> line_shift; kk++)
+      STAT_EVENT(proc_id, access_stat + 2 + kk);  // LRU_MISS_<size>
+  }
+
+  for(uns ii = 0; ii < num_configs; ii++) {
+    Explore_Config* config = &configs[ii];
+    Cache*          cache  = &config->caches[proc_id];
+    Addr            line_addr, repl_line_addr;
+    if(config->level != level)
+      continue;
+    STAT_EVENT(proc_id, CACHE_EXPLORE_CFG0_ACCESS + 2 * ii);
+    if(!cache_access(cache, addr, &line_addr, TRUE)) {
+      STAT_EVENT(proc_id, CACHE_EXPLORE_CFG0_MISS + 2 * ii);
+      cache_insert(cache, proc_id, addr, &line_addr, &repl_line_addr);
+    }
+  }
+}
+
+/**************************************************************************************/
+/* stack_dist_init: */
+
+static void stack_dist_init(Stack_Dist* sd, const char* name) {
+  init_hash_table(&sd->last_use, name, STACK_DIST_INIT_CAPACITY,
+                  sizeof(uns64));
+  sd->capacity  = STACK_DIST_INIT_CAPACITY;
+  sd->tree      = (uns*)calloc(sd->capacity + 1, sizeof(uns));
+  sd->next_time = 1;
+  sd->live      = 0;
+}
+
+/**************************************************************************************/
+/* stack_dist_access: returns the stack distance of the access, MAX_CTR for
+   the first access to a line */
+
+static uns64 stack_dist_access(Stack_Dist* sd, Addr line) {
+  uns64  dist = MAX_CTR;
+  Flag   new_entry;
+  uns64* last;
+  uns64  ii;
+
+  if(sd->next_time > sd->capacity)
+    stack_dist_compact(sd);
+
+  last = (uns64*)hash_table_access_create(&sd->last_use, line, &new_entry);
+  if(new_entry) {
+    sd->live++;
+  } else {
+    /* marks up to and including the last access of this line */
+    uns64 before = 0;
+    for(ii = *last; ii > 0; ii -= ii & -ii)
+      before += sd->tree[ii];
+    dist = sd->live - before;
+    for(ii = *last; ii <= sd->capacity; ii += ii & -ii)
+      sd->tree[ii]--;
+  }
+
+  *last = sd->next_time++;
+  for(ii = *last; ii <= sd->capacity; ii += ii & -ii)
+    sd->tree[ii]++;
+  return dist;
+}
+
+/**************************************************************************************/
+/* stack_dist_compact: renumbers the live lines 1..n by their last access and
+   makes sure at least half of the tree is free afterwards */
+
+static void stack_dist_compact(Stack_Dist* sd) {
+  uns64** times = (uns64**)hash_table_flatten(&sd->last_use, NULL);
+  uns64   n     = sd->live;
+  uns64   ii;
+
+  ASSERT(0, n == sd->last_use.count);
+  qsort(times, n, sizeof(uns64*), cmp_time_ptr);
+  for(ii = 0; ii < n; ii++)
+    *times[ii] = ii + 1;
+  free(times);
+
+  if(2 * n > sd->capacity) {
+    sd->capacity = 2 * n;
+    sd->tree = (uns*)realloc(sd->tree, (sd->capacity + 1) * sizeof(uns));
+    ASSERT(0, sd->tree);
+  }
+  /* every time 1..n is marked: node ii covers (ii - lowbit(ii), ii] */
+  for(ii = 1; ii <= sd->capacity; ii++) {
+    uns64 low    = ii - (ii & -ii);
+    sd->tree[ii] = low < n ? MIN2(ii, n) - low : 0;
+  }
+  sd->next_time = n + 1;
+}
+
+/**************************************************************************************/
+/* cmp_time_ptr: */
+
+static int cmp_time_ptr(const void* a, const void* b) {
+  uns64 ta = **(uns64* const*)a;
+  uns64 tb = **(uns64* const*)b;
+  return ta < tb ? -1 : ta > tb;
+}
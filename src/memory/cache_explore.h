@@ -0,0 +1,47 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cache_explore.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Functional cache exploration: many cache configurations and
+ *                LRU stack distance monitors fed from the warmup access stream
+ ***************************************************************************************/
+
+#ifndef __CACHE_EXPLORE_H__
+#define __CACHE_EXPLORE_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize (does nothing unless CACHE_EXPLORE is set) */
+void cache_explore_init(void);
+
+/* Report a data access of the core during warmup */
+void cache_explore_dcache_access(uns proc_id, Addr addr);
+
+/* Report an access that missed the core's first level caches during warmup */
+void cache_explore_uncore_access(uns proc_id, Addr addr);
+
+#endif /* #ifndef __CACHE_EXPLORE_H__ */
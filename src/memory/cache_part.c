@@ -33,7 +33,9 @@
 #include "globals/assert.h"
 #include "globals/global_types.h"
 #include "libs/cache_lib.h"
+#include "libs/set_mon_lib.h"
 #include "memory/cache_part.h"
+#include "memory/cache_part_solver.h"
 #include "memory/mem_req.h"
 #include "memory/memory.h"
 #include "memory/memory.param.h"
@@ -50,21 +52,22 @@
 /* Types */
 
 typedef struct Proc_Info_struct {
-  Cache   shadow_cache;
   double* miss_rates;  // indexed by number of ways - 1
 } Proc_Info;
 
-typedef struct Shadow_Cache_Data_struct {
-  Flag prefetched;
-} Shadow_Cache_Data;
+typedef struct Shadow_Data_struct {
+  Counter fetch_cycle;
+} Shadow_Data;
 
 typedef double (*Metric_Func)(uns*);
 typedef void (*Search_Func)(void);
+typedef double (*Core_Cost_Func)(uns proc_id, uns ways);
 
 /**************************************************************************************/
 /* Global variables */
 
 Proc_Info* proc_infos;
+Set_Mon    shadow_tags;  // per-core shadow tags of the sampled L1 sets
 Trigger*   l1_part_start;  // indicates the L1 partition has been enabled
 Trigger* l1_part_trigger;  // external trigger for trigger repart (should not be
                            // set too often)
@@ -76,6 +79,13 @@ uns*        new_partition;      // pre-allocated structure for new partition
 uns* temp_partition;  // pre-allocated structure for partition exploration
 uns  tie_breaker_proc_id;
 
+// dp/fast_lookahead searches minimize a sum of per-core costs
+Core_Cost_Func   core_cost_func;
+Part_Solver*     part_solver;
+Part_Solver_Algo part_solver_algo;
+Flag             part_solver_pending;      // async solve not applied yet
+Counter          part_solver_apply_cycle;  // L1 cycle to apply it at
+
 /**************************************************************************************/
 /* Enums */
 
@@ -85,16 +95,23 @@ DEFINE_ENUM(Cache_Part_Search, CACHE_PART_SEARCH_LIST);
 /**************************************************************************************/
 /* Local Prototypes */
 
-static Flag   in_shadow_cache(Addr addr);
 static double get_global_miss_rate(uns* partition);
 static double get_miss_rate_sum(uns* partition);
 static double get_gmean_perf(uns* partition);
+static double predict_perf(uns proc_id, uns ways);
+static double get_core_miss_count(uns proc_id, uns ways);
+static double get_core_miss_rate(uns proc_id, uns ways);
+static double get_core_neg_log_perf(uns proc_id, uns ways);
 static double get_best_marginal_utility(uns* partition, uns proc_id,
                                         uns balance, uns* extra_ways);
 static void   measure_miss_curves(void);
 static void   search_lookahead(void);
 static void   search_bruteforce(void);
+static void   fill_solver_costs(void);
+static void   search_solver(void);
+static void   apply_solver_partition(void);
 static void   set_partition(void);
+static void   apply_partition(void);
 static void   debug_cache_part(uns* old_partition, uns* new_partition);
 
 
@@ -111,281 +128,20 @@ void cache_part_init(void) {
   ASSERT(0, L1_CACHE_REPL_POLICY == REPL_PARTITION);
   ASSERT(0, L1_ASSOC <= 128);
 
-  // create shadow cache for each core
+  // per-core shadow tags, only for every L1_SHADOW_TAGS_MODULO-th set
+  set_mon_init(&shadow_tags, "SHADOW L1", L1_SIZE / L1_LINE_SIZE / L1_ASSOC,
+               L1_ASSOC, L1_LINE_SIZE, NUM_CORES, L1_SHADOW_TAGS_MODULO,
+               sizeof(Shadow_Data));
   proc_infos = calloc(NUM_CORES, sizeof(Proc_Info));
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    Proc_Info* proc_info = &proc_infos[proc_id];
-    char       buf[MAX_STR_LENGTH + 1];
-    sprintf(buf, "SHADOW L1[%d]", proc_id);
-    init_cache(&proc_info->shadow_cache, buf, L1_SIZE, L1_ASSOC, L1_LINE_SIZE,
-               sizeof(Shadow_Cache_Data), REPL_TRUE_LRU);
-    proc_info->miss_rates = calloc(L1_ASSOC, sizeof(double));
+    proc_infos[proc_id].miss_rates = calloc(L1_ASSOC, sizeof(double));
   }
 
   l1_part_trigger = trigger_create("L1 PART TRIGGER", L1_PART_TRIGGER,
                                    TRIGGER_REPEAT);
   l1_part_start = trigger_create("L1 PART START", L1_PART_START, TRIGGER_ONCE);
-  Stat_Enum monitored_stats[] = {NODE_CYCLE,
-                                 RET_BLOCKED_L1_MISS,
-                                 CORE_MEM_BLOCKED,
-                                 L1_SHADOW_ACCESS_STALLING,
-                                 L1_SHADOW_ACCESS_DEMAND,
-                                 L1_SHADOW_STALLING_HIT_POS0,
-                                 L1_SHADOW_STALLING_HIT_POS1,
-                                 L1_SHADOW_STALLING_HIT_POS2,
-                                 L1_SHADOW_STALLING_HIT_POS3,
-                                 L1_SHADOW_STALLING_HIT_POS4,
-                                 L1_SHADOW_STALLING_HIT_POS5,
-                                 L1_SHADOW_STALLING_HIT_POS6,
-                                 L1_SHADOW_STALLING_HIT_POS7,
-                                 L1_SHADOW_STALLING_HIT_POS8,
-                                 L1_SHADOW_STALLING_HIT_POS9,
-                                 L1_SHADOW_STALLING_HIT_POS10,
-                                 L1_SHADOW_STALLING_HIT_POS11,
-                                 L1_SHADOW_STALLING_HIT_POS12,
-                                 L1_SHADOW_STALLING_HIT_POS13,
-                                 L1_SHADOW_STALLING_HIT_POS14,
-                                 L1_SHADOW_STALLING_HIT_POS15,
-                                 L1_SHADOW_STALLING_HIT_POS16,
-                                 L1_SHADOW_STALLING_HIT_POS17,
-                                 L1_SHADOW_STALLING_HIT_POS18,
-                                 L1_SHADOW_STALLING_HIT_POS19,
-                                 L1_SHADOW_STALLING_HIT_POS20,
-                                 L1_SHADOW_STALLING_HIT_POS21,
-                                 L1_SHADOW_STALLING_HIT_POS22,
-                                 L1_SHADOW_STALLING_HIT_POS23,
-                                 L1_SHADOW_STALLING_HIT_POS24,
-                                 L1_SHADOW_STALLING_HIT_POS25,
-                                 L1_SHADOW_STALLING_HIT_POS26,
-                                 L1_SHADOW_STALLING_HIT_POS27,
-                                 L1_SHADOW_STALLING_HIT_POS28,
-                                 L1_SHADOW_STALLING_HIT_POS29,
-                                 L1_SHADOW_STALLING_HIT_POS30,
-                                 L1_SHADOW_STALLING_HIT_POS31,
-                                 L1_SHADOW_STALLING_HIT_POS32,
-                                 L1_SHADOW_STALLING_HIT_POS33,
-                                 L1_SHADOW_STALLING_HIT_POS34,
-                                 L1_SHADOW_STALLING_HIT_POS35,
-                                 L1_SHADOW_STALLING_HIT_POS36,
-                                 L1_SHADOW_STALLING_HIT_POS37,
-                                 L1_SHADOW_STALLING_HIT_POS38,
-                                 L1_SHADOW_STALLING_HIT_POS39,
-                                 L1_SHADOW_STALLING_HIT_POS40,
-                                 L1_SHADOW_STALLING_HIT_POS41,
-                                 L1_SHADOW_STALLING_HIT_POS42,
-                                 L1_SHADOW_STALLING_HIT_POS43,
-                                 L1_SHADOW_STALLING_HIT_POS44,
-                                 L1_SHADOW_STALLING_HIT_POS45,
-                                 L1_SHADOW_STALLING_HIT_POS46,
-                                 L1_SHADOW_STALLING_HIT_POS47,
-                                 L1_SHADOW_STALLING_HIT_POS48,
-                                 L1_SHADOW_STALLING_HIT_POS49,
-                                 L1_SHADOW_STALLING_HIT_POS50,
-                                 L1_SHADOW_STALLING_HIT_POS51,
-                                 L1_SHADOW_STALLING_HIT_POS52,
-                                 L1_SHADOW_STALLING_HIT_POS53,
-                                 L1_SHADOW_STALLING_HIT_POS54,
-                                 L1_SHADOW_STALLING_HIT_POS55,
-                                 L1_SHADOW_STALLING_HIT_POS56,
-                                 L1_SHADOW_STALLING_HIT_POS57,
-                                 L1_SHADOW_STALLING_HIT_POS58,
-                                 L1_SHADOW_STALLING_HIT_POS59,
-                                 L1_SHADOW_STALLING_HIT_POS60,
-                                 L1_SHADOW_STALLING_HIT_POS61,
-                                 L1_SHADOW_STALLING_HIT_POS62,
-                                 L1_SHADOW_STALLING_HIT_POS63,
-                                 L1_SHADOW_STALLING_HIT_POS64,
-                                 L1_SHADOW_STALLING_HIT_POS65,
-                                 L1_SHADOW_STALLING_HIT_POS66,
-                                 L1_SHADOW_STALLING_HIT_POS67,
-                                 L1_SHADOW_STALLING_HIT_POS68,
-                                 L1_SHADOW_STALLING_HIT_POS69,
-                                 L1_SHADOW_STALLING_HIT_POS70,
-                                 L1_SHADOW_STALLING_HIT_POS71,
-                                 L1_SHADOW_STALLING_HIT_POS72,
-                                 L1_SHADOW_STALLING_HIT_POS73,
-                                 L1_SHADOW_STALLING_HIT_POS74,
-                                 L1_SHADOW_STALLING_HIT_POS75,
-                                 L1_SHADOW_STALLING_HIT_POS76,
-                                 L1_SHADOW_STALLING_HIT_POS77,
-                                 L1_SHADOW_STALLING_HIT_POS78,
-                                 L1_SHADOW_STALLING_HIT_POS79,
-                                 L1_SHADOW_STALLING_HIT_POS80,
-                                 L1_SHADOW_STALLING_HIT_POS81,
-                                 L1_SHADOW_STALLING_HIT_POS82,
-                                 L1_SHADOW_STALLING_HIT_POS83,
-                                 L1_SHADOW_STALLING_HIT_POS84,
-                                 L1_SHADOW_STALLING_HIT_POS85,
-                                 L1_SHADOW_STALLING_HIT_POS86,
-                                 L1_SHADOW_STALLING_HIT_POS87,
-                                 L1_SHADOW_STALLING_HIT_POS88,
-                                 L1_SHADOW_STALLING_HIT_POS89,
-                                 L1_SHADOW_STALLING_HIT_POS90,
-                                 L1_SHADOW_STALLING_HIT_POS91,
-                                 L1_SHADOW_STALLING_HIT_POS92,
-                                 L1_SHADOW_STALLING_HIT_POS93,
-                                 L1_SHADOW_STALLING_HIT_POS94,
-                                 L1_SHADOW_STALLING_HIT_POS95,
-                                 L1_SHADOW_STALLING_HIT_POS96,
-                                 L1_SHADOW_STALLING_HIT_POS97,
-                                 L1_SHADOW_STALLING_HIT_POS98,
-                                 L1_SHADOW_STALLING_HIT_POS99,
-                                 L1_SHADOW_STALLING_HIT_POS100,
-                                 L1_SHADOW_STALLING_HIT_POS101,
-                                 L1_SHADOW_STALLING_HIT_POS102,
-                                 L1_SHADOW_STALLING_HIT_POS103,
-                                 L1_SHADOW_STALLING_HIT_POS104,
-                                 L1_SHADOW_STALLING_HIT_POS105,
-                                 L1_SHADOW_STALLING_HIT_POS106,
-                                 L1_SHADOW_STALLING_HIT_POS107,
-                                 L1_SHADOW_STALLING_HIT_POS108,
-                                 L1_SHADOW_STALLING_HIT_POS109,
-                                 L1_SHADOW_STALLING_HIT_POS110,
-                                 L1_SHADOW_STALLING_HIT_POS111,
-                                 L1_SHADOW_STALLING_HIT_POS112,
-                                 L1_SHADOW_STALLING_HIT_POS113,
-                                 L1_SHADOW_STALLING_HIT_POS114,
-                                 L1_SHADOW_STALLING_HIT_POS115,
-                                 L1_SHADOW_STALLING_HIT_POS116,
-                                 L1_SHADOW_STALLING_HIT_POS117,
-                                 L1_SHADOW_STALLING_HIT_POS118,
-                                 L1_SHADOW_STALLING_HIT_POS119,
-                                 L1_SHADOW_STALLING_HIT_POS120,
-                                 L1_SHADOW_STALLING_HIT_POS121,
-                                 L1_SHADOW_STALLING_HIT_POS122,
-                                 L1_SHADOW_STALLING_HIT_POS123,
-                                 L1_SHADOW_STALLING_HIT_POS124,
-                                 L1_SHADOW_STALLING_HIT_POS125,
-                                 L1_SHADOW_STALLING_HIT_POS126,
-                                 L1_SHADOW_STALLING_HIT_POS127,
-                                 L1_SHADOW_DEMAND_HIT_POS0,
-                                 L1_SHADOW_DEMAND_HIT_POS1,
-                                 L1_SHADOW_DEMAND_HIT_POS2,
-                                 L1_SHADOW_DEMAND_HIT_POS3,
-                                 L1_SHADOW_DEMAND_HIT_POS4,
-                                 L1_SHADOW_DEMAND_HIT_POS5,
-                                 L1_SHADOW_DEMAND_HIT_POS6,
-                                 L1_SHADOW_DEMAND_HIT_POS7,
-                                 L1_SHADOW_DEMAND_HIT_POS8,
-                                 L1_SHADOW_DEMAND_HIT_POS9,
-                                 L1_SHADOW_DEMAND_HIT_POS10,
-                                 L1_SHADOW_DEMAND_HIT_POS11,
-                                 L1_SHADOW_DEMAND_HIT_POS12,
-                                 L1_SHADOW_DEMAND_HIT_POS13,
-                                 L1_SHADOW_DEMAND_HIT_POS14,
-                                 L1_SHADOW_DEMAND_HIT_POS15,
-                                 L1_SHADOW_DEMAND_HIT_POS16,
-                                 L1_SHADOW_DEMAND_HIT_POS17,
-                                 L1_SHADOW_DEMAND_HIT_POS18,
-                                 L1_SHADOW_DEMAND_HIT_POS19,
-                                 L1_SHADOW_DEMAND_HIT_POS20,
-                                 L1_SHADOW_DEMAND_HIT_POS21,
-                                 L1_SHADOW_DEMAND_HIT_POS22,
-                                 L1_SHADOW_DEMAND_HIT_POS23,
-                                 L1_SHADOW_DEMAND_HIT_POS24,
-                                 L1_SHADOW_DEMAND_HIT_POS25,
-                                 L1_SHADOW_DEMAND_HIT_POS26,
-                                 L1_SHADOW_DEMAND_HIT_POS27,
-                                 L1_SHADOW_DEMAND_HIT_POS28,
-                                 L1_SHADOW_DEMAND_HIT_POS29,
-                                 L1_SHADOW_DEMAND_HIT_POS30,
-                                 L1_SHADOW_DEMAND_HIT_POS31,
-                                 L1_SHADOW_DEMAND_HIT_POS32,
-                                 L1_SHADOW_DEMAND_HIT_POS33,
-                                 L1_SHADOW_DEMAND_HIT_POS34,
-                                 L1_SHADOW_DEMAND_HIT_POS35,
-                                 L1_SHADOW_DEMAND_HIT_POS36,
-                                 L1_SHADOW_DEMAND_HIT_POS37,
-                                 L1_SHADOW_DEMAND_HIT_POS38,
-                                 L1_SHADOW_DEMAND_HIT_POS39,
-                                 L1_SHADOW_DEMAND_HIT_POS40,
-                                 L1_SHADOW_DEMAND_HIT_POS41,
-                                 L1_SHADOW_DEMAND_HIT_POS42,
-                                 L1_SHADOW_DEMAND_HIT_POS43,
-                                 L1_SHADOW_DEMAND_HIT_POS44,
-                                 L1_SHADOW_DEMAND_HIT_POS45,
-                                 L1_SHADOW_DEMAND_HIT_POS46,
-                                 L1_SHADOW_DEMAND_HIT_POS47,
-                                 L1_SHADOW_DEMAND_HIT_POS48,
-                                 L1_SHADOW_DEMAND_HIT_POS49,
-                                 L1_SHADOW_DEMAND_HIT_POS50,
-                                 L1_SHADOW_DEMAND_HIT_POS51,
-                                 L1_SHADOW_DEMAND_HIT_POS52,
-                                 L1_SHADOW_DEMAND_HIT_POS53,
-                                 L1_SHADOW_DEMAND_HIT_POS54,
-                                 L1_SHADOW_DEMAND_HIT_POS55,
-                                 L1_SHADOW_DEMAND_HIT_POS56,
-                                 L1_SHADOW_DEMAND_HIT_POS57,
-                                 L1_SHADOW_DEMAND_HIT_POS58,
-                                 L1_SHADOW_DEMAND_HIT_POS59,
-                                 L1_SHADOW_DEMAND_HIT_POS60,
-                                 L1_SHADOW_DEMAND_HIT_POS61,
-                                 L1_SHADOW_DEMAND_HIT_POS62,
-                                 L1_SHADOW_DEMAND_HIT_POS63,
-                                 L1_SHADOW_DEMAND_HIT_POS64,
-                                 L1_SHADOW_DEMAND_HIT_POS65,
-                                 L1_SHADOW_DEMAND_HIT_POS66,
-                                 L1_SHADOW_DEMAND_HIT_POS67,
-                                 L1_SHADOW_DEMAND_HIT_POS68,
-                                 L1_SHADOW_DEMAND_HIT_POS69,
-                                 L1_SHADOW_DEMAND_HIT_POS70,
-                                 L1_SHADOW_DEMAND_HIT_POS71,
-                                 L1_SHADOW_DEMAND_HIT_POS72,
-                                 L1_SHADOW_DEMAND_HIT_POS73,
-                                 L1_SHADOW_DEMAND_HIT_POS74,
-                                 L1_SHADOW_DEMAND_HIT_POS75,
-                                 L1_SHADOW_DEMAND_HIT_POS76,
-                                 L1_SHADOW_DEMAND_HIT_POS77,
-                                 L1_SHADOW_DEMAND_HIT_POS78,
-                                 L1_SHADOW_DEMAND_HIT_POS79,
-                                 L1_SHADOW_DEMAND_HIT_POS80,
-                                 L1_SHADOW_DEMAND_HIT_POS81,
-                                 L1_SHADOW_DEMAND_HIT_POS82,
-                                 L1_SHADOW_DEMAND_HIT_POS83,
-                                 L1_SHADOW_DEMAND_HIT_POS84,
-                                 L1_SHADOW_DEMAND_HIT_POS85,
-                                 L1_SHADOW_DEMAND_HIT_POS86,
-                                 L1_SHADOW_DEMAND_HIT_POS87,
-                                 L1_SHADOW_DEMAND_HIT_POS88,
-                                 L1_SHADOW_DEMAND_HIT_POS89,
-                                 L1_SHADOW_DEMAND_HIT_POS90,
-                                 L1_SHADOW_DEMAND_HIT_POS91,
-                                 L1_SHADOW_DEMAND_HIT_POS92,
-                                 L1_SHADOW_DEMAND_HIT_POS93,
-                                 L1_SHADOW_DEMAND_HIT_POS94,
-                                 L1_SHADOW_DEMAND_HIT_POS95,
-                                 L1_SHADOW_DEMAND_HIT_POS96,
-                                 L1_SHADOW_DEMAND_HIT_POS97,
-                                 L1_SHADOW_DEMAND_HIT_POS98,
-                                 L1_SHADOW_DEMAND_HIT_POS99,
-                                 L1_SHADOW_DEMAND_HIT_POS100,
-                                 L1_SHADOW_DEMAND_HIT_POS101,
-                                 L1_SHADOW_DEMAND_HIT_POS102,
-                                 L1_SHADOW_DEMAND_HIT_POS103,
-                                 L1_SHADOW_DEMAND_HIT_POS104,
-                                 L1_SHADOW_DEMAND_HIT_POS105,
-                                 L1_SHADOW_DEMAND_HIT_POS106,
-                                 L1_SHADOW_DEMAND_HIT_POS107,
-                                 L1_SHADOW_DEMAND_HIT_POS108,
-                                 L1_SHADOW_DEMAND_HIT_POS109,
-                                 L1_SHADOW_DEMAND_HIT_POS110,
-                                 L1_SHADOW_DEMAND_HIT_POS111,
-                                 L1_SHADOW_DEMAND_HIT_POS112,
-                                 L1_SHADOW_DEMAND_HIT_POS113,
-                                 L1_SHADOW_DEMAND_HIT_POS114,
-                                 L1_SHADOW_DEMAND_HIT_POS115,
-                                 L1_SHADOW_DEMAND_HIT_POS116,
-                                 L1_SHADOW_DEMAND_HIT_POS117,
-                                 L1_SHADOW_DEMAND_HIT_POS118,
-                                 L1_SHADOW_DEMAND_HIT_POS119,
-                                 L1_SHADOW_DEMAND_HIT_POS120,
-                                 L1_SHADOW_DEMAND_HIT_POS121,
-                                 L1_SHADOW_DEMAND_HIT_POS122,
-                                 L1_SHADOW_DEMAND_HIT_POS123,
-                                 L1_SHADOW_DEMAND_HIT_POS124,
-                                 L1_SHADOW_DEMAND_HIT_POS125,
-                                 L1_SHADOW_DEMAND_HIT_POS126,
-                                 L1_SHADOW_DEMAND_HIT_POS127};
+  Stat_Enum monitored_stats[] = {NODE_CYCLE, RET_BLOCKED_L1_MISS,
+                                 CORE_MEM_BLOCKED};
 
 
   // monitor here observe various global stats, and reset its internal
@@ -395,13 +151,17 @@ void cache_part_init(void) {
 
   switch(L1_PART_METRIC) {
     case CACHE_PART_METRIC_GLOBAL_MISS_RATE:
-      metric_func = &get_global_miss_rate;
+      metric_func    = &get_global_miss_rate;
+      core_cost_func = &get_core_miss_count;
       break;
     case CACHE_PART_METRIC_MISS_RATE_SUM:
-      metric_func = &get_miss_rate_sum;
+      metric_func    = &get_miss_rate_sum;
+      core_cost_func = &get_core_miss_rate;
       break;
     case CACHE_PART_METRIC_GMEAN_PERF:
-      metric_func = &get_gmean_perf;
+      // maximizing the product is minimizing the sum of -log(perf)
+      metric_func    = &get_gmean_perf;
+      core_cost_func = &get_core_neg_log_perf;
       break;
     default:
       FATAL_ERROR(0, "Unknown metric %s\n",
@@ -416,12 +176,28 @@ void cache_part_init(void) {
     case CACHE_PART_SEARCH_BRUTE_FORCE:
       search_func = &search_bruteforce;
       break;
+    case CACHE_PART_SEARCH_DP:
+      search_func      = &search_solver;
+      part_solver_algo = PART_SOLVER_DP;
+      break;
+    case CACHE_PART_SEARCH_FAST_LOOKAHEAD:
+      search_func      = &search_solver;
+      part_solver_algo = PART_SOLVER_LOOKAHEAD;
+      break;
     default:
       FATAL_ERROR(0, "Unknown search algorithm %s\n",
                   Cache_Part_Search_str(L1_PART_METRIC));
       break;
   }
 
+  if(search_func == &search_solver) {
+    part_solver = part_solver_create(NUM_CORES, L1_ASSOC, L1_PART_ASYNC);
+  } else {
+    ASSERTM(0, !L1_PART_ASYNC,
+            "L1_PART_ASYNC requires the dp or fast_lookahead search\n");
+  }
+  part_solver_pending = FALSE;
+
   current_partition = calloc(NUM_CORES, sizeof(uns));
   ASSERT(0, L1_ASSOC % NUM_CORES == 0);
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
@@ -451,21 +227,17 @@ void cache_part_init(void) {
 void cache_part_l1_access(Mem_Req* req) {
   if(!L1_PART_ON)
     return;
-  if(!in_shadow_cache(req->addr))
+  if(!set_mon_sampled(&shadow_tags, req->addr))
     return;
 
-  Proc_Info* proc_info = &proc_infos[req->proc_id];
-  Addr       dummy_line_addr;
-  int  pos = cache_find_pos_in_lru_stack(&proc_info->shadow_cache, req->proc_id,
-                                        req->addr, &dummy_line_addr);
-  Flag miss         = (pos == -1);
-  Flag untimely_hit = FALSE;
-  Flag stalling     = mem_req_type_is_stalling(req->type);
-  Flag demand       = mem_req_type_is_demand(req->type);
+  Shadow_Data* data;
+  int          pos = set_mon_lookup(&shadow_tags, req->proc_id, req->addr,
+                           (void**)&data);
+  Flag         miss         = (pos == -1);
+  Flag         untimely_hit = FALSE;
+  Flag         stalling     = mem_req_type_is_stalling(req->type);
+  Flag         demand       = mem_req_type_is_demand(req->type);
   if(!miss && L1_PART_FILL_DELAY) {
-    L1_Data* data = (L1_Data*)cache_access(&proc_info->shadow_cache, req->addr,
-                                           &dummy_line_addr, FALSE);
-    ASSERT(req->proc_id, data);
     untimely_hit = data->fetch_cycle > freq_cycle_count(FREQ_DOMAIN_L1);
   }
   STAT_EVENT(req->proc_id, L1_SHADOW_ACCESS);
@@ -481,6 +253,11 @@ void cache_part_l1_access(Mem_Req* req) {
       STAT_EVENT(req->proc_id, L1_SHADOW_DEMAND_HIT_POS0 + MIN2(pos, 127));
   }
 
+  // the miss curves come from the shadow tag counters, an untimely hit
+  // counts as a miss
+  if(L1_PART_USE_STALLING ? stalling : demand)
+    set_mon_count(&shadow_tags, req->proc_id, untimely_hit ? -1 : pos);
+
   INC_STAT_EVENT(req->proc_id, L1_SHADOW_HIT, !miss);
   INC_STAT_EVENT(req->proc_id, L1_SHADOW_HIT_STALLING, stalling && !miss);
   INC_STAT_EVENT(req->proc_id, L1_SHADOW_HIT_DEMAND, demand && !miss);
@@ -491,14 +268,11 @@ void cache_part_l1_access(Mem_Req* req) {
                  demand && untimely_hit);
 
   // update shadow tag
+  set_mon_access(&shadow_tags, req->proc_id, req->addr, FALSE, (void**)&data);
   if(miss) {
-    L1_Data* data     = cache_insert(&proc_info->shadow_cache, req->proc_id,
-                                 req->addr, &dummy_line_addr, &dummy_line_addr);
     data->fetch_cycle = freq_cycle_count(FREQ_DOMAIN_L1) +
                         (stalling || req->type == MRT_WB ? 0 :
                                                            L1_PART_FILL_DELAY);
-  } else {
-    cache_access(&proc_info->shadow_cache, req->addr, &dummy_line_addr, TRUE);
   }
 }
 
@@ -506,15 +280,8 @@ void cache_part_l1_access(Mem_Req* req) {
 /* cache_part_l1_warmup: */
 
 void cache_part_l1_warmup(uns proc_id, Addr addr) {
-  Proc_Info* proc_info = &proc_infos[proc_id];
-  Addr       dummy_line_addr;
-  L1_Data*   data = (L1_Data*)cache_access(&proc_info->shadow_cache, addr,
-                                         &dummy_line_addr, TRUE);
-  if(!data) {
-    L1_Data* data     = cache_insert(&proc_info->shadow_cache, proc_id, addr,
-                                 &dummy_line_addr, &dummy_line_addr);
-    data->fetch_cycle = 0;
-  }
+  // lines inserted here start with a zero fetch cycle (always timely)
+  set_mon_access(&shadow_tags, proc_id, addr, FALSE, NULL);
 }
 
 
@@ -535,6 +302,13 @@ void cache_part_update(void) {
     }
   }
 
+  // an asynchronous solve is applied at a fixed cycle so that the results do
+  // not depend on how fast the helper thread is
+  if(part_solver_pending &&
+     freq_cycle_count(FREQ_DOMAIN_L1) >= part_solver_apply_cycle) {
+    apply_solver_partition();
+  }
+
   if(!trigger_fired(l1_part_trigger))
     return;
 
@@ -545,42 +319,19 @@ void cache_part_update(void) {
   }
 
   // TODO: if this func is called too often (controlled by user through
-  // l1_part_trigger)  the misscurve calculated will be incorrect (no additional
-  // shadow access between two  triggers, thus divide by 0), corrently there is
-  // not check for this case
+  // l1_part_trigger) the miss curves will be incorrect (no shadow access
+  // between two triggers gives all zero miss rates), currently there is no
+  // check for this case
   stat_mon_reset(stat_mon);
+  set_mon_reset_counts(&shadow_tags);
 }
 
 /**************************************************************************************/
-/* Is the line with specified addr tracked in the shadow cache? */
-
-Flag in_shadow_cache(Addr addr) {
-  Addr dummy_addr;
-  uns  set = ext_cache_index(&proc_infos[0].shadow_cache, addr, &dummy_addr,
-                            &dummy_addr);
-  return set % L1_SHADOW_TAGS_MODULO == 0;
-}
-
-/**************************************************************************************/
-/* Measure miss curves from monitored statistics */
+/* Measure miss curves from the shadow tag counters */
 
 void measure_miss_curves(void) {
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    Proc_Info* proc_info   = &proc_infos[proc_id];
-    uns        access_stat = L1_PART_USE_STALLING ? L1_SHADOW_ACCESS_STALLING :
-                                             L1_SHADOW_ACCESS_DEMAND;
-    uns pos0_hit_stat = L1_PART_USE_STALLING ? L1_SHADOW_STALLING_HIT_POS0 :
-                                               L1_SHADOW_DEMAND_HIT_POS0;
-    Counter shadow_accesses   = stat_mon_get_count(stat_mon, proc_id,
-                                                 access_stat);
-    Counter shadow_misses_sum = shadow_accesses;
-    for(uns ii = 0; ii < L1_ASSOC - 1; ii++) {
-      Counter way_hits = stat_mon_get_count(stat_mon, proc_id,
-                                            pos0_hit_stat + ii);
-      shadow_misses_sum -= way_hits;
-      proc_info->miss_rates[ii] = (double)shadow_misses_sum /
-                                  (double)shadow_accesses;
-    }
+    set_mon_miss_curve(&shadow_tags, proc_id, proc_infos[proc_id].miss_rates);
   }
 }
 
@@ -713,13 +464,66 @@ void search_lookahead(void) {
   }
 }
 
+/**************************************************************************************/
+/* Fill the solver cost curves from the measured miss curves */
+
+void fill_solver_costs(void) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    double* cost = part_solver_cost(part_solver, proc_id);
+    for(uns ways = 1; ways <= L1_ASSOC - NUM_CORES + 1; ways++) {
+      cost[ways] = core_cost_func(proc_id, ways);
+    }
+  }
+}
+
+/**************************************************************************************/
+/* Use the partition solver (dp or heap based lookahead) */
+
+void search_solver(void) {
+  fill_solver_costs();
+  part_solver_start(part_solver, part_solver_algo);
+  memcpy(new_partition, part_solver_finish(part_solver),
+         NUM_CORES * sizeof(uns));
+}
+
+/**************************************************************************************/
+/* Wait for the asynchronous solve if needed and enforce its partition */
+
+void apply_solver_partition(void) {
+  ASSERT(0, part_solver_pending);
+  if(part_solver_busy(part_solver))
+    STAT_EVENT_ALL(L1_PARTITION_ASYNC_STALL);
+  memcpy(new_partition, part_solver_finish(part_solver),
+         NUM_CORES * sizeof(uns));
+  part_solver_pending = FALSE;
+  apply_partition();
+}
+
 /**************************************************************************************/
 /* Set target partition */
 
 void set_partition(void) {
-  // the one bind at config time (lookahead/brutal force)
+  if(L1_PART_ASYNC) {
+    // the cost curves are in use until the previous solve is applied
+    if(part_solver_pending)
+      apply_solver_partition();
+    fill_solver_costs();
+    part_solver_start(part_solver, part_solver_algo);
+    part_solver_pending     = TRUE;
+    part_solver_apply_cycle = freq_cycle_count(FREQ_DOMAIN_L1) +
+                              L1_PART_ASYNC_DELAY;
+    return;
+  }
+
+  // the one bind at config time (lookahead/brutal force/dp)
   search_func();
+  apply_partition();
+}
+
+/**************************************************************************************/
+/* Enforce new_partition */
 
+void apply_partition(void) {
   if(ENABLE_GLOBAL_DEBUG_PRINT && DEBUG_RANGE_COND(0)) {
     debug_cache_part(current_partition, new_partition);
   }
@@ -746,7 +550,7 @@ void debug_cache_part(uns* old_partition, uns* new_partition) {
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     ptr += sprintf(ptr, "%d,", new_partition[proc_id]);
     DPRINTF("Miss curve[%d]:", proc_id);
-    for(uns ii = 0; ii < L1_ASSOC - 1; ii++) {
+    for(uns ii = 0; ii < L1_ASSOC; ii++) {
       DPRINTF(" %.4f", proc_infos[proc_id].miss_rates[ii]);
     }
     DPRINTF("\n");
@@ -762,11 +566,8 @@ double get_global_miss_rate(uns* partition) {
   double sum = 0.0;
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     Proc_Info* proc_info = &proc_infos[proc_id];
-    Counter    accesses  = stat_mon_get_count(stat_mon, proc_id,
-                                          L1_PART_USE_STALLING ?
-                                            L1_SHADOW_ACCESS_STALLING :
-                                            L1_SHADOW_ACCESS_DEMAND);
-    sum += proc_info->miss_rates[partition[proc_id]] * (double)accesses;
+    Counter    accesses  = set_mon_accesses(&shadow_tags, proc_id);
+    sum += proc_info->miss_rates[partition[proc_id] - 1] * (double)accesses;
   }
   return sum;
 }
@@ -778,7 +579,7 @@ double get_miss_rate_sum(uns* partition) {
   double sum = 0.0;
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     Proc_Info* proc_info = &proc_infos[proc_id];
-    sum += proc_info->miss_rates[partition[proc_id]];
+    sum += proc_info->miss_rates[partition[proc_id] - 1];
   }
   return sum;
 }
@@ -809,26 +610,45 @@ double get_gmean_perf(uns* partition) {
            1 + | ------------- - 1 | x stall frac
                \ old miss rate     /
     */
-    Proc_Info* proc_info  = &proc_infos[proc_id];
-    double     stall_frac = (double)stat_mon_get_count(stat_mon, proc_id,
-                                                   RET_BLOCKED_L1_MISS) /
-                        (double)stat_mon_get_count(stat_mon, proc_id,
-                                                   NODE_CYCLE);
-    double miss_rate0 = proc_info->miss_rates[current_partition[proc_id]];
-    double miss_rate  = proc_info->miss_rates[partition[proc_id]];
-    double pred_perf;
-    if(miss_rate0 == 0.0 || stall_frac == 0.0) {
-      // in case of zero misses or stall time make the smallest
-      // partition most attractive
-      if(partition[proc_id] == 1) {
-        pred_perf = 1.0;
-      } else {
-        pred_perf = 0.0;
-      }
-    } else {
-      pred_perf = 1.0 / (1.0 + (miss_rate / miss_rate0 - 1) * stall_frac);
-    }
-    product *= pred_perf;
+    product *= predict_perf(proc_id, partition[proc_id]);
   }
   return -product;
 }
+
+/**************************************************************************************/
+/* Predicted performance of a core with the given ways, normalized to its
+ * current partition (see the model in get_gmean_perf) */
+
+double predict_perf(uns proc_id, uns ways) {
+  Proc_Info* proc_info  = &proc_infos[proc_id];
+  double     stall_frac = (double)stat_mon_get_count(stat_mon, proc_id,
+                                                 RET_BLOCKED_L1_MISS) /
+                      (double)stat_mon_get_count(stat_mon, proc_id,
+                                                 NODE_CYCLE);
+  double miss_rate0 = proc_info->miss_rates[current_partition[proc_id] - 1];
+  double miss_rate  = proc_info->miss_rates[ways - 1];
+  if(miss_rate0 == 0.0 || stall_frac == 0.0) {
+    // in case of zero misses or stall time make the smallest
+    // partition most attractive
+    return ways == 1 ? 1.0 : 0.0;
+  }
+  return 1.0 / (1.0 + (miss_rate / miss_rate0 - 1) * stall_frac);
+}
+
+/**************************************************************************************/
+/* Per-core costs for the partition solver; summing them over the cores gives
+ * the corresponding metric (or its log for gmean) */
+
+double get_core_miss_count(uns proc_id, uns ways) {
+  Counter accesses = set_mon_accesses(&shadow_tags, proc_id);
+  return proc_infos[proc_id].miss_rates[ways - 1] * (double)accesses;
+}
+
+double get_core_miss_rate(uns proc_id, uns ways) {
+  return proc_infos[proc_id].miss_rates[ways - 1];
+}
+
+double get_core_neg_log_perf(uns proc_id, uns ways) {
+  // a zero predicted performance becomes a large finite cost
+  return -log(MAX2(predict_perf(proc_id, ways), 1e-12));
+}
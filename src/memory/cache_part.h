@@ -41,7 +41,8 @@ struct Mem_Req_struct;
 
 DECLARE_ENUM(Cache_Part_Metric, CACHE_PART_METRIC_LIST, CACHE_PART_METRIC_);
 
-#define CACHE_PART_SEARCH_LIST(elem) elem(LOOKAHEAD) elem(BRUTE_FORCE)
+#define CACHE_PART_SEARCH_LIST(elem) \
+  elem(LOOKAHEAD) elem(BRUTE_FORCE) elem(DP) elem(FAST_LOOKAHEAD)
 
 DECLARE_ENUM(Cache_Part_Search, CACHE_PART_SEARCH_LIST, CACHE_PART_SEARCH_);
 
@@ -0,0 +1,350 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/cache_part_solver.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Way partition solvers over per-core cost curves, optionally
+ *                run on a helper thread
+ ***************************************************************************************/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/utils.h"
+#include "memory/cache_part_solver.h"
+
+/* Both solvers work on a table of costs, cost[core][ways], and minimize the
+   sum of the costs over the cores, giving every core at least one way and
+   handing out all of them.
+
+   PART_SOLVER_DP is exact: best[k][w] is the cheapest way to give w ways to
+   the first k cores, O(cores * ways^2) overall.
+
+   PART_SOLVER_LOOKAHEAD makes the same greedy choices as the UCP lookahead
+   algorithm, but each core's best marginal utility is cached in a heap
+   instead of being recomputed for every core on every step. A cached value
+   only goes stale for the core that just got ways, or when the remaining
+   balance drops below the extra ways the value was computed with; in the
+   latter case it is a lower bound of the real value, so stale entries are
+   simply refreshed when they reach the top of the heap. */
+
+/**************************************************************************************/
+/* Types */
+
+struct Part_Solver_struct {
+  uns              num_cores;
+  uns              assoc;
+  Part_Solver_Algo algo;
+  double*          cost;       // [num_cores][assoc + 1]
+  uns*             partition;  // result
+  uns              tie_breaker;
+
+  // dynamic programming
+  double* best;    // [num_cores + 1][assoc + 1]
+  uns16*  choice;  // ways given to the last core in best[k][w]
+
+  // lookahead
+  uns*    heap;
+  uns*    heap_pos;
+  double* mu;
+  uns*    extra;  // ways the cached utility is for (0 == no gain)
+
+  // helper thread
+  Flag            async;
+  Flag            busy;
+  pthread_t       thread;
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+};
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static void  part_solver_run(Part_Solver* solver);
+static void  part_solver_dp(Part_Solver* solver);
+static void  part_solver_lookahead(Part_Solver* solver);
+static void  lookahead_refresh(Part_Solver* solver, uns proc_id, uns balance);
+static Flag  heap_less(Part_Solver* solver, uns a, uns b);
+static void  heap_swap(Part_Solver* solver, uns a, uns b);
+static void  heap_sift_down(Part_Solver* solver, uns pos);
+static void  heap_fix(Part_Solver* solver, uns pos);
+static void* part_solver_main(void* arg);
+
+/**************************************************************************************/
+/* part_solver_create: */
+
+Part_Solver* part_solver_create(uns num_cores, uns assoc, Flag async) {
+  Part_Solver* solver = calloc(1, sizeof(Part_Solver));
+  ASSERT(0, num_cores > 0 && num_cores <= assoc && assoc <= 0xffff);
+
+  solver->num_cores = num_cores;
+  solver->assoc     = assoc;
+  solver->cost      = calloc(num_cores * (assoc + 1), sizeof(double));
+  solver->partition = calloc(num_cores, sizeof(uns));
+  solver->best      = malloc((num_cores + 1) * (assoc + 1) * sizeof(double));
+  solver->choice    = malloc((num_cores + 1) * (assoc + 1) * sizeof(uns16));
+  solver->heap      = calloc(num_cores, sizeof(uns));
+  solver->heap_pos  = calloc(num_cores, sizeof(uns));
+  solver->mu        = calloc(num_cores, sizeof(double));
+  solver->extra     = calloc(num_cores, sizeof(uns));
+
+  solver->async = async;
+  if(async) {
+    pthread_mutex_init(&solver->lock, NULL);
+    pthread_cond_init(&solver->cond, NULL);
+    int err = pthread_create(&solver->thread, NULL, part_solver_main, solver);
+    ASSERTM(0, !err, "Could not start the cache partition solver thread\n");
+    pthread_detach(solver->thread);
+  }
+  return solver;
+}
+
+/**************************************************************************************/
+/* part_solver_cost: */
+
+double* part_solver_cost(Part_Solver* solver, uns proc_id) {
+  ASSERT(0, proc_id < solver->num_cores);
+  return &solver->cost[proc_id * (solver->assoc + 1)];
+}
+
+/**************************************************************************************/
+/* part_solver_start: */
+
+void part_solver_start(Part_Solver* solver, Part_Solver_Algo algo) {
+  if(!solver->async) {
+    solver->algo = algo;
+    part_solver_run(solver);
+    return;
+  }
+  pthread_mutex_lock(&solver->lock);
+  ASSERT(0, !solver->busy);
+  solver->algo = algo;
+  solver->busy = TRUE;
+  pthread_cond_broadcast(&solver->cond);
+  pthread_mutex_unlock(&solver->lock);
+}
+
+/**************************************************************************************/
+/* part_solver_busy: */
+
+Flag part_solver_busy(Part_Solver* solver) {
+  Flag busy;
+  if(!solver->async)
+    return FALSE;
+  pthread_mutex_lock(&solver->lock);
+  busy = solver->busy;
+  pthread_mutex_unlock(&solver->lock);
+  return busy;
+}
+
+/**************************************************************************************/
+/* part_solver_finish: */
+
+uns const* part_solver_finish(Part_Solver* solver) {
+  if(solver->async) {
+    pthread_mutex_lock(&solver->lock);
+    while(solver->busy)
+      pthread_cond_wait(&solver->cond, &solver->lock);
+    pthread_mutex_unlock(&solver->lock);
+  }
+  return solver->partition;
+}
+
+/**************************************************************************************/
+/* part_solver_main: helper thread, solves whenever a job is posted */
+
+static void* part_solver_main(void* arg) {
+  Part_Solver* solver = (Part_Solver*)arg;
+  pthread_mutex_lock(&solver->lock);
+  while(TRUE) {
+    while(!solver->busy)
+      pthread_cond_wait(&solver->cond, &solver->lock);
+    pthread_mutex_unlock(&solver->lock);
+
+    part_solver_run(solver);
+
+    pthread_mutex_lock(&solver->lock);
+    solver->busy = FALSE;
+    pthread_cond_broadcast(&solver->cond);
+  }
+  return NULL;
+}
+
+static void part_solver_run(Part_Solver* solver) {
+  switch(solver->algo) {
+    case PART_SOLVER_DP:
+      part_solver_dp(solver);
+      break;
+    case PART_SOLVER_LOOKAHEAD:
+      part_solver_lookahead(solver);
+      break;
+    default:
+      ASSERT(0, FALSE);
+  }
+}
+
+/**************************************************************************************/
+/* part_solver_dp: */
+
+static void part_solver_dp(Part_Solver* solver) {
+  uns     width  = solver->assoc + 1;
+  uns     cores  = solver->num_cores;
+  double* best   = solver->best;
+  uns16*  choice = solver->choice;
+
+  best[0] = 0.0;
+  for(uns k = 1; k <= cores; k++) {
+    double const* cost = part_solver_cost(solver, k - 1);
+    // the first k cores hold at least k ways and leave one per later core
+    uns min_ways = k;
+    uns max_ways = solver->assoc - (cores - k);
+    for(uns w = min_ways; w <= max_ways; w++) {
+      double min_cost = 0.0;
+      uns    min_x    = 0;
+      // with no cores before it, the first core takes all w ways
+      for(uns x = (k == 1 ? w : 1); x + (k - 1) <= w; x++) {
+        double c = best[(k - 1) * width + (w - x)] + cost[x];
+        if(!min_x || c < min_cost) {
+          min_cost = c;
+          min_x    = x;
+        }
+      }
+      best[k * width + w]   = min_cost;
+      choice[k * width + w] = min_x;
+    }
+  }
+
+  uns w = solver->assoc;
+  for(uns k = cores; k > 0; k--) {
+    uns x                    = choice[k * width + w];
+    solver->partition[k - 1] = x;
+    w -= x;
+  }
+  ASSERT(0, w == 0);
+}
+
+/**************************************************************************************/
+/* part_solver_lookahead: */
+
+static void part_solver_lookahead(Part_Solver* solver) {
+  uns cores     = solver->num_cores;
+  uns allocated = cores;
+
+  for(uns proc_id = 0; proc_id < cores; proc_id++) {
+    solver->partition[proc_id] = 1;
+    lookahead_refresh(solver, proc_id, solver->assoc - cores);
+    solver->heap[proc_id]     = proc_id;
+    solver->heap_pos[proc_id] = proc_id;
+  }
+  for(uns pos = cores / 2; pos-- > 0;)
+    heap_sift_down(solver, pos);
+
+  while(allocated < solver->assoc) {
+    uns balance = solver->assoc - allocated;
+    uns proc_id = solver->heap[0];
+    uns extra;
+
+    if(solver->extra[proc_id] > balance) {
+      // stale: recompute with the smaller balance and look again
+      lookahead_refresh(solver, proc_id, balance);
+      heap_fix(solver, 0);
+      continue;
+    }
+
+    extra = solver->extra[proc_id];
+    if(extra == 0) {
+      // nobody gains from more ways, hand them out round robin
+      proc_id             = solver->tie_breaker;
+      solver->tie_breaker = (solver->tie_breaker + 1) % cores;
+      extra               = 1;
+    }
+    solver->partition[proc_id] += extra;
+    allocated += extra;
+    lookahead_refresh(solver, proc_id, solver->assoc - allocated);
+    heap_fix(solver, solver->heap_pos[proc_id]);
+  }
+}
+
+/* lookahead_refresh: best marginal utility of a core given the balance */
+static void lookahead_refresh(Part_Solver* solver, uns proc_id, uns balance) {
+  double const* cost     = part_solver_cost(solver, proc_id);
+  uns           old_ways = solver->partition[proc_id];
+  double        best_mu  = 0.0;
+  uns           best_x   = 0;
+
+  for(uns x = 1; x <= balance; x++) {
+    double mu = (cost[old_ways + x] - cost[old_ways]) / (double)x;
+    if(mu < best_mu) {
+      best_mu = mu;
+      best_x  = x;
+    }
+  }
+  solver->mu[proc_id]    = best_mu;
+  solver->extra[proc_id] = best_x;
+}
+
+/* heap order: lowest utility first, lowest core id on ties */
+static Flag heap_less(Part_Solver* solver, uns a, uns b) {
+  uns pa = solver->heap[a];
+  uns pb = solver->heap[b];
+  if(solver->mu[pa] != solver->mu[pb])
+    return solver->mu[pa] < solver->mu[pb];
+  return pa < pb;
+}
+
+static void heap_swap(Part_Solver* solver, uns a, uns b) {
+  uns tmp                           = solver->heap[a];
+  solver->heap[a]                   = solver->heap[b];
+  solver->heap[b]                   = tmp;
+  solver->heap_pos[solver->heap[a]] = a;
+  solver->heap_pos[solver->heap[b]] = b;
+}
+
+static void heap_sift_down(Part_Solver* solver, uns pos) {
+  while(TRUE) {
+    uns left     = 2 * pos + 1;
+    uns right    = left + 1;
+    uns smallest = pos;
+    if(left < solver->num_cores && heap_less(solver, left, smallest))
+      smallest = left;
+    if(right < solver->num_cores && heap_less(solver, right, smallest))
+      smallest = right;
+    if(smallest == pos)
+      break;
+    heap_swap(solver, pos, smallest);
+    pos = smallest;
+  }
+}
+
+/* heap_fix: restore the heap after the key at pos changed either way */
+static void heap_fix(Part_Solver* solver, uns pos) {
+  while(pos > 0 && heap_less(solver, pos, (pos - 1) / 2)) {
+    heap_swap(solver, pos, (pos - 1) / 2);
+    pos = (pos - 1) / 2;
+  }
+  heap_sift_down(solver, pos);
+}
@@ -0,0 +1,67 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/cache_part_solver.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Way partition solvers over per-core cost curves, optionally
+ *                run on a helper thread
+ ***************************************************************************************/
+
+#ifndef __CACHE_PART_SOLVER_H__
+#define __CACHE_PART_SOLVER_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef enum Part_Solver_Algo_enum {
+  PART_SOLVER_DP,         // exact minimum of the summed costs
+  PART_SOLVER_LOOKAHEAD,  // UCP lookahead with a marginal utility heap
+} Part_Solver_Algo;
+
+typedef struct Part_Solver_struct Part_Solver;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Create a solver for num_cores cores sharing assoc ways. With async set,
+   solves run on a helper thread. */
+Part_Solver* part_solver_create(uns num_cores, uns assoc, Flag async);
+
+/* Cost curve of a core, indexed by number of ways (1 to assoc - num_cores +
+   1). The caller fills it in before part_solver_start and must not touch it
+   again until part_solver_finish. */
+double* part_solver_cost(Part_Solver* solver, uns proc_id);
+
+/* Start a solve on the current cost curves (runs to completion here unless
+   the solver is asynchronous) */
+void part_solver_start(Part_Solver* solver, Part_Solver_Algo algo);
+
+/* Is a solve still running? */
+Flag part_solver_busy(Part_Solver* solver);
+
+/* Wait for the solve to finish and return its partition (ways per core) */
+uns const* part_solver_finish(Part_Solver* solver);
+
+#endif /* #ifndef __CACHE_PART_SOLVER_H__ */
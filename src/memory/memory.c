@@ -49,6 +49,7 @@
 #include "core.param.h"
 #include "debug/debug.param.h"
 #include "dvfs/perf_pred.h"
+#include "host_prof.h"
 #include "icache_stage.h"
 #include "memory.param.h"
 #include "prefetcher//stream.param.h"
@@ -475,22 +476,10 @@ void init_uncores(void) {
 
     // set dynamic partition (if used)
     if(L1_DYNAMIC_PARTITION_ENABLE && L1_DYNAMIC_PARTITION_POLICY == UMON_DSS) {
-      mem->umon_cache_core = (Cache*)malloc(sizeof(Cache) * NUM_CORES);
-      mem->umon_cache_hit_count_core = (double**)malloc(sizeof(double*) *
-                                                        NUM_CORES);
-      int ii;
-
-      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-        init_cache(&mem->umon_cache_core[proc_id], "UMON_CACHE",
-                   L1_SIZE / 32 / L1_LINE_SIZE, L1_ASSOC, 1,
-                   sizeof(Umon_Cache_Data), REPL_TRUE_LRU);
-
-        mem->umon_cache_hit_count_core[proc_id] = (double*)malloc(
-          sizeof(double) * L1_ASSOC);
-        for(ii = 0; ii < L1_ASSOC; ii++) {
-          mem->umon_cache_hit_count_core[proc_id][ii] = 0;
-        }
-      }
+      // dynamic set sampling: shadow tags of every 33rd L1 set
+      set_mon_init(&mem->umon, "UMON", L1_SIZE / L1_LINE_SIZE / L1_ASSOC,
+                   L1_ASSOC, L1_LINE_SIZE, NUM_CORES, 33,
+                   sizeof(Umon_Cache_Data));
     }
   }
 
@@ -875,35 +864,62 @@ void update_memory() {
   if(freq_is_ready(FREQ_DOMAIN_L1)) {
     cycle_count = freq_cycle_count(FREQ_DOMAIN_L1);
 
+    HOST_PROF_BEGIN(PERF_PRED);
     perf_pred_cycle();
+    HOST_PROF_END(0, PERF_PRED);
 
+    HOST_PROF_BEGIN(PREF_UPDATE);
     pref_update();
+    HOST_PROF_END(0, PREF_UPDATE);
+
+    HOST_PROF_BEGIN(MEMORY_QUEUES);
     update_memory_queues();
+    HOST_PROF_END(0, MEMORY_QUEUES);
+
+    HOST_PROF_BEGIN(MEMORY_STATS);
     update_on_chip_memory_stats();
+    HOST_PROF_END(0, MEMORY_STATS);
 
+    HOST_PROF_BEGIN(MLC_FILL_REQS);
     mem_process_mlc_fill_reqs();
+    HOST_PROF_END(0, MLC_FILL_REQS);
+
+    HOST_PROF_BEGIN(L1_FILL_REQS);
     mem_process_l1_fill_reqs();
+    HOST_PROF_END(0, L1_FILL_REQS);
   }
 
   if(freq_is_ready(FREQ_DOMAIN_MEMORY)) {
     cycle_count = freq_cycle_count(FREQ_DOMAIN_MEMORY);
 
     // dram_process_main_memory_reqs();
+    HOST_PROF_BEGIN(RAMULATOR_TICK);
     ramulator_tick();
+    HOST_PROF_END(0, RAMULATOR_TICK);
   }
 
   if(freq_is_ready(FREQ_DOMAIN_L1)) {
     cycle_count = freq_cycle_count(FREQ_DOMAIN_L1);
 
+    HOST_PROF_BEGIN(BUS_OUT_REQS);
     mem_process_bus_out_reqs();
+    HOST_PROF_END(0, BUS_OUT_REQS);
+
+    HOST_PROF_BEGIN(L1_REQS);
     mem_process_l1_reqs();
+    HOST_PROF_END(0, L1_REQS);
+
+    HOST_PROF_BEGIN(MLC_REQS);
     mem_process_mlc_reqs();
+    HOST_PROF_END(0, MLC_REQS);
   }
 
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     if(freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
       cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+      HOST_PROF_BEGIN(CORE_FILL_REQS);
       mem_process_core_fill_reqs(proc_id);
+      HOST_PROF_END(proc_id, CORE_FILL_REQS);
     }
   }
 }
@@ -1495,45 +1511,22 @@ static Flag mem_complete_l1_access(Mem_Req*         req,
   if(L1_DYNAMIC_PARTITION_ENABLE && L1_DYNAMIC_PARTITION_POLICY == UMON_DSS) {
     if((req->type == MRT_DFETCH) || (req->type == MRT_DSTORE) ||
        (req->type == MRT_IFETCH)) {
-      Addr             conv_addr, dummy_addr;
-      Cache*           l1_cache;
-      Cache*           umon_cache;
-      Umon_Cache_Data* umon_data;
-      uns              set;
-      Addr             tag;
-      int              lru_pos = -1;
-
       ASSERT(0, L1_CACHE_REPL_POLICY == REPL_PARTITION);
       ASSERT(0, ADDR_TRANSLATION == ADDR_TRANS_NONE);
 
-      l1_cache = &L1(req->proc_id)->cache;
-      set      = req->addr >> l1_cache->shift_bits & l1_cache->set_mask;
-      if(set % 33 == 0) {
-        set        = set / 33;  // converting the addr
-        tag        = req->addr >> (l1_cache->shift_bits + l1_cache->set_bits);
-        conv_addr  = tag << 5 | set;
-        umon_cache = &mem->umon_cache_core[req->proc_id];
-
-        lru_pos   = cache_find_pos_in_lru_stack(umon_cache, req->proc_id,
-                                              conv_addr, &dummy_addr);
-        umon_data = (Umon_Cache_Data*)cache_access(
-          umon_cache, conv_addr, &dummy_addr, TRUE);  // acces umon cache
-
-        if(!umon_data) {  // miss
-          Addr repl_addr;
-          umon_data = (Umon_Cache_Data*)cache_insert(
-            umon_cache, req->proc_id, conv_addr, &dummy_addr, &repl_addr);
-          ASSERT(req->proc_id, lru_pos == -1);
+      if(set_mon_sampled(&mem->umon, req->addr)) {
+        Umon_Cache_Data* umon_data;
+        // counts the hit position in the per-core umon counters
+        int lru_pos = set_mon_access(&mem->umon, req->proc_id, req->addr, TRUE,
+                                     (void**)&umon_data);
+        if(lru_pos == -1) {  // miss
           umon_data->addr     = req->addr;
           umon_data->prefetch = FALSE;
         } else {  // hit
-          ASSERT(req->proc_id, umon_data->addr == req->addr);
-          ASSERT(req->proc_id, lru_pos > -1 && lru_pos < (int)L1_ASSOC);
-          // increase the corresponding counter
-          if(umon_data->prefetch) {
-            umon_data->prefetch = FALSE;
-          }
-          mem->umon_cache_hit_count_core[req->proc_id][lru_pos]++;
+          ASSERT(req->proc_id, lru_pos < (int)L1_ASSOC);
+          ASSERT(req->proc_id,
+                 (umon_data->addr ^ req->addr) >> LOG2(L1_LINE_SIZE) == 0);
+          umon_data->prefetch = FALSE;
         }
       }
     }
@@ -4515,33 +4508,14 @@ Flag l1_fill_line(Mem_Req* req) {
       }
       // fill umon_cache
 
-      if(PARTITION_UMON_DSS_PREF_ENABLE) {
-        Cache *          l1_cache, *umon_cache;
+      if(PARTITION_UMON_DSS_PREF_ENABLE &&
+         set_mon_sampled(&mem->umon, req->addr)) {
         Umon_Cache_Data* umon_data;
-        uns              set;
-        Addr             tag, conv_addr, dummy_addr;
-
-        l1_cache = &L1(req->proc_id)->cache;
-        set      = req->addr >> l1_cache->shift_bits & l1_cache->set_mask;
-        if(set % 33 == 0) {
-          set        = set / 33;  // converting the addr
-          tag        = req->addr >> (l1_cache->shift_bits + l1_cache->set_bits);
-          conv_addr  = tag << 5 | set;
-          umon_cache = &mem->umon_cache_core[req->proc_id];
-
-          ASSERT(0, ADDR_TRANSLATION == ADDR_TRANS_NONE);
-          umon_data = (Umon_Cache_Data*)cache_access(
-            umon_cache, conv_addr, &dummy_addr, TRUE);  // acces umon cache
-
-          if(!umon_data) {  // miss
-            Addr repl_addr;
-            umon_data = (Umon_Cache_Data*)cache_insert(
-              umon_cache, req->proc_id, conv_addr, &dummy_addr, &repl_addr);
-            umon_data->addr     = req->addr;
-            umon_data->prefetch = TRUE;
-          } else {  // hit
-            ASSERT(req->proc_id, umon_data->addr == req->addr);
-          }
+        ASSERT(0, ADDR_TRANSLATION == ADDR_TRANS_NONE);
+        if(set_mon_access(&mem->umon, req->proc_id, req->addr, FALSE,
+                          (void**)&umon_data) == -1) {  // miss
+          umon_data->addr     = req->addr;
+          umon_data->prefetch = TRUE;
         }
       }
     }
@@ -4975,31 +4949,27 @@ void mark_ops_as_l1_miss_satisfied(Mem_Req* req) {
 /* recursively go through the wake up lists of the op and mark ops as
  * l1_miss_dep */
 static void mark_l1_miss_deps(Op* op) {
-  Wake_Up_Entry* temp;
+  Wake_Up_Iter iter;
+  Op*          dep_op;
 
   ASSERT(op->proc_id,
          (op->engine_info.l1_miss && !op->engine_info.l1_miss_satisfied) ||
            op->engine_info.dep_on_l1_miss);
 
-  for(temp = op->wake_up_head; temp; temp = temp->next) {
-    Op*     dep_op         = temp->op;
-    Counter dep_unique_num = temp->unique_num;
-
-
-    if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
-      ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
-      /*printf("MARK c: %s dep_op: %s %s %s %s op: %s %s %s %s\n",
-         unsstr64(cycle_count), unsstr64(dep_op->unique_num),
-         unsstr64(dep_op->exec_cycle), disasm_op(dep_op, TRUE),
-         unsstr64(dep_op->oracle_info.va), unsstr64(op->unique_num),
-         unsstr64(op->exec_cycle), disasm_op(op, TRUE),
-         unsstr64(op->oracle_info.va)); */
-      ASSERT(dep_op->proc_id, !dep_op->engine_info.l1_miss ||
-                                dep_op->table_info->mem_type == MEM_ST);
-      if(!dep_op->engine_info.dep_on_l1_miss) {
-        dep_op->engine_info.dep_on_l1_miss = TRUE;
-        mark_l1_miss_deps(dep_op);
-      }
+  for(dep_op = wake_up_iter_start(&iter, op); dep_op;
+      dep_op = wake_up_iter_next(&iter)) {
+    ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
+    /*printf("MARK c: %s dep_op: %s %s %s %s op: %s %s %s %s\n",
+       unsstr64(cycle_count), unsstr64(dep_op->unique_num),
+       unsstr64(dep_op->exec_cycle), disasm_op(dep_op, TRUE),
+       unsstr64(dep_op->oracle_info.va), unsstr64(op->unique_num),
+       unsstr64(op->exec_cycle), disasm_op(op, TRUE),
+       unsstr64(op->oracle_info.va)); */
+    ASSERT(dep_op->proc_id, !dep_op->engine_info.l1_miss ||
+                              dep_op->table_info->mem_type == MEM_ST);
+    if(!dep_op->engine_info.dep_on_l1_miss) {
+      dep_op->engine_info.dep_on_l1_miss = TRUE;
+      mark_l1_miss_deps(dep_op);
     }
   }
 }
@@ -5010,7 +4980,8 @@ static void mark_l1_miss_deps(Op* op) {
  * l1_miss_dep */
 
 static void unmark_l1_miss_deps(Op* op) {
-  Wake_Up_Entry* temp;
+  Wake_Up_Iter iter;
+  Op*          dep_op;
 
   ASSERT(op->proc_id, op->engine_info.l1_miss_satisfied ||
                         (!op->engine_info.dep_on_l1_miss &&
@@ -5018,44 +4989,40 @@ static void unmark_l1_miss_deps(Op* op) {
 
   /* Go thru the wake up list and unmark ops if they are not dependent on
    * another l1 miss */
-  for(temp = op->wake_up_head; temp; temp = temp->next) {
-    Op*     dep_op         = temp->op;
-    Counter dep_unique_num = temp->unique_num;
-
-    if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
-      int      ii;
-      Op_Info* op_info              = &dep_op->oracle_info;
-      Flag     still_dep_on_l1_miss = FALSE;
-
-      ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
-      ASSERT(dep_op->proc_id, dep_op->engine_info.dep_on_l1_miss ||
-                                dep_op->engine_info.was_dep_on_l1_miss);
-
-      if(dep_op->engine_info.dep_on_l1_miss) {
-        /* Determine if the op is dependent on another l1_miss */
-        for(ii = 0; ii < op_info->num_srcs; ii++) {
-          Src_Info* src_info = &op_info->src_info[ii];
-          Op*       src_op   = src_info->op;
-
-          if(src_op->unique_num == src_info->unique_num &&
-             src_op->op_pool_valid) {
-            if(src_op->unique_num != op->unique_num)
-              if((src_op->engine_info.l1_miss &&
-                  !src_op->engine_info.l1_miss_satisfied) ||
-                 src_op->engine_info.dep_on_l1_miss)
-                still_dep_on_l1_miss = TRUE;
-          }
-          if(still_dep_on_l1_miss)
-            break;
+  for(dep_op = wake_up_iter_start(&iter, op); dep_op;
+      dep_op = wake_up_iter_next(&iter)) {
+    int      ii;
+    Op_Info* op_info              = &dep_op->oracle_info;
+    Flag     still_dep_on_l1_miss = FALSE;
+
+    ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
+    ASSERT(dep_op->proc_id, dep_op->engine_info.dep_on_l1_miss ||
+                              dep_op->engine_info.was_dep_on_l1_miss);
+
+    if(dep_op->engine_info.dep_on_l1_miss) {
+      /* Determine if the op is dependent on another l1_miss */
+      for(ii = 0; ii < op_info->num_srcs; ii++) {
+        Src_Info* src_info = &op_info->src_info[ii];
+        Op*       src_op   = src_info->op;
+
+        if(src_op->unique_num == src_info->unique_num &&
+           src_op->op_pool_valid) {
+          if(src_op->unique_num != op->unique_num)
+            if((src_op->engine_info.l1_miss &&
+                !src_op->engine_info.l1_miss_satisfied) ||
+               src_op->engine_info.dep_on_l1_miss)
+              still_dep_on_l1_miss = TRUE;
         }
+        if(still_dep_on_l1_miss)
+          break;
+      }
 
-        /* If the op is not dependent on another l1 miss, then go ahead and
-           unmark it and figure out if we need to unmark its dependents */
-        if(!still_dep_on_l1_miss) {
-          dep_op->engine_info.dep_on_l1_miss     = FALSE;
-          dep_op->engine_info.was_dep_on_l1_miss = TRUE;
-          unmark_l1_miss_deps(dep_op);
-        }
+      /* If the op is not dependent on another l1 miss, then go ahead and
+         unmark it and figure out if we need to unmark its dependents */
+      if(!still_dep_on_l1_miss) {
+        dep_op->engine_info.dep_on_l1_miss     = FALSE;
+        dep_op->engine_info.was_dep_on_l1_miss = TRUE;
+        unmark_l1_miss_deps(dep_op);
       }
     }
   }
@@ -37,6 +37,7 @@
 #include "libs/hash_lib.h"
 #include "libs/list_lib.h"
 #include "libs/port_lib.h"
+#include "libs/set_mon_lib.h"
 #include "memory/mem_req.h"
 #include "op_info.h"
 //#include "dram.h"
@@ -164,8 +165,7 @@ typedef struct Memory_struct {
   double* l1_ave_num_ways_per_core;
 
   // CP
-  Cache*   umon_cache_core;
-  double** umon_cache_hit_count_core;
+  Set_Mon umon;  // UMON_DSS shadow tags and hit position counters
 
   uns*  bus_out_queue_entry_count_core;
   int*  bus_out_queue_index_core;  // bus_out_queue to mem_queue scheduling
@@ -821,7 +821,7 @@ void node_retire() {
                  LD_EXEC_CYCLES_0 + (op->done_cycle - op->sched_cycle));
     }
     if(op->table_info->mem_type == MEM_LD) {
-      STAT_EVENT(op->proc_id, LD_NO_DEPENDENTS + (op->wake_up_head ? 1 : 0));
+      STAT_EVENT(op->proc_id, LD_NO_DEPENDENTS + (op->wake_up_count ? 1 : 0));
     }
     STAT_EVENT(op->proc_id, RET_OP_EXEC_COUNT_0 + MIN2(32, op->exec_count));
 
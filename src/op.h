@@ -79,17 +79,6 @@
 DECLARE_ENUM(Op_State, OP_STATE_LIST, OS_);
 // }}}
 
-/*------------------------------------------------------------------------------------*/
-// {{{ Wake_Up_Entry
-typedef struct Wake_Up_Entry_struct {
-  Op*                          op;
-  Counter                      unique_num;
-  Dep_Type                     dep_type;
-  uns8                         rdy_bit;
-  struct Wake_Up_Entry_struct* next;
-} Wake_Up_Entry;
-// }}}
-
 /*------------------------------------------------------------------------------------*/
 // {{{ Recovery_Info
 // this information is used when the op mispredicts
@@ -139,6 +128,48 @@ typedef struct Dp_Info_struct {
 // {{{ Op
 // typedef in globals/global_types.h
 struct Op_struct {
+  // {{{ hot fields --- read every cycle by the scheduler, wakeup and retire
+  // loops (node_sched_ops, node_retire, wake_up_ops). They fill exactly the
+  // first two cache lines of the op (ops are line aligned), everything below
+  // is touched only at fetch, recovery or for stats. Keep new fields out of
+  // this block unless those loops need them.
+  Op_State state;       // the state of the op in the datapath
+  uns      proc_id;     // processor id for cmp model
+  Counter  op_num;      // op number
+  Counter  unique_num;  // unique number for each instance of an op (not reset
+                        // on recovery)
+  Counter rdy_cycle;  // cycle when the final source value is available to the
+                      // op (only useful when vector is clear)
+  uns srcs_not_rdy_vector;  // bits as given by order in the src_info array
+  uns fu_num;  // functional unit number the op will or did execute on
+  struct Op_struct* next_rdy;    // pointer to next ready op (node table)
+  Table_Info*       table_info;  // copy of info->table_info to limit pointer
+                                 // chasing
+  Counter sched_cycle;  // cycle when the op is scheduled (arrives at the
+                        // functional unit)
+
+  Counter exec_cycle;  // cycle when execution (or addr gen) of op will be
+                       // completed (result usable)
+  Counter done_cycle;  // cycle when the op is ready to retire
+  struct Op_struct* next_node;  // pointer to the next op in the node table
+  Counter rs_id;  // id for which Reservation Station (RS) this op is assigned
+                  // to
+  struct Mem_Req_struct* req;  // pointer to memory request responsible for
+                               // waking up the op
+  Inst_Info* inst_info;  // pointer to unique struct for each static instruction
+  uns wake_up_count;  // number of sources of later ops that depend on this op
+                      // (not decremented when they go away)
+  Flag off_path;  // is the op on the correct path of the program? - oracle
+                  // information
+  Flag in_rdy_list;         // is the op in the node stage's ready list?
+  Flag in_node_list;        // is the op in the node list?
+  Flag replay;              // is the op waiting to replay?
+  Flag recovery_scheduled;  // set once the op has scheduled a recovery
+  Flag redirect_scheduled;  // set once the op has scheduled a redirect
+  Flag exit;                // is this the last instruction to execute?
+  Flag marked;              // for algorithms that mark already seen ops
+  // }}}
+
   // {{{ op_pool stuff --- don't use outside of op pool management
   Flag op_pool_valid;  // is op allocated from the op_pool?
   Op*  op_pool_next;   // either next free or next active op
@@ -146,44 +177,30 @@ struct Op_struct {
   // }}}
 
   // {{{ op numbers and info pointers
-  uns     proc_id;     // processor id for cmp model
   uns     thread_id;   // id number for the thread to which this op belongs
   Flag    bom;         // begining of macro instruction when we use op as a uop
   Flag    eom;         // end of macro instruction when we use op as a uop
-  Counter op_num;      // op number
-  Counter unique_num;  // unique number for each instance of an op (not reset on
-                       // recovery)
   Counter unique_num_per_proc;  // unique number per core
   uns64   inst_uid;  // unique number for the macro instruction provided
                      // by the frontend (PIN)
-  Counter     addr_pred_num;  // unique number for each address prediction
-  Table_Info* table_info;  // copy of info->table_info to limit pointer chasing
-  Inst_Info* inst_info;  // pointer to unique struct for each static instruction
-  Op_Info    oracle_info;  // information about the execution of the op in the
-                           // oracle
-  Op_Info engine_info;     // information about the execution of the op in the
-                           // engine
+  Counter addr_pred_num;  // unique number for each address prediction
+  Op_Info oracle_info;    // information about the execution of the op in the
+                          // oracle
+  Op_Info engine_info;    // information about the execution of the op in the
+                          // engine
   int oracle_cp_num;  // if the op has created an oracle checkpointed this is
                       // not -1
   // }}}
 
   int32 perceptron_output;       //
   int32 conf_perceptron_output;  // confidece perceptron
-  // {{{ state and event cycle counters
-  Op_State state;        // the state of the op in the datapath
-  Counter  fetch_cycle;  // cycle an individual instruction is fetched
-  Counter  bp_cycle;     // cycle a CF instruction accesses the branch predictor
-  Counter  map_cycle;    // cycle an individual instruction enters the map stage
-  Counter  issue_cycle;  // cycle an individual instruction is issued -- same as
+  // {{{ event cycle counters (the hot ones are above)
+  Counter fetch_cycle;   // cycle an individual instruction is fetched
+  Counter bp_cycle;      // cycle a CF instruction accesses the branch predictor
+  Counter map_cycle;     // cycle an individual instruction enters the map stage
+  Counter issue_cycle;   // cycle an individual instruction is issued -- same as
                          // chkpt
-  Counter rdy_cycle;    // cycle when the final source value is available to the
-                        // op (only useful when vector is clear)
-  Counter sched_cycle;  // cycle when the op is scheduled (arrives at the
-                        // functional unit)
-  Counter exec_cycle;   // cycle when execution (or addr gen) of op will be
-                        // completed (result usable)
   Counter dcache_cycle;  // cycle when the op accesses the dcache
-  Counter done_cycle;    // cycle when the op is ready to retire
   Counter retire_cycle;  // cycle when the op actually retires (useful if you
                          // keep the ops around after they leave the node
                          // talbes)
@@ -193,9 +210,6 @@ struct Op_struct {
   // }}}
 
   // {{{ path and fetch info
-  Flag off_path;    // is the op on the correct path of the program? - oracle
-                    // information
-  Flag exit;        // is this the last instruction to execute?
   Flag prog_input;  // is this op directly related to an input value of the
                     // program ?
   Addr          fetch_addr;       // fetch address used to fetch the instruction
@@ -205,43 +219,23 @@ struct Op_struct {
   // }}}
 
   // {{{ scheduler information
-  uns     fu_num;   // functional unit number the op will or did execute on
-  Counter node_id;  // id for position in the node table
-  Counter rs_id;    // id for which Reservation Station (RS) this op is assigned
-                    // to
+  Counter node_id;    // id for position in the node table
   Counter chkpt_num;  // id for chkpt (WARNING: this can change due to
                       // recoveries)
 
-  struct Op_struct* next_rdy;      // pointer to next ready op (node table)
-  Flag              in_rdy_list;   // is the op in the node stage's ready list?
-  struct Op_struct* next_node;     // pointer to the next op in the node table
-  Flag              in_node_list;  // is the op in the node list?
-  Flag              replay;        // is the op waiting to replay?
-  uns               replay_count;  // number of times the op has replayed
+  uns  replay_count;        // number of times the op has replayed
   Flag dont_cause_replays;  // true if the op should not cause other ops to
                             // replay (like a correct value prediction)
   uns exec_count;           // how many times has this op been executed?
   // }}}
 
   // {{{ dependency information
-  uns  srcs_not_rdy_vector;  // bits as given by order in the src_info array
   Flag wake_up_signaled[NUM_DEP_TYPES];  // set to true once a wake up has been
                                          // signaled by the op for the given
                                          // type
-  Wake_Up_Entry* wake_up_head;  // list of ops that are dependent on this op, by
-                                // dependency type
-  Wake_Up_Entry* wake_up_tail;  // last entry in each wake up list (for speed)
-  uns wake_up_count;   // count of ops to be awakened by this op (wake up list
-                       // length)
   Counter wake_cycle;  // used by wake up logic for time wake up signal is sent
   // }}}
 
-  struct Mem_Req_struct* req;  // pointer to memory request responsible for
-                               // waking up the op
-  // }}}
-
-  Flag marked;  // for algorithms that mark already seen ops
-
   /*------------------------------------------------------------------------------------*/
   // FIELDS BELOW THIS POINT SHOULD BE MOVED INTO OTHER HEADERS
   // (along with any related structs above)
@@ -287,10 +281,8 @@ struct Op_struct {
   uns  addr_pred_flags;
   uns  stephan_corr_index;
   Addr pred_addr;
-  Flag recovery_scheduled;
-  Flag redirect_scheduled;
   // }}}
-};
+} __attribute__((aligned(64)));
 // }}}
 
 /**************************************************************************************/
@@ -36,6 +36,7 @@ allocates them once and then hands out pointers every time 'alloc_op' is called.
 #include "globals/utils.h"
 
 #include "debug/pipeview.h"
+#include "libs/malloc_lib.h"
 #include "model.h"
 #include "op_pool.h"
 
@@ -58,14 +59,14 @@ allocates them once and then hands out pointers every time 'alloc_op' is called.
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_OP_POOL, ##args)
 #define DEBUGU(proc_id, args...) _DEBUGU(proc_id, DEBUG_OP_POOL, ##args)
 
-#define OP_POOL_ENTRIES_INC 128 /* default 128 */
+#define OP_POOL_MAX_ENTRIES (128 * 128) /* per core, catches op leaks */
 
 /**************************************************************************************/
 /* Global variables */
 
-uns        op_pool_entries    = 0;
-uns        op_pool_active_ops = 0;
-static Op* op_pool_free_head;
+uns              op_pool_entries    = 0;
+uns              op_pool_active_ops = 0;
+static Slab_Pool op_pools[MAX_NUM_PROCS]; /* each core recycles its own ops */
 
 Op invalid_op;
 
@@ -74,15 +75,20 @@ Op invalid_op;
 /* Prototypes */
 
 
-static inline void expand_op_pool(void);
+static void op_pool_new_op(void* obj);
 
 
 /**************************************************************************************/
 /* init_op_pool: */
 
 void init_op_pool() {
+  uns proc_id;
+
   DEBUGU(0, "Initializing op pool...\n");
 
+  /* the hot fields at the top of Op must stay within two cache lines */
+  ASSERT(0, offsetof(Op, op_pool_valid) <= 128);
+
   /* set up invalid op (for use as default value various places) */
   op_pool_init_op(&invalid_op);
   invalid_op.op_pool_valid = FALSE;
@@ -92,8 +98,10 @@ void init_op_pool() {
   /* clear counters */
   reset_op_pool();
 
-  /* allocate memory for op pool */
-  expand_op_pool();
+  /* ops are allocated a slab at a time, the first time a core needs them */
+  for(proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    slab_pool_init(&op_pools[proc_id], "op pool", proc_id, sizeof(Op),
+                   offsetof(Op, op_pool_next), op_pool_new_op);
 }
 
 
@@ -111,14 +119,8 @@ void reset_op_pool() {
 /* alloc_op:  returns a pointer to the next available op */
 
 Op* alloc_op(uns proc_id) {
-  Op* new_op;
-
-  if(op_pool_free_head == NULL) {
-    ASSERT(0, op_pool_active_ops == op_pool_entries);
-    expand_op_pool();
-  }
+  Op* new_op = (Op*)slab_alloc(&op_pools[proc_id]);
 
-  new_op = op_pool_free_head;
   ASSERT(0, !new_op->op_pool_valid);
   new_op->op_pool_valid = TRUE;
 
@@ -127,7 +129,6 @@ Op* alloc_op(uns proc_id) {
   op_pool_active_ops++;
   DEBUG(0, "Allocating op  id:%u  op_pool_active_ops:%u  op_pool_entries:%d\n",
         new_op->op_pool_id, op_pool_active_ops, op_pool_entries);
-  op_pool_free_head = new_op->op_pool_next;
 
   return new_op;
 }
@@ -158,14 +159,13 @@ void free_op(Op* op) {
 
   if(op->inst_info && op->inst_info->fake_inst) {
     ASSERT(0, op->table_info == op->inst_info->table_info);
-    free(op->inst_info->table_info);
-    free(op->inst_info);
+    arena_free(op->proc_id, sizeof(Table_Info), op->inst_info->table_info);
+    arena_free(op->proc_id, sizeof(Inst_Info), op->inst_info);
     op->inst_info = NULL;
   }
 
-  op->op_pool_next  = op_pool_free_head;
-  op_pool_free_head = op;
   free_wake_up_list(op);
+  slab_free(&op_pools[op->proc_id], op);
 }
 
 
@@ -255,25 +255,16 @@ void op_pool_setup_op(uns proc_id, Op* op) {
 
 
 /**************************************************************************************/
-/* expand_op_pool: */
+/* op_pool_new_op: called on every op of a new op pool slab */
 
-static inline void expand_op_pool() {
-  Op* new_pool = (Op*)calloc(OP_POOL_ENTRIES_INC, sizeof(Op));
-  uns ii;
-
-  DEBUGU(0, "Expanding op pool to size %d\n",
-         op_pool_entries + OP_POOL_ENTRIES_INC);
-  for(ii = 0; ii < OP_POOL_ENTRIES_INC - 1; ii++) {
-    new_pool[ii].op_pool_valid = FALSE;
-    new_pool[ii].op_pool_next  = &new_pool[ii + 1];
-    new_pool[ii].op_pool_id    = op_pool_entries++;
-    op_pool_init_op(&new_pool[ii]);
-  }
-  new_pool[ii].op_pool_valid = FALSE;
-  new_pool[ii].op_pool_next  = op_pool_free_head;
-  new_pool[ii].op_pool_id    = op_pool_entries++;
-  op_pool_init_op(&new_pool[ii]);
+static void op_pool_new_op(void* obj) {
+  Op* op = (Op*)obj;
 
-  op_pool_free_head = &new_pool[0];
-  ASSERT(0, op_pool_entries <= OP_POOL_ENTRIES_INC * 128);
+  memset(op, 0, sizeof(Op));
+  op->op_pool_valid = FALSE;
+  op->op_pool_id    = op_pool_entries++;
+  op_pool_init_op(op);
+  ASSERTM(0, op_pool_entries <= OP_POOL_MAX_ENTRIES * NUM_CORES,
+          "Op pool grew to %u entries, are ops being leaked?\n",
+          op_pool_entries);
 }
@@ -78,7 +78,8 @@ the program.  This way, an exact duplicate run can be performed.
 
 const char* help_options[]    = {"-help", "-h", "--help",
                               "--h"}; /* cmd-line help options strings */
-const char* sim_mode_names[]  = {"uop", "full"};
+const char* sim_mode_names[]  = {"uop", "full", "bp", "cache", "simpoint",
+                                 "sample"};
 const char* exit_cond_names[] = {"last_done", "first_done"};
 
 /**************************************************************************************/
@@ -43,6 +43,7 @@
 #include "../../ctype_pin_inst.h"
 #include "../../isa/isa.h"
 #include "../../libs/hash_lib.h"
+#include "../../libs/malloc_lib.h"
 
 #include "uop_generator.h"
 
@@ -472,11 +473,8 @@ void convert_t_uop_to_info(uns8 proc_id, Trace_Uop* t_uop, Inst_Info* info) {
   int ii;
 
   // build info // we  can optimize to build this info only once
-  info->table_info = (Table_Info*)malloc(sizeof(Table_Info));  // FIXME. at
-                                                               // least a hash
-                                                               // function based
-                                                               // on the same
-                                                               // table info.
+  info->table_info = (Table_Info*)arena_alloc(proc_id, sizeof(Table_Info));
+  // FIXME. at least a hash function based on the same table info.
 
   ASSERT(proc_id, info);
   ASSERT(proc_id, info->table_info);
@@ -836,7 +834,8 @@ void convert_pinuop_to_t_uop(uns8 proc_id, ctype_pin_inst* pi,
   Addr key_addr  = convert_pinuop_inst_addr_to_key_addr(pi->instruction_addr);
   Inst_Info* info;
   if(pi->fake_inst) {
-    info                   = (Inst_Info*)calloc(1, sizeof(Inst_Info));
+    info = (Inst_Info*)arena_alloc(proc_id, sizeof(Inst_Info));
+    memset(info, 0, sizeof(Inst_Info));
     info->fake_inst        = TRUE;
     info->fake_inst_reason = pi->fake_inst_reason;
   } else {
@@ -880,7 +879,8 @@ void convert_pinuop_to_t_uop(uns8 proc_id, ctype_pin_inst* pi,
     for(ii = 0; ii < num_uop; ii++) {
       if(ii > 0) {
         if(pi->fake_inst) {
-          info                   = (Inst_Info*)calloc(1, sizeof(Inst_Info));
+          info = (Inst_Info*)arena_alloc(proc_id, sizeof(Inst_Info));
+          memset(info, 0, sizeof(Inst_Info));
           info->fake_inst        = TRUE;
           info->fake_inst_reason = pi->fake_inst_reason;
         } else {
@@ -37,6 +37,11 @@
 typedef std::unordered_map<ADDRINT, ctype_pin_inst*> inst_info_map;
 typedef inst_info_map::iterator                      inst_info_map_p;
 
+// Version of what the functions below fill in. Bump it whenever they change
+// what ends up in a ctype_pin_inst, so that memtrace decode caches written by
+// an older build are replaced instead of used.
+#define X86_DECODER_VERSION 1
+
 /**************************** Public Functions ********************************/
 
 void init_x86_decoder(std::ostream* err_ostream);
@@ -77,6 +77,7 @@ using namespace CONTROLLER;
 
 #include "../../ctype_pin_inst.h"
 #include "../../table_info.h"
+#include "trace_index.h"
 
 std::vector<std::string> iclass_prints;
 
@@ -95,6 +96,9 @@ KNOB<BOOL> KnobPinPlayReplayer(KNOB_MODE_WRITEONCE, "pintool", "replay", "0",
 // Knobs that control trace generation
 KNOB<string> Knob_output(KNOB_MODE_WRITEONCE, "pintool", "o", "trace.bz2",
                          "trace outputfilename");
+KNOB<UINT64> KnobIndexInterval(
+  KNOB_MODE_WRITEONCE, "pintool", "index_interval", "10000000",
+  "Instructions between the seek points of the trace index (0: no index)");
 
 // Trace start and end options
 KNOB<UINT64> KnobStartRip(
@@ -108,7 +112,7 @@ KNOB<UINT64> KnobFastForward(
   "Number of instructions to fast-forward before generating the trace");
 
 /*** globals ***/
-FILE* output_stream;
+TraceIndexWriter* output_stream;
 
 ctype_pin_inst mailbox;
 bool           mailbox_full = false;
@@ -137,9 +141,9 @@ LOCALFUN VOID Fini(int n, void* v) {
   pin_decoder_print_unknown_opcodes();
   if(output_stream) {
     if(mailbox_full) {
-      fwrite(&mailbox, sizeof(mailbox), 1, output_stream);
+      output_stream->write(&mailbox);
     }
-    pclose(output_stream);
+    output_stream->close();
   }
 }
 
@@ -178,7 +182,7 @@ void dump_instruction() {
   ctype_pin_inst* info = pin_decoder_get_latest_inst();
   if(mailbox_full) {
     mailbox.instruction_next_addr = info->instruction_addr;
-    fwrite(&mailbox, sizeof(mailbox), 1, output_stream);
+    output_stream->write(&mailbox);
   }
   mailbox      = *info;
   mailbox_full = true;
@@ -222,9 +226,12 @@ int main(int argc, char* argv[]) {
   pinplay_engine.Activate(argc, argv, KnobPinPlayLogger, KnobPinPlayReplayer);
 
   if(!Knob_output.Value().empty()) {
-    char popename[1024];
-    sprintf(popename, "bzip2 > %s", Knob_output.Value().c_str());
-    output_stream = popen(popename, "w");
+    output_stream = new TraceIndexWriter(Knob_output.Value(),
+                                         KnobIndexInterval.Value());
+    if(!output_stream->ok()) {
+      std::cerr << "Cannot write trace " << Knob_output.Value() << endl;
+      return -1;
+    }
   } else {
     cout << "No trace specified. Only verifying opcodes." << endl;
   }
@@ -0,0 +1,76 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pin/pin_trace/index_trace.cc
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Rewrites an existing trace as a seekable trace with an index
+ *                (see trace_index.h)
+ ***************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "trace_index.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+  if(argc < 3) {
+    cerr << "Usage: index_trace <trace> <indexed trace> [index interval]"
+         << endl;
+    exit(1);
+  }
+  uint64_t interval = argc > 3 ? strtoull(argv[3], NULL, 0) : 10000000;
+  if(!interval) {
+    cerr << "The index interval must be positive" << endl;
+    exit(1);
+  }
+
+  char cmdline[1024];
+  snprintf(cmdline, sizeof(cmdline), "bzip2 -dc %s", argv[1]);
+  FILE* orig_stream = popen(cmdline, "r");
+  if(!orig_stream) {
+    cerr << "Cannot open trace " << argv[1] << endl;
+    exit(1);
+  }
+
+  TraceIndexWriter writer(argv[2], interval);
+  if(!writer.ok()) {
+    cerr << "Cannot write trace " << argv[2] << endl;
+    exit(1);
+  }
+
+  ctype_pin_inst pin_inst;
+  uint64_t       inst_count = 0;
+  while(fread(&pin_inst, sizeof(ctype_pin_inst), 1, orig_stream)) {
+    writer.write(&pin_inst);
+    inst_count++;
+  }
+  writer.close();
+  pclose(orig_stream);
+
+  cout << "Indexed " << inst_count << " instructions every " << interval
+       << endl;
+  return 0;
+}
@@ -0,0 +1,112 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pin/pin_trace/trace_index.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Seekable traces: a trace written as a sequence of bzip2
+ *                streams plus a sidecar index of where each stream starts
+ ***************************************************************************************/
+
+#ifndef __TRACE_INDEX_H__
+#define __TRACE_INDEX_H__
+
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+
+#include "../../ctype_pin_inst.h"
+
+/* The index of trace T is the text file T.idx. Its first line is
+   TRACE_INDEX_MAGIC followed by sizeof(ctype_pin_inst); every other line is
+   "<instruction> <offset>": the bzip2 stream starting at byte <offset> of T
+   begins with that instruction (counted from 0). Concatenated bzip2 streams
+   are still one valid bzip2 file, so indexed traces read like any other. */
+#define TRACE_INDEX_SUFFIX ".idx"
+#define TRACE_INDEX_MAGIC "# scarab trace index"
+
+/* Writes a trace, starting a new bzip2 stream (and index entry) every
+   interval instructions. An interval of 0 writes a single stream and no
+   index. */
+class TraceIndexWriter {
+ public:
+  TraceIndexWriter(const std::string& trace, uint64_t interval) :
+      trace_(trace), interval_(interval), count_(0), stream_(NULL),
+      index_(NULL) {
+    if(interval_) {
+      index_ = fopen((trace_ + TRACE_INDEX_SUFFIX).c_str(), "w");
+      if(index_)
+        fprintf(index_, "%s %zu\n", TRACE_INDEX_MAGIC, sizeof(ctype_pin_inst));
+    }
+  }
+
+  ~TraceIndexWriter() { close(); }
+
+  /* Could the trace (and index) be opened? */
+  bool ok() { return stream_ || start_stream(); }
+
+  void write(const ctype_pin_inst* inst) {
+    if(!stream_ || (interval_ && count_ % interval_ == 0 && count_))
+      start_stream();
+    fwrite(inst, sizeof(ctype_pin_inst), 1, stream_);
+    count_++;
+  }
+
+  void close() {
+    if(stream_)
+      pclose(stream_);
+    if(index_)
+      fclose(index_);
+    stream_ = NULL;
+    index_  = NULL;
+  }
+
+ private:
+  /* End the current stream (waiting for bzip2 so that the file size is the
+     offset of the next one) and start the next */
+  bool start_stream() {
+    std::string cmd = "bzip2 ";
+    if(stream_) {
+      pclose(stream_);
+      cmd += ">> " + trace_;
+    } else {
+      cmd += "> " + trace_;
+    }
+    uint64_t offset = 0;
+    struct stat st;
+    if(count_ && stat(trace_.c_str(), &st) == 0)
+      offset = st.st_size;
+    stream_ = popen(cmd.c_str(), "w");
+    if(index_)
+      fprintf(index_, "%" PRIu64 " %" PRIu64 "\n", count_, offset);
+    return stream_ != NULL && (!interval_ || index_ != NULL);
+  }
+
+  std::string trace_;
+  uint64_t    interval_;
+  uint64_t    count_;
+  FILE*       stream_;
+  FILE*       index_;
+};
+
+#endif /* #ifndef __TRACE_INDEX_H__ */
@@ -291,7 +291,7 @@ void update_energy_stats(void) {
 
 void dump_power_energy_stats(void) {
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    dump_stats(proc_id, TRUE, global_stat_array[proc_id] + POWER_STATS_BEGIN,
+    dump_stats(proc_id, TRUE, POWER_STATS_BEGIN,
                ENERGY_STATS_END - POWER_STATS_BEGIN + 1);
   }
 }
@@ -0,0 +1,350 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_bingo.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Bingo spatial footprint prefetcher
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "globals/assert.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/pref.param.h"
+#include "prefetcher/pref_bingo.h"
+#include "prefetcher/pref_bingo.param.h"
+#include "prefetcher/pref_common.h"
+#include "statistics.h"
+
+/* bingo : Memory is divided into spatial regions. The first access to a
+   region (the trigger) allocates an accumulation table entry that records
+   which lines of the region are touched until the entry is evicted. The
+   footprint is then stored in the pattern history table under two events:
+   the PC+Address of the trigger (long, precise) and its PC+Offset (short,
+   general). Both events hash to the same set through PC+Offset, so one set
+   read finds the long match or, failing that, all the short matches, which
+   vote on the lines to prefetch.
+
+   The filter table of the original design is folded into the accumulation
+   table: regions that saw a single access are dropped on eviction instead
+   of being committed.
+*/
+
+/**************************************************************************************/
+/* Macros */
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_PREF_BINGO, ##args)
+
+#define BINGO_REGION_BITS LOG2(PREF_BINGO_REGION_LINES)
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Pref_Bingo* bingo_hwp_core;
+static Pref_Bingo* bingo_hwp;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static Bingo_PHT_Entry* bingo_pht_set(uns16 pc_hash, uns trigger_offset,
+                                      uns32 region_tag, uns8* short_tag,
+                                      uns16* long_tag);
+static void  bingo_pht_insert(Bingo_AT_Entry const* at_entry);
+static uns32 bingo_pht_predict(uns8 proc_id, uns16 pc_hash,
+                               uns trigger_offset, uns32 region_tag);
+static void  bingo_prefetch(uns8 proc_id, Addr region, uns trigger_offset,
+                            uns32 footprint);
+
+/* Ages of a set stay a permutation of 0..ways-1, 0 being the MRU way */
+#define BINGO_TOUCH(set, ways, way)        \
+  do {                                     \
+    uns _ii;                               \
+    for(_ii = 0; _ii < (ways); _ii++) {    \
+      if((set)[_ii].age < (set)[way].age)  \
+        (set)[_ii].age++;                  \
+    }                                      \
+    (set)[way].age = 0;                    \
+  } while(0)
+
+/* Invalid ways first, then the LRU way */
+#define BINGO_VICTIM(set, ways, victim)                          \
+  do {                                                           \
+    uns _ii;                                                     \
+    (victim) = 0;                                                \
+    for(_ii = 0; _ii < (ways) && (set)[victim].valid; _ii++) {   \
+      if(!(set)[_ii].valid || (set)[_ii].age > (set)[victim].age) \
+        (victim) = _ii;                                          \
+    }                                                            \
+  } while(0)
+
+/**************************************************************************************/
+
+void set_pref_bingo(Pref_Bingo* new_bingo) {
+  bingo_hwp = new_bingo;
+}
+
+void pref_bingo_init(HWP* hwp) {
+  uns8 proc_id;
+  uns  ii;
+
+  if(!PREF_BINGO_ON)
+    return;
+  hwp->hwp_info->enabled = TRUE;
+
+  ASSERTM(0, !PREF_BINGO_UMLC || MLC_PRESENT,
+          "pref_bingo_umlc needs an MLC (mlc_present)\n");
+  ASSERTM(0, is_power_of_2(PREF_BINGO_REGION_LINES) &&
+               PREF_BINGO_REGION_LINES <= 32,
+          "Bingo footprints are 32 bits wide\n");
+  ASSERT(0, is_power_of_2(PREF_BINGO_AT_SETS) &&
+              is_power_of_2(PREF_BINGO_PHT_SETS) &&
+              PREF_BINGO_PHT_SETS <= (1 << 16));
+
+  bingo_hwp_core = (Pref_Bingo*)calloc(NUM_CORES, sizeof(Pref_Bingo));
+
+  for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Pref_Bingo* bingo = &bingo_hwp_core[proc_id];
+
+    bingo->hwp_info = hwp->hwp_info;
+    bingo->at       = (Bingo_AT_Entry*)pref_alloc_table(
+      PREF_BINGO_AT_SETS * BINGO_AT_WAYS, sizeof(Bingo_AT_Entry));
+    bingo->pht      = (Bingo_PHT_Entry*)pref_alloc_table(
+      PREF_BINGO_PHT_SETS * BINGO_PHT_WAYS, sizeof(Bingo_PHT_Entry));
+    for(ii = 0; ii < PREF_BINGO_AT_SETS * BINGO_AT_WAYS; ii++)
+      bingo->at[ii].age = ii % BINGO_AT_WAYS;
+    for(ii = 0; ii < PREF_BINGO_PHT_SETS * BINGO_PHT_WAYS; ii++)
+      bingo->pht[ii].age = ii % BINGO_PHT_WAYS;
+
+    bingo->max_degree     = PREF_BINGO_REGION_LINES;
+    bingo->degree_vals[0] = 2;
+    bingo->degree_vals[1] = 4;
+    bingo->degree_vals[2] = 8;
+    bingo->degree_vals[3] = 16;
+    bingo->degree_vals[4] = 32;
+  }
+}
+
+void pref_bingo_umlc_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                          uns32 global_hist) {
+  if(!PREF_BINGO_UMLC)
+    return;
+  set_pref_bingo(&bingo_hwp_core[proc_id]);
+  pref_bingo_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_bingo_umlc_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                         uns32 global_hist) {
+  if(!PREF_BINGO_UMLC)
+    return;
+  set_pref_bingo(&bingo_hwp_core[proc_id]);
+  pref_bingo_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_bingo_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                         uns32 global_hist) {
+  if(PREF_BINGO_UMLC)
+    return;
+  set_pref_bingo(&bingo_hwp_core[proc_id]);
+  pref_bingo_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_bingo_ul1_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                        uns32 global_hist) {
+  if(PREF_BINGO_UMLC)
+    return;
+  set_pref_bingo(&bingo_hwp_core[proc_id]);
+  pref_bingo_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_bingo_train(uns8 proc_id, Addr lineAddr, Addr loadPC) {
+  Addr            line_index = lineAddr >> LOG2(DCACHE_LINE_SIZE);
+  Addr            region     = line_index >> BINGO_REGION_BITS;
+  uns             offset     = line_index & (PREF_BINGO_REGION_LINES - 1);
+  uns32           region_tag = (uns32)(region ^ (region >> 32));
+  uns16           pc_hash    = (uns16)(loadPC ^ (loadPC >> 16) ^
+                                (loadPC >> 32));
+  Bingo_AT_Entry* set = &bingo_hwp->at[(region_tag &
+                                        (PREF_BINGO_AT_SETS - 1)) *
+                                       BINGO_AT_WAYS];
+  uns32           footprint;
+  uns             way;
+
+  STAT_EVENT(proc_id, BINGO_ACCESS);
+  for(way = 0; way < BINGO_AT_WAYS; way++) {
+    if(set[way].valid && set[way].region_tag == region_tag) {
+      set[way].footprint |= 1u << offset;
+      BINGO_TOUCH(set, BINGO_AT_WAYS, way);
+      return;
+    }
+  }
+
+  // trigger access: retire the victim's footprint and start a new one
+  STAT_EVENT(proc_id, BINGO_TRIGGER);
+  BINGO_VICTIM(set, BINGO_AT_WAYS, way);
+  if(set[way].valid) {
+    if(__builtin_popcount(set[way].footprint) > 1)
+      bingo_pht_insert(&set[way]);
+    else
+      STAT_EVENT(proc_id, BINGO_AT_DROP_SINGLE);
+  }
+  set[way].valid          = TRUE;
+  set[way].region_tag     = region_tag;
+  set[way].footprint      = 1u << offset;
+  set[way].pc_hash        = pc_hash;
+  set[way].trigger_offset = offset;
+  BINGO_TOUCH(set, BINGO_AT_WAYS, way);
+
+  footprint = bingo_pht_predict(proc_id, pc_hash, offset, region_tag);
+  if(!footprint)
+    return;
+
+  if(PREF_THROTTLEFB_ON)
+    pref_bingo_throttle_fb(proc_id);
+
+  DEBUG(proc_id, "region:%s trigger:%u footprint:%08x\n", hexstr64s(region),
+        offset, footprint);
+  bingo_prefetch(proc_id, region, offset, footprint & ~(1u << offset));
+}
+
+void pref_bingo_throttle_fb(uns8 proc_id) {
+  uns level;
+  pref_get_degfb(proc_id, bingo_hwp->hwp_info->id);
+  level = MIN2(bingo_hwp->hwp_info->dyn_degree_core[proc_id],
+               BINGO_DEGFB_LEVELS - 1);
+  bingo_hwp->max_degree = bingo_hwp->degree_vals[level];
+}
+
+/**************************************************************************************/
+/* Pattern history table */
+
+/* bingo_pht_set: both events of a trigger map to the set of its PC+Offset */
+static Bingo_PHT_Entry* bingo_pht_set(uns16 pc_hash, uns trigger_offset,
+                                      uns32 region_tag, uns8* short_tag,
+                                      uns16* long_tag) {
+  uns32 key = (((uns32)pc_hash << 5) | trigger_offset) * 0x9E3779B1u;
+  *short_tag = (uns8)key;
+  *long_tag  = (uns16)(((region_tag * 0x85EBCA6Bu) ^ key) >> 16);
+  return &bingo_hwp->pht[((key >> 16) & (PREF_BINGO_PHT_SETS - 1)) *
+                         BINGO_PHT_WAYS];
+}
+
+static void bingo_pht_insert(Bingo_AT_Entry const* at_entry) {
+  uns8             short_tag;
+  uns16            long_tag;
+  Bingo_PHT_Entry* set = bingo_pht_set(at_entry->pc_hash,
+                                       at_entry->trigger_offset,
+                                       at_entry->region_tag, &short_tag,
+                                       &long_tag);
+  uns              way;
+
+  for(way = 0; way < BINGO_PHT_WAYS; way++) {
+    if(set[way].valid && set[way].short_tag == short_tag &&
+       set[way].long_tag == long_tag)
+      break;
+  }
+  if(way == BINGO_PHT_WAYS)
+    BINGO_VICTIM(set, BINGO_PHT_WAYS, way);
+
+  set[way].valid     = TRUE;
+  set[way].short_tag = short_tag;
+  set[way].long_tag  = long_tag;
+  set[way].footprint = at_entry->footprint;
+  BINGO_TOUCH(set, BINGO_PHT_WAYS, way);
+}
+
+/* bingo_pht_predict: the footprint of the PC+Address match, or the lines
+ * that enough PC+Offset matches agree on */
+static uns32 bingo_pht_predict(uns8 proc_id, uns16 pc_hash,
+                               uns trigger_offset, uns32 region_tag) {
+  uns8             short_tag;
+  uns16            long_tag;
+  Bingo_PHT_Entry* set = bingo_pht_set(pc_hash, trigger_offset, region_tag,
+                                       &short_tag, &long_tag);
+  uns              votes[32] = {0};
+  uns              matches   = 0;
+  uns32            footprint = 0;
+  uns              way, ii;
+
+  for(way = 0; way < BINGO_PHT_WAYS; way++) {
+    if(!set[way].valid || set[way].short_tag != short_tag)
+      continue;
+    if(set[way].long_tag == long_tag) {
+      STAT_EVENT(proc_id, BINGO_PHT_LONG_HIT);
+      BINGO_TOUCH(set, BINGO_PHT_WAYS, way);
+      return set[way].footprint;
+    }
+    matches++;
+    for(ii = 0; ii < PREF_BINGO_REGION_LINES; ii++)
+      votes[ii] += (set[way].footprint >> ii) & 1;
+  }
+
+  if(!matches) {
+    STAT_EVENT(proc_id, BINGO_PHT_MISS);
+    return 0;
+  }
+  STAT_EVENT(proc_id, BINGO_PHT_SHORT_HIT);
+  for(ii = 0; ii < PREF_BINGO_REGION_LINES; ii++) {
+    if(votes[ii] * 100 >= matches * PREF_BINGO_VOTE_THRESH)
+      footprint |= 1u << ii;
+  }
+  return footprint;
+}
+
+/* bingo_prefetch: lines after the trigger first, then the ones before it */
+static void bingo_prefetch(uns8 proc_id, Addr region, uns trigger_offset,
+                           uns32 footprint) {
+  uns sent = 0;
+  uns ii;
+
+  for(ii = 1; ii < PREF_BINGO_REGION_LINES && sent < bingo_hwp->max_degree;
+      ii++) {
+    uns  offset = (trigger_offset + ii) & (PREF_BINGO_REGION_LINES - 1);
+    Addr line_index;
+    Flag added;
+
+    if(!((footprint >> offset) & 1))
+      continue;
+    line_index = (region << BINGO_REGION_BITS) | offset;
+    ASSERT(proc_id,
+           proc_id == (line_index >> (58 - LOG2(DCACHE_LINE_SIZE))));
+    added = PREF_BINGO_UMLC ?
+              pref_addto_umlc_req_queue(proc_id, line_index,
+                                        bingo_hwp->hwp_info->id) :
+              pref_addto_ul1req_queue(proc_id, line_index,
+                                      bingo_hwp->hwp_info->id);
+    if(!added) {
+      STAT_EVENT(proc_id, BINGO_QUEUE_FULL);
+      break;
+    }
+    STAT_EVENT(proc_id, BINGO_ISSUED);
+    sent++;
+  }
+}
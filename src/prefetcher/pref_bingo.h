@@ -0,0 +1,87 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_bingo.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Bingo spatial footprint prefetcher (Bakhshalipour et al.,
+ *                HPCA 2019)
+ ***************************************************************************************/
+#ifndef __PREF_BINGO_H__
+#define __PREF_BINGO_H__
+
+#include "pref_common.h"
+
+#define BINGO_AT_WAYS 4   // 16B entries, one set per cache line
+#define BINGO_PHT_WAYS 8  // 8B entries, one set per cache line
+#define BINGO_DEGFB_LEVELS 5
+
+/* Accumulation table: footprint of a region since its trigger access */
+typedef struct Bingo_AT_Entry_Struct {
+  uns32 region_tag;
+  uns32 footprint;
+  uns16 pc_hash;
+  uns8  trigger_offset;
+  uns8  age : 7;  // 0 == MRU
+  uns8  valid : 1;
+  uns32 pad;
+} Bingo_AT_Entry;
+
+/* Pattern history table: footprints found by PC+Address (long event) or, when
+ * that misses, by voting among the entries of the same PC+Offset */
+typedef struct Bingo_PHT_Entry_Struct {
+  uns32 footprint;
+  uns16 long_tag;
+  uns8  short_tag;
+  uns8  age : 7;  // 0 == MRU
+  uns8  valid : 1;
+} Bingo_PHT_Entry;
+
+typedef struct Pref_Bingo_Struct {
+  HWP_Info* hwp_info;
+
+  Bingo_AT_Entry*  at;
+  Bingo_PHT_Entry* pht;
+
+  uns max_degree;
+  uns degree_vals[BINGO_DEGFB_LEVELS];
+} Pref_Bingo;
+
+/*************************************************************/
+/* HWP Interface */
+void set_pref_bingo(Pref_Bingo* new_bingo);
+void pref_bingo_init(HWP* hwp);
+void pref_bingo_umlc_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                          uns32 global_hist);
+void pref_bingo_umlc_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                         uns32 global_hist);
+void pref_bingo_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                         uns32 global_hist);
+void pref_bingo_ul1_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                        uns32 global_hist);
+void pref_bingo_train(uns8 proc_id, Addr lineAddr, Addr loadPC);
+
+/*************************************************************/
+/* Misc functions */
+void pref_bingo_throttle_fb(uns8 proc_id);
+
+#endif /*  __PREF_BINGO_H__*/
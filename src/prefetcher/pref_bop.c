@@ -0,0 +1,287 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_bop.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Best-Offset prefetcher
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "globals/assert.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/pref.param.h"
+#include "prefetcher/pref_bop.h"
+#include "prefetcher/pref_bop.param.h"
+#include "prefetcher/pref_common.h"
+#include "statistics.h"
+
+/* bop : Best-Offset prefetching. A single offset D is used to prefetch X+D
+   on every miss (and first hit on a prefetched line) X. D is learned in
+   phases: each access tests one candidate offset d, scoring it when X-d is
+   in the recent requests (RR) table, i.e. a prefetch with offset d issued
+   at X-d would have been in time for X. The best scoring offset wins the
+   phase; if even that one scores too low prefetching is turned off until a
+   later phase finds a good offset.
+
+   The RR table is meant to be written when a prefetched line Y arrives
+   (with Y-D). There is no fill hook in the framework, so lines are recorded
+   when the first demand hit on them shows they arrived in time. While
+   prefetching is off, demand misses are recorded instead.
+*/
+
+/**************************************************************************************/
+/* Macros */
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_PREF_BOP, ##args)
+
+#define BOP_PAGE_BITS LOG2(VA_PAGE_SIZE_BYTES / DCACHE_LINE_SIZE)
+#define BOP_RR_BITS LOG2(PREF_BOP_RR_N)
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Pref_BOP* bop_hwp_core;
+static Pref_BOP* bop_hwp;
+
+static int bop_offsets[BOP_MAX_OFFSETS];
+static uns bop_num_offsets;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void  bop_init_offsets(void);
+static uns   bop_rr_index(Addr line_index);
+static uns16 bop_rr_tag(Addr line_index);
+static void  bop_rr_insert(Addr line_index);
+static Flag  bop_rr_hit(Addr line_index);
+static void  bop_learn(uns8 proc_id, Addr line_index);
+static void  bop_end_phase(uns8 proc_id);
+
+/**************************************************************************************/
+
+void set_pref_bop(Pref_BOP* new_bop) {
+  bop_hwp = new_bop;
+}
+
+void pref_bop_init(HWP* hwp) {
+  uns8 proc_id;
+
+  if(!PREF_BOP_ON)
+    return;
+  hwp->hwp_info->enabled = TRUE;
+
+  ASSERTM(0, !PREF_BOP_UMLC || MLC_PRESENT,
+          "pref_bop_umlc needs an MLC (mlc_present)\n");
+  ASSERT(0, is_power_of_2(PREF_BOP_RR_N));
+  ASSERT(0, PREF_BOP_SCORE_MAX < 256);
+  bop_init_offsets();
+
+  bop_hwp_core = (Pref_BOP*)calloc(NUM_CORES, sizeof(Pref_BOP));
+
+  for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Pref_BOP* bop = &bop_hwp_core[proc_id];
+
+    bop->hwp_info = hwp->hwp_info;
+    bop->rr_table = (uns16*)pref_alloc_table(PREF_BOP_RR_N, sizeof(uns16));
+    bop->offset   = 1;  // next line until the first phase ends
+    bop->degree   = PREF_BOP_DEGREE;
+
+    bop->degree_vals[0] = 1;
+    bop->degree_vals[1] = 1;
+    bop->degree_vals[2] = 2;
+    bop->degree_vals[3] = 3;
+    bop->degree_vals[4] = 4;
+  }
+}
+
+void pref_bop_umlc_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                        uns32 global_hist) {
+  if(!PREF_BOP_UMLC)
+    return;
+  set_pref_bop(&bop_hwp_core[proc_id]);
+  pref_bop_train(proc_id, lineAddr, FALSE);
+}
+
+void pref_bop_umlc_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                           uns32 global_hist) {
+  if(!PREF_BOP_UMLC)
+    return;
+  set_pref_bop(&bop_hwp_core[proc_id]);
+  pref_bop_train(proc_id, lineAddr, TRUE);
+}
+
+void pref_bop_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist) {
+  if(PREF_BOP_UMLC)
+    return;
+  set_pref_bop(&bop_hwp_core[proc_id]);
+  pref_bop_train(proc_id, lineAddr, FALSE);
+}
+
+void pref_bop_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                          uns32 global_hist) {
+  if(PREF_BOP_UMLC)
+    return;
+  set_pref_bop(&bop_hwp_core[proc_id]);
+  pref_bop_train(proc_id, lineAddr, TRUE);
+}
+
+void pref_bop_train(uns8 proc_id, Addr lineAddr, Flag pref_hit) {
+  Addr line_index = lineAddr >> LOG2(DCACHE_LINE_SIZE);
+  uns  ii;
+
+  // record before testing: the line being here already means it arrived
+  if(pref_hit && bop_hwp->offset)
+    bop_rr_insert(line_index - bop_hwp->offset);
+  else if(!pref_hit && !bop_hwp->offset)
+    bop_rr_insert(line_index);
+
+  bop_learn(proc_id, line_index);
+  if(!bop_hwp->offset)
+    return;
+
+  if(PREF_THROTTLEFB_ON)
+    pref_bop_throttle_fb(proc_id);
+
+  for(ii = 1; ii <= bop_hwp->degree; ii++) {
+    Addr target = line_index + (Addr)((int64)ii * bop_hwp->offset);
+    Flag added;
+
+    if((target >> BOP_PAGE_BITS) != (line_index >> BOP_PAGE_BITS))
+      break;
+    ASSERT(proc_id, proc_id == (target >> (58 - LOG2(DCACHE_LINE_SIZE))));
+    added = PREF_BOP_UMLC ?
+              pref_addto_umlc_req_queue(proc_id, target,
+                                        bop_hwp->hwp_info->id) :
+              pref_addto_ul1req_queue(proc_id, target, bop_hwp->hwp_info->id);
+    if(!added) {
+      STAT_EVENT(proc_id, BOP_QUEUE_FULL);
+      break;
+    }
+    STAT_EVENT(proc_id, BOP_ISSUED);
+  }
+}
+
+void pref_bop_throttle_fb(uns8 proc_id) {
+  uns level;
+  pref_get_degfb(proc_id, bop_hwp->hwp_info->id);
+  level = MIN2(bop_hwp->hwp_info->dyn_degree_core[proc_id],
+               BOP_DEGFB_LEVELS - 1);
+  bop_hwp->degree = bop_hwp->degree_vals[level];
+}
+
+/**************************************************************************************/
+/* Offset learning */
+
+/* bop_init_offsets: offsets whose prime factors are 2, 3 and 5 */
+static void bop_init_offsets(void) {
+  uns ii;
+
+  bop_num_offsets = 0;
+  for(ii = 1; ii <= PREF_BOP_MAX_OFFSET; ii++) {
+    uns rest = ii;
+    while(rest % 2 == 0)
+      rest /= 2;
+    while(rest % 3 == 0)
+      rest /= 3;
+    while(rest % 5 == 0)
+      rest /= 5;
+    if(rest != 1)
+      continue;
+    ASSERTM(0, bop_num_offsets + (PREF_BOP_NEGATIVE ? 2 : 1) <=
+                 BOP_MAX_OFFSETS,
+            "Too many BOP offsets, lower pref_bop_max_offset\n");
+    bop_offsets[bop_num_offsets++] = ii;
+    if(PREF_BOP_NEGATIVE)
+      bop_offsets[bop_num_offsets++] = -(int)ii;
+  }
+  ASSERT(0, bop_num_offsets > 0);
+}
+
+static uns bop_rr_index(Addr line_index) {
+  return (line_index ^ (line_index >> BOP_RR_BITS)) & (PREF_BOP_RR_N - 1);
+}
+
+static uns16 bop_rr_tag(Addr line_index) {
+  return 0x8000 | ((line_index >> BOP_RR_BITS) & 0x7fff);
+}
+
+static void bop_rr_insert(Addr line_index) {
+  bop_hwp->rr_table[bop_rr_index(line_index)] = bop_rr_tag(line_index);
+}
+
+static Flag bop_rr_hit(Addr line_index) {
+  return bop_hwp->rr_table[bop_rr_index(line_index)] == bop_rr_tag(line_index);
+}
+
+/* bop_learn: test the next offset of the current round against the access */
+static void bop_learn(uns8 proc_id, Addr line_index) {
+  uns idx = bop_hwp->test_index;
+
+  if(bop_rr_hit(line_index - (Addr)(int64)bop_offsets[idx])) {
+    STAT_EVENT(proc_id, BOP_RR_HIT);
+    if(++bop_hwp->scores[idx] >= PREF_BOP_SCORE_MAX) {
+      bop_end_phase(proc_id);
+      return;
+    }
+  }
+
+  if(++bop_hwp->test_index == bop_num_offsets) {
+    bop_hwp->test_index = 0;
+    if(++bop_hwp->round >= PREF_BOP_ROUND_MAX)
+      bop_end_phase(proc_id);
+  }
+}
+
+static void bop_end_phase(uns8 proc_id) {
+  uns best = 0;
+  uns ii;
+
+  for(ii = 1; ii < bop_num_offsets; ii++) {
+    if(bop_hwp->scores[ii] > bop_hwp->scores[best])
+      best = ii;
+  }
+
+  STAT_EVENT(proc_id, BOP_PHASE);
+  if(bop_hwp->scores[best] <= PREF_BOP_BAD_SCORE) {
+    STAT_EVENT(proc_id, BOP_PHASE_OFF);
+    bop_hwp->offset = 0;
+  } else {
+    bop_hwp->offset = bop_offsets[best];
+  }
+  DEBUG(proc_id, "phase done, offset:%d score:%u\n", bop_offsets[best],
+        bop_hwp->scores[best]);
+
+  memset(bop_hwp->scores, 0, sizeof(bop_hwp->scores));
+  bop_hwp->test_index = 0;
+  bop_hwp->round      = 0;
+}
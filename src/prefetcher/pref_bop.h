@@ -0,0 +1,69 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_bop.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Best-Offset prefetcher (Michaud, HPCA 2016)
+ ***************************************************************************************/
+#ifndef __PREF_BOP_H__
+#define __PREF_BOP_H__
+
+#include "pref_common.h"
+
+#define BOP_MAX_OFFSETS 64
+#define BOP_DEGFB_LEVELS 5
+
+typedef struct Pref_BOP_Struct {
+  HWP_Info* hwp_info;
+
+  uns16* rr_table;  // recent requests, tag per entry (0 == empty)
+
+  // learning phase
+  uns8 scores[BOP_MAX_OFFSETS];
+  uns  test_index;
+  uns  round;
+
+  int offset;  // offset in use, 0 == prefetching off
+  uns degree;
+  uns degree_vals[BOP_DEGFB_LEVELS];
+} Pref_BOP;
+
+/*************************************************************/
+/* HWP Interface */
+void set_pref_bop(Pref_BOP* new_bop);
+void pref_bop_init(HWP* hwp);
+void pref_bop_umlc_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                        uns32 global_hist);
+void pref_bop_umlc_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                           uns32 global_hist);
+void pref_bop_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist);
+void pref_bop_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                          uns32 global_hist);
+void pref_bop_train(uns8 proc_id, Addr lineAddr, Flag pref_hit);
+
+/*************************************************************/
+/* Misc functions */
+void pref_bop_throttle_fb(uns8 proc_id);
+
+#endif /*  __PREF_BOP_H__*/
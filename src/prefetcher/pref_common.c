@@ -55,9 +55,12 @@
 #include "prefetcher/l2l1pref.h"
 #include "prefetcher/pref.param.h"
 #include "prefetcher/pref_2dc.h"
+#include "prefetcher/pref_bingo.h"
+#include "prefetcher/pref_bop.h"
 #include "prefetcher/pref_ghb.h"
 #include "prefetcher/pref_markov.h"
 #include "prefetcher/pref_phase.h"
+#include "prefetcher/pref_spp.h"
 #include "statistics.h"
 /**************************************************************************************
  * Usage Notes
@@ -87,6 +90,14 @@ FILE* PREF_TRACE_OUT;
 FILE* PREF_DEGFB_FILE;
 
 static void pref_core_init(HWP_Core* pref_core);
+static void pref_req_index_init(Pref_Req_Index* index, uns queue_size);
+static void pref_req_index_write(Pref_Req_Index* index, Pref_Mem_Req* queue,
+                                 int slot, Pref_Mem_Req* new_req);
+static int  pref_req_index_find(Pref_Req_Index const* index,
+                                Pref_Mem_Req const* queue, Addr line_index,
+                                Flag valid_only);
+static Flag pref_req_queue_filter(Pref_Req_Index const* index,
+                                  Pref_Mem_Req* queue, Addr line_addr);
 static void pref_update_core(uns proc_id);
 static void pref_polbv_update_on_evict(uns8 pref_proc_id, uns8 evicted_proc_id,
                                        Addr evicted_addr);
@@ -124,6 +135,77 @@ void pref_core_init(HWP_Core* pref_core) {
 
   pref_core->ul1req_queue_req_pos  = -1;
   pref_core->ul1req_queue_send_pos = 0;
+
+  pref_req_index_init(&pref_core->dl0req_index, PREF_DL0REQ_QUEUE_SIZE);
+  pref_req_index_init(&pref_core->umlc_req_index, PREF_UMLC_REQ_QUEUE_SIZE);
+  pref_req_index_init(&pref_core->ul1req_index, PREF_UL1REQ_QUEUE_SIZE);
+}
+
+/* pref_req_index_init: twice as many buckets as slots keeps chains short */
+void pref_req_index_init(Pref_Req_Index* index, uns queue_size) {
+  uns num_buckets;
+  index->bucket_bits = 1;
+  while((1U << index->bucket_bits) < 2 * queue_size)
+    index->bucket_bits++;
+  num_buckets  = 1U << index->bucket_bits;
+  index->heads = (int*)malloc(sizeof(int) * num_buckets);
+  index->next  = (int*)malloc(sizeof(int) * queue_size);
+  memset(index->heads, -1, sizeof(int) * num_buckets);
+  memset(index->next, -1, sizeof(int) * queue_size);
+}
+
+static inline uns pref_req_index_bucket(Pref_Req_Index const* index,
+                                        Addr                  line_index) {
+  return (line_index * 0x9e3779b97f4a7c15ULL) >> (64 - index->bucket_bits);
+}
+
+/* pref_req_index_write: stores new_req into the slot, moving the slot to the
+   chain of its new line */
+void pref_req_index_write(Pref_Req_Index* index, Pref_Mem_Req* queue, int slot,
+                          Pref_Mem_Req* new_req) {
+  if(queue[slot].line_index) {
+    int* link = &index->heads[pref_req_index_bucket(index,
+                                                    queue[slot].line_index)];
+    while(*link != slot) {
+      ASSERT(0, *link >= 0);
+      link = &index->next[*link];
+    }
+    *link = index->next[slot];
+  }
+
+  queue[slot] = *new_req;
+
+  if(new_req->line_index) {
+    uns bucket           = pref_req_index_bucket(index, new_req->line_index);
+    index->next[slot]    = index->heads[bucket];
+    index->heads[bucket] = slot;
+  }
+}
+
+/* pref_req_index_find: returns the lowest slot holding line_index (a valid
+   request if valid_only), -1 if there is none. The lowest slot is what the
+   linear scans this replaces used to find. */
+int pref_req_index_find(Pref_Req_Index const* index, Pref_Mem_Req const* queue,
+                        Addr line_index, Flag valid_only) {
+  int found = -1;
+  for(int slot = index->heads[pref_req_index_bucket(index, line_index)];
+      slot >= 0; slot = index->next[slot]) {
+    if(queue[slot].line_index == line_index &&
+       (queue[slot].valid || !valid_only) && (found < 0 || slot < found))
+      found = slot;
+  }
+  return found;
+}
+
+/* pref_req_queue_filter: invalidates the request for line_addr, if any */
+Flag pref_req_queue_filter(Pref_Req_Index const* index, Pref_Mem_Req* queue,
+                           Addr line_addr) {
+  int slot = pref_req_index_find(index, queue,
+                                 line_addr >> LOG2(DCACHE_LINE_SIZE), TRUE);
+  if(slot < 0)
+    return FALSE;
+  queue[slot].valid = FALSE;
+  return TRUE;
 }
 
 void pref_init(void) {
@@ -469,16 +551,11 @@ void pref_ul1_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC,
 Flag pref_dl0req_queue_filter(Addr line_addr) {
   if(!PREF_DL0REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns           proc_id      = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* dl0req_queue = pref.cores[proc_id]->dl0req_queue;
-  for(uns ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++) {
-    if(dl0req_queue[ii].valid &&
-       (dl0req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      dl0req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_DL0REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
+  HWP_Core* core = pref.cores[get_proc_id_from_cmp_addr(line_addr)];
+  if(pref_req_queue_filter(&core->dl0req_index, core->dl0req_queue,
+                           line_addr)) {
+    STAT_EVENT(0, PREF_DL0REQ_QUEUE_HIT_BY_DEMAND);
+    return TRUE;
   }
   return FALSE;
 }
@@ -486,16 +563,11 @@ Flag pref_dl0req_queue_filter(Addr line_addr) {
 Flag pref_umlc_req_queue_filter(Addr line_addr) {
   if(!PREF_UMLC_REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns           proc_id        = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* umlc_req_queue = pref.cores[proc_id]->umlc_req_queue;
-  for(uns ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++) {
-    if(umlc_req_queue[ii].valid &&
-       (umlc_req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      umlc_req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
+  HWP_Core* core = pref.cores[get_proc_id_from_cmp_addr(line_addr)];
+  if(pref_req_queue_filter(&core->umlc_req_index, core->umlc_req_queue,
+                           line_addr)) {
+    STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_HIT_BY_DEMAND);
+    return TRUE;
   }
   return FALSE;
 }
@@ -503,48 +575,33 @@ Flag pref_umlc_req_queue_filter(Addr line_addr) {
 Flag pref_ul1req_queue_filter(Addr line_addr) {
   if(!PREF_UL1REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns           proc_id      = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
-  for(uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-    if(ul1req_queue[ii].valid &&
-       (ul1req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      ul1req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_UL1REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
+  HWP_Core* core = pref.cores[get_proc_id_from_cmp_addr(line_addr)];
+  if(pref_req_queue_filter(&core->ul1req_index, core->ul1req_queue,
+                           line_addr)) {
+    STAT_EVENT(0, PREF_UL1REQ_QUEUE_HIT_BY_DEMAND);
+    return TRUE;
   }
   return FALSE;
 }
 
 Flag pref_ul1req_queue_match(Addr line_addr) {
-  uns           proc_id      = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
-  for(uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-    if(ul1req_queue[ii].valid &&
-       (ul1req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      return TRUE;
-    }
-  }
-  return FALSE;
+  HWP_Core* core = pref.cores[get_proc_id_from_cmp_addr(line_addr)];
+  return pref_req_index_find(&core->ul1req_index, core->ul1req_queue,
+                             line_addr >> LOG2(DCACHE_LINE_SIZE), TRUE) >= 0;
 }
 
 Flag pref_addto_dl0req_queue(uns8 proc_id, Addr line_index,
                              uns8 prefetcher_id) {
-  int          ii;
   Pref_Mem_Req new_req = {0};
   if(!line_index)  // addr = 0
     return TRUE;
   Pref_Mem_Req* dl0req_queue = pref.cores[proc_id]->dl0req_queue;
   int* dl0req_queue_req_pos  = &pref.cores[proc_id]->dl0req_queue_req_pos;
-  if(PREF_DL0REQ_ADD_FILTER_ON) {
-    for(ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++) {
-      if(dl0req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_DL0REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  if(PREF_DL0REQ_ADD_FILTER_ON &&
+     pref_req_index_find(&pref.cores[proc_id]->dl0req_index, dl0req_queue,
+                         line_index, FALSE) >= 0) {
+    STAT_EVENT(0, PREF_DL0REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if(dl0req_queue[(*dl0req_queue_req_pos + 1) % PREF_DL0REQ_QUEUE_SIZE].valid) {
     STAT_EVENT_ALL(PREF_DL0REQ_QUEUE_FULL);
@@ -561,25 +618,23 @@ Flag pref_addto_dl0req_queue(uns8 proc_id, Addr line_index,
 
   *dl0req_queue_req_pos = (*dl0req_queue_req_pos + 1) % PREF_DL0REQ_QUEUE_SIZE;
 
-  dl0req_queue[*dl0req_queue_req_pos] = new_req;
+  pref_req_index_write(&pref.cores[proc_id]->dl0req_index, dl0req_queue,
+                       *dl0req_queue_req_pos, &new_req);
   return TRUE;
 }
 
 Flag pref_addto_umlc_req_queue(uns8 proc_id, Addr line_index,
                                uns8 prefetcher_id) {
-  int          ii;
   Pref_Mem_Req new_req = {0};
   if(!line_index)  // addr = 0
     return TRUE;
   Pref_Mem_Req* umlc_req_queue = pref.cores[proc_id]->umlc_req_queue;
   int* umlc_req_queue_req_pos  = &pref.cores[proc_id]->umlc_req_queue_req_pos;
-  if(PREF_UMLC_REQ_ADD_FILTER_ON) {
-    for(ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++) {
-      if(umlc_req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  if(PREF_UMLC_REQ_ADD_FILTER_ON &&
+     pref_req_index_find(&pref.cores[proc_id]->umlc_req_index, umlc_req_queue,
+                         line_index, FALSE) >= 0) {
+    STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if(umlc_req_queue[(*umlc_req_queue_req_pos + 1) % PREF_UMLC_REQ_QUEUE_SIZE]
        .valid) {
@@ -600,7 +655,8 @@ Flag pref_addto_umlc_req_queue(uns8 proc_id, Addr line_index,
   *umlc_req_queue_req_pos = (*umlc_req_queue_req_pos + 1) %
                             PREF_UMLC_REQ_QUEUE_SIZE;
 
-  umlc_req_queue[*umlc_req_queue_req_pos] = new_req;
+  pref_req_index_write(&pref.cores[proc_id]->umlc_req_index, umlc_req_queue,
+                       *umlc_req_queue_req_pos, &new_req);
   return TRUE;
 }
 
@@ -613,7 +669,6 @@ Flag pref_addto_ul1req_queue(uns8 proc_id, Addr line_index,
 Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index,
                                  uns8 prefetcher_id, uns distance, Addr loadPC,
                                  uns32 global_hist, Flag bw) {
-  int          ii;
   Pref_Mem_Req new_req;
   Addr         line_addr;
   if(!line_index)  // addr = 0
@@ -626,13 +681,11 @@ Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index,
 
   pref_feed_back_info_update(prefetcher_id);
 
-  if(PREF_UL1REQ_ADD_FILTER_ON) {
-    for(ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-      if(ul1req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_UL1REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  if(PREF_UL1REQ_ADD_FILTER_ON &&
+     pref_req_index_find(&pref.cores[proc_id]->ul1req_index, ul1req_queue,
+                         line_index, FALSE) >= 0) {
+    STAT_EVENT(0, PREF_UL1REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if(ul1req_queue[(*ul1req_queue_req_pos + 1) % PREF_UL1REQ_QUEUE_SIZE].valid) {
     STAT_EVENT_ALL(PREF_UL1REQ_QUEUE_FULL);
@@ -653,7 +706,8 @@ Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index,
 
   *ul1req_queue_req_pos = (*ul1req_queue_req_pos + 1) % PREF_UL1REQ_QUEUE_SIZE;
 
-  ul1req_queue[*ul1req_queue_req_pos] = new_req;
+  pref_req_index_write(&pref.cores[proc_id]->ul1req_index, ul1req_queue,
+                       *ul1req_queue_req_pos, &new_req);
   return TRUE;
 }
 
@@ -1388,6 +1442,19 @@ float pref_get_ul1pollution(uns8 proc_id) {
   return pol;
 }
 
+/* pref_alloc_table: zeroed, cache line aligned storage for a prefetcher
+ * table. Entry sizes are chosen so that a set never straddles two lines. */
+void* pref_alloc_table(uns num_entries, uns entry_size) {
+  void* table;
+  uns64 bytes = (uns64)num_entries * entry_size;
+  bytes       = (bytes + PREF_TABLE_ALIGN - 1) & ~(uns64)(PREF_TABLE_ALIGN - 1);
+  ASSERTM(0, !posix_memalign(&table, PREF_TABLE_ALIGN, bytes),
+          "Could not allocate %llu bytes for a prefetcher table\n",
+          (unsigned long long)bytes);
+  memset(table, 0, bytes);
+  return table;
+}
+
 // BE
 
 void pref_req_drop_process(uns8 proc_id, uns8 prefetcher_id) {
@@ -32,6 +32,7 @@
 #include "memory/mem_req.h"
 
 #define PREF_TRACKERS_NUM 16
+#define PREF_TABLE_ALIGN 64  // prefetcher tables start on a cache line
 
 // typedef in globals/global_types.h
 struct Pref_Mem_Req_struct {
@@ -48,6 +49,16 @@ struct Pref_Mem_Req_struct {
   Counter rdy_cycle;  // Move this out
 };
 
+/* Finds the slots of a request queue that hold a given line without scanning
+   the queue. Slots are chained per hash bucket of their line_index; a slot
+   stays in its chain (valid or not) until it is overwritten, like the
+   line_index it holds. */
+typedef struct Pref_Req_Index_struct {
+  int* heads;  // first slot of each bucket, -1 if empty
+  int* next;   // next slot in the same bucket, -1 at the end
+  uns  bucket_bits;
+} Pref_Req_Index;
+
 typedef struct Pref_Polbv_Info_struct {
   uns8 proc_id;
   Flag pollution;
@@ -138,6 +149,10 @@ typedef struct HWP_Core_struct {
   int ul1req_queue_req_pos;
   int ul1req_queue_send_pos;
 
+  Pref_Req_Index dl0req_index;
+  Pref_Req_Index umlc_req_index;
+  Pref_Req_Index ul1req_index;
+
   Counter ul1_misses;
   Counter curr_ul1_misses;
 
@@ -229,6 +244,7 @@ int         pref_compare_hwp_priority(const void* const a, const void* const b);
 float       pref_get_accuracy(uns8 proc_id, uns8 prefetcher_id);
 float       pref_get_timeliness(uns8 proc_id, uns8 prefetcher_id);
 HWP_DynAggr pref_get_degfb(uns8 proc_id, uns8 prefetcher_id);
+void*       pref_alloc_table(uns num_entries, uns entry_size);
 
 
 float pref_get_overallaccuracy(HWP_Type);
@@ -0,0 +1,529 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_spp.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Signature Path Prefetcher with a perceptron prefetch filter
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "globals/assert.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/pref.param.h"
+#include "prefetcher/pref_common.h"
+#include "prefetcher/pref_spp.h"
+#include "prefetcher/pref_spp.param.h"
+#include "statistics.h"
+
+/* spp : Signature Path Prefetcher. Each page keeps a signature, a compressed
+   history of the deltas between its last accesses. The pattern table tells
+   which deltas followed a signature and how often, so the prefetcher can walk
+   the most likely path ahead of the demand stream, multiplying confidences
+   along the way (lookahead). Paths that leave the page are remembered in the
+   GHR so that the next page can start with a signature instead of from
+   scratch.
+
+   The perceptron filter (PPF) sits between the lookahead and the queue. Each
+   candidate is scored with a few hashed features; candidates below tau are
+   dropped. Issued and dropped candidates are remembered so that demand
+   accesses (and useless prefetches being overwritten) can train the weights.
+*/
+
+/**************************************************************************************/
+/* Macros */
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_PREF_SPP, ##args)
+
+#define SPP_PAGE_LINES (VA_PAGE_SIZE_BYTES / DCACHE_LINE_SIZE)
+#define SPP_PAGE_BITS LOG2(SPP_PAGE_LINES)
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Pref_SPP* spp_hwp_core;
+static Pref_SPP* spp_hwp;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void          spp_st_touch(SPP_ST_Entry* set, uns way);
+static SPP_ST_Entry* spp_st_access(Addr page, uns offset, uns16* old_sig,
+                                   Flag* hit);
+static uns16         spp_ghr_bootstrap(uns offset);
+static void          spp_ghr_insert(uns16 sig, uns conf, uns last_offset,
+                                    int delta);
+static void          spp_pt_update(uns16 sig, int delta);
+static uns16         spp_next_sig(uns16 sig, int delta);
+static void          spp_lookahead(uns8 proc_id, Addr page, uns offset,
+                                   uns16 sig, Addr loadPC);
+static Flag spp_candidate(uns8 proc_id, Addr line_index, uns16 sig, int delta,
+                          uns conf, uns depth, Addr loadPC);
+static Flag spp_issue(uns8 proc_id, Addr line_index);
+static void spp_ppf_features(uns16* feature, Addr line_index, uns16 sig,
+                             int delta, uns conf, uns depth, Addr loadPC);
+static int  spp_ppf_sum(uns16 const* feature);
+static void spp_ppf_train(uns16 const* feature, Flag useful);
+static void spp_ppf_demand(uns8 proc_id, Addr line_index);
+
+/**************************************************************************************/
+
+void set_pref_spp(Pref_SPP* new_spp) {
+  spp_hwp = new_spp;
+}
+
+void pref_spp_init(HWP* hwp) {
+  uns8 proc_id;
+  uns  ii;
+
+  if(!PREF_SPP_ON)
+    return;
+  hwp->hwp_info->enabled = TRUE;
+
+  ASSERTM(0, !PREF_SPP_UMLC || MLC_PRESENT,
+          "pref_spp_umlc needs an MLC (mlc_present)\n");
+  ASSERT(0, is_power_of_2(PREF_SPP_ST_SETS) && is_power_of_2(PREF_SPP_PT_N));
+  ASSERT(0, PREF_SPP_PT_N <= (1 << SPP_SIG_BITS));
+  ASSERT(0, is_power_of_2(PREF_SPP_PPF_N) &&
+              is_power_of_2(PREF_SPP_PPF_TABLE_N));
+  ASSERTM(0, SPP_PAGE_LINES <= 64 && is_power_of_2(SPP_PAGE_LINES),
+          "SPP deltas are encoded in 7 bits (at most 64 lines per page)\n");
+
+  spp_hwp_core = (Pref_SPP*)calloc(NUM_CORES, sizeof(Pref_SPP));
+
+  for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Pref_SPP* spp = &spp_hwp_core[proc_id];
+
+    spp->hwp_info = hwp->hwp_info;
+    spp->st = (SPP_ST_Entry*)pref_alloc_table(PREF_SPP_ST_SETS * SPP_ST_WAYS,
+                                              sizeof(SPP_ST_Entry));
+    for(ii = 0; ii < PREF_SPP_ST_SETS * SPP_ST_WAYS; ii++)
+      spp->st[ii].age = ii % SPP_ST_WAYS;
+    spp->pt = (SPP_PT_Entry*)pref_alloc_table(PREF_SPP_PT_N,
+                                              sizeof(SPP_PT_Entry));
+
+    if(PREF_SPP_PPF_ON) {
+      spp->ppf_weights  = (int8*)pref_alloc_table(
+        SPP_PPF_FEATURES * PREF_SPP_PPF_N, sizeof(int8));
+      spp->ppf_issued   = (SPP_PPF_Entry*)pref_alloc_table(
+        PREF_SPP_PPF_TABLE_N, sizeof(SPP_PPF_Entry));
+      spp->ppf_rejected = (SPP_PPF_Entry*)pref_alloc_table(
+        PREF_SPP_PPF_TABLE_N, sizeof(SPP_PPF_Entry));
+    }
+
+    spp->max_depth     = PREF_SPP_MAX_DEPTH;
+    spp->depth_vals[0] = 2;
+    spp->depth_vals[1] = 4;
+    spp->depth_vals[2] = 8;
+    spp->depth_vals[3] = 12;
+    spp->depth_vals[4] = 16;
+  }
+}
+
+void pref_spp_umlc_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                        uns32 global_hist) {
+  if(!PREF_SPP_UMLC)
+    return;
+  set_pref_spp(&spp_hwp_core[proc_id]);
+  STAT_EVENT(proc_id, SPP_TRAIN_MISS);
+  pref_spp_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_spp_umlc_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist) {
+  if(!PREF_SPP_UMLC)
+    return;
+  set_pref_spp(&spp_hwp_core[proc_id]);
+  STAT_EVENT(proc_id, SPP_TRAIN_HIT);
+  pref_spp_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_spp_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist) {
+  if(PREF_SPP_UMLC)
+    return;
+  set_pref_spp(&spp_hwp_core[proc_id]);
+  STAT_EVENT(proc_id, SPP_TRAIN_MISS);
+  pref_spp_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_spp_ul1_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                      uns32 global_hist) {
+  if(PREF_SPP_UMLC)
+    return;
+  set_pref_spp(&spp_hwp_core[proc_id]);
+  STAT_EVENT(proc_id, SPP_TRAIN_HIT);
+  pref_spp_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_spp_train(uns8 proc_id, Addr lineAddr, Addr loadPC) {
+  Addr          line_index = lineAddr >> LOG2(DCACHE_LINE_SIZE);
+  Addr          page       = line_index >> SPP_PAGE_BITS;
+  uns           offset     = line_index & (SPP_PAGE_LINES - 1);
+  uns16         old_sig;
+  Flag          hit;
+  SPP_ST_Entry* entry;
+
+  if(PREF_SPP_PPF_ON)
+    spp_ppf_demand(proc_id, line_index);
+
+  entry = spp_st_access(page, offset, &old_sig, &hit);
+  if(hit) {
+    int delta = (int)offset - (int)entry->last_offset;
+    if(delta == 0)
+      return;
+    spp_pt_update(old_sig, delta);
+    entry->sig         = spp_next_sig(old_sig, delta);
+    entry->last_offset = offset;
+  } else {
+    STAT_EVENT(proc_id, SPP_ST_MISS);
+    entry->sig = spp_ghr_bootstrap(offset);
+    if(entry->sig)
+      STAT_EVENT(proc_id, SPP_GHR_BOOTSTRAP);
+  }
+
+  if(!entry->sig)
+    return;  // a fresh page has nothing to predict yet
+
+  if(PREF_THROTTLEFB_ON)
+    pref_spp_throttle_fb(proc_id);
+
+  DEBUG(proc_id, "page:%s off:%u sig:%x\n", hexstr64s(page), offset,
+        entry->sig);
+  spp_lookahead(proc_id, page, offset, entry->sig, loadPC);
+}
+
+void pref_spp_throttle_fb(uns8 proc_id) {
+  uns level;
+  pref_get_degfb(proc_id, spp_hwp->hwp_info->id);
+  level = MIN2(spp_hwp->hwp_info->dyn_degree_core[proc_id],
+               SPP_DEGFB_LEVELS - 1);
+  spp_hwp->max_depth = spp_hwp->depth_vals[level];
+}
+
+/**************************************************************************************/
+/* Signature and pattern tables */
+
+/* spp_st_touch: make 'way' the MRU way of a set, ages stay a permutation */
+static void spp_st_touch(SPP_ST_Entry* set, uns way) {
+  uns ii;
+  for(ii = 0; ii < SPP_ST_WAYS; ii++) {
+    if(set[ii].age < set[way].age)
+      set[ii].age++;
+  }
+  set[way].age = 0;
+}
+
+/* spp_st_access: find the page's entry or replace the LRU one. On a hit
+ * old_sig is the signature before this access. */
+static SPP_ST_Entry* spp_st_access(Addr page, uns offset, uns16* old_sig,
+                                   Flag* hit) {
+  uns32         tag = (uns32)(page ^ (page >> 32));
+  SPP_ST_Entry* set = &spp_hwp->st[(tag & (PREF_SPP_ST_SETS - 1)) *
+                                   SPP_ST_WAYS];
+  uns           victim = 0;
+  uns           ii;
+
+  for(ii = 0; ii < SPP_ST_WAYS; ii++) {
+    if(set[ii].valid && set[ii].page_tag == tag)
+      break;
+    if(!set[victim].valid)
+      continue;
+    if(!set[ii].valid || set[ii].age > set[victim].age)
+      victim = ii;
+  }
+
+  if(ii < SPP_ST_WAYS) {
+    *hit     = TRUE;
+    *old_sig = set[ii].sig;
+    spp_st_touch(set, ii);
+    return &set[ii];
+  }
+
+  *hit                    = FALSE;
+  *old_sig                = 0;
+  set[victim].valid       = TRUE;
+  set[victim].page_tag    = tag;
+  set[victim].sig         = 0;
+  set[victim].last_offset = offset;
+  spp_st_touch(set, victim);
+  return &set[victim];
+}
+
+/* spp_ghr_bootstrap: a lookahead path that left its page through the offset
+ * just touched gives the new page its first signature */
+static uns16 spp_ghr_bootstrap(uns offset) {
+  uns16 sig  = 0;
+  uns   conf = 0;
+  uns   ii;
+
+  for(ii = 0; ii < SPP_GHR_N; ii++) {
+    SPP_GHR_Entry* ghr = &spp_hwp->ghr[ii];
+    int            target;
+    if(!ghr->valid)
+      continue;
+    target = ((int)ghr->last_offset + ghr->delta) & (SPP_PAGE_LINES - 1);
+    if(target == (int)offset && ghr->conf >= conf) {
+      conf = ghr->conf;
+      sig  = spp_next_sig(ghr->sig, ghr->delta);
+    }
+  }
+  return sig;
+}
+
+static void spp_ghr_insert(uns16 sig, uns conf, uns last_offset, int delta) {
+  SPP_GHR_Entry* victim = &spp_hwp->ghr[0];
+  uns            ii;
+
+  for(ii = 0; ii < SPP_GHR_N; ii++) {
+    SPP_GHR_Entry* ghr = &spp_hwp->ghr[ii];
+    if(ghr->valid && ghr->sig == sig && ghr->last_offset == last_offset &&
+       ghr->delta == delta) {
+      victim = ghr;
+      break;
+    }
+    if(!ghr->valid || (victim->valid && ghr->conf < victim->conf))
+      victim = ghr;
+  }
+  victim->valid       = TRUE;
+  victim->sig         = sig;
+  victim->conf        = conf;
+  victim->last_offset = last_offset;
+  victim->delta       = delta;
+}
+
+/* spp_pt_update: count 'delta' after 'sig', halving the counters of the entry
+ * when one of them saturates */
+static void spp_pt_update(uns16 sig, int delta) {
+  SPP_PT_Entry* entry  = &spp_hwp->pt[sig & (PREF_SPP_PT_N - 1)];
+  uns           victim = 0;
+  uns           ii;
+
+  if(entry->c_sig == SPP_CTR_MAX) {
+    entry->c_sig >>= 1;
+    for(ii = 0; ii < SPP_PT_DELTAS; ii++)
+      entry->c_delta[ii] >>= 1;
+  }
+  entry->c_sig++;
+
+  for(ii = 0; ii < SPP_PT_DELTAS; ii++) {
+    if(entry->c_delta[ii] && entry->delta[ii] == delta)
+      break;
+    if(entry->c_delta[ii] < entry->c_delta[victim])
+      victim = ii;
+  }
+  if(ii == SPP_PT_DELTAS) {
+    ii                  = victim;
+    entry->delta[ii]    = delta;
+    entry->c_delta[ii]  = 0;
+  }
+  if(entry->c_delta[ii] == SPP_CTR_MAX) {
+    uns jj;
+    for(jj = 0; jj < SPP_PT_DELTAS; jj++)
+      entry->c_delta[jj] >>= 1;
+  }
+  entry->c_delta[ii]++;
+}
+
+/* spp_next_sig: shift in the delta as 7 bits of sign and magnitude */
+static uns16 spp_next_sig(uns16 sig, int delta) {
+  uns16 enc = delta < 0 ? (uns16)(-delta | 0x40) : (uns16)delta;
+  uns16 next = ((sig << SPP_SIG_SHIFT) ^ enc) & SPP_SIG_MASK;
+  return next ? next : 1;  // 0 means "no history"
+}
+
+/**************************************************************************************/
+/* Lookahead */
+
+static void spp_lookahead(uns8 proc_id, Addr page, uns offset, uns16 sig,
+                          Addr loadPC) {
+  uns alpha = (uns)(100.0 * MIN2(pref_get_accuracy(proc_id,
+                                                   spp_hwp->hwp_info->id),
+                                 1.0));
+  uns conf  = 100;
+  uns depth = 0;
+  int base  = offset;
+  uns ii;
+
+  while(depth < spp_hwp->max_depth) {
+    SPP_PT_Entry* entry     = &spp_hwp->pt[sig & (PREF_SPP_PT_N - 1)];
+    uns           best_conf = 0;
+    int           best      = 0;
+
+    if(!entry->c_sig)
+      break;
+
+    for(ii = 0; ii < SPP_PT_DELTAS; ii++) {
+      int delta = entry->delta[ii];
+      int target;
+      uns path_conf;
+
+      if(!entry->c_delta[ii])
+        continue;
+      path_conf = conf * entry->c_delta[ii] / entry->c_sig;
+      if(depth)
+        path_conf = path_conf * alpha / 100;
+      if(path_conf > best_conf) {
+        best_conf = path_conf;
+        best      = delta;
+      }
+      if(path_conf < PREF_SPP_PF_THRESH)
+        continue;
+
+      target = base + delta;
+      if(target < 0 || target >= (int)SPP_PAGE_LINES) {
+        spp_ghr_insert(sig, path_conf, base, delta);
+        continue;
+      }
+      if(!spp_candidate(proc_id, (page << SPP_PAGE_BITS) | target, sig, delta,
+                        path_conf, depth, loadPC))
+        return;  // queue is full
+    }
+
+    if(best_conf < PREF_SPP_LA_THRESH)
+      break;
+    base += best;
+    if(base < 0 || base >= (int)SPP_PAGE_LINES)
+      break;
+    conf = best_conf;
+    sig  = spp_next_sig(sig, best);
+    depth++;
+  }
+  STAT_EVENT(proc_id, SPP_DEPTH_0 + MIN2(depth, 8));
+}
+
+/* spp_candidate: run a lookahead candidate through the filter. Returns FALSE
+ * only when the prefetch queue is full. */
+static Flag spp_candidate(uns8 proc_id, Addr line_index, uns16 sig, int delta,
+                          uns conf, uns depth, Addr loadPC) {
+  uns16          feature[SPP_PPF_FEATURES];
+  SPP_PPF_Entry* entry;
+  Flag           accept;
+
+  STAT_EVENT(proc_id, SPP_CANDIDATE);
+  if(!PREF_SPP_PPF_ON)
+    return spp_issue(proc_id, line_index);
+
+  spp_ppf_features(feature, line_index, sig, delta, conf, depth, loadPC);
+  accept = spp_ppf_sum(feature) >= PREF_SPP_PPF_TAU;
+  STAT_EVENT(proc_id, accept ? SPP_PPF_ACCEPT : SPP_PPF_REJECT);
+
+  if(accept) {
+    if(!spp_issue(proc_id, line_index))
+      return FALSE;
+    entry = &spp_hwp->ppf_issued[line_index & (PREF_SPP_PPF_TABLE_N - 1)];
+    if(entry->valid && !entry->useful &&
+       entry->line_tag != (uns32)line_index) {
+      STAT_EVENT(proc_id, SPP_PPF_TRAIN_USELESS);
+      spp_ppf_train(entry->feature, FALSE);
+    }
+  } else {
+    entry = &spp_hwp->ppf_rejected[line_index & (PREF_SPP_PPF_TABLE_N - 1)];
+  }
+  entry->valid    = TRUE;
+  entry->useful   = FALSE;
+  entry->line_tag = (uns32)line_index;
+  memcpy(entry->feature, feature, sizeof(feature));
+  return TRUE;
+}
+
+static Flag spp_issue(uns8 proc_id, Addr line_index) {
+  Flag added;
+  ASSERT(proc_id, proc_id == (line_index >> (58 - LOG2(DCACHE_LINE_SIZE))));
+  added = PREF_SPP_UMLC ?
+            pref_addto_umlc_req_queue(proc_id, line_index,
+                                      spp_hwp->hwp_info->id) :
+            pref_addto_ul1req_queue(proc_id, line_index,
+                                    spp_hwp->hwp_info->id);
+  STAT_EVENT(proc_id, added ? SPP_ISSUED : SPP_QUEUE_FULL);
+  return added;
+}
+
+/**************************************************************************************/
+/* Perceptron prefetch filter */
+
+static void spp_ppf_features(uns16* feature, Addr line_index, uns16 sig,
+                             int delta, uns conf, uns depth, Addr loadPC) {
+  uns  mask = PREF_SPP_PPF_N - 1;
+  Addr pc   = loadPC ^ (loadPC >> 16);
+
+  feature[0] = (pc ^ depth) & mask;
+  feature[1] = (pc ^ (pc >> 8) ^ (delta & 0x7f)) & mask;
+  feature[2] = (sig ^ ((delta & 0x7f) << 5)) & mask;
+  feature[3] = (line_index ^ (line_index >> 10)) & mask;
+  feature[4] = ((line_index & (SPP_PAGE_LINES - 1)) ^ ((conf / 10) << 6)) &
+               mask;
+}
+
+static int spp_ppf_sum(uns16 const* feature) {
+  int sum = 0;
+  uns ii;
+  for(ii = 0; ii < SPP_PPF_FEATURES; ii++)
+    sum += spp_hwp->ppf_weights[ii * PREF_SPP_PPF_N + feature[ii]];
+  return sum;
+}
+
+/* spp_ppf_train: push the weights of a candidate towards its outcome unless
+ * the sum is already past the margin */
+static void spp_ppf_train(uns16 const* feature, Flag useful) {
+  int sum = spp_ppf_sum(feature);
+  uns ii;
+
+  if(useful ? sum > PREF_SPP_PPF_THETA : sum < -PREF_SPP_PPF_THETA)
+    return;
+  for(ii = 0; ii < SPP_PPF_FEATURES; ii++) {
+    int8* weight = &spp_hwp->ppf_weights[ii * PREF_SPP_PPF_N + feature[ii]];
+    if(useful && *weight < SPP_PPF_WEIGHT_MAX)
+      (*weight)++;
+    else if(!useful && *weight > SPP_PPF_WEIGHT_MIN)
+      (*weight)--;
+  }
+}
+
+/* spp_ppf_demand: a demand access to a line we prefetched (or should have)
+ * is a positive example */
+static void spp_ppf_demand(uns8 proc_id, Addr line_index) {
+  uns            idx    = line_index & (PREF_SPP_PPF_TABLE_N - 1);
+  SPP_PPF_Entry* issued = &spp_hwp->ppf_issued[idx];
+  SPP_PPF_Entry* reject = &spp_hwp->ppf_rejected[idx];
+
+  if(issued->valid && !issued->useful &&
+     issued->line_tag == (uns32)line_index) {
+    issued->useful = TRUE;
+    STAT_EVENT(proc_id, SPP_PPF_TRAIN_USEFUL);
+    spp_ppf_train(issued->feature, TRUE);
+  }
+  if(reject->valid && reject->line_tag == (uns32)line_index) {
+    reject->valid = FALSE;
+    STAT_EVENT(proc_id, SPP_PPF_TRAIN_MISSED);
+    spp_ppf_train(reject->feature, TRUE);
+  }
+}
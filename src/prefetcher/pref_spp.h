@@ -0,0 +1,113 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_spp.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Signature Path Prefetcher (Kim et al., MICRO 2016) with the
+ *                Perceptron-based Prefetch Filter (Bhatia et al., ISCA 2019)
+ ***************************************************************************************/
+#ifndef __PREF_SPP_H__
+#define __PREF_SPP_H__
+
+#include "pref_common.h"
+
+#define SPP_SIG_BITS 12
+#define SPP_SIG_SHIFT 3
+#define SPP_SIG_MASK ((1 << SPP_SIG_BITS) - 1)
+#define SPP_ST_WAYS 8     // one signature table set per cache line
+#define SPP_PT_DELTAS 4   // deltas tracked per signature
+#define SPP_CTR_MAX 15    // 4-bit pattern table counters
+#define SPP_GHR_N 8       // global history register (page crossings)
+#define SPP_PPF_FEATURES 5
+#define SPP_PPF_WEIGHT_MAX 15
+#define SPP_PPF_WEIGHT_MIN -16
+#define SPP_DEGFB_LEVELS 5
+
+/* Signature table: last offset and signature of recently touched pages */
+typedef struct SPP_ST_Entry_Struct {
+  uns32 page_tag;
+  uns16 sig;
+  uns8  last_offset;
+  uns8  age : 7;  // 0 == MRU
+  uns8  valid : 1;
+} SPP_ST_Entry;
+
+/* Pattern table: deltas seen after a signature, with confidence counters */
+typedef struct SPP_PT_Entry_Struct {
+  int8 delta[SPP_PT_DELTAS];
+  uns8 c_delta[SPP_PT_DELTAS];
+  uns8 c_sig;
+  uns8 pad[7];
+} SPP_PT_Entry;
+
+/* Lookahead paths that left the page, used to start signatures in new pages */
+typedef struct SPP_GHR_Entry_Struct {
+  Flag  valid;
+  uns16 sig;
+  uns8  conf;
+  uns8  last_offset;
+  int8  delta;
+} SPP_GHR_Entry;
+
+/* Perceptron filter bookkeeping for issued and rejected candidates */
+typedef struct SPP_PPF_Entry_Struct {
+  uns32 line_tag;
+  uns16 feature[SPP_PPF_FEATURES];
+  uns8  valid;
+  uns8  useful;
+} SPP_PPF_Entry;
+
+typedef struct Pref_SPP_Struct {
+  HWP_Info* hwp_info;
+
+  SPP_ST_Entry* st;
+  SPP_PT_Entry* pt;
+  SPP_GHR_Entry ghr[SPP_GHR_N];
+
+  int8*          ppf_weights;  // SPP_PPF_FEATURES tables of PREF_SPP_PPF_N
+  SPP_PPF_Entry* ppf_issued;
+  SPP_PPF_Entry* ppf_rejected;
+
+  uns max_depth;
+  uns depth_vals[SPP_DEGFB_LEVELS];
+} Pref_SPP;
+
+/*************************************************************/
+/* HWP Interface */
+void set_pref_spp(Pref_SPP* new_spp);
+void pref_spp_init(HWP* hwp);
+void pref_spp_umlc_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                        uns32 global_hist);
+void pref_spp_umlc_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist);
+void pref_spp_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist);
+void pref_spp_ul1_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                      uns32 global_hist);
+void pref_spp_train(uns8 proc_id, Addr lineAddr, Addr loadPC);
+
+/*************************************************************/
+/* Misc functions */
+void pref_spp_throttle_fb(uns8 proc_id);
+
+#endif /*  __PREF_SPP_H__*/
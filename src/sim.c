@@ -27,6 +27,7 @@
  ***************************************************************************************/
 
 #include <fcntl.h>
+#include <math.h>
 #include <signal.h>
 #include <stdio.h>
 #include <time.h>
@@ -51,6 +52,10 @@
 #include "debug/pipeview.h"
 #include "dumb_model.h"
 #include "frontend/pin_trace_fe.h"
+#include "host_prof.h"
+#include "interval_model.h"
+#include "libs/malloc_lib.h"
+#include "live_stats.h"
 #include "model.h"
 #include "optimizer2.h"
 #include "power/power_intf.h"
@@ -61,6 +66,7 @@
 #include "core.param.h"
 #include "debug/debug.param.h"
 #include "general.param.h"
+#include "memory/memory.param.h"
 
 #include "ramulator.h"
 
@@ -125,9 +131,9 @@ static void reset_uop_mode_counters(void);
 
 static inline void    check_heartbeat(uns8 proc_id, Flag final);
 static inline Counter check_forward_progress(uns8 proc_id);
-static inline double  sim_progress(void);
 static inline void    set_last_sim_param(uns8 proc_id);
 static inline void    print_bogus_sim_param(uns8 proc_id);
+static void           init_bogus_sim(uns8 proc_id);
 
 /**************************************************************************************/
 /* handle_SIGINT: this handler is for exiting smoothly when a SIGINT is caught
@@ -266,12 +272,16 @@ static inline Counter check_forward_progress(uns8 proc_id) {
        (Counter)FORWARD_PROGRESS_LIMIT)) {
     uns8 proc_id2;
     for(proc_id2 = 0; proc_id2 < NUM_CORES; proc_id2++) {
-      if(!sim_done[proc_id2])
-        dump_stats(proc_id2, TRUE, global_stat_array[proc_id2],
-                   NUM_GLOBAL_STATS);
+      if(!sim_done[proc_id2]) {
+        update_arena_stats(proc_id2);
+        dump_stats(proc_id2, TRUE, 0, NUM_GLOBAL_STATS);
+      }
     }
 
-    if(cmp_model.node_stage[proc_id].node_head) {
+    if(SIM_MODEL != CMP_MODEL) {
+      printf("What prevents proceeding? (no node stage in the %s model)\n",
+             model->name);
+    } else if(cmp_model.node_stage[proc_id].node_head) {
       printf("What op prevents proceeding? unique: %llu, valid: %u, va: %llx, "
              "opstate: %u, op_type: %u, mem_type: %u, req: %p proc: %u, addr: "
              "%llu, state: %u\n",
@@ -307,10 +317,10 @@ static inline Counter check_forward_progress(uns8 proc_id) {
 }
 
 /**************************************************************************************/
-/* sim_progress: */
+/* sim_progress: fraction of the simulation done */
 
-static inline double sim_progress(void) {
-  double sim_limit_progress = SIM_MODE == FULL_SIM_MODE ?
+double sim_progress(void) {
+  double sim_limit_progress = SIM_MODE == FULL_SIM_MODE && sim_limit ?
                                 trigger_progress(sim_limit) :
                                 0.0;
 
@@ -514,6 +524,16 @@ static inline void print_bogus_sim_param(uns8 proc_id) {
           cycle_count - sim_done_last_cycle_count[proc_id], ipc);
 }
 
+/**************************************************************************************/
+/* init_bogus_sim: restart the trace of a finished core in the current model */
+
+static void init_bogus_sim(uns8 proc_id) {
+  if(SIM_MODEL == INTERVAL_MODEL)
+    interval_init_bogus_sim(proc_id);
+  else
+    cmp_init_bogus_sim(proc_id);
+}
+
 /**************************************************************************************/
 /* uop_sim: This is the main loop for running in uop level simulation mode.*/
 
@@ -570,8 +590,8 @@ void uop_sim() {
                 if(retired_exit[proc_id] ||
                    (INST_LIMIT && inst_count[proc_id] == inst_limit[proc_id])) {
                   sim_done[proc_id] = TRUE;
-                  dump_stats(proc_id, TRUE, global_stat_array[proc_id],
-                             NUM_GLOBAL_STATS);
+                  update_arena_stats(proc_id);
+                  dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
                   check_heartbeat(proc_id, TRUE);
                 } else {
                   uop_sim_done = FALSE;
@@ -605,9 +625,246 @@ void uop_sim() {
         ASSERT(0, operating_mode == SIMULATION_MODE);
         break;
     }
+    live_stats_cycle();
   }
 }
 
+/**************************************************************************************/
+/* Sampled simulation: state and helpers of sampling_sim */
+
+/* Metrics estimated from the measured units: CPI, and the per 1000
+   instruction rates of a few key stats */
+typedef struct Sample_Metric_struct {
+  const char* name;
+  Stat_Enum   stat; /* NUM_GLOBAL_STATS for CPI */
+  Counter     start;
+  double      sum;
+  double      sum_sq;
+} Sample_Metric;
+
+static Sample_Metric sample_metrics[] = {
+  {"CPI", NUM_GLOBAL_STATS},
+  {"BP_ON_PATH_MISPREDICT_PKI", BP_ON_PATH_MISPREDICT},
+  {"ICACHE_MISS_PKI", ICACHE_MISS},
+  {"DCACHE_MISS_PKI", DCACHE_MISS},
+  {"L1_MISS_PKI", L1_MISS},
+};
+
+/* sample_z: two-sided normal quantile for a confidence level */
+static double sample_z(double confidence) {
+  double lo = 0.0;
+  double hi = 10.0;
+  for(uns ii = 0; ii < 64; ii++) {
+    double mid = (lo + hi) / 2;
+    if(erf(mid / M_SQRT2) < confidence)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/* sample_estimate: mean of a metric over num_units units and the half width
+   of its confidence interval */
+static double sample_estimate(Sample_Metric* metric, uns num_units, double z,
+                              double* half_width) {
+  double mean     = metric->sum / num_units;
+  double variance = num_units > 1 ?
+                      (metric->sum_sq - metric->sum * mean) / (num_units - 1) :
+                      0.0;
+  *half_width     = z * sqrt(MAX2(variance, 0.0) / num_units);
+  return mean;
+}
+
+/* sample_warm: functionally warm core 0 (through the model's warmup
+   function) until it has executed target instructions. Returns FALSE if the
+   program ended first. */
+static Flag sample_warm(Counter target) {
+  Op         op;
+  Table_Info table_info;
+  Inst_Info  inst_info;
+  op.table_info = &table_info;
+  op.inst_info  = &inst_info;
+  op.mbp7_info  = NULL;
+
+  while(inst_count[0] < target) {
+    do {
+      frontend_fetch_op(0, &op);
+      if(op.table_info->mem_type != NOT_MEM && op.oracle_info.va == 0) {
+        FATAL_ERROR(0, "Access to 0x0\n");
+      }
+      model->warmup_func(&op);
+      if(op.eom) {
+        inst_count[0]++;
+        frontend_retire(op.proc_id, op.inst_uid);
+      }
+      if(op.exit) {
+        retired_exit[0] = TRUE;
+        return FALSE;
+      }
+    } while(!op.eom);
+
+    // HACK that ensures that cache replacement works in warmup
+    do {
+      freq_advance_time();
+    } while(!freq_is_ready(FREQ_DOMAIN_L1));
+    sim_time = freq_time();
+    check_heartbeat(0, FALSE);
+    live_stats_cycle();
+  }
+  return TRUE;
+}
+
+/* sample_cycle: simulate one cycle of the machine in detail */
+static void sample_cycle(void) {
+  freq_advance_time();
+  sim_time = freq_time();
+  model->cycle_func();
+  cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  check_heartbeat(0, FALSE);
+  live_stats_cycle();
+  if(cycle_count % FORWARD_PROGRESS_INTERVAL == 0)
+    check_forward_progress(0);
+}
+
+/* sample_detail: simulate core 0 in detail until it has retired target
+   instructions. Returns FALSE if the program ended first. */
+static Flag sample_detail(Counter target) {
+  while(inst_count[0] < target) {
+    if(retired_exit[0])
+      return FALSE;
+    sample_cycle();
+  }
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* sampling_sim: SMARTS-style sampled simulation of core 0. Each period of
+   SAMPLE_PERIOD instructions is functionally warmed except for its last
+   SAMPLE_WARMUP + SAMPLE_UNIT instructions, which are simulated in detail;
+   only the last SAMPLE_UNIT of them are measured. After each unit, fetch is
+   held and the pipeline drained so that functional warming can take over from
+   the frontend. Reports the estimates with their confidence intervals. */
+
+void sampling_sim() {
+  ASSERTM(0, NUM_CORES == 1,
+          "Sampled simulation works only for single core\n");
+  ASSERTM(0, SIM_MODEL == CMP_MODEL,
+          "Sampled simulation needs the cmp model\n");
+  ASSERTM(0, SAMPLE_UNIT > 0 && SAMPLE_PERIOD >= SAMPLE_WARMUP + SAMPLE_UNIT,
+          "sample_period must cover sample_warmup + sample_unit\n");
+
+  Counter limit        = INST_LIMIT ? inst_limit[0] : MAX_CTR;
+  double  z            = sample_z(SAMPLE_CONFIDENCE);
+  uns     num_units    = 0;
+  Counter num_detailed = 0;
+  FILE*   file         = file_tag_fopen(OUTPUT_DIR, SAMPLE_FILE, "w");
+  ASSERTM(0, file, "Could not open the sample file %s\n", SAMPLE_FILE);
+  fprintf(file, "# period %llu  unit %llu  warmup %llu  confidence %.4f\n",
+          SAMPLE_PERIOD, SAMPLE_UNIT, SAMPLE_WARMUP, SAMPLE_CONFIDENCE);
+  fprintf(file, "# unit start_inst insts cycles\n");
+
+  /* perform initialization: the pipeline starts drained with fetch held */
+  init_model(WARMUP_MODE);  // make sure this happens before init_op_pool
+  operating_mode = SIMULATION_MODE;
+  init_model(operating_mode);
+  init_op_pool();
+  unique_count = 1;
+  cmp_hold_fetch(0, TRUE);
+
+  for(Counter period_start = 0;; period_start += SAMPLE_PERIOD) {
+    Counter unit_start = period_start + SAMPLE_PERIOD - SAMPLE_UNIT;
+    Counter warm_end   = unit_start - SAMPLE_WARMUP;
+    if(unit_start + SAMPLE_UNIT > limit)
+      break;
+
+    /* functional warming */
+    if(!sample_warm(warm_end))
+      break;
+
+    /* detailed warm-up */
+    cycle_count              = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+    last_forward_progress[0] = cycle_count;
+    cmp_resync_fetch(0);
+    Counter detail_start = inst_count[0];
+    if(!sample_detail(unit_start))
+      break;
+
+    /* measured unit */
+    Counter start_inst  = inst_count[0];
+    Counter start_cycle = cycle_count;
+    for(uns ii = 1; ii < NUM_ELEMENTS(sample_metrics); ii++)
+      sample_metrics[ii].start = GET_STAT_EVENT(0, sample_metrics[ii].stat);
+    if(!sample_detail(start_inst + SAMPLE_UNIT))
+      break;
+
+    Counter insts  = inst_count[0] - start_inst;
+    Counter cycles = cycle_count - start_cycle;
+    fprintf(file, "%u %llu %llu %llu\n", num_units, start_inst, insts, cycles);
+    for(uns ii = 0; ii < NUM_ELEMENTS(sample_metrics); ii++) {
+      Sample_Metric* metric = &sample_metrics[ii];
+      double         value;
+      if(metric->stat == NUM_GLOBAL_STATS)
+        value = (double)cycles / insts;
+      else
+        value = 1000.0 * (GET_STAT_EVENT(0, metric->stat) - metric->start) /
+                insts;
+      metric->sum += value;
+      metric->sum_sq += value * value;
+    }
+    num_units++;
+
+    /* drain the pipeline before going back to functional warming */
+    cmp_hold_fetch(0, TRUE);
+    while(!cmp_drained(0) && !retired_exit[0])
+      sample_cycle();
+    num_detailed += inst_count[0] - detail_start;
+    if(retired_exit[0] || inst_count[0] >= limit)
+      break;
+
+    double half_width;
+    double cpi = sample_estimate(&sample_metrics[0], num_units, z, &half_width);
+    if(SAMPLE_TARGET_ERROR > 0 && num_units >= SAMPLE_MIN_UNITS &&
+       half_width <= SAMPLE_TARGET_ERROR * cpi)
+      break;
+  }
+
+  /* report the estimates */
+  fprintf(file, "# %u units, %llu of %llu instructions in detail\n", num_units,
+          num_detailed, inst_count[0]);
+  fprintf(file, "# metric mean half_width rel_error\n");
+  fprintf(mystdout, "Sampled %u units (%.1f%% confidence):\n", num_units,
+          100.0 * SAMPLE_CONFIDENCE);
+  if(num_units) {
+    double half_width;
+    double cpi = sample_estimate(&sample_metrics[0], num_units, z, &half_width);
+    fprintf(file, "IPC %.4f %.4f %.2f%%\n", 1 / cpi,
+            half_width / (cpi * cpi), 100.0 * half_width / cpi);
+    fprintf(mystdout, "  %-28s %10.4f +- %.2f%%\n", "IPC", 1 / cpi,
+            100.0 * half_width / cpi);
+    for(uns ii = 0; ii < NUM_ELEMENTS(sample_metrics); ii++) {
+      double mean  = sample_estimate(&sample_metrics[ii], num_units, z,
+                                     &half_width);
+      double error = mean > 0 ? 100.0 * half_width / mean : 0.0;
+      fprintf(file, "%s %.4f %.4f %.2f%%\n", sample_metrics[ii].name, mean,
+              half_width, error);
+      fprintf(mystdout, "  %-28s %10.4f +- %.2f%%\n", sample_metrics[ii].name,
+              mean, error);
+    }
+  }
+  fclose(file);
+
+  if(model->done_func)
+    model->done_func();
+  frontend_done(retired_exit);
+  ramulator_finish();
+
+  update_arena_stats(0);
+  dump_stats(0, TRUE, 0, NUM_GLOBAL_STATS);
+  check_heartbeat(0, TRUE);
+}
+
+
 /**************************************************************************************/
 /* full_sim: This is the main loop for running in full simulation mode.*/
 
@@ -650,6 +907,7 @@ void full_sim() {
 
   sim_limit   = trigger_create("SIM_LIMIT", SIM_LIMIT, TRIGGER_ONCE);
   clear_stats = trigger_create("CLEAR_STATS", CLEAR_STATS, TRIGGER_ONCE);
+  host_prof_init();
 
   /* main loop */
   while(!trigger_fired(sim_limit)) {
@@ -675,6 +933,8 @@ void full_sim() {
     check_heartbeat(0, FALSE);
 
     stat_trace_cycle();
+    host_prof_cycle();
+    live_stats_cycle();
     if(trigger_fired(clear_stats)) {
       reset_stats(TRUE);
     }
@@ -689,7 +949,8 @@ void full_sim() {
       if(!sim_done[proc_id] && (retired_exit[proc_id] || reachedInstLimit)) {
         if(model->per_core_done_func)
           model->per_core_done_func(proc_id);
-        dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+        update_arena_stats(proc_id);
+        dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
         sim_done[proc_id] = TRUE;
         any_sim_done      = TRUE;
         check_heartbeat(proc_id, TRUE);
@@ -698,7 +959,7 @@ void full_sim() {
           set_last_sim_param(proc_id);
           // rerun the corresponding benchmark again.
           // (reset retired_exit and reached_exit)
-          cmp_init_bogus_sim(proc_id);
+          init_bogus_sim(proc_id);
         }
       } else if(sim_done[proc_id] && retired_exit[proc_id]) {
         ASSERTM(
@@ -708,7 +969,7 @@ void full_sim() {
         if(FRONTEND == FE_TRACE) {
           print_bogus_sim_param(proc_id);
           set_last_sim_param(proc_id);
-          cmp_init_bogus_sim(proc_id);
+          init_bogus_sim(proc_id);
         }
       }
 
@@ -729,6 +990,7 @@ void full_sim() {
     model_table[DUMB_MODEL].done_func();
 
   stat_trace_done();
+  host_prof_done();
   if(PIPEVIEW)
     pipeview_done();
   memview_done();
@@ -738,13 +1000,78 @@ void full_sim() {
 
   for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     if(!sim_done[proc_id]) {
-      dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+      update_arena_stats(proc_id);
+      dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
       check_heartbeat(proc_id, TRUE);
     }
   }
 
   trigger_free(sim_limit);
   trigger_free(clear_stats);
+  sim_limit = NULL;
+}
+
+
+/**************************************************************************************/
+/* cache_explore_sim: one functional pass over the whole run that only warms
+   up the branch predictor and the caches, with the cache exploration
+   monitors (memory/cache_explore.c) watching every access. Each core runs
+   until its INST_LIMIT or the end of its program, and the pass ends when all
+   cores are done. */
+
+void cache_explore_sim() {
+  Op         op;
+  Table_Info table_info;
+  Inst_Info  inst_info;
+  op.table_info = &table_info;
+  op.inst_info  = &inst_info;
+  op.mbp7_info  = NULL;
+
+  CACHE_EXPLORE = TRUE;
+  init_model(WARMUP_MODE);
+  operating_mode = WARMUP_MODE;
+  ASSERTM(0, model->warmup_func, "Model %s does not have a warmup function\n",
+          model->name);
+
+  Flag all_done = FALSE;
+  while(!all_done) {
+    all_done = TRUE;
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      if(sim_done[proc_id] || (DUMB_CORE_ON && DUMB_CORE == proc_id))
+        continue;
+      do {
+        frontend_fetch_op(proc_id, &op);
+        op_count[proc_id]++;
+        if(op.eom)
+          inst_count[proc_id]++;
+        if(op.exit)
+          retired_exit[proc_id] = TRUE;
+        model->warmup_func(&op);
+        if(op.eom)
+          frontend_retire(op.proc_id, op.inst_uid);
+      } while(!op.eom && !op.exit);
+
+      if(retired_exit[proc_id] ||
+         (INST_LIMIT && inst_count[proc_id] == inst_limit[proc_id])) {
+        sim_done[proc_id] = TRUE;
+        check_heartbeat(proc_id, TRUE);
+      } else {
+        all_done = FALSE;
+      }
+    }
+    // same as uop_sim, so that cache replacement works
+    do {
+      freq_advance_time();
+    } while(!freq_is_ready(FREQ_DOMAIN_L1));
+    sim_time = freq_time();
+    live_stats_cycle();
+  }
+
+  frontend_done(retired_exit);
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    update_arena_stats(proc_id);
+    dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
+  }
 }
 
 
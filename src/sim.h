@@ -32,7 +32,15 @@
 /**************************************************************************************/
 /* Types */
 
-enum sim_mode_enum { UOP_SIM_MODE, FULL_SIM_MODE, NUM_SIM_MODES };
+enum sim_mode_enum {
+  UOP_SIM_MODE,
+  FULL_SIM_MODE,
+  BP_SIM_MODE,
+  CACHE_SIM_MODE,
+  SIMPOINT_SIM_MODE,
+  SAMPLE_SIM_MODE,
+  NUM_SIM_MODES
+};
 
 enum operating_mode_enum {
   SIMULATION_MODE,
@@ -56,6 +64,8 @@ void uop_sim(void);
 void monitor_sim(void);
 void sampling_sim(void);
 void full_sim(void);
+void cache_explore_sim(void);
+double sim_progress(void);
 void handle_SIGINT(int);
 void close_output_streams(void);
 
@@ -0,0 +1,573 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : simpoint.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : SimPoint mode (--mode simpoint).
+ *
+ * One functional pass over the frontend of core 0 collects a basic block
+ * vector (BBV) for every interval of SIMPOINT_INTERVAL instructions: the
+ * instructions executed in each basic block, keyed by the address the block
+ * starts at. Each BBV is normalized and randomly projected down to
+ * SIMPOINT_DIMS dimensions as soon as its interval ends, so only the small
+ * projected vectors are kept around.
+ *
+ * The vectors are clustered with k-means for every k up to SIMPOINT_MAX_K,
+ * with SIMPOINT_SEEDS random starts each, spread over SIMPOINT_THREADS
+ * threads. As in SimPoint, the smallest k whose Bayesian information
+ * criterion (BIC) score reaches SIMPOINT_BIC_THRESHOLD of the range of scores
+ * wins, and each of its clusters is represented by the interval closest to
+ * the cluster center, weighted by the share of instructions in the cluster.
+ *
+ * The choice is written to <SIMPOINT_FILE>.simpoints.out and .weights.out in
+ * the format of the SimPoint tool, and to <SIMPOINT_FILE>.regions.out, one
+ * line per representative interval with its first instruction, length and
+ * weight (this is what bin/scarab_simpoint.py simulates).
+ ***************************************************************************************/
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "frontend/frontend.h"
+#include "libs/hash_lib.h"
+#include "live_stats.h"
+#include "op.h"
+#include "sim.h"
+#include "simpoint.h"
+
+#include "core.param.h"
+#include "general.param.h"
+
+/**************************************************************************************/
+/* Types */
+
+/* one k-means clustering (a k and a random start) */
+typedef struct Simpoint_Run_struct {
+  uns     k;
+  uns     seed;
+  double  distortion; /* weighted squared distance of the points to their
+                         centers */
+  double* centers;    /* k centers of SIMPOINT_DIMS coordinates */
+} Simpoint_Run;
+
+typedef struct Simpoint_Region_struct {
+  uns    cluster;
+  uns    interval;
+  double weight;
+} Simpoint_Region;
+
+/**************************************************************************************/
+/* Global Variables */
+
+/* basic blocks seen so far and the instructions each executed in the current
+   interval */
+static Hash_Table blocks;
+static uns        num_blocks;
+static uns        blocks_size;
+static Counter*   block_insts;
+static uns*       touched;
+static uns        num_touched;
+
+/* one point (projected BBV) per interval */
+static double*  points;
+static Counter* starts;  /* first instruction of the interval */
+static Counter* lengths; /* instructions in the interval */
+static double*  weights; /* weight of the point in k-means */
+static uns      num_points;
+static uns      points_size;
+
+static Simpoint_Run* runs;
+static uns           num_runs;
+static uns           next_run; /* next run for a worker thread to take */
+
+static FILE* bbv_file;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void   collect(void);
+static void   count_block(Addr addr, Counter insts);
+static void   end_interval(Counter start, Counter insts);
+static double projection(uns block, uns dim);
+static void   cluster(void);
+static void*  cluster_worker(void* arg);
+static void   kmeans(Simpoint_Run* run, uns* assign);
+static uns    nearest_center(double const* point, double const* centers, uns k,
+                             double* dist);
+static double bic(Simpoint_Run* run, uns* assign);
+static void   write_results(Simpoint_Run* run);
+static int    cmp_region_start(const void*, const void*);
+static uns64  next_rand(uns64* state);
+
+/**************************************************************************************/
+/* simpoint_sim: */
+
+void simpoint_sim(void) {
+  ASSERTM(0, NUM_CORES == 1, "SimPoint mode supports a single core\n");
+  ASSERTM(0, SIMPOINT_INTERVAL > 0 && SIMPOINT_DIMS > 0 && SIMPOINT_MAX_K > 0 &&
+               SIMPOINT_SEEDS > 0,
+          "SimPoint intervals, dimensions, k and seeds must be positive\n");
+  /* the profile only follows the correct path, the frontend is never
+     redirected, so it need not keep the history for wrong path fetch */
+  FETCH_OFF_PATH_OPS = FALSE;
+
+  init_hash_table(&blocks, "simpoint_blocks", 4096, sizeof(uns));
+  if(SIMPOINT_DUMP_BBV) {
+    char name[MAX_STR_LENGTH + 1];
+    snprintf(name, MAX_STR_LENGTH, "%s.bb", SIMPOINT_FILE);
+    bbv_file = file_tag_fopen(OUTPUT_DIR, name, "w");
+    ASSERTM(0, bbv_file, "Could not open %s\n", name);
+  }
+
+  collect();
+  frontend_done(retired_exit);
+  if(bbv_file)
+    fclose(bbv_file);
+
+  ASSERTM(0, num_points > 0, "No instructions to profile\n");
+  fprintf(mystdout,
+          "SimPoint profile: %s instructions, %u intervals, %u basic blocks\n",
+          unsstr64(inst_count[0]), num_points, num_blocks);
+  cluster();
+}
+
+/**************************************************************************************/
+/* collect: functional pass over the frontend that builds the BBVs */
+
+static void collect(void) {
+  Op         op;
+  Table_Info table_info;
+  Inst_Info  inst_info;
+  Counter    limit          = INST_LIMIT ? inst_limit[0] : 0;
+  Counter    interval_start = 0;
+  Addr       block_addr     = 0;
+  Counter    block_len      = 0; /* instructions so far in the block */
+  Flag       block_open     = FALSE;
+  Flag       block_end      = FALSE;
+
+  op.table_info = &table_info;
+  op.inst_info  = &inst_info;
+  op.mbp7_info  = NULL;
+
+  while(!retired_exit[0] && (!limit || inst_count[0] < limit)) {
+    frontend_fetch_op(0, &op);
+    op_count[0]++;
+
+    if(!block_open) {
+      block_addr = op.inst_info->addr;
+      block_open = TRUE;
+    }
+    if(op.table_info->cf_type)
+      block_end = TRUE;
+    if(op.exit)
+      retired_exit[0] = TRUE;
+    if(!op.eom)
+      continue;
+
+    inst_count[0]++;
+    block_len++;
+    frontend_retire(0, op.inst_uid);
+    live_stats_cycle();
+
+    /* a block still running at the end of an interval is split */
+    Flag interval_end = inst_count[0] - interval_start == SIMPOINT_INTERVAL;
+    if(block_end || interval_end) {
+      count_block(block_addr, block_len);
+      block_len  = 0;
+      block_open = FALSE;
+      block_end  = FALSE;
+    }
+    if(interval_end) {
+      end_interval(interval_start, SIMPOINT_INTERVAL);
+      interval_start = inst_count[0];
+    }
+  }
+
+  if(block_len)
+    count_block(block_addr, block_len);
+  if(inst_count[0] > interval_start)
+    end_interval(interval_start, inst_count[0] - interval_start);
+}
+
+/**************************************************************************************/
+/* count_block: */
+
+static void count_block(Addr addr, Counter insts) {
+  Flag new_entry;
+  uns* idx = (uns*)hash_table_access_create(&blocks, addr, &new_entry);
+
+  if(new_entry) {
+    if(num_blocks == blocks_size) {
+      blocks_size = blocks_size ? 2 * blocks_size : 4096;
+      block_insts = realloc(block_insts, blocks_size * sizeof(Counter));
+      touched     = realloc(touched, blocks_size * sizeof(uns));
+      ASSERT(0, block_insts && touched);
+      memset(block_insts + num_blocks, 0,
+             (blocks_size - num_blocks) * sizeof(Counter));
+    }
+    *idx = num_blocks++;
+  }
+
+  if(!block_insts[*idx])
+    touched[num_touched++] = *idx;
+  block_insts[*idx] += insts;
+}
+
+/**************************************************************************************/
+/* end_interval: project the interval's BBV into a new point */
+
+static void end_interval(Counter start, Counter insts) {
+  if(num_points == points_size) {
+    points_size = points_size ? 2 * points_size : 1024;
+    points  = realloc(points, points_size * SIMPOINT_DIMS * sizeof(double));
+    starts  = realloc(starts, points_size * sizeof(Counter));
+    lengths = realloc(lengths, points_size * sizeof(Counter));
+    ASSERT(0, points && starts && lengths);
+  }
+
+  double* point = &points[num_points * SIMPOINT_DIMS];
+  Counter total = 0;
+  memset(point, 0, SIMPOINT_DIMS * sizeof(double));
+  for(uns ii = 0; ii < num_touched; ii++)
+    total += block_insts[touched[ii]];
+
+  if(bbv_file)
+    fprintf(bbv_file, "T");
+  for(uns ii = 0; ii < num_touched; ii++) {
+    uns    block = touched[ii];
+    double frac  = (double)block_insts[block] / total;
+    for(uns dim = 0; dim < SIMPOINT_DIMS; dim++)
+      point[dim] += frac * projection(block, dim);
+    if(bbv_file)
+      fprintf(bbv_file, ":%u:%llu ", block + 1, block_insts[block]);
+    block_insts[block] = 0;
+  }
+  if(bbv_file)
+    fprintf(bbv_file, "\n");
+  num_touched = 0;
+
+  starts[num_points]  = start;
+  lengths[num_points] = insts;
+  num_points++;
+}
+
+/**************************************************************************************/
+/* projection: entry of the random projection matrix, uniform in [-1, 1) and
+   computed on the fly so that the matrix is never stored */
+
+static double projection(uns block, uns dim) {
+  uns64 state = (uns64)block * SIMPOINT_DIMS + dim;
+  return (double)(next_rand(&state) >> 11) / (double)(1ULL << 52) - 1.0;
+}
+
+/**************************************************************************************/
+/* cluster: run k-means for every k and seed, pick k by BIC */
+
+static void cluster(void) {
+  uns       max_k    = MIN2(SIMPOINT_MAX_K, num_points);
+  uns       threads  = MAX2(SIMPOINT_THREADS, 1);
+  uns*      assign   = malloc(num_points * sizeof(uns));
+  double*   scores   = malloc((max_k + 1) * sizeof(double));
+  uns*      best     = malloc((max_k + 1) * sizeof(uns));
+  pthread_t workers[threads];
+
+  /* k-means weighs the points by their instructions, scaled so that the
+     average weight is one (BIC counts points) */
+  weights = malloc(num_points * sizeof(double));
+  for(uns ii = 0; ii < num_points; ii++)
+    weights[ii] = (double)lengths[ii] * num_points / inst_count[0];
+
+  num_runs = max_k * SIMPOINT_SEEDS;
+  runs     = calloc(num_runs, sizeof(Simpoint_Run));
+  for(uns ii = 0; ii < num_runs; ii++) {
+    runs[ii].k       = ii / SIMPOINT_SEEDS + 1;
+    runs[ii].seed    = ii % SIMPOINT_SEEDS;
+    runs[ii].centers = malloc(runs[ii].k * SIMPOINT_DIMS * sizeof(double));
+  }
+
+  next_run = 0;
+  for(uns ii = 0; ii < threads; ii++) {
+    int err = pthread_create(&workers[ii], NULL, cluster_worker, NULL);
+    ASSERTM(0, !err, "Could not start a clustering thread\n");
+  }
+  for(uns ii = 0; ii < threads; ii++)
+    pthread_join(workers[ii], NULL);
+
+  /* best start of each k, and the range of their scores */
+  double min_score = INFINITY, max_score = -INFINITY;
+  for(uns k = 1; k <= max_k; k++) {
+    best[k] = (k - 1) * SIMPOINT_SEEDS;
+    for(uns ii = best[k] + 1; ii < k * SIMPOINT_SEEDS; ii++)
+      if(runs[ii].distortion < runs[best[k]].distortion)
+        best[k] = ii;
+    scores[k] = bic(&runs[best[k]], assign);
+    min_score = MIN2(min_score, scores[k]);
+    max_score = MAX2(max_score, scores[k]);
+  }
+
+  double threshold = min_score +
+                     SIMPOINT_BIC_THRESHOLD * (max_score - min_score);
+  uns    k         = 1;
+  while(k < max_k && scores[k] < threshold)
+    k++;
+  fprintf(mystdout,
+          "SimPoint clustering: k %u of %u (BIC %.1f in [%.1f, %.1f])\n", k,
+          max_k, scores[k], min_score, max_score);
+  write_results(&runs[best[k]]);
+
+  for(uns ii = 0; ii < num_runs; ii++)
+    free(runs[ii].centers);
+  free(runs);
+  free(best);
+  free(scores);
+  free(assign);
+  free(weights);
+}
+
+/**************************************************************************************/
+/* cluster_worker: takes runs until all are done */
+
+static void* cluster_worker(void* arg) {
+  uns* assign = malloc(num_points * sizeof(uns));
+  uns  idx;
+  while((idx = __atomic_fetch_add(&next_run, 1, __ATOMIC_RELAXED)) <
+        num_runs)
+    kmeans(&runs[idx], assign);
+  free(assign);
+  return NULL;
+}
+
+/**************************************************************************************/
+/* kmeans: Lloyd's algorithm from k distinct random points */
+
+static void kmeans(Simpoint_Run* run, uns* assign) {
+  uns     dims   = SIMPOINT_DIMS;
+  uns64   state  = ((uns64)run->k << 32) + run->seed + 1;
+  uns*    order  = malloc(num_points * sizeof(uns));
+  double* sums   = malloc(run->k * dims * sizeof(double));
+  double* totals = malloc(run->k * sizeof(double));
+  Flag    moved  = TRUE;
+
+  /* partial Fisher-Yates shuffle for the initial centers */
+  for(uns ii = 0; ii < num_points; ii++)
+    order[ii] = ii;
+  for(uns ii = 0; ii < run->k; ii++) {
+    uns jj    = ii + next_rand(&state) % (num_points - ii);
+    uns tmp   = order[ii];
+    order[ii] = order[jj];
+    order[jj] = tmp;
+    memcpy(&run->centers[ii * dims], &points[order[ii] * dims],
+           dims * sizeof(double));
+  }
+  for(uns ii = 0; ii < num_points; ii++)
+    assign[ii] = run->k;
+
+  for(uns iter = 0; iter < SIMPOINT_ITERS && moved; iter++) {
+    moved = FALSE;
+    for(uns ii = 0; ii < num_points; ii++) {
+      uns center = nearest_center(&points[ii * dims], run->centers, run->k,
+                                  NULL);
+      moved |= center != assign[ii];
+      assign[ii] = center;
+    }
+
+    memset(sums, 0, run->k * dims * sizeof(double));
+    memset(totals, 0, run->k * sizeof(double));
+    for(uns ii = 0; ii < num_points; ii++) {
+      for(uns dim = 0; dim < dims; dim++)
+        sums[assign[ii] * dims + dim] += weights[ii] * points[ii * dims + dim];
+      totals[assign[ii]] += weights[ii];
+    }
+    for(uns center = 0; center < run->k; center++) {
+      if(!totals[center])
+        continue; /* an empty cluster keeps its center */
+      for(uns dim = 0; dim < dims; dim++)
+        run->centers[center * dims + dim] = sums[center * dims + dim] /
+                                            totals[center];
+    }
+  }
+
+  run->distortion = 0;
+  for(uns ii = 0; ii < num_points; ii++) {
+    double dist;
+    nearest_center(&points[ii * dims], run->centers, run->k, &dist);
+    run->distortion += weights[ii] * dist;
+  }
+
+  free(totals);
+  free(sums);
+  free(order);
+}
+
+/**************************************************************************************/
+/* nearest_center: returns the closest center (and its squared distance) */
+
+static uns nearest_center(double const* point, double const* centers, uns k,
+                          double* dist) {
+  uns    best      = 0;
+  double best_dist = INFINITY;
+  for(uns center = 0; center < k; center++) {
+    double sum = 0;
+    for(uns dim = 0; dim < SIMPOINT_DIMS; dim++) {
+      double diff = point[dim] - centers[center * SIMPOINT_DIMS + dim];
+      sum += diff * diff;
+    }
+    if(sum < best_dist) {
+      best      = center;
+      best_dist = sum;
+    }
+  }
+  if(dist)
+    *dist = best_dist;
+  return best;
+}
+
+/**************************************************************************************/
+/* bic: BIC score of a clustering under the spherical Gaussian model of
+   X-means (Pelleg and Moore), which is what SimPoint uses */
+
+static double bic(Simpoint_Run* run, uns* assign) {
+  uns     k      = run->k;
+  uns     dims   = SIMPOINT_DIMS;
+  double  count  = num_points;
+  double* sizes  = calloc(k, sizeof(double));
+  double  score  = 0;
+  double  params = (k - 1) + (double)k * dims + 1;
+
+  for(uns ii = 0; ii < num_points; ii++) {
+    assign[ii] = nearest_center(&points[ii * dims], run->centers, k, NULL);
+    sizes[assign[ii]] += weights[ii];
+  }
+
+  double variance = count > k ? run->distortion / (count - k) : 0;
+  variance        = MAX2(variance, 1e-12);
+  for(uns center = 0; center < k; center++) {
+    double size = sizes[center];
+    if(size <= 0)
+      continue;
+    score += -size / 2 * log(2 * M_PI) - size * dims / 2 * log(variance) -
+             (size - k) / 2 + size * log(size) - size * log(count);
+  }
+
+  free(sizes);
+  return score - params / 2 * log(count);
+}
+
+/**************************************************************************************/
+/* write_results: pick the representative of each cluster and write them out */
+
+static void write_results(Simpoint_Run* run) {
+  uns              k       = run->k;
+  uns*             assign  = malloc(num_points * sizeof(uns));
+  double*          dists   = malloc(num_points * sizeof(double));
+  Simpoint_Region* regions = calloc(k, sizeof(Simpoint_Region));
+  uns              num_regions = 0;
+  char             name[MAX_STR_LENGTH + 1];
+  FILE*            file;
+
+  for(uns ii = 0; ii < num_points; ii++) {
+    assign[ii] = nearest_center(&points[ii * SIMPOINT_DIMS], run->centers, k,
+                                &dists[ii]);
+  }
+
+  /* clusters are numbered in the order of their centers; empty ones get no
+     region */
+  for(uns center = 0; center < k; center++) {
+    Simpoint_Region* region = &regions[num_regions];
+    uns              rep    = num_points;
+    Counter          insts  = 0;
+    for(uns ii = 0; ii < num_points; ii++) {
+      if(assign[ii] != center)
+        continue;
+      insts += lengths[ii];
+      if(rep == num_points || dists[ii] < dists[rep])
+        rep = ii;
+    }
+    if(rep == num_points)
+      continue;
+    region->cluster  = num_regions;
+    region->interval = rep;
+    region->weight   = (double)insts / inst_count[0];
+    num_regions++;
+  }
+
+  snprintf(name, MAX_STR_LENGTH, "%s.simpoints", SIMPOINT_FILE);
+  file = file_tag_fopen(OUTPUT_DIR, name, "w");
+  ASSERTM(0, file, "Could not open %s\n", name);
+  for(uns ii = 0; ii < num_regions; ii++)
+    fprintf(file, "%u %u\n", regions[ii].interval, regions[ii].cluster);
+  fclose(file);
+
+  snprintf(name, MAX_STR_LENGTH, "%s.weights", SIMPOINT_FILE);
+  file = file_tag_fopen(OUTPUT_DIR, name, "w");
+  ASSERTM(0, file, "Could not open %s\n", name);
+  for(uns ii = 0; ii < num_regions; ii++)
+    fprintf(file, "%.6f %u\n", regions[ii].weight, regions[ii].cluster);
+  fclose(file);
+
+  qsort(regions, num_regions, sizeof(Simpoint_Region), cmp_region_start);
+  snprintf(name, MAX_STR_LENGTH, "%s.regions", SIMPOINT_FILE);
+  file = file_tag_fopen(OUTPUT_DIR, name, "w");
+  ASSERTM(0, file, "Could not open %s\n", name);
+  fprintf(file, "# cluster start_inst num_insts weight\n");
+  for(uns ii = 0; ii < num_regions; ii++) {
+    uns interval = regions[ii].interval;
+    fprintf(file, "%u %llu %llu %.6f\n", regions[ii].cluster, starts[interval],
+            lengths[interval], regions[ii].weight);
+    fprintf(mystdout, "  region %-3u  insts %llu+%llu  weight %.4f\n",
+            regions[ii].cluster, starts[interval], lengths[interval],
+            regions[ii].weight);
+  }
+  fclose(file);
+
+  free(regions);
+  free(dists);
+  free(assign);
+}
+
+/**************************************************************************************/
+/* cmp_region_start: */
+
+static int cmp_region_start(const void* a, const void* b) {
+  uns ia = ((Simpoint_Region const*)a)->interval;
+  uns ib = ((Simpoint_Region const*)b)->interval;
+  return ia < ib ? -1 : ia > ib;
+}
+
+/**************************************************************************************/
+/* next_rand: splitmix64 */
+
+static uns64 next_rand(uns64* state) {
+  uns64 z = (*state += 0x9E3779B97F4A7C15ULL);
+  z       = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z       = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
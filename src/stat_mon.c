@@ -99,7 +99,8 @@ Counter stat_mon_get_count(Stat_Mon* mon, uns proc_id, uns stat_idx) {
   Stat* stat = &global_stat_array[proc_id][stat_idx];
   ASSERT(proc_id, stat->type != FLOAT_TYPE_STAT);
   Stat_Info* info = find_stat_info(mon, stat_idx);
-  return stat->count + stat->total_count - info->last_data[proc_id].count;
+  return GET_TOTAL_STAT_EVENT(proc_id, stat_idx) -
+         info->last_data[proc_id].count;
 }
 
 /**************************************************************************************/
@@ -111,7 +112,8 @@ double stat_mon_get_value(Stat_Mon* mon, uns proc_id, uns stat_idx) {
   Stat* stat = &global_stat_array[proc_id][stat_idx];
   ASSERT(proc_id, stat->type == FLOAT_TYPE_STAT);
   Stat_Info* info = find_stat_info(mon, stat_idx);
-  return stat->value + stat->total_value - info->last_data[proc_id].value;
+  return GET_TOTAL_STAT_VALUE(proc_id, stat_idx) -
+         info->last_data[proc_id].value;
 }
 
 /**************************************************************************************/
@@ -128,9 +130,11 @@ void stat_mon_reset(Stat_Mon* mon) {
     for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
       Stat* stat = &global_stat_array[proc_id][info->stat_idx];
       if(stat->type == FLOAT_TYPE_STAT) {
-        info->last_data[proc_id].value = stat->value + stat->total_value;
+        info->last_data[proc_id].value = GET_TOTAL_STAT_VALUE(proc_id,
+                                                              info->stat_idx);
       } else {
-        info->last_data[proc_id].count = stat->count + stat->total_count;
+        info->last_data[proc_id].count = GET_TOTAL_STAT_EVENT(proc_id,
+                                                              info->stat_idx);
       }
     }
   }
@@ -46,7 +46,7 @@ working on this (ob).
 /* Global Variables */
 
 #define DEF_STAT(name, type, ratio) \
-  {type##_TYPE_STAT, #name, {0}, {0}, ratio, __FILE__, FALSE},
+  {type##_TYPE_STAT, #name, {0}, ratio, __FILE__, FALSE},
 
 Stat global_stat_sample[] = {
 #include "stat_files.def"
@@ -54,7 +54,17 @@ Stat global_stat_sample[] = {
 
 #undef DEF_STAT
 
-Stat** global_stat_array;
+Stat**         global_stat_array;
+Stat_Counter** global_stat_counters;
+uns16          global_stat_slot[NUM_GLOBAL_STATS];
+#ifdef STAT_PROFILE
+Counter global_stat_profile[NUM_GLOBAL_STATS];
+#endif
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static void init_global_stat_slots(void);
 
 /**************************************************************************************/
 // init_global_stats_array:
@@ -72,6 +82,8 @@ void init_global_stats_array() {
       stat->file_name = last_slash + 1;
   }
 
+  init_global_stat_slots();
+
   // Make a copy of stats array for each core
   global_stat_array = (Stat**)malloc(NUM_CORES * sizeof(Stat*));
   for(ii = 0; ii < NUM_CORES; ii++) {
@@ -79,6 +91,42 @@ void init_global_stats_array() {
     memcpy(global_stat_array[ii], global_stat_sample,
            NUM_GLOBAL_STATS * sizeof(Stat));
   }
+
+  // Counters of each core start on their own cache line so that the hot
+  // stats of different cores never share one
+  global_stat_counters = (Stat_Counter**)malloc(NUM_CORES *
+                                                sizeof(Stat_Counter*));
+  for(ii = 0; ii < NUM_CORES; ii++) {
+    void* buf;
+    int   err = posix_memalign(&buf, 64, NUM_STAT_SLOTS * sizeof(Stat_Counter));
+    ASSERTM(0, !err, "Could not allocate stat counters\n");
+    memset(buf, 0, NUM_STAT_SLOTS * sizeof(Stat_Counter));
+    global_stat_counters[ii] = (Stat_Counter*)buf;
+  }
+}
+
+/**************************************************************************************/
+/* init_global_stat_slots: the slots of stat_slot() for stats only known at
+   run time, each stat must get a slot of its own */
+
+static void init_global_stat_slots(void) {
+  Flag used[NUM_STAT_SLOTS];
+  uns  ii;
+
+#define DEF_HOT_STAT(name)
+#define DEF_HOT_STAT_RANGE(first, last) \
+  ASSERTM(0, first <= last, "Empty hot stat range at %s\n", #first);
+#include "stat_hot.def"
+#undef DEF_HOT_STAT
+#undef DEF_HOT_STAT_RANGE
+
+  memset(used, 0, sizeof(used));
+  for(ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    uns slot = stat_slot(ii);
+    ASSERT(0, slot < NUM_STAT_SLOTS && !used[slot]);
+    used[slot]           = TRUE;
+    global_stat_slot[ii] = slot;
+  }
 }
 
 /**************************************************************************************/
@@ -132,7 +180,8 @@ void fprint_line(FILE* file) {
 /**************************************************************************************/
 /* dump_stats: */
 
-void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
+void dump_stats(uns8 proc_id, Flag final, Stat_Enum first_stat,
+                uns num_stats) {
   Flag in_dist = FALSE;
 
   uns64 dist_sum = 0, total_dist_sum = 0, dist_vtotal = 0,
@@ -143,21 +192,28 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
   if(!DUMP_STATS)
     return;
 
+  /* Gather the interval counters of the dumped stats in .def order, so that
+     they can be printed side by side with the totals below. */
+  Stat*         stat_array = &global_stat_array[proc_id][first_stat];
+  Stat_Counter* cur = (Stat_Counter*)malloc(num_stats * sizeof(Stat_Counter));
   for(ii = 0; ii < num_stats; ii++) {
     Stat* s = &stat_array[ii];
+    cur[ii] = STAT_COUNTER(proc_id, first_stat + ii);
 
     /* update the total counter for this interval */
     if(s->type == FLOAT_TYPE_STAT)
-      s->total_value += s->value;
+      s->total_value += cur[ii].value;
     else
-      s->total_count += s->count;
+      s->total_count += cur[ii].count;
   }
 
   const char* last_file_name = NULL;
   FILE*       file_stream    = NULL;
+  Stat*       core_stats     = global_stat_array[proc_id];
 
   for(ii = 0; ii < num_stats; ii++) {
-    Stat* s = &stat_array[ii];
+    Stat*         s = &stat_array[ii];
+    Stat_Counter* c = &cur[ii];
 
     if(!last_file_name || s->file_name != last_file_name) {
       if(last_file_name) {
@@ -197,18 +253,18 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
     switch(s->type) {
       case COUNT_TYPE_STAT:
         if(!in_dist)
-          fprintf(file_stream, "%13s %13s    %13s %13s\n", unsstr64(s->count),
+          fprintf(file_stream, "%13s %13s    %13s %13s\n", unsstr64(c->count),
                   "", unsstr64(s->total_count), "");
         else
           fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%",
-                  unsstr64(s->count), (double)s->count / dist_sum * 100,
+                  unsstr64(c->count), (double)c->count / dist_sum * 100,
                   unsstr64(s->total_count),
                   (double)s->total_count / total_dist_sum * 100);
         break;
 
       case FLOAT_TYPE_STAT:
         ASSERTM(0, !in_dist, "Distributions not supported for float stats\n");
-        fprintf(file_stream, "%13lf %13s    %13lf %13s\n", s->value, "",
+        fprintf(file_stream, "%13lf %13s    %13lf %13s\n", c->value, "",
                 s->total_value, "");
         break;
 
@@ -217,38 +273,38 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
           uns jj;
 
           in_dist           = TRUE;
-          dist_sum          = s->count;
+          dist_sum          = c->count;
           total_dist_sum    = s->total_count;
           dist_vtotal       = 0;
           total_dist_vtotal = 0;
 
           for(jj = ii + 1; stat_array[jj].type != DIST_TYPE_STAT; jj++) {
-            dist_sum += stat_array[jj].count;
+            dist_sum += cur[jj].count;
             total_dist_sum += stat_array[jj].total_count;
-            dist_vtotal += (jj - ii) * stat_array[jj].count;
+            dist_vtotal += (jj - ii) * cur[jj].count;
             total_dist_vtotal += (jj - ii) * stat_array[jj].total_count;
           }
-          dist_sum += stat_array[jj].count;
+          dist_sum += cur[jj].count;
           total_dist_sum += stat_array[jj].total_count;
-          dist_vtotal += (jj - ii) * stat_array[jj].count;
+          dist_vtotal += (jj - ii) * cur[jj].count;
           total_dist_vtotal += (jj - ii) * stat_array[jj].total_count;
 
           dist_variance = pow((0.0 - ((double)dist_vtotal / dist_sum)), 2) *
-                          stat_array[jj].count;
+                          cur[jj].count;
           total_dist_variance =
             pow((0.0 - ((double)total_dist_vtotal / total_dist_sum)), 2) *
             stat_array[jj].total_count;
           for(jj = ii + 1; stat_array[jj].type != DIST_TYPE_STAT; jj++) {
             dist_variance += pow((jj - ii - ((double)dist_vtotal / dist_sum)),
                                  2) *
-                             stat_array[jj].count;
+                             cur[jj].count;
             total_dist_variance +=
               pow((jj - ii - ((double)total_dist_vtotal / total_dist_sum)), 2) *
               stat_array[jj].total_count;
           }
           dist_variance += pow((jj - ii - ((double)dist_vtotal / dist_sum)),
                                2) *
-                           stat_array[jj].count;
+                           cur[jj].count;
           total_dist_variance +=
             pow((jj - ii - ((double)total_dist_vtotal / total_dist_sum)), 2) *
             stat_array[jj].total_count;
@@ -256,13 +312,13 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
           total_dist_variance /= total_dist_sum - 1;
 
           fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%",
-                  unsstr64(s->count), (double)s->count / dist_sum * 100,
+                  unsstr64(c->count), (double)c->count / dist_sum * 100,
                   unsstr64(s->total_count),
                   (double)s->total_count / total_dist_sum * 100);
         } else {
           in_dist = FALSE;
           fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%\n",
-                  unsstr64(s->count), (double)s->count / dist_sum * 100,
+                  unsstr64(c->count), (double)c->count / dist_sum * 100,
                   unsstr64(s->total_count),
                   (double)s->total_count / total_dist_sum * 100);
 
@@ -281,15 +337,15 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
         break;
 
       case PER_INST_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)s->count / (double)inst_count[proc_id],
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(c->count),
+                (double)c->count / (double)inst_count[proc_id],
                 unsstr64(s->total_count),
                 (double)s->total_count / (double)inst_count[proc_id]);
         break;
 
       case PER_1000_INST_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)1000.0 * (double)s->count / (double)inst_count[proc_id],
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(c->count),
+                (double)1000.0 * (double)c->count / (double)inst_count[proc_id],
                 unsstr64(s->total_count),
                 (double)1000.0 * (double)s->total_count /
                   (double)inst_count[proc_id]);
@@ -297,34 +353,34 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
 
       case PER_1000_PRET_INST_TYPE_STAT:
         fprintf(
-          file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-          (double)1000.0 * (double)s->count / (double)pret_inst_count[proc_id],
+          file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(c->count),
+          (double)1000.0 * (double)c->count / (double)pret_inst_count[proc_id],
           unsstr64(s->total_count),
           (double)1000.0 * (double)s->total_count / (double)pret_inst_count[0]);
         break;
 
       case PER_CYCLE_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)s->count / (double)cycle_count,
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(c->count),
+                (double)c->count / (double)cycle_count,
                 unsstr64(s->total_count),
                 (double)s->total_count / (double)cycle_count);
         break;
 
       case RATIO_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)s->count / (double)(stat_array[s->ratio_stat].count),
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(c->count),
+                (double)c->count / GET_STAT_EVENT(proc_id, s->ratio_stat),
                 unsstr64(s->total_count),
                 (double)s->total_count /
-                  (double)stat_array[s->ratio_stat].total_count);
+                  (double)core_stats[s->ratio_stat].total_count);
         break;
 
       case PERCENT_TYPE_STAT:
         fprintf(
-          file_stream, "%13s %12.3f%%    %13s %12.3f%%\n", unsstr64(s->count),
-          (double)s->count * 100 / (double)(stat_array[s->ratio_stat].count),
+          file_stream, "%13s %12.3f%%    %13s %12.3f%%\n", unsstr64(c->count),
+          (double)c->count * 100 / GET_STAT_EVENT(proc_id, s->ratio_stat),
           unsstr64(s->total_count),
           (double)s->total_count * 100 /
-            (double)stat_array[s->ratio_stat].total_count);
+            (double)core_stats[s->ratio_stat].total_count);
         break;
 
       case LINE_TYPE_STAT:
@@ -351,10 +407,11 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
   for(ii = 0; ii < num_stats; ii++) {
     Stat* s = &stat_array[ii];
     if(s->type == FLOAT_TYPE_STAT)
-      s->value = 0.0;
+      STAT_COUNTER(proc_id, first_stat + ii).value = 0.0;
     else
-      s->count = 0;
+      STAT_COUNTER(proc_id, first_stat + ii).count = 0;
   }
+  free(cur);
 }
 
 /**************************************************************************************/
@@ -373,15 +430,16 @@ void reset_stats(Flag keep_total) {
 
   for(ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
     for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-      Stat* stat = &global_stat_array[proc_id][ii];
+      Stat*         stat    = &global_stat_array[proc_id][ii];
+      Stat_Counter* counter = &STAT_COUNTER(proc_id, ii);
       if(stat->type == FLOAT_TYPE_STAT) {
         if(keep_total || stat->noreset)
-          stat->total_value += stat->value;
-        stat->value = 0.0;
+          stat->total_value += counter->value;
+        counter->value = 0.0;
       } else {
         if(keep_total || stat->noreset)
-          stat->total_count += stat->count;
-        stat->count = 0ULL;
+          stat->total_count += counter->count;
+        counter->count = 0ULL;
       }
     }
   }
@@ -426,3 +484,38 @@ Counter get_accum_stat_event(Stat_Enum name) {
 
   return accum;
 }
+
+
+/**************************************************************************************/
+/* stat_profile_done: write the stats ordered by how often they were updated,
+ * in the format of stat_hot.def */
+
+#ifdef STAT_PROFILE
+static int stat_profile_compare(const void* a, const void* b) {
+  Counter ca = global_stat_profile[*(const Stat_Enum*)a];
+  Counter cb = global_stat_profile[*(const Stat_Enum*)b];
+  return ca < cb ? 1 : ca > cb ? -1 : 0;
+}
+#endif
+
+void stat_profile_done(void) {
+#ifdef STAT_PROFILE
+  Stat_Enum order[NUM_GLOBAL_STATS];
+  uns       ii;
+
+  for(ii = 0; ii < NUM_GLOBAL_STATS; ii++)
+    order[ii] = ii;
+  qsort(order, NUM_GLOBAL_STATS, sizeof(Stat_Enum), stat_profile_compare);
+
+  FILE* file = file_tag_fopen(OUTPUT_DIR, "stat_profile.out", "w");
+  ASSERTM(0, file, "Could not open stat profile file\n");
+  fprintf(file, "/* Stats ordered by number of updates, drop-in for "
+                "stat_hot.def */\n");
+  for(ii = 0; ii < NUM_GLOBAL_STATS && global_stat_profile[order[ii]]; ii++) {
+    fprintf(file, "DEF_HOT_STAT( %-40s ) /* %s */\n",
+            global_stat_sample[order[ii]].name,
+            unsstr64(global_stat_profile[order[ii]]));
+  }
+  fclose(file);
+#endif
+}
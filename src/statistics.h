@@ -47,6 +47,24 @@ typedef enum Stat_Enum_enum {
 
 #undef DEF_STAT
 
+/* The stats of stat_hot.def come first in the counter array of a core (see
+   Stat_Counter), in that order. A range gets one slot per stat. */
+#define DEF_HOT_STAT(name) HOT_SLOT_##name,
+#define DEF_HOT_STAT_RANGE(first, last) \
+  HOT_SLOT_##first, HOT_SLOT_END_##first = HOT_SLOT_##first + (last) - (first),
+
+typedef enum Stat_Hot_Slot_enum {
+#include "stat_hot.def"
+  NUM_HOT_STAT_SLOTS
+} Stat_Hot_Slot;
+
+#undef DEF_HOT_STAT
+#undef DEF_HOT_STAT_RANGE
+
+/* All other stats follow the hot slots in enum order. The slots a hot stat
+   would get there are left unused. */
+#define NUM_STAT_SLOTS (NUM_HOT_STAT_SLOTS + NUM_GLOBAL_STATS)
+
 
 typedef enum Stat_Type_enum {
   COUNT_TYPE_STAT,  // stat is a simple counter
@@ -73,13 +91,20 @@ typedef enum Stat_Type_enum {
 } Stat_Type;
 
 
+/* The interval count (or value) of each stat is not kept in the Stat struct.
+   All hot counters of a core live in one dense array of 8-byte counters that
+   is separate from the stat metadata, so a STAT_EVENT touches a single
+   counter instead of a line full of names and types. The position of a stat
+   in that array is given by stat_slot(): the stats listed in stat_hot.def
+   come first (in that order), the rest follow in .def order. */
+typedef union Stat_Counter_union {
+  Counter count;  // count during the current stat interval
+  double  value;  // value during the current stat interval
+} Stat_Counter;
+
 typedef struct Stat_struct {
   Stat_Type   type;  // see types above
   const char* name;  // name of stat
-  union {
-    Counter count;  // count during the current stat interval
-    double  value;  // value during the current stat interval
-  };
   union {
     Counter total_count;  // total count from beginning of run
     double  total_value;  // total value from beginning of run
@@ -94,48 +119,85 @@ typedef struct Stat_struct {
 /* Macros */
 
 #ifndef NO_STAT
-#define STAT_EVENT(proc_id, stat)             \
-  do {                                        \
-    global_stat_array[proc_id][stat].count++; \
+/* stat_slot: position of a stat in the counter array of a core. It folds to
+   a constant for a constant stat, so such a STAT_EVENT needs no lookup. Stats
+   computed at run time (a bucket of a distribution) use global_stat_slot[],
+   which holds the same slots. */
+static inline uns stat_slot(uns stat) {
+#define DEF_HOT_STAT(name) \
+  if(stat == name)         \
+    return HOT_SLOT_##name;
+#define DEF_HOT_STAT_RANGE(first, last) \
+  if(stat >= first && stat <= last)     \
+    return HOT_SLOT_##first + stat - first;
+#include "stat_hot.def"
+#undef DEF_HOT_STAT
+#undef DEF_HOT_STAT_RANGE
+  return NUM_HOT_STAT_SLOTS + stat;
+}
+
+#define STAT_SLOT(stat) \
+  (__builtin_constant_p(stat) ? stat_slot(stat) : global_stat_slot[stat])
+#define STAT_COUNTER(proc_id, stat) \
+  (global_stat_counters[proc_id][STAT_SLOT(stat)])
+
+/* In profile builds (-DSTAT_PROFILE) every event is also counted per stat, so
+   that stat_hot.def can be regenerated from the most frequent ones. */
+#ifdef STAT_PROFILE
+#define STAT_PROFILE_EVENT(stat) (global_stat_profile[stat]++)
+#else
+#define STAT_PROFILE_EVENT(stat)
+#endif
+
+#define STAT_EVENT(proc_id, stat)          \
+  do {                                     \
+    STAT_PROFILE_EVENT(stat);              \
+    STAT_COUNTER(proc_id, stat).count++;   \
   } while(0)
 
 #define STAT_EVENT_ALL(stat)                             \
   do {                                                   \
+    STAT_PROFILE_EVENT(stat);                            \
     for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
-      global_stat_array[proc_id][stat].count++;          \
+      STAT_COUNTER(proc_id, stat).count++;               \
   } while(0)
 
-#define INC_STAT_EVENT(proc_id, stat, inc)           \
-  do {                                               \
-    global_stat_array[proc_id][stat].count += (inc); \
+#define INC_STAT_EVENT(proc_id, stat, inc)      \
+  do {                                          \
+    STAT_PROFILE_EVENT(stat);                   \
+    STAT_COUNTER(proc_id, stat).count += (inc); \
   } while(0)
 
 #define INC_STAT_EVENT_ALL(stat, inc)                    \
   do {                                                   \
+    STAT_PROFILE_EVENT(stat);                            \
     for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
-      global_stat_array[proc_id][stat].count += (inc);   \
+      STAT_COUNTER(proc_id, stat).count += (inc);        \
   } while(0)
 
-#define INC_STAT_VALUE(proc_id, stat, inc)           \
-  do {                                               \
-    global_stat_array[proc_id][stat].value += (inc); \
+#define INC_STAT_VALUE(proc_id, stat, inc)      \
+  do {                                          \
+    STAT_PROFILE_EVENT(stat);                   \
+    STAT_COUNTER(proc_id, stat).value += (inc); \
   } while(0)
 
 #define INC_STAT_VALUE_ALL(stat, inc)                    \
   do {                                                   \
+    STAT_PROFILE_EVENT(stat);                            \
     for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
-      global_stat_array[proc_id][stat].value += (inc);   \
+      STAT_COUNTER(proc_id, stat).value += (inc);        \
   } while(0)
 
-#define GET_STAT_EVENT(proc_id, stat) (global_stat_array[proc_id][stat].count)
+#define GET_STAT_EVENT(proc_id, stat) (STAT_COUNTER(proc_id, stat).count)
+#define GET_STAT_VALUE(proc_id, stat) (STAT_COUNTER(proc_id, stat).value)
 #define GET_TOTAL_STAT_EVENT(proc_id, stat) \
-  (global_stat_array[proc_id][stat].count + \
+  (STAT_COUNTER(proc_id, stat).count +      \
    global_stat_array[proc_id][stat].total_count)
 #define GET_TOTAL_STAT_VALUE(proc_id, stat) \
-  (global_stat_array[proc_id][stat].value + \
+  (STAT_COUNTER(proc_id, stat).value +      \
    global_stat_array[proc_id][stat].total_value)
 #define GET_ACCUM_STAT_EVENT(stat) get_accum_stat_event(stat)
-#define RESET_STAT(proc_id, stat) (global_stat_array[proc_id][stat].count = 0)
+#define RESET_STAT(proc_id, stat) (STAT_COUNTER(proc_id, stat).count = 0)
 
 #define NO_RATIO NUM_GLOBAL_STATS
 
@@ -148,6 +210,7 @@ typedef struct Stat_struct {
 #define INC_STAT_VALUE(proc_id, stat, inc)
 #define INC_STAT_VALUE_ALL(stat, inc)
 #define GET_STAT_EVENT(proc_id, stat) 0
+#define GET_STAT_VALUE(proc_id, stat) 0
 #define GET_TOTAL_STAT_EVENT(proc_id, stat) 0
 #define GET_TOTAL_STAT_VALUE(proc_id, stat)
 #define GET_ACCUM_STAT_EVENT(stat)
@@ -160,7 +223,12 @@ typedef struct Stat_struct {
 /* Global Variables */
 
 #ifndef NO_STAT
-extern Stat** global_stat_array;
+extern Stat**         global_stat_array;
+extern Stat_Counter** global_stat_counters;
+extern uns16          global_stat_slot[];
+#ifdef STAT_PROFILE
+extern Counter global_stat_profile[];
+#endif
 #endif
 
 
@@ -170,12 +238,13 @@ extern Stat** global_stat_array;
 void        init_global_stats_array(void);
 void        gen_stat_output_file(char*, uns8, Stat*);
 void        init_global_stats(uns8);
-void        dump_stats(uns8, Flag, Stat[], uns);
+void        dump_stats(uns8, Flag, Stat_Enum, uns);
 void        reset_stats(Flag);
 void        fprint_line(FILE*);
 Stat_Enum   get_stat_idx(const char* name);
 const Stat* get_stat(uns8, const char*);
 Counter     get_accum_stat_event(Stat_Enum name);
+void        stat_profile_done(void);
 
 
 /**************************************************************************************/
@@ -37,4 +37,5 @@ Flag*    trace_read_done;
 // const char* PIN_EXEC_DRIVEN_FE_SOCKET = "./temp.socket";
 const char* FILE_TAG             = "";
 uns         INST_HASH_TABLE_SIZE = 500021;
+Flag        ARENA_USE_MALLOC     = FALSE;
 int         op_type_delays[NUM_OP_TYPES];
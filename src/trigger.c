@@ -40,6 +40,8 @@
 struct Trigger_struct {
   Flag         armed;
   const Stat*  stat;
+  uns          proc_id;
+  Stat_Enum    stat_idx;
   char*        name;
   Trigger_Type type;
   Counter      period;
@@ -90,24 +92,29 @@ Trigger* trigger_create(const char* name, const char* spec, Trigger_Type type) {
 
   switch(*stat_str) {
     case 'i':
-      trigger->stat = &global_stat_array[proc_id][NODE_INST_COUNT];
+      trigger->stat_idx = NODE_INST_COUNT;
       break;
     case 'c':
-      trigger->stat = &global_stat_array[proc_id][NODE_CYCLE];
+      trigger->stat_idx = NODE_CYCLE;
       break;
     case 't':
-      trigger->stat = &global_stat_array[proc_id][EXECUTION_TIME];
+      trigger->stat_idx = EXECUTION_TIME;
       break;
     default:
-      trigger->stat = get_stat(proc_id, stat_str);
-      ASSERTM(0, trigger->stat, "Stat '%s' for trigger '%s' not found\n",
-              stat_str, name);
-      ASSERTM(0, trigger->stat->type != FLOAT_TYPE_STAT,
+      trigger->stat_idx = get_stat_idx(stat_str);
+      ASSERTM(0, trigger->stat_idx != NUM_GLOBAL_STATS,
+              "Stat '%s' for trigger '%s' not found\n", stat_str, name);
+      ASSERTM(0,
+              global_stat_array[proc_id][trigger->stat_idx].type !=
+                FLOAT_TYPE_STAT,
               "Stat '%s' for trigger '%s' is a float (triggers support counter "
               "stats only)\n",
               stat_str, name);
   }
 
+  trigger->stat    = &global_stat_array[proc_id][trigger->stat_idx];
+  trigger->proc_id = proc_id;
+
   trigger->period = atoll(number_str);
   if(trigger->period == 0 && trigger->type == TRIGGER_REPEAT) {
     FATAL_ERROR(0, "Repeat trigger '%s' has a zero period\n", name);
@@ -120,8 +127,9 @@ Trigger* trigger_create(const char* name, const char* spec, Trigger_Type type) {
 
 Flag trigger_fired(Trigger* trigger) {
   // common (false) case first
-  if(!trigger->armed || (trigger->stat->count + trigger->stat->total_count) <
-                          trigger->next_threshold) {
+  if(!trigger->armed ||
+     GET_TOTAL_STAT_EVENT(trigger->proc_id, trigger->stat_idx) <
+       trigger->next_threshold) {
     return FALSE;
   }
 
@@ -131,7 +139,7 @@ Flag trigger_fired(Trigger* trigger) {
   } else {
     trigger->next_threshold += trigger->period;
     uns skipped = 0;
-    while(trigger->stat->count + trigger->stat->total_count >=
+    while(GET_TOTAL_STAT_EVENT(trigger->proc_id, trigger->stat_idx) >=
           trigger->next_threshold) {
       trigger->next_threshold += trigger->period;
       skipped++;
@@ -155,7 +163,8 @@ double trigger_progress(Trigger* trigger) {
     return 1.0;
 
   ASSERT(0, trigger->next_threshold >= trigger->period);
-  Counter stat_count = trigger->stat->count + trigger->stat->total_count;
+  Counter stat_count = GET_TOTAL_STAT_EVENT(trigger->proc_id,
+                                            trigger->stat_idx);
   ASSERT(0, stat_count >= trigger->next_threshold - trigger->period);
   if(stat_count >= trigger->next_threshold)
     return 1.0;
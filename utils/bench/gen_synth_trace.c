@@ -0,0 +1,261 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : gen_synth_trace.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Writes synthetic instruction traces in the format read by the
+ *                trace frontend (an uncompressed stream of ctype_pin_inst,
+ *                pipe it through bzip2). The traces are deterministic, so the
+ *                simulator throughput benchmark always runs the same work.
+ *
+ *   gen_synth_trace <kernel> <num_insts>
+ *
+ *   stream  -- unit-stride loads over a 256MB array (bandwidth bound)
+ *   chase   -- dependent loads to random lines of a 512MB region (latency
+ *              bound)
+ *   branchy -- 256 static conditional branches with biased, patterned and
+ *              random outcomes (branch predictor bound)
+ ***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ctype_pin_inst.h"
+#include "globals/global_types.h"
+#include "isa/isa.h"
+#include "table_info.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define LINE_SIZE 64
+#define STREAM_BASE 0x10000000ULL
+#define STREAM_BYTES (256ULL << 20)
+#define CHASE_BASE 0x40000000ULL
+#define CHASE_BYTES (512ULL << 20)
+#define NUM_BRANCHES 256
+
+/**************************************************************************************/
+/* Global Variables */
+
+static uint64_t inst_uid;
+static uint64_t num_insts;
+static uint64_t rand_state = 0x2545f4914f6cdd1dULL;
+
+/**************************************************************************************/
+/* Local functions */
+
+static uint64_t next_rand(void) {
+  /* xorshift64*, fixed seed so every trace is reproducible */
+  rand_state ^= rand_state >> 12;
+  rand_state ^= rand_state << 25;
+  rand_state ^= rand_state >> 27;
+  return rand_state * 0x2545f4914f6cdd1dULL;
+}
+
+static void init_inst(ctype_pin_inst* pi, uint64_t pc, uint8_t size,
+                      Op_Type op_type, const char* iclass) {
+  memset(pi, 0, sizeof(*pi));
+  pi->instruction_addr      = pc;
+  pi->instruction_next_addr = pc + size;
+  pi->size                  = size;
+  pi->op_type               = op_type;
+  pi->cf_type               = NOT_CF;
+  pi->num_simd_lanes        = 1;
+  pi->lane_width_bytes      = 8;
+  pi->fake_inst_reason      = WPNM_NOT_IN_WPNM;
+  strncpy(pi->pin_iclass, iclass, sizeof(pi->pin_iclass) - 1);
+}
+
+static void add_src(ctype_pin_inst* pi, Reg_Id reg) {
+  pi->src_regs[pi->num_src_regs++] = reg;
+}
+
+static void add_dst(ctype_pin_inst* pi, Reg_Id reg) {
+  pi->dst_regs[pi->num_dst_regs++] = reg;
+}
+
+/* returns FALSE once the requested number of instructions is written */
+static int emit(ctype_pin_inst* pi) {
+  pi->inst_uid = inst_uid++;
+  if(fwrite(pi, sizeof(*pi), 1, stdout) != 1) {
+    perror("gen_synth_trace");
+    exit(1);
+  }
+  return inst_uid < num_insts;
+}
+
+static int emit_alu(uint64_t pc, Op_Type op_type, const char* iclass,
+                    Reg_Id dst, Reg_Id src0, Reg_Id src1) {
+  ctype_pin_inst pi;
+  init_inst(&pi, pc, 3, op_type, iclass);
+  add_src(&pi, src0);
+  if(src1 != REG_INV)
+    add_src(&pi, src1);
+  add_dst(&pi, dst);
+  if(op_type == OP_IADD && dst != REG_ZPS)
+    add_dst(&pi, REG_ZPS);
+  return emit(&pi);
+}
+
+static int emit_load(uint64_t pc, Reg_Id dst, Reg_Id base, uint64_t addr) {
+  ctype_pin_inst pi;
+  init_inst(&pi, pc, 3, OP_MOV, "MOV");
+  pi.is_move           = 1;
+  pi.num_ld            = 1;
+  pi.ld_vaddr[0]       = addr;
+  pi.ld_size           = 8;
+  pi.num_ld1_addr_regs = 1;
+  pi.ld1_addr_regs[0]  = base;
+  add_src(&pi, base);
+  add_dst(&pi, dst);
+  return emit(&pi);
+}
+
+static int emit_branch(uint64_t pc, Cf_Type cf_type, uint64_t target,
+                       int taken) {
+  ctype_pin_inst pi;
+  init_inst(&pi, pc, 2, OP_CF, cf_type == CF_CBR ? "JNZ" : "JMP");
+  pi.cf_type        = cf_type;
+  pi.branch_target  = target;
+  pi.actually_taken = taken;
+  if(taken)
+    pi.instruction_next_addr = target;
+  if(cf_type == CF_CBR)
+    add_src(&pi, REG_ZPS);
+  return emit(&pi);
+}
+
+/**************************************************************************************/
+/* Kernels */
+
+/* loop: mov rax,[rsi]; add rbx,rax; add rsi,64; cmp rsi,rdi; jnz loop */
+static void gen_stream(void) {
+  const uint64_t loop = 0x400000;
+  uint64_t       addr = STREAM_BASE;
+  int            more = 1;
+
+  while(more) {
+    int last = addr + LINE_SIZE >= STREAM_BASE + STREAM_BYTES;
+    more     = more && emit_load(loop + 0x0, REG_RAX, REG_RSI, addr);
+    more     = more &&
+           emit_alu(loop + 0x3, OP_IADD, "ADD", REG_RBX, REG_RBX, REG_RAX);
+    more = more && emit_alu(loop + 0x6, OP_IADD, "ADD", REG_RSI, REG_RSI,
+                            REG_INV);
+    more = more && emit_alu(loop + 0x9, OP_ICMP, "CMP", REG_ZPS, REG_RSI,
+                            REG_RDI);
+    more = more && emit_branch(loop + 0xc, CF_CBR, loop, !last);
+    addr = last ? STREAM_BASE : addr + LINE_SIZE;
+    if(last) {
+      more = more && emit_alu(loop + 0xe, OP_MOV, "MOV", REG_RSI, REG_RDX,
+                              REG_INV);
+      more = more && emit_branch(loop + 0x11, CF_BR, loop, 1);
+    }
+  }
+}
+
+/* loop: mov rsi,[rsi]; add rcx,1; cmp rcx,rdi; jnz loop */
+static void gen_chase(void) {
+  const uint64_t loop = 0x500000;
+  uint64_t       addr = CHASE_BASE;
+  int            more = 1;
+
+  while(more) {
+    more = more && emit_load(loop + 0x0, REG_RSI, REG_RSI, addr);
+    more = more && emit_alu(loop + 0x3, OP_IADD, "ADD", REG_RCX, REG_RCX,
+                            REG_INV);
+    more = more && emit_alu(loop + 0x6, OP_ICMP, "CMP", REG_ZPS, REG_RCX,
+                            REG_RDI);
+    more = more && emit_branch(loop + 0x9, CF_CBR, loop, 1);
+    addr = CHASE_BASE + (next_rand() % (CHASE_BYTES / LINE_SIZE)) * LINE_SIZE;
+  }
+}
+
+/* NUM_BRANCHES times: cmp rax,rbx; jnz +3; add rcx,1 -- then jmp back. A
+   quarter of the branches are 90% biased, a quarter follow a short periodic
+   pattern, a quarter are correlated with the previous branch and the rest are
+   random. */
+static void gen_branchy(void) {
+  const uint64_t base      = 0x600000;
+  const uint64_t block     = 8; /* cmp(3) + jnz(2) + add(3) */
+  uint64_t       iteration = 0;
+  int            more      = 1;
+
+  while(more) {
+    int prev_taken = 0;
+    for(uns ii = 0; ii < NUM_BRANCHES && more; ii++) {
+      uint64_t pc = base + ii * block;
+      int      taken;
+      switch(ii % 4) {
+        case 0:
+          taken = next_rand() % 10 != 0;
+          break;
+        case 1:
+          taken = ((iteration + ii) % (3 + ii % 5)) == 0;
+          break;
+        case 2:
+          taken = !prev_taken;
+          break;
+        default:
+          taken = next_rand() & 1;
+          break;
+      }
+      more = more && emit_alu(pc, OP_ICMP, "CMP", REG_ZPS, REG_RAX, REG_RBX);
+      more = more && emit_branch(pc + 3, CF_CBR, pc + block, taken);
+      if(!taken)
+        more = more && emit_alu(pc + 5, OP_IADD, "ADD", REG_RCX, REG_RCX,
+                                REG_INV);
+      prev_taken = taken;
+    }
+    more = more && emit_branch(base + NUM_BRANCHES * block, CF_BR, base, 1);
+    iteration++;
+  }
+}
+
+/**************************************************************************************/
+/* main */
+
+int main(int argc, char* argv[]) {
+  if(argc != 3) {
+    fprintf(stderr, "Usage: %s <stream|chase|branchy> <num_insts>\n", argv[0]);
+    return 1;
+  }
+  num_insts = strtoull(argv[2], NULL, 0);
+  if(num_insts == 0) {
+    fprintf(stderr, "Number of instructions must be positive\n");
+    return 1;
+  }
+
+  if(!strcmp(argv[1], "stream"))
+    gen_stream();
+  else if(!strcmp(argv[1], "chase"))
+    gen_chase();
+  else if(!strcmp(argv[1], "branchy"))
+    gen_branchy();
+  else {
+    fprintf(stderr, "Unknown kernel '%s'\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}
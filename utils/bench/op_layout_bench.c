@@ -0,0 +1,212 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : op_layout_bench.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Microbenchmark for the layout of Op. It replays the memory
+ *                access pattern of node_sched_ops (walk the ready list) and
+ *                node_retire (walk the node table) over many in-flight ops
+ *                and reports how many cache lines each op visit touches and
+ *                the time per visit. Build it against two checkouts to compare
+ *                layouts.
+ *
+ *   op_layout_bench [num_ops] [passes]
+ *
+ *   num_ops -- ops in flight (default 8192, e.g. 16 cores with a 512 entry
+ *              ROB)
+ *   passes  -- scheduler and retire walks over all ops (default 200)
+ ***************************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "globals/global_types.h"
+#include "op.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define LINE_SIZE 64
+
+/* fields read by the ready list walk of node_sched_ops */
+#define SCHED_FIELDS(f)                                                \
+  f(next_rdy) f(proc_id) f(in_rdy_list) f(state) f(op_num) f(rdy_cycle) \
+    f(srcs_not_rdy_vector) f(sched_cycle) f(fu_num) f(table_info)
+
+/* fields read by the node table walk of node_retire */
+#define RETIRE_FIELDS(f)                                                  \
+  f(next_node) f(proc_id) f(state) f(done_cycle) f(op_num) f(off_path)    \
+    f(exit) f(replay) f(recovery_scheduled) f(redirect_scheduled) f(req) \
+    f(inst_info)
+
+/**************************************************************************************/
+/* Global Variables */
+
+Counter cycle_count;
+
+static uint64_t rand_state = 0x2545f4914f6cdd1dULL;
+
+/**************************************************************************************/
+/* Local functions */
+
+static uint64_t next_rand(void) {
+  rand_state ^= rand_state >> 12;
+  rand_state ^= rand_state << 25;
+  rand_state ^= rand_state >> 27;
+  return rand_state * 0x2545f4914f6cdd1dULL;
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* number of distinct cache lines of an op covered by the given offsets */
+static uns count_lines(const size_t* offsets, uns num) {
+  uns lines = 0;
+  for(uns ii = 0; ii < num; ii++) {
+    Flag seen = FALSE;
+    for(uns jj = 0; jj < ii; jj++)
+      seen |= offsets[jj] / LINE_SIZE == offsets[ii] / LINE_SIZE;
+    lines += !seen;
+  }
+  return lines;
+}
+
+/* same checks as node_sched_ops, scheduling an op when it is ready */
+static uns sched_walk(Op* rdy_head) {
+  uns scheduled = 0;
+  for(Op* op = rdy_head; op; op = op->next_rdy) {
+    if(!op->in_rdy_list || op->state == OS_TENTATIVE ||
+       op->state == OS_WAIT_DCACHE)
+      continue;
+    if(cycle_count >= op->rdy_cycle - 1 && op->srcs_not_rdy_vector == 0 &&
+       op->fu_num != (uns)-1 && op->table_info) {
+      op->sched_cycle = cycle_count + (op->op_num & 1);
+      scheduled++;
+    }
+  }
+  return scheduled;
+}
+
+/* same checks as node_retire and op_not_ready_for_retire, without removing
+   the ops */
+static uns retire_walk(Op* node_head) {
+  uns retirable = 0;
+  for(Op* op = node_head; op; op = op->next_node) {
+    if(op->state != OS_DONE || cycle_count < op->done_cycle || op->replay ||
+       op->recovery_scheduled || op->redirect_scheduled)
+      continue;
+    retirable += !op->off_path && !op->exit && op->inst_info && !op->req &&
+                 op->op_num != 0;
+  }
+  return retirable;
+}
+
+/**************************************************************************************/
+/* main */
+
+int main(int argc, char* argv[]) {
+  uns num_ops = argc > 1 ? atoi(argv[1]) : 8192;
+  uns passes  = argc > 2 ? atoi(argv[2]) : 200;
+  Op* ops;
+  Op* rdy_head  = NULL;
+  Op* node_head = NULL;
+
+  static const size_t sched_offsets[] = {
+#define OFFSET(field) offsetof(Op, field),
+    SCHED_FIELDS(OFFSET)};
+  static const size_t retire_offsets[] = {RETIRE_FIELDS(OFFSET)
+#undef OFFSET
+  };
+
+  /* the op pool hands out ops from 64-byte aligned slabs */
+  if(posix_memalign((void**)&ops, LINE_SIZE, (size_t)num_ops * sizeof(Op))) {
+    perror("op_layout_bench");
+    return 1;
+  }
+  memset(ops, 0, (size_t)num_ops * sizeof(Op));
+
+  /* node table in op_num order, ready list in a random order */
+  uns* perm = malloc(num_ops * sizeof(uns));
+  for(uns ii = 0; ii < num_ops; ii++)
+    perm[ii] = ii;
+  for(uns ii = num_ops - 1; ii > 0; ii--) {
+    uns jj   = next_rand() % (ii + 1);
+    uns tmp  = perm[ii];
+    perm[ii] = perm[jj];
+    perm[jj] = tmp;
+  }
+  static Table_Info table_info;
+  static Inst_Info  inst_info;
+  for(uns ii = num_ops; ii-- > 0;) {
+    Op* op                  = &ops[ii];
+    op->op_num              = ii + 1;
+    op->state               = next_rand() % 4 ? OS_DONE : OS_IN_RS;
+    op->rdy_cycle           = next_rand() % 16;
+    op->done_cycle          = next_rand() % 16;
+    op->srcs_not_rdy_vector = next_rand() % 8 == 0;
+    op->fu_num              = 0;
+    op->table_info          = &table_info;
+    op->inst_info           = &inst_info;
+    op->next_node           = node_head;
+    node_head               = op;
+  }
+  for(uns ii = 0; ii < num_ops; ii++) {
+    Op* op          = &ops[perm[ii]];
+    op->in_rdy_list = TRUE;
+    op->next_rdy    = rdy_head;
+    rdy_head        = op;
+  }
+
+  double  sched_ns = 0, retire_ns = 0;
+  Counter checksum = 0;
+  for(uns pass = 0; pass < passes; pass++) {
+    cycle_count  = pass % 16;
+    double start = now_ns();
+    checksum += sched_walk(rdy_head);
+    double mid = now_ns();
+    checksum += retire_walk(node_head);
+    sched_ns += mid - start;
+    retire_ns += now_ns() - mid;
+  }
+
+  printf("sizeof(Op)            %zu bytes\n", sizeof(Op));
+  printf("sched lines per op    %u\n",
+         count_lines(sched_offsets, sizeof(sched_offsets) / sizeof(size_t)));
+  printf("retire lines per op   %u\n",
+         count_lines(retire_offsets, sizeof(retire_offsets) / sizeof(size_t)));
+  printf("sched walk            %.2f ns/op\n",
+         sched_ns / ((double)passes * num_ops));
+  printf("retire walk           %.2f ns/op\n",
+         retire_ns / ((double)passes * num_ops));
+  printf("checksum              %llu\n", (unsigned long long)checksum);
+  free(perm);
+  free(ops);
+  return 0;
+}
@@ -0,0 +1,240 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+# Simulator Throughput Benchmark
+
+Runs Scarab on a fixed set of traces and reports how fast the simulator itself
+is: KIPS, host cycles per simulated cycle, peak RSS and the share of host time
+spent in each simulator phase (from the HOST_PROF_* stats). The results can be
+stored as a baseline and later runs compared against it:
+
+> python ./utils/bench/scarab_bench.py --save_baseline
+> python ./utils/bench/scarab_bench.py
+
+The second command exits with status 1 if any workload got slower (or bigger)
+than the baseline by more than --tolerance. The synthetic traces are built by
+./utils/bench/Makefile. Recorded memtrace workloads can be added with
+--memtrace_dir and --memtrace_modules.
+
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+scarab_root_path = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+sys.path.append(scarab_root_path + '/bin')
+from scarab_globals import *
+
+bench_dir = scarab_paths.sim_dir + '/utils/bench'
+
+# name -> list of per-core trace files, relative to the Scarab root
+TRACE_WORKLOADS = [
+  ('simple_loop', ['src/test/simple_loop.trace.bz2']),
+  ('stream',      ['utils/bench/traces/stream.trace.bz2']),
+  ('chase',       ['utils/bench/traces/chase.trace.bz2']),
+  ('branchy',     ['utils/bench/traces/branchy.trace.bz2']),
+  ('mix4',        ['utils/bench/traces/stream.trace.bz2',
+                   'utils/bench/traces/chase.trace.bz2',
+                   'utils/bench/traces/branchy.trace.bz2',
+                   'utils/bench/traces/stream.trace.bz2']),
+]
+
+HEADER_RE = re.compile(r'Cumulative:\s+Cycles:\s+(\d+)\s+Instructions:\s+(\d+)')
+PHASE_RE  = re.compile(r'^HOST_PROF_(\w+)_CYCLES\s+\S+\s+\S+\s+(\d+)')
+
+def build_traces():
+  print('Building the synthetic benchmark traces')
+  subprocess.check_call(['make', '--no-print-directory', '-C', bench_dir, 'all'])
+
+def get_workloads():
+  workloads = []
+  for name, traces in TRACE_WORKLOADS:
+    args_list = ['--frontend', 'trace', '--num_cores', str(len(traces))]
+    for core, trace in enumerate(traces):
+      args_list += ['--cbp_trace_r{}'.format(core), os.path.join(scarab_paths.sim_dir, trace)]
+    workloads.append((name, args_list))
+
+  if args.memtrace_dir:
+    for trace in sorted(os.listdir(args.memtrace_dir)):
+      args_list = ['--frontend', 'memtrace', '--num_cores', '1',
+                   '--cbp_trace_r0', os.path.join(args.memtrace_dir, trace),
+                   '--memtrace_modules_log', args.memtrace_modules,
+                   '--inst_limit', str(args.memtrace_inst_limit)]
+      workloads.append(('memtrace_' + trace.split('.')[0], args_list))
+
+  if args.workloads:
+    selected = set(args.workloads.split(','))
+    workloads = [w for w in workloads if w[0] in selected]
+  return workloads
+
+def parse_stats(run_dir, num_cores):
+  cycles = 0
+  insts  = 0
+  phases = {}
+  for core in range(num_cores):
+    with open(os.path.join(run_dir, 'host_prof.stat.{}.out'.format(core))) as f:
+      for line in f:
+        m = HEADER_RE.search(line)
+        if m:
+          cycles = max(cycles, int(m.group(1)))
+          insts += int(m.group(2))
+          continue
+        m = PHASE_RE.match(line)
+        if m:
+          phases[m.group(1)] = phases.get(m.group(1), 0) + int(m.group(2))
+  return cycles, insts, phases
+
+def run_workload(name, workload_args):
+  run_dir = os.path.join(args.results_dir, name)
+  shutil.rmtree(run_dir, ignore_errors=True)
+  os.makedirs(run_dir)
+  shutil.copy(args.param, os.path.join(run_dir, 'PARAMS.in'))
+  num_cores = int(workload_args[workload_args.index('--num_cores') + 1])
+
+  cmd = [args.scarab] + workload_args + ['--host_prof', '1']
+  with open(os.path.join(run_dir, 'scarab.out'), 'w') as out:
+    start = time.time()
+    proc = subprocess.Popen(cmd, cwd=run_dir, stdout=out, stderr=subprocess.STDOUT)
+    _, status, rusage = os.wait4(proc.pid, 0)
+    seconds = time.time() - start
+  if status != 0:
+    print('{}: Scarab failed, see {}/scarab.out'.format(name, run_dir))
+    return None
+
+  cycles, insts, phases = parse_stats(run_dir, num_cores)
+  # the root phase covers the whole cycle loop, every other phase is a share of it
+  total = phases.pop('CMP_CYCLE', 0)
+  return {
+    'seconds': seconds,
+    'cycles': cycles,
+    'instructions': insts,
+    'kips': insts / seconds / 1000.0,
+    'host_cycles_per_cycle': float(total) / cycles if cycles else 0.0,
+    'peak_rss_kb': rusage.ru_maxrss,
+    'phase_share': dict((p, float(c) / total if total else 0.0) for p, c in phases.items()),
+  }
+
+def best_of(results):
+  # take the fastest repeat; it is the one least disturbed by the host
+  return max(results, key=lambda r: r['kips'])
+
+def print_result(name, r):
+  print('{:<16} {:>10.1f} KIPS  {:>10.1f} host cyc/cyc  {:>8d} KB  {:>8.2f} s'.format(
+        name, r['kips'], r['host_cycles_per_cycle'], r['peak_rss_kb'], r['seconds']))
+  top = sorted(r['phase_share'].items(), key=lambda p: -p[1])[:args.num_phases]
+  print('                 ' + '  '.join('{} {:.1%}'.format(p, s) for p, s in top))
+
+def compare(results, baseline, failed):
+  regressions = [(name, 'failed') for name in failed]
+  for name in sorted(baseline):
+    # a workload left out with --workloads was not run on purpose
+    if name in results or name in failed:
+      continue
+    if args.workloads and name not in args.workloads.split(','):
+      continue
+    print('{:<16} missing from the results  REGRESSION'.format(name))
+    regressions.append((name, 'missing'))
+  for name, r in sorted(results.items()):
+    base = baseline.get(name)
+    if not base:
+      print('{:<16} no baseline'.format(name))
+      continue
+    checks = [('kips', r['kips'] < base['kips'] * (1.0 - args.tolerance)),
+              ('host_cycles_per_cycle',
+               r['host_cycles_per_cycle'] > base['host_cycles_per_cycle'] * (1.0 + args.tolerance)),
+              ('peak_rss_kb', r['peak_rss_kb'] > base['peak_rss_kb'] * (1.0 + args.tolerance))]
+    for metric, regressed in checks:
+      change = (r[metric] - base[metric]) / base[metric] if base[metric] else 0.0
+      print('{:<16} {:<22} {:>12.1f} -> {:>12.1f} ({:+.1%}){}'.format(
+            name, metric, base[metric], r[metric], change, '  REGRESSION' if regressed else ''))
+      if regressed:
+        regressions.append((name, metric))
+  return regressions
+
+def __main():
+  global args
+
+  parser = argparse.ArgumentParser(description='Measure and track Scarab simulation throughput')
+  parser.add_argument('--scarab', default=scarab_paths.scarab_bin, help='Scarab binary to benchmark.')
+  parser.add_argument('--param', default=bench_dir + '/PARAMS.bench', help='PARAMS file for every run.')
+  parser.add_argument('--results_dir', default=bench_dir + '/results', help='Where to run the workloads.')
+  parser.add_argument('--baseline', default=bench_dir + '/baseline.json', help='Baseline results file.')
+  parser.add_argument('--save_baseline', action='store_true', help='Store the results as the new baseline.')
+  parser.add_argument('--tolerance', type=float, default=0.05, help='Allowed relative slowdown before failing.')
+  parser.add_argument('--repeat', type=int, default=3, help='Runs per workload; the fastest one is kept.')
+  parser.add_argument('--workloads', help='Comma-separated subset of workloads to run.')
+  parser.add_argument('--num_phases', type=int, default=6, help='Number of phases to print per workload.')
+  parser.add_argument('--memtrace_dir', help='Directory of recorded memtraces to add as workloads.')
+  parser.add_argument('--memtrace_modules', help='Modules log for the recorded memtraces.')
+  parser.add_argument('--memtrace_inst_limit', type=int, default=10000000, help='Instructions per memtrace workload.')
+  args = parser.parse_args()
+
+  if args.memtrace_dir and not args.memtrace_modules:
+    parser.error('--memtrace_dir requires --memtrace_modules')
+
+  os.makedirs(args.results_dir, exist_ok=True)
+  build_traces()
+  results = {}
+  failed  = []
+  for name, workload_args in get_workloads():
+    runs = [run_workload(name, workload_args) for _ in range(args.repeat)]
+    # a workload that fails even once is broken, not slow
+    if None in runs:
+      print('{:<16} FAILED'.format(name))
+      failed.append(name)
+      continue
+    results[name] = best_of(runs)
+    print_result(name, results[name])
+
+  with open(os.path.join(args.results_dir, 'results.json'), 'w') as f:
+    json.dump(results, f, indent=2, sort_keys=True)
+
+  if args.save_baseline:
+    if failed:
+      print('Not saving a baseline, {} workload(s) failed: {}'.format(
+            len(failed), ', '.join(failed)))
+      sys.exit(1)
+    with open(args.baseline, 'w') as f:
+      json.dump(results, f, indent=2, sort_keys=True)
+    print('Saved baseline to', args.baseline)
+    return
+
+  if not os.path.exists(args.baseline):
+    print('No baseline at {}, run with --save_baseline first'.format(args.baseline))
+    sys.exit(1 if failed else 0)
+
+  with open(args.baseline) as f:
+    regressions = compare(results, json.load(f), failed)
+  if regressions:
+    print('{} regression(s) (failed, missing or worse by more than {:.0%}): {}'.format(
+          len(regressions), args.tolerance, ', '.join('{} {}'.format(n, m) for n, m in regressions)))
+    sys.exit(1)
+
+if __name__ == "__main__":
+  __main()